@@ -40,7 +40,11 @@
   'target_defaults': {
     'include_dirs': [
       '.',
-      'include'
+      'include',
+      'third_party/zstd/lib'
+    ],
+    'defines': [
+      'ZSTD_DISABLE_ASM'
     ],
     'conditions': [
       ['OS == "win"', {
@@ -500,6 +504,7 @@
         'src/core/lib/support/alloc.c',
         'src/core/lib/support/avl.c',
         'src/core/lib/support/backoff.c',
+        'src/core/lib/support/byte_class.c',
         'src/core/lib/support/cmdline.c',
         'src/core/lib/support/cpu_iphone.c',
         'src/core/lib/support/cpu_linux.c',
@@ -520,6 +525,8 @@
         'src/core/lib/support/percent_encoding.c',
         'src/core/lib/support/slice.c',
         'src/core/lib/support/slice_buffer.c',
+        'src/core/lib/support/slice_mapped_file_posix.c',
+        'src/core/lib/support/slice_mapped_file_posix_noop.c',
         'src/core/lib/support/stack_lockfree.c',
         'src/core/lib/support/string.c',
         'src/core/lib/support/string_posix.c',
@@ -574,7 +581,9 @@
         'src/core/lib/channel/handshaker.c',
         'src/core/lib/channel/http_client_filter.c',
         'src/core/lib/channel/http_server_filter.c',
+        'src/core/lib/channel/max_age_filter.c',
         'src/core/lib/channel/message_size_filter.c',
+        'src/core/lib/channel/shm_handshaker.c',
         'src/core/lib/compression/compression.c',
         'src/core/lib/compression/message_compress.c',
         'src/core/lib/debug/trace.c',
@@ -600,10 +609,13 @@
         'src/core/lib/iomgr/load_file.c',
         'src/core/lib/iomgr/network_status_tracker.c',
         'src/core/lib/iomgr/polling_entity.c',
+        'src/core/lib/iomgr/pollset_set_members.c',
         'src/core/lib/iomgr/pollset_set_windows.c',
         'src/core/lib/iomgr/pollset_windows.c',
         'src/core/lib/iomgr/resolve_address_posix.c',
         'src/core/lib/iomgr/resolve_address_windows.c',
+        'src/core/lib/iomgr/shm_endpoint_linux.c',
+        'src/core/lib/iomgr/shm_endpoint_noop.c',
         'src/core/lib/iomgr/sockaddr_utils.c',
         'src/core/lib/iomgr/socket_utils_common_posix.c',
         'src/core/lib/iomgr/socket_utils_linux.c',
@@ -770,6 +782,53 @@
         }]
       ]
     },
+    {
+      'cflags': [
+        '-std=c99',
+        '-Wall',
+        '-Werror'
+      ],
+      'target_name': 'zstd',
+      'product_prefix': 'lib',
+      'type': 'static_library',
+      'dependencies': [
+      ],
+      'sources': [
+        'third_party/zstd/lib/common/debug.c',
+        'third_party/zstd/lib/common/entropy_common.c',
+        'third_party/zstd/lib/common/error_private.c',
+        'third_party/zstd/lib/common/fse_decompress.c',
+        'third_party/zstd/lib/common/pool.c',
+        'third_party/zstd/lib/common/threading.c',
+        'third_party/zstd/lib/common/xxhash.c',
+        'third_party/zstd/lib/common/zstd_common.c',
+        'third_party/zstd/lib/compress/fse_compress.c',
+        'third_party/zstd/lib/compress/hist.c',
+        'third_party/zstd/lib/compress/huf_compress.c',
+        'third_party/zstd/lib/compress/zstd_compress.c',
+        'third_party/zstd/lib/compress/zstd_compress_literals.c',
+        'third_party/zstd/lib/compress/zstd_compress_sequences.c',
+        'third_party/zstd/lib/compress/zstd_compress_superblock.c',
+        'third_party/zstd/lib/compress/zstd_double_fast.c',
+        'third_party/zstd/lib/compress/zstd_fast.c',
+        'third_party/zstd/lib/compress/zstd_lazy.c',
+        'third_party/zstd/lib/compress/zstd_ldm.c',
+        'third_party/zstd/lib/compress/zstd_opt.c',
+        'third_party/zstd/lib/compress/zstd_preSplit.c',
+        'third_party/zstd/lib/compress/zstdmt_compress.c',
+        'third_party/zstd/lib/decompress/huf_decompress.c',
+        'third_party/zstd/lib/decompress/zstd_ddict.c',
+        'third_party/zstd/lib/decompress/zstd_decompress.c',
+        'third_party/zstd/lib/decompress/zstd_decompress_block.c',
+      ],
+      "conditions": [
+        ['OS == "mac"', {
+          'xcode_settings': {
+            'MACOSX_DEPLOYMENT_TARGET': '10.9'
+          }
+        }]
+      ]
+    },
     {
       'include_dirs': [
         "<!(node -e \"require('nan')\")"
@@ -816,6 +875,7 @@
         "src/node/ext/channel.cc",
         "src/node/ext/channel_credentials.cc",
         "src/node/ext/completion_queue_async_worker.cc",
+        "src/node/ext/completion_queue_poller.cc",
         "src/node/ext/node_grpc.cc",
         "src/node/ext/server.cc",
         "src/node/ext/server_credentials.cc",
@@ -824,6 +884,7 @@
       "dependencies": [
         "grpc",
         "gpr",
+        "zstd",
       ]
     },
     {
@@ -8,6 +8,7 @@ if test "$PHP_GRPC" != "no"; then
   PHP_ADD_INCLUDE(../../grpc/include)
   PHP_ADD_INCLUDE(../../grpc/src/php/ext/grpc)
   PHP_ADD_INCLUDE(../../grpc/third_party/boringssl/include)
+  PHP_ADD_INCLUDE(../../grpc/third_party/zstd/lib)
 
   LIBS="-lpthread $LIBS"
 
@@ -41,6 +42,7 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/support/alloc.c \
     src/core/lib/support/avl.c \
     src/core/lib/support/backoff.c \
+    src/core/lib/support/byte_class.c \
     src/core/lib/support/cmdline.c \
     src/core/lib/support/cpu_iphone.c \
     src/core/lib/support/cpu_linux.c \
@@ -61,6 +63,8 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/support/percent_encoding.c \
     src/core/lib/support/slice.c \
     src/core/lib/support/slice_buffer.c \
+    src/core/lib/support/slice_mapped_file_posix.c \
+    src/core/lib/support/slice_mapped_file_posix_noop.c \
     src/core/lib/support/stack_lockfree.c \
     src/core/lib/support/string.c \
     src/core/lib/support/string_posix.c \
@@ -93,7 +97,9 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/channel/handshaker.c \
     src/core/lib/channel/http_client_filter.c \
     src/core/lib/channel/http_server_filter.c \
+    src/core/lib/channel/max_age_filter.c \
     src/core/lib/channel/message_size_filter.c \
+    src/core/lib/channel/shm_handshaker.c \
     src/core/lib/compression/compression.c \
     src/core/lib/compression/message_compress.c \
     src/core/lib/debug/trace.c \
@@ -119,10 +125,13 @@ if test "$PHP_GRPC" != "no"; then
     src/core/lib/iomgr/load_file.c \
     src/core/lib/iomgr/network_status_tracker.c \
     src/core/lib/iomgr/polling_entity.c \
+    src/core/lib/iomgr/pollset_set_members.c \
     src/core/lib/iomgr/pollset_set_windows.c \
     src/core/lib/iomgr/pollset_windows.c \
     src/core/lib/iomgr/resolve_address_posix.c \
     src/core/lib/iomgr/resolve_address_windows.c \
+    src/core/lib/iomgr/shm_endpoint_linux.c \
+    src/core/lib/iomgr/shm_endpoint_noop.c \
     src/core/lib/iomgr/sockaddr_utils.c \
     src/core/lib/iomgr/socket_utils_common_posix.c \
     src/core/lib/iomgr/socket_utils_linux.c \
@@ -577,10 +586,36 @@ if test "$PHP_GRPC" != "no"; then
     third_party/boringssl/ssl/t1_enc.c \
     third_party/boringssl/ssl/t1_lib.c \
     third_party/boringssl/ssl/tls_record.c \
+    third_party/zstd/lib/common/debug.c \
+    third_party/zstd/lib/common/entropy_common.c \
+    third_party/zstd/lib/common/error_private.c \
+    third_party/zstd/lib/common/fse_decompress.c \
+    third_party/zstd/lib/common/pool.c \
+    third_party/zstd/lib/common/threading.c \
+    third_party/zstd/lib/common/xxhash.c \
+    third_party/zstd/lib/common/zstd_common.c \
+    third_party/zstd/lib/compress/fse_compress.c \
+    third_party/zstd/lib/compress/hist.c \
+    third_party/zstd/lib/compress/huf_compress.c \
+    third_party/zstd/lib/compress/zstd_compress.c \
+    third_party/zstd/lib/compress/zstd_compress_literals.c \
+    third_party/zstd/lib/compress/zstd_compress_sequences.c \
+    third_party/zstd/lib/compress/zstd_compress_superblock.c \
+    third_party/zstd/lib/compress/zstd_double_fast.c \
+    third_party/zstd/lib/compress/zstd_fast.c \
+    third_party/zstd/lib/compress/zstd_lazy.c \
+    third_party/zstd/lib/compress/zstd_ldm.c \
+    third_party/zstd/lib/compress/zstd_opt.c \
+    third_party/zstd/lib/compress/zstd_preSplit.c \
+    third_party/zstd/lib/compress/zstdmt_compress.c \
+    third_party/zstd/lib/decompress/huf_decompress.c \
+    third_party/zstd/lib/decompress/zstd_ddict.c \
+    third_party/zstd/lib/decompress/zstd_decompress.c \
+    third_party/zstd/lib/decompress/zstd_decompress_block.c \
     , $ext_shared, , -Wall -Werror \
     -Wno-parentheses-equality -Wno-unused-value -std=c11 \
-    -fvisibility=hidden -DOPENSSL_NO_ASM -D_GNU_SOURCE -DWIN32_LEAN_AND_MEAN \
-    -D_HAS_EXCEPTIONS=0 -DNOMINMAX)
+    -fvisibility=hidden -DOPENSSL_NO_ASM -DZSTD_DISABLE_ASM -D_GNU_SOURCE \
+    -DWIN32_LEAN_AND_MEAN -D_HAS_EXCEPTIONS=0 -DNOMINMAX)
 
   PHP_ADD_BUILD_DIR($ext_builddir/src/php/ext/grpc)
 
@@ -669,4 +704,7 @@ if test "$PHP_GRPC" != "no"; then
   PHP_ADD_BUILD_DIR($ext_builddir/third_party/boringssl/ssl)
   PHP_ADD_BUILD_DIR($ext_builddir/third_party/boringssl/ssl/pqueue)
   PHP_ADD_BUILD_DIR($ext_builddir/third_party/nanopb)
+  PHP_ADD_BUILD_DIR($ext_builddir/third_party/zstd/lib/common)
+  PHP_ADD_BUILD_DIR($ext_builddir/third_party/zstd/lib/compress)
+  PHP_ADD_BUILD_DIR($ext_builddir/third_party/zstd/lib/decompress)
 fi
@@ -246,6 +246,12 @@ class ServerCompletionQueue : public CompletionQueue {
   /// frequently polled.
   ServerCompletionQueue(bool is_frequently_polled = true)
       : is_frequently_polled_(is_frequently_polled) {}
+
+ protected:
+  /// Wrap the C completion queue instance \a take, which becomes owned by the
+  /// new queue.
+  ServerCompletionQueue(grpc_completion_queue* take, bool is_frequently_polled)
+      : CompletionQueue(take), is_frequently_polled_(is_frequently_polled) {}
 };
 
 }  // namespace grpc
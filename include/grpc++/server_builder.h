@@ -52,6 +52,7 @@ class Server;
 class ServerCompletionQueue;
 class ServerCredentials;
 class Service;
+class ShardedServerCompletionQueue;
 
 namespace testing {
 class ServerBuilderPluginTest;
@@ -154,6 +155,13 @@ class ServerBuilder {
   std::unique_ptr<ServerCompletionQueue> AddCompletionQueue(
       bool is_frequently_polled = true);
 
+  /// Add a completion queue made of \a num_shards shards for handling
+  /// asynchronous services (see \a ShardedServerCompletionQueue), to be used
+  /// like one returned by \a AddCompletionQueue. Returns nullptr if
+  /// \a num_shards is 0.
+  std::unique_ptr<ShardedServerCompletionQueue> AddShardedCompletionQueue(
+      size_t num_shards);
+
   /// Return a running server which is ready for processing calls.
   std::unique_ptr<Server> BuildAndStart();
 
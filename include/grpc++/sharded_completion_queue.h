@@ -0,0 +1,79 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GRPCXX_SHARDED_COMPLETION_QUEUE_H
+#define GRPCXX_SHARDED_COMPLETION_QUEUE_H
+
+#include <stddef.h>
+
+#include <grpc++/impl/codegen/completion_queue.h>
+
+namespace grpc {
+
+class ServerBuilder;
+
+/// A server completion queue made of several shards, each with its own lock
+/// and poller, used through this single handle like any other
+/// \a ServerCompletionQueue.
+///
+/// With a single completion queue, every polling thread contends on the same
+/// queue; with one queue per thread, a thread whose queue runs dry sits idle
+/// while another one is backed up. Instead, each thread has a home shard in a
+/// sharded queue: the calls it requests on the queue are notified there, and
+/// that's where \a Next waits, unless another shard is left without a waiting
+/// thread. When the shard it waits on has nothing to offer, \a Next takes an
+/// event from one of the others, and an event completing on a shard no thread
+/// is waiting on wakes up a thread waiting on another one.
+///
+/// Obtain one from \a ServerBuilder::AddShardedCompletionQueue. As with a
+/// plain \a ServerCompletionQueue, the server must be shut down before the
+/// queue, and the queue must be drained (\a Next returning false) before it is
+/// destroyed.
+class ShardedServerCompletionQueue : public ServerCompletionQueue {
+ public:
+  ~ShardedServerCompletionQueue();
+
+  /// Number of shards this queue is made of.
+  size_t NumShards() const { return num_shards_; }
+
+ private:
+  friend class ServerBuilder;
+
+  explicit ShardedServerCompletionQueue(size_t num_shards);
+
+  const size_t num_shards_;
+};
+
+}  // namespace grpc
+
+#endif  // GRPCXX_SHARDED_COMPLETION_QUEUE_H
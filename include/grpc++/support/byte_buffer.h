@@ -66,6 +66,12 @@ class ByteBuffer GRPC_FINAL {
   /// Dump (read) the buffer contents into \a slices.
   Status Dump(std::vector<Slice>* slices) const;
 
+  /// Replace the buffer contents with the \a length bytes of the file \a fd
+  /// at \a offset, without reading them. Wrapper of core function
+  /// grpc_raw_byte_buffer_from_file, which details how the data gets sent and
+  /// what the file must guarantee.
+  Status SetFromFile(int fd, int64_t offset, size_t length);
+
   /// Remove all data.
   void Clear();
 
@@ -59,6 +59,20 @@ class Slice GRPC_FINAL {
   /// Construct a slice from \a slice, stealing a reference.
   Slice(gpr_slice slice, StealRef);
 
+  /// How the bytes of a mapped file slice are going to be accessed.
+  enum MapAdvice {
+    MAP_ADVICE_NORMAL = GPR_SLICE_MAP_ADVICE_NORMAL,
+    MAP_ADVICE_SEQUENTIAL = GPR_SLICE_MAP_ADVICE_SEQUENTIAL,
+    MAP_ADVICE_RANDOM = GPR_SLICE_MAP_ADVICE_RANDOM,
+    MAP_ADVICE_WILLNEED = GPR_SLICE_MAP_ADVICE_WILLNEED
+  };
+  /// Construct a slice of the \a length bytes of the file \a fd at \a offset,
+  /// backed by a read-only mapping of the file instead of a copy of its bytes.
+  /// Wrapper of core function gpr_slice_from_mapped_file, which details what
+  /// the file must guarantee. The slice is empty if the range couldn't be
+  /// mapped.
+  Slice(int fd, int64_t offset, size_t length, MapAdvice advice);
+
   /// Copy constructor, adds a reference.
   Slice(const Slice& other);
 
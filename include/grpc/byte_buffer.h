@@ -57,6 +57,23 @@ GRPCAPI grpc_byte_buffer *grpc_raw_byte_buffer_create(gpr_slice *slices,
 GRPCAPI grpc_byte_buffer *grpc_raw_compressed_byte_buffer_create(
     gpr_slice *slices, size_t nslices, grpc_compression_algorithm compression);
 
+/** Returns a RAW byte buffer instance holding the \a length bytes of the file
+ * \a fd starting at \a offset, or NULL if the file range couldn't be mapped
+ * into memory (or file backed buffers are not supported on this platform).
+ *
+ * The buffer holds a single slice from gpr_slice_from_mapped_file(). The
+ * data is not copied: the buffer refers to the file, which must not be
+ * modified while the buffer (or a copy of it, including one that is being
+ * sent) is alive. When sent over a plaintext TCP connection, the data goes
+ * straight from the file to the socket (with sendfile() on Linux). \a fd
+ * itself can be closed as soon as this returns.
+ *
+ * The user is responsible for invoking grpc_byte_buffer_destroy on the
+ * returned instance. */
+GRPCAPI grpc_byte_buffer *grpc_raw_byte_buffer_from_file(int fd,
+                                                         int64_t offset,
+                                                         size_t length);
+
 /** Copies input byte buffer \a bb.
  *
  * Increases the reference count of all the source slices. The user is
@@ -91,6 +108,13 @@ GRPCAPI int grpc_byte_buffer_reader_next(grpc_byte_buffer_reader *reader,
 GRPCAPI gpr_slice
 grpc_byte_buffer_reader_readall(grpc_byte_buffer_reader *reader);
 
+/** Like grpc_byte_buffer_reader_readall, but when there is only one slice left
+ * to read, that slice is returned (with a new reference) instead of a copy.
+ * The result may share its bytes with other slices, so it must not be
+ * modified. */
+GRPCAPI gpr_slice
+grpc_byte_buffer_reader_readall_shared(grpc_byte_buffer_reader *reader);
+
 /** Returns a RAW byte buffer instance from the output of \a reader. */
 GRPCAPI grpc_byte_buffer *grpc_raw_byte_buffer_from_reader(
     grpc_byte_buffer_reader *reader);
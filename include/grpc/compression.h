@@ -39,6 +39,7 @@
 #include <grpc/impl/codegen/port_platform.h>
 
 #include <grpc/impl/codegen/compression_types.h>
+#include <grpc/impl/codegen/grpc_types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -78,6 +79,33 @@ GRPCAPI void grpc_compression_options_disable_algorithm(
 GRPCAPI int grpc_compression_options_is_algorithm_enabled(
     const grpc_compression_options *opts, grpc_compression_algorithm algorithm);
 
+/** Creates a preset dictionary for GRPC_COMPRESS_DICT_DEFLATE out of the \a
+ * length bytes at \a data, which are copied. A good dictionary is made of the
+ * strings that recur most across messages, the most frequent ones last; only
+ * its last 32KiB are used.
+ *
+ * Compressed messages name the dictionary they were compressed against in
+ * their grpc-encoding, and can only be decompressed by peers whose channel or
+ * server is configured with a dictionary of the same contents. Peers advertise
+ * their dictionary in grpc-accept-encoding, and messages to peers not known to
+ * have it are compressed with GRPC_COMPRESS_DEFLATE instead. */
+GRPCAPI grpc_compression_dictionary *grpc_compression_dictionary_create(
+    const void *data, size_t length);
+
+/** Releases the reference returned by \a grpc_compression_dictionary_create.
+ * Channels and servers configured with the dictionary hold their own. */
+GRPCAPI void grpc_compression_dictionary_unref(
+    grpc_compression_dictionary *dictionary);
+
+/** Returns a channel argument (keyed \a GRPC_COMPRESSION_CHANNEL_DICTIONARY)
+ * selecting \a dictionary for the GRPC_COMPRESS_DICT_DEFLATE messages a
+ * channel or server sends and receives. The returned argument holds no
+ * reference of its own, but copies of it (in the channel arguments of the
+ * channels and servers created with it) take and release theirs: \a
+ * dictionary need only stay alive until those are created. */
+GRPCAPI grpc_arg
+grpc_compression_dictionary_to_arg(grpc_compression_dictionary *dictionary);
+
 #ifdef __cplusplus
 }
 #endif
@@ -145,7 +145,8 @@ GRPCAPI void grpc_completion_queue_destroy(grpc_completion_queue *cq);
  * Once the alarm expires (at \a deadline) or it's cancelled (see \a
  * grpc_alarm_cancel), an event with tag \a tag will be added to \a cq. If the
  * alarm expired, the event's success bit will be true, false otherwise (ie,
- * upon cancellation). */
+ * upon cancellation). Alarms have millisecond precision: \a deadline is
+ * rounded up to the next millisecond. */
 GRPCAPI grpc_alarm *grpc_alarm_create(grpc_completion_queue *cq,
                                       gpr_timespec deadline, void *tag);
 
@@ -368,6 +369,17 @@ GRPCAPI void grpc_server_shutdown_and_notify(grpc_server *server,
                                              grpc_completion_queue *cq,
                                              void *tag);
 
+/** Begin shutting down a server, as grpc_server_shutdown_and_notify, but
+    only wait until 'deadline' for the calls in progress to complete: any
+    still running then are cancelled (with status UNAVAILABLE).
+    Connected clients are sent a GOAWAY in two phases (the second after a
+    ping round trip), so that calls they started before learning of the
+    shutdown are still serviced. */
+GRPCAPI void grpc_server_drain_and_notify(grpc_server *server,
+                                          gpr_timespec deadline,
+                                          grpc_completion_queue *cq,
+                                          void *tag);
+
 /** Cancel all in-progress calls.
     Only usable after shutdown. */
 GRPCAPI void grpc_server_cancel_all_calls(grpc_server *server);
@@ -66,6 +66,11 @@ extern "C" {
  * be ignored). */
 #define GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET \
   "grpc.compression_enabled_algorithms_bitset"
+/** Preset dictionary that messages sent with GRPC_COMPRESS_DICT_DEFLATE are
+ * compressed against. Its value is a pointer to a \a
+ * grpc_compression_dictionary: use \a grpc_compression_dictionary_to_arg to
+ * create the argument. */
+#define GRPC_COMPRESSION_CHANNEL_DICTIONARY "grpc.compression_dictionary"
 /** \} */
 
 /* The various compression algorithms supported by gRPC */
@@ -73,10 +78,22 @@ typedef enum {
   GRPC_COMPRESS_NONE = 0,
   GRPC_COMPRESS_DEFLATE,
   GRPC_COMPRESS_GZIP,
+  /* deflate with a single compression context per stream: messages can refer
+     back to data sent earlier on the same stream */
+  GRPC_COMPRESS_STREAM_DEFLATE,
+  /* Zstandard: deflate-class ratios at several times the (de)compression
+     speed */
+  GRPC_COMPRESS_ZSTD,
+  /* deflate against a preset dictionary shared by both peers, for small
+     messages of a known shape */
+  GRPC_COMPRESS_DICT_DEFLATE,
   /* TODO(ctiller): snappy */
   GRPC_COMPRESS_ALGORITHMS_COUNT
 } grpc_compression_algorithm;
 
+/** A preset dictionary for GRPC_COMPRESS_DICT_DEFLATE. */
+typedef struct grpc_compression_dictionary grpc_compression_dictionary;
+
 /** Compression levels allow a party with knowledge of its peer's accepted
  * encodings to request compression in an abstract way. The level-algorithm
  * mapping is performed internally and depends on the peer's supported
@@ -129,8 +129,14 @@ typedef struct {
   size_t capacity;
   /* the combined length of all slices in the array */
   size_t length;
-  /* inlined elements to avoid allocations */
-  gpr_slice inlined[GRPC_SLICE_BUFFER_INLINE_ELEMENTS];
+  /* where the slices live: the inlined elements until the buffer first needs
+     more than those, the allocated array from then on */
+  union {
+    /* inlined elements to avoid allocations */
+    gpr_slice inlined[GRPC_SLICE_BUFFER_INLINE_ELEMENTS];
+    /* the allocated array; 'slices' points into it */
+    gpr_slice *base_slices;
+  } storage;
 } gpr_slice_buffer;
 
 #ifdef __cplusplus
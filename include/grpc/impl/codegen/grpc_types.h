@@ -156,6 +156,35 @@ typedef struct {
 /** Maximum message length that the channel can send. Int valued, bytes.
     -1 means unlimited. */
 #define GRPC_ARG_MAX_SEND_MESSAGE_LENGTH "grpc.max_send_message_length"
+/** Messages of at least this many bytes are compressed on a separate thread
+    rather than on the one sending them, and received compressed messages of at
+    least this many bytes are decompressed on a separate thread rather than on
+    the one reading them: either would otherwise be held up for as long as that
+    takes. Int valued, bytes; -1 means never. Defaults to 64KiB. */
+#define GRPC_ARG_COMPRESSION_OFFLOAD_THRESHOLD \
+  "grpc.compression_offload_threshold"
+/** Maximum time that a server connection may exist, after which the server
+    sends a GOAWAY so that clients reconnect elsewhere. Calls in progress are
+    allowed to finish (see GRPC_ARG_MAX_CONNECTION_AGE_GRACE_MS). The time is
+    randomized by +/-10% to spread reconnections out. Int valued,
+    milliseconds. */
+#define GRPC_ARG_MAX_CONNECTION_AGE_MS "grpc.max_connection_age_ms"
+/** How long calls still in progress after GRPC_ARG_MAX_CONNECTION_AGE_MS are
+    given to finish before the connection is forcibly closed. Unlimited by
+    default. Int valued, milliseconds. */
+#define GRPC_ARG_MAX_CONNECTION_AGE_GRACE_MS "grpc.max_connection_age_grace_ms"
+/** Maximum time that a server connection may have no calls in progress,
+    after which the server sends a GOAWAY and closes it. Int valued,
+    milliseconds. */
+#define GRPC_ARG_MAX_CONNECTION_IDLE_MS "grpc.max_connection_idle_ms"
+/** If non-zero, plaintext connections over unix domain sockets carry their
+    data through shared memory rings instead of the socket. Only the server
+    side is backwards compatible: a client setting this needs a server that
+    sets it too. Int valued, Linux only. */
+#define GRPC_ARG_SHARED_MEMORY "grpc.shared_memory"
+/** Size of the ring used for each direction of a shared memory connection.
+    Int valued, bytes; rounded up to a power of two. */
+#define GRPC_ARG_SHARED_MEMORY_RING_SIZE "grpc.shared_memory_ring_size"
 /** Initial sequence number for http2 transports. Int valued. */
 #define GRPC_ARG_HTTP2_INITIAL_SEQUENCE_NUMBER \
   "grpc.http2.initial_sequence_number"
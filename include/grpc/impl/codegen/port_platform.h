@@ -204,6 +204,7 @@
 #define GPR_HAVE_UNIX_SOCKET 1
 #define GPR_HAVE_IP_PKTINFO 1
 #define GPR_HAVE_IPV6_RECVPKTINFO 1
+#define GPR_LINUX_SENDFILE 1
 #ifdef __GLIBC_PREREQ
 #if __GLIBC_PREREQ(2, 9)
 #define GPR_LINUX_EVENTFD 1
@@ -442,6 +443,17 @@ typedef unsigned __int64 uint64_t;
    power of two */
 #define GPR_MAX_ALIGNMENT 16
 
+/* Whether functions can be compiled for SSSE3 with
+   __attribute__((target("ssse3"))) whatever the -m flags, to be called only
+   once __builtin_cpu_supports("ssse3") says the CPU has the instructions */
+#ifndef GPR_HAS_SSSE3_TARGET
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ > 4 ||                              \
+     (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define GPR_HAS_SSSE3_TARGET 1
+#endif
+#endif /* GPR_HAS_SSSE3_TARGET */
+
 #ifndef GRPC_MUST_USE_RESULT
 #ifdef __GNUC__
 #define GRPC_MUST_USE_RESULT __attribute__((warn_unused_result))
@@ -93,6 +93,30 @@ GPRAPI gpr_slice gpr_slice_from_copied_buffer(const char *source, size_t len);
 /* Create a slice pointing to constant memory */
 GPRAPI gpr_slice gpr_slice_from_static_string(const char *source);
 
+/* How the bytes of a mapped file slice are going to be accessed; a hint for
+   the kernel's paging of the mapping. */
+typedef enum {
+  GPR_SLICE_MAP_ADVICE_NORMAL = 0,
+  GPR_SLICE_MAP_ADVICE_SEQUENTIAL,
+  GPR_SLICE_MAP_ADVICE_RANDOM,
+  /* read the range ahead of time */
+  GPR_SLICE_MAP_ADVICE_WILLNEED
+} gpr_slice_map_advice;
+
+/* Create a slice of the 'length' bytes of the file 'fd' at 'offset', backed by
+   a read-only shared mapping of the file rather than a copy of its bytes: every
+   slice of the same file shares its pages in the page cache. The slice holds
+   its own duplicate of 'fd', and the range is unmapped when the last reference
+   to the slice (or to a slice derived from it) is dropped.
+   The range must lie within the file, and the file must not be modified or
+   truncated while the slice is in use.
+   On success stores the slice in *slice and returns 1. Returns 0, with errno
+   set, if the range couldn't be mapped or files can't be mapped on this
+   platform. */
+GPRAPI int gpr_slice_from_mapped_file(int fd, int64_t offset, size_t length,
+                                      gpr_slice_map_advice advice,
+                                      gpr_slice *slice);
+
 /* Return a result slice derived from s, which shares a ref count with s, where
    result.data==s.data+begin, and result.length==end-begin.
    The ref count of s is increased by one.
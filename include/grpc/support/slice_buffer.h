@@ -74,10 +74,11 @@ GPRAPI void gpr_slice_buffer_move_into(gpr_slice_buffer *src,
 /* remove n bytes from the end of a slice buffer */
 GPRAPI void gpr_slice_buffer_trim_end(gpr_slice_buffer *src, size_t n,
                                       gpr_slice_buffer *garbage);
-/* move the first n bytes of src into dst */
+/* move the first n bytes of src into dst; the slices that remain in src are
+   not moved around */
 GPRAPI void gpr_slice_buffer_move_first(gpr_slice_buffer *src, size_t n,
                                         gpr_slice_buffer *dst);
-/* take the first slice in the slice buffer */
+/* take the first slice in the slice buffer, in constant time */
 GPRAPI gpr_slice gpr_slice_buffer_take_first(gpr_slice_buffer *src);
 
 #ifdef __cplusplus
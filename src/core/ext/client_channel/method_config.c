@@ -39,6 +39,7 @@
 #include <grpc/support/string_util.h>
 #include <grpc/support/time.h>
 
+#include "src/core/lib/support/murmur_hash.h"
 #include "src/core/lib/transport/mdstr_hash_table.h"
 #include "src/core/lib/transport/metadata.h"
 
@@ -225,6 +226,84 @@ static int method_config_cmp(void* valuep1, void* valuep2) {
 static const grpc_mdstr_hash_table_vtable method_config_table_vtable = {
     method_config_unref, method_config_ref, method_config_cmp};
 
+// An entry for a whole service ("/service/*"), indexed by its "/service/"
+// prefix.  The prefix and value are owned by the table's entries.
+typedef struct service_entry {
+  const char* prefix;  // NULL for an empty slot
+  size_t prefix_length;
+  uint32_t hash;
+  void* value;
+} service_entry;
+
+struct grpc_method_config_table {
+  gpr_refcount refs;
+  grpc_mdstr_hash_table* entries;
+  // Open addressed index of the service entries, so that a path without
+  // an entry of its own can be matched to its service without building
+  // and interning the "/service/*" name on every call.
+  service_entry* services;
+  size_t services_mask;
+};
+
+// Returns the length of the "/service/" prefix of \a name.
+static size_t service_prefix_length(const char* name) {
+  const char* sep = strrchr(name, '/');
+  return sep == NULL ? 0 : (size_t)(sep - name) + 1;
+}
+
+static uint32_t service_prefix_hash(const char* prefix, size_t length) {
+  return gpr_murmur_hash3(prefix, length, 0);
+}
+
+static bool is_service_entry(const grpc_mdstr* name) {
+  const size_t length = GRPC_MDSTR_LENGTH(name);
+  const char* str = grpc_mdstr_as_c_string(name);
+  return length >= 2 && str[length - 2] == '/' && str[length - 1] == '*';
+}
+
+static void count_service_entry(const grpc_mdstr_hash_table_entry* entry,
+                                void* user_data) {
+  if (is_service_entry(entry->key)) ++*(size_t*)user_data;
+}
+
+static void index_service_entry(const grpc_mdstr_hash_table_entry* entry,
+                                void* user_data) {
+  grpc_method_config_table* table = user_data;
+  if (!is_service_entry(entry->key)) return;
+  const char* prefix = grpc_mdstr_as_c_string(entry->key);
+  const size_t prefix_length = GRPC_MDSTR_LENGTH(entry->key) - 1;
+  const uint32_t hash = service_prefix_hash(prefix, prefix_length);
+  size_t idx = hash & table->services_mask;
+  while (table->services[idx].prefix != NULL) {
+    idx = (idx + 1) & table->services_mask;
+  }
+  table->services[idx].prefix = prefix;
+  table->services[idx].prefix_length = prefix_length;
+  table->services[idx].hash = hash;
+  table->services[idx].value = entry->value;
+}
+
+// Takes ownership of \a entries.
+static grpc_method_config_table* method_config_table_create(
+    grpc_mdstr_hash_table* entries) {
+  grpc_method_config_table* table = gpr_malloc(sizeof(*table));
+  gpr_ref_init(&table->refs, 1);
+  table->entries = entries;
+  table->services = NULL;
+  table->services_mask = 0;
+  size_t num_services = 0;
+  grpc_mdstr_hash_table_iterate(entries, count_service_entry, &num_services);
+  if (num_services > 0) {
+    size_t size = 1;
+    while (size < num_services * 2) size <<= 1;
+    table->services = gpr_malloc(sizeof(*table->services) * size);
+    memset(table->services, 0, sizeof(*table->services) * size);
+    table->services_mask = size - 1;
+    grpc_mdstr_hash_table_iterate(entries, index_service_entry, table);
+  }
+  return table;
+}
+
 grpc_method_config_table* grpc_method_config_table_create(
     size_t num_entries, grpc_method_config_table_entry* entries) {
   grpc_mdstr_hash_table_entry* hash_table_entries =
@@ -234,45 +313,50 @@ grpc_method_config_table* grpc_method_config_table_create(
     hash_table_entries[i].value = entries[i].method_config;
     hash_table_entries[i].vtable = &method_config_table_vtable;
   }
-  grpc_method_config_table* method_config_table =
-      grpc_mdstr_hash_table_create(num_entries, hash_table_entries);
+  grpc_method_config_table* method_config_table = method_config_table_create(
+      grpc_mdstr_hash_table_create(num_entries, hash_table_entries));
   gpr_free(hash_table_entries);
   return method_config_table;
 }
 
 grpc_method_config_table* grpc_method_config_table_ref(
     grpc_method_config_table* table) {
-  return grpc_mdstr_hash_table_ref(table);
+  if (table != NULL) gpr_ref(&table->refs);
+  return table;
 }
 
 void grpc_method_config_table_unref(grpc_method_config_table* table) {
-  grpc_mdstr_hash_table_unref(table);
+  if (table != NULL && gpr_unref(&table->refs)) {
+    grpc_mdstr_hash_table_unref(table->entries);
+    gpr_free(table->services);
+    gpr_free(table);
+  }
 }
 
 int grpc_method_config_table_cmp(const grpc_method_config_table* table1,
                                  const grpc_method_config_table* table2) {
-  return grpc_mdstr_hash_table_cmp(table1, table2);
+  return grpc_mdstr_hash_table_cmp(table1->entries, table2->entries);
 }
 
-void* grpc_method_config_table_get(const grpc_mdstr_hash_table* table,
+void* grpc_method_config_table_get(const grpc_method_config_table* table,
                                    const grpc_mdstr* path) {
-  void* value = grpc_mdstr_hash_table_get(table, path);
-  // If we didn't find a match for the path, try looking for a wildcard
-  // entry (i.e., change "/service/method" to "/service/*").
-  if (value == NULL) {
-    const char* path_str = grpc_mdstr_as_c_string(path);
-    const char* sep = strrchr(path_str, '/') + 1;
-    const size_t len = (size_t)(sep - path_str);
-    char* buf = gpr_malloc(len + 2);  // '*' and NUL
-    memcpy(buf, path_str, len);
-    buf[len] = '*';
-    buf[len + 1] = '\0';
-    grpc_mdstr* wildcard_path = grpc_mdstr_from_string(buf);
-    gpr_free(buf);
-    value = grpc_mdstr_hash_table_get(table, wildcard_path);
-    GRPC_MDSTR_UNREF(wildcard_path);
+  void* value = grpc_mdstr_hash_table_get(table->entries, path);
+  if (value != NULL || table->services == NULL) return value;
+  // If we didn't find a match for the path, look for a wildcard entry
+  // (i.e., one for "/service/*" when the path is "/service/method").
+  const char* path_str = grpc_mdstr_as_c_string(path);
+  const size_t prefix_length = service_prefix_length(path_str);
+  const uint32_t hash = service_prefix_hash(path_str, prefix_length);
+  for (size_t idx = hash & table->services_mask;
+       table->services[idx].prefix != NULL;
+       idx = (idx + 1) & table->services_mask) {
+    const service_entry* entry = &table->services[idx];
+    if (entry->hash == hash && entry->prefix_length == prefix_length &&
+        memcmp(entry->prefix, path_str, prefix_length) == 0) {
+      return entry->value;
+    }
   }
-  return value;
+  return NULL;
 }
 
 static void* copy_arg(void* p) { return grpc_method_config_table_ref(p); }
@@ -314,7 +398,7 @@ static void convert_entry(const grpc_mdstr_hash_table_entry* entry,
   ++state->num_entries;
 }
 
-grpc_mdstr_hash_table* grpc_method_config_table_convert(
+grpc_method_config_table* grpc_method_config_table_convert(
     const grpc_method_config_table* table,
     void* (*convert_value)(const grpc_method_config* method_config),
     const grpc_mdstr_hash_table_vtable* vtable) {
@@ -324,11 +408,11 @@ grpc_mdstr_hash_table* grpc_method_config_table_convert(
   state.vtable = vtable;
   state.num_entries = 0;
   state.entries = gpr_malloc(sizeof(grpc_mdstr_hash_table_entry) *
-                             grpc_mdstr_hash_table_num_entries(table));
-  grpc_mdstr_hash_table_iterate(table, convert_entry, &state);
+                             grpc_mdstr_hash_table_num_entries(table->entries));
+  grpc_mdstr_hash_table_iterate(table->entries, convert_entry, &state);
   // Create a new table based on the array we just constructed.
-  grpc_mdstr_hash_table* new_table =
-      grpc_mdstr_hash_table_create(state.num_entries, state.entries);
+  grpc_method_config_table* new_table = method_config_table_create(
+      grpc_mdstr_hash_table_create(state.num_entries, state.entries));
   // Clean up the array.
   for (size_t i = 0; i < state.num_entries; ++i) {
     GRPC_MDSTR_UNREF(state.entries[i].key);
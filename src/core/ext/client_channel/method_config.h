@@ -79,7 +79,9 @@ const int32_t* grpc_method_config_get_max_response_message_bytes(
     const grpc_method_config* method_config);
 
 /// A table of method configs.
-typedef grpc_mdstr_hash_table grpc_method_config_table;
+/// Lookups take a single probe for paths with a config of their own, and
+/// one more for paths that fall back to the config of their service.
+typedef struct grpc_method_config_table grpc_method_config_table;
 
 typedef struct grpc_method_config_table_entry {
   /// The name is of one of the following forms:
@@ -110,7 +112,7 @@ int grpc_method_config_table_cmp(const grpc_method_config_table* table1,
 /// Note: This returns a void* instead of a grpc_method_config* so that
 /// it can also be used for tables constructed via
 /// grpc_method_config_table_convert().
-void* grpc_method_config_table_get(const grpc_mdstr_hash_table* table,
+void* grpc_method_config_table_get(const grpc_method_config_table* table,
                                    const grpc_mdstr* path);
 
 /// Returns a channel arg containing \a table.
@@ -128,7 +130,7 @@ grpc_arg grpc_method_config_table_create_channel_arg(
 /// will return a new instance of the struct containing the values from
 /// the grpc_method_config, and \a vtable provides the methods for
 /// operating on the struct type.
-grpc_mdstr_hash_table* grpc_method_config_table_convert(
+grpc_method_config_table* grpc_method_config_table_convert(
     const grpc_method_config_table* table,
     void* (*convert_value)(const grpc_method_config* method_config),
     const grpc_mdstr_hash_table_vtable* vtable);
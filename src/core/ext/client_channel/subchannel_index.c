@@ -49,9 +49,14 @@ static gpr_avl g_subchannel_index;
 
 static gpr_mu g_mu;
 
+// keys are immutable once created, so copies of them (including those the avl
+// makes when rebalancing) just share a ref
 struct grpc_subchannel_key {
+  gpr_refcount refs;
   grpc_connector *connector;
   grpc_subchannel_args args;
+  // args.args points into this: interned args compare equal by pointer
+  grpc_interned_channel_args *interned_args;
 };
 
 GPR_TLS_DECL(subchannel_index_exec_ctx);
@@ -72,10 +77,10 @@ static grpc_exec_ctx *current_ctx() {
   return c;
 }
 
-static grpc_subchannel_key *create_key(
-    grpc_connector *connector, grpc_subchannel_args *args,
-    grpc_channel_args *(*copy_channel_args)(const grpc_channel_args *args)) {
+grpc_subchannel_key *grpc_subchannel_key_create(grpc_connector *connector,
+                                                grpc_subchannel_args *args) {
   grpc_subchannel_key *k = gpr_malloc(sizeof(*k));
+  gpr_ref_init(&k->refs, 1);
   k->connector = grpc_connector_ref(connector);
   k->args.filter_count = args->filter_count;
   if (k->args.filter_count > 0) {
@@ -92,17 +97,14 @@ static grpc_subchannel_key *create_key(
   if (k->args.addr_len > 0) {
     memcpy(k->args.addr, args->addr, k->args.addr_len);
   }
-  k->args.args = copy_channel_args(args->args);
+  k->interned_args = grpc_channel_args_intern(args->args);
+  k->args.args = grpc_interned_channel_args_get(k->interned_args);
   return k;
 }
 
-grpc_subchannel_key *grpc_subchannel_key_create(grpc_connector *connector,
-                                                grpc_subchannel_args *args) {
-  return create_key(connector, args, grpc_channel_args_normalize);
-}
-
 static grpc_subchannel_key *subchannel_key_copy(grpc_subchannel_key *k) {
-  return create_key(k->connector, &k->args, grpc_channel_args_copy);
+  gpr_ref(&k->refs);
+  return k;
 }
 
 static int subchannel_key_compare(grpc_subchannel_key *a,
@@ -124,14 +126,15 @@ static int subchannel_key_compare(grpc_subchannel_key *a,
                a->args.filter_count * sizeof(*a->args.filters));
     if (c != 0) return c;
   }
-  return grpc_channel_args_compare(a->args.args, b->args.args);
+  return GPR_ICMP(a->interned_args, b->interned_args);
 }
 
 void grpc_subchannel_key_destroy(grpc_exec_ctx *exec_ctx,
                                  grpc_subchannel_key *k) {
+  if (!gpr_unref(&k->refs)) return;
   grpc_connector_unref(exec_ctx, k->connector);
   gpr_free((grpc_channel_args *)k->args.filters);
-  grpc_channel_args_destroy((grpc_channel_args *)k->args.args);
+  grpc_interned_channel_args_unref(k->interned_args);
   gpr_free((void *)k->args.server_name);
   gpr_free(k->args.addr);
   gpr_free(k);
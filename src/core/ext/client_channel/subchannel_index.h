@@ -46,7 +46,7 @@ typedef struct grpc_subchannel_key grpc_subchannel_key;
 grpc_subchannel_key *grpc_subchannel_key_create(grpc_connector *con,
                                                 grpc_subchannel_args *args);
 
-/** Destroy a subchannel key */
+/** Release a ref to a subchannel key (the index holds its own) */
 void grpc_subchannel_key_destroy(grpc_exec_ctx *exec_ctx,
                                  grpc_subchannel_key *key);
 
@@ -47,6 +47,7 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/compress_filter.h"
 #include "src/core/lib/channel/handshaker.h"
+#include "src/core/lib/channel/shm_handshaker.h"
 #include "src/core/lib/channel/http_client_filter.h"
 #include "src/core/lib/iomgr/tcp_client.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -190,6 +191,8 @@ static grpc_subchannel *client_channel_factory_create_subchannel(
   c->base.vtable = &connector_vtable;
   gpr_ref_init(&c->refs, 1);
   c->handshake_mgr = grpc_handshake_manager_create();
+  grpc_handshake_manager_add(c->handshake_mgr,
+                             grpc_shm_handshaker_create(true /* is_client */));
   char *proxy_name = grpc_get_http_proxy_server();
   if (proxy_name != NULL) {
     grpc_handshake_manager_add(
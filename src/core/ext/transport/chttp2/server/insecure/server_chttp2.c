@@ -42,6 +42,7 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/handshaker.h"
 #include "src/core/lib/channel/http_server_filter.h"
+#include "src/core/lib/channel/shm_handshaker.h"
 #include "src/core/lib/iomgr/resolve_address.h"
 #include "src/core/lib/iomgr/tcp_server.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -93,6 +94,8 @@ static void on_accept(grpc_exec_ctx *exec_ctx, void *server, grpc_endpoint *tcp,
   state->accepting_pollset = accepting_pollset;
   state->acceptor = acceptor;
   state->handshake_mgr = grpc_handshake_manager_create();
+  grpc_handshake_manager_add(state->handshake_mgr,
+                             grpc_shm_handshaker_create(false /* is_client */));
   // TODO(roth): We should really get this timeout value from channel
   // args instead of hard-coding it.
   const gpr_timespec deadline = gpr_time_add(
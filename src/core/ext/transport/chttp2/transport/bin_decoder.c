@@ -36,6 +36,10 @@
 #include <grpc/support/log.h>
 #include "src/core/lib/support/string.h"
 
+#ifdef GPR_HAS_SSSE3_TARGET
+#include <tmmintrin.h>
+#endif
+
 static uint8_t decode_table[] = {
     0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
     0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
@@ -88,6 +92,56 @@ static bool input_is_valid(uint8_t *input_ptr, size_t length) {
 #define COMPOSE_OUTPUT_BYTE_2(input_ptr) \
   (uint8_t)((decode_table[input_ptr[2]] << 6) | decode_table[input_ptr[3]])
 
+#ifdef GPR_HAS_SSSE3_TARGET
+/* Decode blocks of 16 characters into 12 bytes while there is room to store
+   16 bytes of output. Stops at the first block holding anything other than
+   the 64 alphabet characters (pad chars included), leaving it for the scalar
+   code to decode or to reject. */
+__attribute__((target("ssse3"))) static void decode_blocks_ssse3(
+    struct grpc_base64_decode_context *ctx) {
+  /* each character is classified by a bit set both in the entry for its low
+     nibble and in the entry for its high nibble only if it is invalid */
+  const __m128i valid_lo =
+      _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                    0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+  const __m128i valid_hi =
+      _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+                    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  /* offset from character to value, by high nibble ('/' gets its own) */
+  const __m128i offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0,
+                                        0, 0, 0, 0, 0, 0, 0);
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  const __m128i slash = _mm_set1_epi8('/');
+
+  while (ctx->input_end >= ctx->input_cur + 16 &&
+         ctx->output_end >= ctx->output_cur + 16) {
+    __m128i in = _mm_loadu_si128((const __m128i *)ctx->input_cur);
+    __m128i hi = _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+    __m128i lo = _mm_and_si128(in, nibble);
+    __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(valid_lo, lo),
+                                    _mm_shuffle_epi8(valid_hi, hi));
+    __m128i values;
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) !=
+        0) {
+      return;
+    }
+    values = _mm_add_epi8(
+        in, _mm_shuffle_epi8(offsets,
+                             _mm_add_epi8(_mm_cmpeq_epi8(in, slash), hi)));
+    /* merge pairs of six bit values into twelve bits, then pairs of those
+       into the 24 bits of each group, and pack the groups together */
+    values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+    values = _mm_shuffle_epi8(values, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                    14, 13, 12, -1, -1, -1,
+                                                    -1));
+    _mm_storeu_si128((__m128i *)ctx->output_cur, values);
+    ctx->input_cur += 16;
+    ctx->output_cur += 12;
+  }
+}
+#endif
+
 bool grpc_base64_decode_partial(struct grpc_base64_decode_context *ctx) {
   size_t input_tail;
 
@@ -95,13 +149,25 @@ bool grpc_base64_decode_partial(struct grpc_base64_decode_context *ctx) {
     return false;
   }
 
+#ifdef GPR_HAS_SSSE3_TARGET
+  if (__builtin_cpu_supports("ssse3")) {
+    decode_blocks_ssse3(ctx);
+  }
+#endif
+
   // Process a block of 4 input characters and 3 output bytes
   while (ctx->input_end >= ctx->input_cur + 4 &&
          ctx->output_end >= ctx->output_cur + 3) {
-    if (!input_is_valid(ctx->input_cur, 4)) return false;
-    ctx->output_cur[0] = COMPOSE_OUTPUT_BYTE_0(ctx->input_cur);
-    ctx->output_cur[1] = COMPOSE_OUTPUT_BYTE_1(ctx->input_cur);
-    ctx->output_cur[2] = COMPOSE_OUTPUT_BYTE_2(ctx->input_cur);
+    uint8_t a = decode_table[ctx->input_cur[0]];
+    uint8_t b = decode_table[ctx->input_cur[1]];
+    uint8_t c = decode_table[ctx->input_cur[2]];
+    uint8_t d = decode_table[ctx->input_cur[3]];
+    if (((a | b | c | d) & 0xC0) != 0 && !input_is_valid(ctx->input_cur, 4)) {
+      return false;
+    }
+    ctx->output_cur[0] = (uint8_t)((a << 2) | (b >> 4));
+    ctx->output_cur[1] = (uint8_t)((b << 4) | (c >> 2));
+    ctx->output_cur[2] = (uint8_t)((c << 6) | d);
     ctx->output_cur += 3;
     ctx->input_cur += 4;
   }
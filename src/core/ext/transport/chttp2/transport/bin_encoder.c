@@ -38,6 +38,10 @@
 #include <grpc/support/log.h>
 #include "src/core/ext/transport/chttp2/transport/huffsyms.h"
 
+#ifdef GPR_HAS_SSSE3_TARGET
+#include <tmmintrin.h>
+#endif
+
 static const char alphabet[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
@@ -61,6 +65,61 @@ static const b64_huff_sym huff_alphabet[64] = {
 
 static const uint8_t tail_xtra[3] = {0, 2, 3};
 
+#ifdef GPR_HAS_SSSE3_TARGET
+static int have_ssse3(void) { return __builtin_cpu_supports("ssse3"); }
+
+/* number of 12 byte blocks the SSSE3 code can take from an input of 'length'
+   bytes: each block is read with a 16 byte load */
+static size_t ssse3_blocks(size_t length) {
+  return length < 16 ? 0 : (length - 4) / 12;
+}
+
+/* split the 12 bytes at 'in' into 16 six bit base64 indices, one per byte */
+__attribute__((target("ssse3"))) static __m128i b64_indices(const uint8_t *in) {
+  __m128i v = _mm_loadu_si128((const __m128i *)in);
+  __m128i hi;
+  __m128i lo;
+  /* gather the 3 bytes of each group into a 32 bit lane, as b1 b0 b2 b1 */
+  v = _mm_shuffle_epi8(
+      v, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  /* then shift each of the four indices into its own byte */
+  hi = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)),
+                       _mm_set1_epi32(0x04000040));
+  lo = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)),
+                       _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(hi, lo);
+}
+
+__attribute__((target("ssse3"))) static void base64_encode_ssse3(
+    const uint8_t *in, size_t blocks, char *out) {
+  /* offset from index to character for each of the alphabet's ranges,
+     selected by the range number computed below */
+  const __m128i offsets =
+      _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  size_t i;
+  for (i = 0; i < blocks; i++) {
+    __m128i indices = b64_indices(in);
+    /* 0 for a-z, 1 to 12 for 0-9 + /, 13 for A-Z */
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    range = _mm_or_si128(
+        range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices),
+                             _mm_set1_epi8(13)));
+    _mm_storeu_si128(
+        (__m128i *)out,
+        _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range)));
+    in += 12;
+    out += 16;
+  }
+}
+
+__attribute__((target("ssse3"))) static void base64_indices_ssse3(
+    const uint8_t *in, uint8_t *indices) {
+  _mm_storeu_si128((__m128i *)indices, b64_indices(in));
+}
+#endif
+
 gpr_slice grpc_chttp2_base64_encode(gpr_slice input) {
   size_t input_length = GPR_SLICE_LENGTH(input);
   size_t input_triplets = input_length / 3;
@@ -69,10 +128,20 @@ gpr_slice grpc_chttp2_base64_encode(gpr_slice input) {
   gpr_slice output = gpr_slice_malloc(output_length);
   uint8_t *in = GPR_SLICE_START_PTR(input);
   char *out = (char *)GPR_SLICE_START_PTR(output);
-  size_t i;
+  size_t i = 0;
+
+#ifdef GPR_HAS_SSSE3_TARGET
+  if (have_ssse3()) {
+    size_t blocks = ssse3_blocks(input_length);
+    base64_encode_ssse3(in, blocks, out);
+    in += 12 * blocks;
+    out += 16 * blocks;
+    i = 4 * blocks;
+  }
+#endif
 
   /* encode full triplets */
-  for (i = 0; i < input_triplets; i++) {
+  for (; i < input_triplets; i++) {
     out[0] = alphabet[in[0] >> 2];
     out[1] = alphabet[((in[0] & 0x3) << 4) | (in[1] >> 4)];
     out[2] = alphabet[((in[1] & 0xf) << 2) | (in[2] >> 6)];
@@ -146,16 +215,25 @@ gpr_slice grpc_chttp2_huffman_compress(gpr_slice input) {
   return output;
 }
 
+/* Pending bits are kept in a 64 bit word and written out four bytes at a time
+   once there are at least 32 of them, which leaves room for the up to 22 bits
+   of the next pair of symbols. */
 typedef struct {
-  uint32_t temp;
+  uint64_t temp;
   uint32_t temp_length;
   uint8_t *out;
 } huff_out;
 
 static void enc_flush_some(huff_out *out) {
-  while (out->temp_length > 8) {
-    out->temp_length -= 8;
-    *out->out++ = (uint8_t)(out->temp >> out->temp_length);
+  if (out->temp_length >= 32) {
+    uint32_t rest = out->temp_length - 32;
+    uint32_t word = (uint32_t)(out->temp >> rest);
+    out->out[0] = (uint8_t)(word >> 24);
+    out->out[1] = (uint8_t)(word >> 16);
+    out->out[2] = (uint8_t)(word >> 8);
+    out->out[3] = (uint8_t)word;
+    out->out += 4;
+    out->temp_length = rest;
   }
 }
 
@@ -163,7 +241,7 @@ static void enc_add2(huff_out *out, uint8_t a, uint8_t b) {
   b64_huff_sym sa = huff_alphabet[a];
   b64_huff_sym sb = huff_alphabet[b];
   out->temp = (out->temp << (sa.length + sb.length)) |
-              ((uint32_t)sa.bits << sb.length) | sb.bits;
+              ((uint64_t)sa.bits << sb.length) | sb.bits;
   out->temp_length += (uint32_t)sa.length + (uint32_t)sb.length;
   enc_flush_some(out);
 }
@@ -186,14 +264,35 @@ gpr_slice grpc_chttp2_base64_encode_and_huffman_compress_impl(gpr_slice input) {
   uint8_t *in = GPR_SLICE_START_PTR(input);
   uint8_t *start_out = GPR_SLICE_START_PTR(output);
   huff_out out;
-  size_t i;
+  size_t i = 0;
 
   out.temp = 0;
   out.temp_length = 0;
   out.out = start_out;
 
+#ifdef GPR_HAS_SSSE3_TARGET
+  if (have_ssse3()) {
+    size_t blocks = ssse3_blocks(input_length);
+    uint8_t indices[16];
+    size_t j;
+    for (j = 0; j < blocks; j++) {
+      base64_indices_ssse3(in, indices);
+      enc_add2(&out, indices[0], indices[1]);
+      enc_add2(&out, indices[2], indices[3]);
+      enc_add2(&out, indices[4], indices[5]);
+      enc_add2(&out, indices[6], indices[7]);
+      enc_add2(&out, indices[8], indices[9]);
+      enc_add2(&out, indices[10], indices[11]);
+      enc_add2(&out, indices[12], indices[13]);
+      enc_add2(&out, indices[14], indices[15]);
+      in += 12;
+    }
+    i = 4 * blocks;
+  }
+#endif
+
   /* encode full triplets */
-  for (i = 0; i < input_triplets; i++) {
+  for (; i < input_triplets; i++) {
     const uint8_t low_to_high = (uint8_t)((in[0] & 0x3) << 4);
     const uint8_t high_to_low = in[1] >> 4;
     enc_add2(&out, in[0] >> 2, low_to_high | high_to_low);
@@ -222,6 +321,10 @@ gpr_slice grpc_chttp2_base64_encode_and_huffman_compress_impl(gpr_slice input) {
     }
   }
 
+  while (out.temp_length >= 8) {
+    out.temp_length -= 8;
+    *out.out++ = (uint8_t)(out.temp >> out.temp_length);
+  }
   if (out.temp_length) {
     /* NB: the following integer arithmetic operation needs to be in its
      * expanded form due to the "integral promotion" performed (see section
@@ -118,6 +118,8 @@ static void close_transport_locked(grpc_exec_ctx *exec_ctx,
                                    grpc_chttp2_transport *t, grpc_error *error);
 static void end_all_the_calls(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
                               grpc_error *error);
+static void send_final_goaway_locked(grpc_exec_ctx *exec_ctx, void *arg,
+                                     grpc_error *error_ignored);
 
 /*******************************************************************************
  * CONSTRUCTION/DESTRUCTION/REFCOUNTING
@@ -137,6 +139,9 @@ static void destruct_transport(grpc_exec_ctx *exec_ctx,
   gpr_slice_buffer_destroy(&t->read_buffer);
   grpc_chttp2_hpack_parser_destroy(&t->hpack_parser);
   grpc_chttp2_goaway_parser_destroy(&t->goaway_parser);
+  if (t->awaiting_final_goaway) {
+    gpr_slice_unref(t->final_goaway_message);
+  }
 
   for (i = 0; i < STREAM_LIST_COUNT; i++) {
     GPR_ASSERT(t->lists[i].head == NULL);
@@ -243,6 +248,7 @@ static void init_transport(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
   grpc_closure_init(&t->read_action_locked, read_action_locked, t);
 
   grpc_chttp2_goaway_parser_init(&t->goaway_parser);
+  grpc_closure_init(&t->send_final_goaway_locked, send_final_goaway_locked, t);
   grpc_chttp2_hpack_parser_init(&t->hpack_parser);
 
   gpr_slice_buffer_init(&t->read_buffer);
@@ -1169,6 +1175,14 @@ static void send_ping_locked(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
 void grpc_chttp2_ack_ping(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
                           const uint8_t *opaque_8bytes) {
   grpc_chttp2_outstanding_ping *ping;
+  if (t->awaiting_final_goaway &&
+      0 == memcmp(opaque_8bytes, t->final_goaway_ping_id, 8)) {
+    /* the client has seen the advisory goaway: finish after parsing */
+    GRPC_CHTTP2_REF_TRANSPORT(t, "final_goaway");
+    grpc_combiner_execute(exec_ctx, t->combiner, &t->send_final_goaway_locked,
+                          GRPC_ERROR_NONE, false);
+    return;
+  }
   for (ping = t->pings.next; ping != &t->pings; ping = ping->next) {
     if (0 == memcmp(opaque_8bytes, ping->id, 8)) {
       grpc_exec_ctx_sched(exec_ctx, ping->on_recv, GRPC_ERROR_NONE, NULL);
@@ -1185,6 +1199,54 @@ void grpc_chttp2_ack_ping(grpc_exec_ctx *exec_ctx, grpc_chttp2_transport *t,
   gpr_free(msg);
 }
 
+static void send_goaway_locked(grpc_exec_ctx *exec_ctx,
+                               grpc_chttp2_transport *t,
+                               grpc_status_code status, gpr_slice message) {
+  t->sent_goaway = 1;
+  grpc_chttp2_goaway_append(
+      t->last_new_stream_id,
+      (uint32_t)grpc_chttp2_grpc_status_to_http2_error(status), message,
+      &t->qbuf);
+  grpc_chttp2_initiate_write(exec_ctx, t, false, "goaway_sent");
+}
+
+static void send_advisory_goaway_locked(grpc_exec_ctx *exec_ctx,
+                                        grpc_chttp2_transport *t,
+                                        gpr_slice message) {
+  t->awaiting_final_goaway = 1;
+  t->final_goaway_status = GRPC_STATUS_OK;
+  t->final_goaway_message = gpr_slice_ref(message);
+  /* the largest possible stream id: any stream may still be started */
+  grpc_chttp2_goaway_append((1u << 31) - 1, GRPC_CHTTP2_NO_ERROR, message,
+                            &t->qbuf);
+  for (size_t i = 0; i < 8; i++) {
+    t->final_goaway_ping_id[i] =
+        (uint8_t)((t->ping_counter >> (56 - 8 * i)) & 0xff);
+  }
+  t->ping_counter++;
+  gpr_slice_buffer_add(&t->qbuf,
+                       grpc_chttp2_ping_create(0, t->final_goaway_ping_id));
+  grpc_chttp2_initiate_write(exec_ctx, t, true, "advisory_goaway_sent");
+}
+
+static void send_final_goaway_locked(grpc_exec_ctx *exec_ctx, void *arg,
+                                     grpc_error *error_ignored) {
+  grpc_chttp2_transport *t = arg;
+  if (t->awaiting_final_goaway) {
+    t->awaiting_final_goaway = 0;
+    if (!t->closed) {
+      send_goaway_locked(exec_ctx, t, t->final_goaway_status,
+                         t->final_goaway_message);
+      if (grpc_chttp2_stream_map_size(&t->stream_map) == 0) {
+        close_transport_locked(exec_ctx, t, GRPC_ERROR_CREATE("GOAWAY sent"));
+      }
+    } else {
+      gpr_slice_unref(t->final_goaway_message);
+    }
+  }
+  GRPC_CHTTP2_UNREF_TRANSPORT(exec_ctx, t, "final_goaway");
+}
+
 static void perform_transport_op_locked(grpc_exec_ctx *exec_ctx,
                                         void *stream_op,
                                         grpc_error *error_ignored) {
@@ -1199,15 +1261,31 @@ static void perform_transport_op_locked(grpc_exec_ctx *exec_ctx,
   }
 
   if (op->send_goaway) {
-    t->sent_goaway = 1;
-    grpc_chttp2_goaway_append(
-        t->last_new_stream_id,
-        (uint32_t)grpc_chttp2_grpc_status_to_http2_error(op->goaway_status),
-        gpr_slice_ref(*op->goaway_message), &t->qbuf);
-    close_transport = grpc_chttp2_stream_map_size(&t->stream_map) == 0
-                          ? GRPC_ERROR_CREATE("GOAWAY sent")
-                          : GRPC_ERROR_NONE;
-    grpc_chttp2_initiate_write(exec_ctx, t, false, "goaway_sent");
+    if (!t->is_client && !t->sent_goaway && !t->awaiting_final_goaway &&
+        op->graceful_goaway && op->goaway_status == GRPC_STATUS_OK) {
+      /* graceful: the final goaway follows a ping round trip */
+      send_advisory_goaway_locked(exec_ctx, t,
+                                  gpr_slice_ref(*op->goaway_message));
+    } else if (!t->awaiting_final_goaway) {
+      /* (a second goaway with status OK would say nothing new) */
+      if (!t->sent_goaway || op->goaway_status != GRPC_STATUS_OK) {
+        send_goaway_locked(exec_ctx, t, op->goaway_status,
+                           gpr_slice_ref(*op->goaway_message));
+      }
+      close_transport = grpc_chttp2_stream_map_size(&t->stream_map) == 0
+                            ? GRPC_ERROR_CREATE("GOAWAY sent")
+                            : GRPC_ERROR_NONE;
+    } else if (op->goaway_status != GRPC_STATUS_OK || !op->graceful_goaway) {
+      /* an abortive goaway overrides a pending graceful one, and one that
+         can't wait for the ack has the final goaway sent now */
+      gpr_slice_unref(t->final_goaway_message);
+      t->final_goaway_status = op->goaway_status;
+      t->final_goaway_message = gpr_slice_ref(*op->goaway_message);
+      if (!op->graceful_goaway) {
+        GRPC_CHTTP2_REF_TRANSPORT(t, "final_goaway");
+        send_final_goaway_locked(exec_ctx, t, GRPC_ERROR_NONE);
+      }
+    }
   }
 
   if (op->set_accept_stream) {
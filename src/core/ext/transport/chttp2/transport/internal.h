@@ -250,6 +250,20 @@ struct grpc_chttp2_transport {
   uint8_t seen_goaway;
   /** have we sent a goaway */
   uint8_t sent_goaway;
+  /** graceful server goaways go out in two phases: first an advisory
+      goaway that does not limit the streams the client may start, followed
+      by a ping, and then (once the ping is acked, so that the client has seen
+      the first goaway) the final goaway, sent with the last stream id
+      actually received. Streams the client started before it saw the goaway
+      are thus not lost. Set between the two phases. */
+  uint8_t awaiting_final_goaway;
+  /** payload of the ping sent after the advisory goaway */
+  uint8_t final_goaway_ping_id[8];
+  /** status and message for the final goaway */
+  grpc_status_code final_goaway_status;
+  gpr_slice final_goaway_message;
+  /** sends the final goaway once the ping has been acked */
+  grpc_closure send_final_goaway_locked;
 
   /** are the local settings dirty and need to be sent? */
   uint8_t dirtied_local_settings;
@@ -33,12 +33,15 @@
 
 #include "src/core/lib/channel/channel_args.h"
 #include <grpc/grpc.h>
+#include "src/core/lib/support/murmur_hash.h"
 #include "src/core/lib/support/string.h"
 
 #include <grpc/compression.h>
 #include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
+#include <grpc/support/sync.h>
 #include <grpc/support/useful.h>
 
 #include <string.h>
@@ -128,21 +131,30 @@ static int cmp_key_stable(const void *ap, const void *bp) {
   return c;
 }
 
-grpc_channel_args *grpc_channel_args_normalize(const grpc_channel_args *a) {
+/* returns pointers to the args of \a a, stably sorted by key */
+static grpc_arg **sort_args(const grpc_channel_args *a) {
   grpc_arg **args = gpr_malloc(sizeof(grpc_arg *) * a->num_args);
   for (size_t i = 0; i < a->num_args; i++) {
     args[i] = &a->args[i];
   }
   if (a->num_args > 1)
     qsort(args, a->num_args, sizeof(grpc_arg *), cmp_key_stable);
+  return args;
+}
 
+static grpc_channel_args *copy_sorted_args(grpc_arg **args, size_t num_args) {
   grpc_channel_args *b = gpr_malloc(sizeof(grpc_channel_args));
-  b->num_args = a->num_args;
+  b->num_args = num_args;
   b->args = gpr_malloc(sizeof(grpc_arg) * b->num_args);
-  for (size_t i = 0; i < a->num_args; i++) {
+  for (size_t i = 0; i < num_args; i++) {
     b->args[i] = copy_arg(args[i]);
   }
+  return b;
+}
 
+grpc_channel_args *grpc_channel_args_normalize(const grpc_channel_args *a) {
+  grpc_arg **args = sort_args(a);
+  grpc_channel_args *b = copy_sorted_args(args, a->num_args);
   gpr_free(args);
   return b;
 }
@@ -284,6 +296,163 @@ const grpc_arg *grpc_channel_args_find(const grpc_channel_args *args,
   return NULL;
 }
 
+/* Interned channel args live in a global hash table, keyed by their contents.
+ * The table does not hold a ref: the last unref removes an entry, and an entry
+ * whose refcount has already dropped to zero is ignored by lookups. */
+
+struct grpc_interned_channel_args {
+  gpr_atm refs;
+  uint32_t hash;
+  grpc_channel_args *args;
+  /* next entry in the same bucket of the intern table */
+  struct grpc_interned_channel_args *bucket_next;
+};
+
+static gpr_once g_intern_once = GPR_ONCE_INIT;
+static gpr_mu g_intern_mu;
+static grpc_interned_channel_args **g_intern_buckets;
+static size_t g_intern_capacity; /* a power of two, or 0 */
+static size_t g_intern_count;
+
+static void intern_init(void) { gpr_mu_init(&g_intern_mu); }
+
+/* must agree with cmp_arg: args that compare equal hash the same */
+static uint32_t hash_arg(const grpc_arg *arg, uint32_t seed) {
+  uint32_t h = gpr_murmur_hash3(arg->key, strlen(arg->key), seed);
+  h = gpr_murmur_hash3(&arg->type, sizeof(arg->type), h);
+  switch (arg->type) {
+    case GRPC_ARG_STRING:
+      return gpr_murmur_hash3(arg->value.string, strlen(arg->value.string), h);
+    case GRPC_ARG_INTEGER:
+      return gpr_murmur_hash3(&arg->value.integer, sizeof(arg->value.integer),
+                              h);
+    case GRPC_ARG_POINTER:
+      /* distinct pointers may still compare equal through their vtable, and
+         the same pointer compares equal whatever its vtable */
+      return h;
+  }
+  GPR_UNREACHABLE_CODE(return 0);
+}
+
+static void destroy_interned(grpc_interned_channel_args *c) {
+  grpc_channel_args_destroy(c->args);
+  gpr_free(c);
+}
+
+/* returns a new ref to the live entry holding \a args, or NULL;
+   g_intern_mu must be held */
+static grpc_interned_channel_args *find_interned(grpc_arg **args,
+                                                 size_t num_args,
+                                                 uint32_t hash) {
+  if (g_intern_capacity == 0) return NULL;
+  for (grpc_interned_channel_args *c =
+           g_intern_buckets[hash & (g_intern_capacity - 1)];
+       c != NULL; c = c->bucket_next) {
+    if (c->hash != hash || c->args->num_args != num_args) continue;
+    size_t i;
+    for (i = 0; i < num_args; i++) {
+      if (cmp_arg(args[i], &c->args->args[i]) != 0) break;
+    }
+    if (i != num_args) continue;
+    gpr_atm refs = gpr_atm_no_barrier_load(&c->refs);
+    while (refs > 0) {
+      if (gpr_atm_no_barrier_cas(&c->refs, refs, refs + 1)) return c;
+      refs = gpr_atm_no_barrier_load(&c->refs);
+    }
+  }
+  return NULL;
+}
+
+/* g_intern_mu must be held */
+static void insert_interned(grpc_interned_channel_args *c) {
+  if (g_intern_count == g_intern_capacity) {
+    size_t capacity = GPR_MAX(16, 2 * g_intern_capacity);
+    grpc_interned_channel_args **buckets =
+        gpr_malloc(sizeof(*buckets) * capacity);
+    memset(buckets, 0, sizeof(*buckets) * capacity);
+    for (size_t i = 0; i < g_intern_capacity; i++) {
+      grpc_interned_channel_args *next;
+      for (grpc_interned_channel_args *e = g_intern_buckets[i]; e != NULL;
+           e = next) {
+        next = e->bucket_next;
+        e->bucket_next = buckets[e->hash & (capacity - 1)];
+        buckets[e->hash & (capacity - 1)] = e;
+      }
+    }
+    gpr_free(g_intern_buckets);
+    g_intern_buckets = buckets;
+    g_intern_capacity = capacity;
+  }
+  grpc_interned_channel_args **bucket =
+      &g_intern_buckets[c->hash & (g_intern_capacity - 1)];
+  c->bucket_next = *bucket;
+  *bucket = c;
+  g_intern_count++;
+}
+
+/* g_intern_mu must be held */
+static void remove_interned(grpc_interned_channel_args *c) {
+  grpc_interned_channel_args **p =
+      &g_intern_buckets[c->hash & (g_intern_capacity - 1)];
+  while (*p != c) p = &(*p)->bucket_next;
+  *p = c->bucket_next;
+  if (--g_intern_count == 0) {
+    gpr_free(g_intern_buckets);
+    g_intern_buckets = NULL;
+    g_intern_capacity = 0;
+  }
+}
+
+grpc_interned_channel_args *grpc_channel_args_intern(
+    const grpc_channel_args *args) {
+  size_t num_args = args == NULL ? 0 : args->num_args;
+  grpc_arg **sorted = num_args == 0 ? NULL : sort_args(args);
+  uint32_t hash = 0;
+  for (size_t i = 0; i < num_args; i++) {
+    hash = hash_arg(sorted[i], hash);
+  }
+
+  gpr_once_init(&g_intern_once, intern_init);
+  gpr_mu_lock(&g_intern_mu);
+  grpc_interned_channel_args *found = find_interned(sorted, num_args, hash);
+  gpr_mu_unlock(&g_intern_mu);
+  if (found != NULL) {
+    gpr_free(sorted);
+    return found;
+  }
+
+  /* copying runs pointer arg vtables: do it outside the lock, and check again
+     for an entry added in the meantime */
+  grpc_interned_channel_args *c = gpr_malloc(sizeof(*c));
+  gpr_atm_no_barrier_store(&c->refs, 1);
+  c->hash = hash;
+  c->args = copy_sorted_args(sorted, num_args);
+  gpr_mu_lock(&g_intern_mu);
+  found = find_interned(sorted, num_args, hash);
+  if (found == NULL) insert_interned(c);
+  gpr_mu_unlock(&g_intern_mu);
+  gpr_free(sorted);
+  if (found != NULL) {
+    destroy_interned(c);
+    return found;
+  }
+  return c;
+}
+
+void grpc_interned_channel_args_unref(grpc_interned_channel_args *args) {
+  if (gpr_atm_full_fetch_add(&args->refs, -1) == 1) {
+    gpr_mu_lock(&g_intern_mu);
+    remove_interned(args);
+    gpr_mu_unlock(&g_intern_mu);
+    destroy_interned(args);
+  }
+}
+
+const grpc_channel_args *grpc_interned_channel_args_get(
+    const grpc_interned_channel_args *args) {
+  return args->args;
+}
+
 int grpc_channel_arg_get_integer(grpc_arg *arg, grpc_integer_options options) {
   if (arg->type != GRPC_ARG_INTEGER) {
     gpr_log(GPR_ERROR, "%s ignored: it must be an integer", arg->key);
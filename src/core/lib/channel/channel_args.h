@@ -93,6 +93,26 @@ int grpc_channel_args_compare(const grpc_channel_args *a,
 const grpc_arg *grpc_channel_args_find(const grpc_channel_args *args,
                                        const char *name);
 
+/** An immutable, shared copy of a set of channel args, normalized (see \a
+ * grpc_channel_args_normalize).
+ *
+ * Interning the same args (in any key order) twice yields the same object, so
+ * interned args compare equal iff their pointers do, and interning args again
+ * is just taking a ref. Used for the keys of the subchannel index, which are
+ * built and compared far more often than their args are read. */
+typedef struct grpc_interned_channel_args grpc_interned_channel_args;
+
+/** Returns the interned version of \a args (NULL is the same as no args), with
+ * a new ref. Only copies \a args if they were not interned already. */
+grpc_interned_channel_args *grpc_channel_args_intern(
+    const grpc_channel_args *args);
+
+void grpc_interned_channel_args_unref(grpc_interned_channel_args *args);
+
+/** Returns the (normalized) args; valid for as long as \a args is held. */
+const grpc_channel_args *grpc_interned_channel_args_get(
+    const grpc_interned_channel_args *args);
+
 typedef struct grpc_integer_options {
   int default_value;  // Return this if value is outside of expected bounds.
   int min_value;
@@ -32,21 +32,31 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <string.h>
 
 #include <grpc/compression.h>
 #include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
 #include <grpc/support/log.h>
 #include <grpc/support/slice_buffer.h>
+#include <grpc/support/string_util.h>
 
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/compress_filter.h"
 #include "src/core/lib/compression/algorithm_metadata.h"
 #include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/support/string.h"
 #include "src/core/lib/transport/static_metadata.h"
 
+/* What the channel knows of its peers having its dict/deflate dictionary */
+#define PEER_DICTIONARY_UNKNOWN 0
+#define PEER_HAS_DICTIONARY 1
+/* sticky: any peer without the dictionary could be the next one */
+#define PEER_LACKS_DICTIONARY 2
+
 int grpc_compression_trace = 0;
 
 typedef struct call_data {
@@ -59,6 +69,16 @@ typedef struct call_data {
   grpc_compression_algorithm compression_algorithm;
   /** If true, contents of \a compression_algorithm are authoritative */
   int has_compression_algorithm;
+  /** Deflate state shared by the messages of the call when \a
+   * compression_algorithm is GRPC_COMPRESS_STREAM_DEFLATE */
+  grpc_msg_stream_context *stream_compressor;
+  /** If true, stream compression failed and the remaining messages are sent
+   * uncompressed */
+  int stream_compression_failed;
+  /** If true, the peer's initial metadata was received, and \a
+   * peer_has_dictionary says whether it advertised the channel's dictionary */
+  int peer_encodings_known;
+  int peer_has_dictionary;
 
   grpc_transport_stream_op *send_op;
   uint32_t send_length;
@@ -68,6 +88,13 @@ typedef struct call_data {
   grpc_closure *post_send;
   grpc_closure send_done;
   grpc_closure got_slice;
+  grpc_closure compress_offloaded;
+  /** The received initial metadata, looked at (when the channel has a
+   * dictionary) by recv_initial_metadata_ready before on_recv_initial_metadata
+   * runs */
+  grpc_metadata_batch *recv_initial_metadata;
+  grpc_closure *on_recv_initial_metadata;
+  grpc_closure recv_initial_metadata_ready;
 } call_data;
 
 typedef struct channel_data {
@@ -77,6 +104,18 @@ typedef struct channel_data {
   uint32_t enabled_algorithms_bitset;
   /** Supported compression algorithms */
   uint32_t supported_compression_algorithms;
+  /** Messages of at least this many bytes are compressed on the executor
+   * thread; -1 if none are */
+  int offload_threshold;
+  /** Dictionary for GRPC_COMPRESS_DICT_DEFLATE, if any */
+  grpc_compression_dictionary *dictionary;
+  /** grpc-encoding naming \a dictionary; NULL unless it is enabled */
+  grpc_mdelem *dictionary_encoding;
+  /** grpc-accept-encoding for the supported algorithms, which lists \a
+   * dictionary_encoding when there is one */
+  grpc_mdelem *accept_encoding;
+  /** PEER_DICTIONARY_UNKNOWN, PEER_HAS_DICTIONARY or PEER_LACKS_DICTIONARY */
+  gpr_atm peer_dictionary;
 } channel_data;
 
 /** For each \a md element from the incoming metadata, filter out the entry for
@@ -124,6 +163,19 @@ static int skip_compression(grpc_call_element *elem) {
   return channeld->default_compression_algorithm == GRPC_COMPRESS_NONE;
 }
 
+/* Messages are only compressed against the dictionary once the peer is known to
+   have it: ours is a call-level answer on servers, which receive the client's
+   initial metadata before sending theirs, and a channel-level one on
+   clients */
+static int peer_has_dictionary(grpc_call_element *elem) {
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+  if (channeld->dictionary_encoding == NULL) return 0;
+  if (calld->peer_encodings_known) return calld->peer_has_dictionary;
+  return gpr_atm_no_barrier_load(&channeld->peer_dictionary) ==
+         PEER_HAS_DICTIONARY;
+}
+
 /** Filter initial metadata */
 static void process_send_initial_metadata(
     grpc_call_element *elem, grpc_metadata_batch *initial_metadata) {
@@ -139,16 +191,69 @@ static void process_send_initial_metadata(
     calld->compression_algorithm = channeld->default_compression_algorithm;
     calld->has_compression_algorithm = 1; /* GPR_TRUE */
   }
+  if (calld->compression_algorithm == GRPC_COMPRESS_DICT_DEFLATE &&
+      !peer_has_dictionary(elem)) {
+    /* plain deflate gets most of the way there for a peer that couldn't
+       decompress the messages */
+    calld->compression_algorithm =
+        GPR_BITGET(channeld->enabled_algorithms_bitset, GRPC_COMPRESS_DEFLATE)
+            ? GRPC_COMPRESS_DEFLATE
+            : GRPC_COMPRESS_NONE;
+  }
   /* hint compression algorithm */
   grpc_metadata_batch_add_tail(
       initial_metadata, &calld->compression_algorithm_storage,
-      grpc_compression_encoding_mdelem(calld->compression_algorithm));
+      calld->compression_algorithm == GRPC_COMPRESS_DICT_DEFLATE
+          ? GRPC_MDELEM_REF(channeld->dictionary_encoding)
+          : grpc_compression_encoding_mdelem(calld->compression_algorithm));
 
   /* convey supported compression algorithms */
   grpc_metadata_batch_add_tail(initial_metadata,
                                &calld->accept_encoding_storage,
-                               GRPC_MDELEM_ACCEPT_ENCODING_FOR_ALGORITHMS(
-                                   channeld->supported_compression_algorithms));
+                               GRPC_MDELEM_REF(channeld->accept_encoding));
+}
+
+/* Returns true if the comma separated 'list' has the entry 'entry' */
+static int list_has_entry(gpr_slice list, gpr_slice entry) {
+  gpr_slice_buffer entries;
+  size_t i;
+  int found = 0;
+  gpr_slice_buffer_init(&entries);
+  gpr_slice_split(list, ",", &entries);
+  for (i = 0; i < entries.count && !found; i++) {
+    found = 0 == gpr_slice_cmp(entries.slices[i], entry);
+  }
+  gpr_slice_buffer_destroy(&entries);
+  return found;
+}
+
+/* Learns from the peer's grpc-accept-encoding whether it has the channel's
+   dictionary */
+static void recv_initial_metadata_ready(grpc_exec_ctx *exec_ctx, void *elemp,
+                                        grpc_error *error) {
+  grpc_call_element *elem = elemp;
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+  grpc_linked_mdelem *l;
+  if (error == GRPC_ERROR_NONE) {
+    for (l = calld->recv_initial_metadata->list.head; l != NULL; l = l->next) {
+      if (l->md->key != GRPC_MDSTR_GRPC_ACCEPT_ENCODING) continue;
+      calld->peer_has_dictionary =
+          list_has_entry(l->md->value->slice,
+                         channeld->dictionary_encoding->value->slice);
+      calld->peer_encodings_known = 1;
+      if (calld->peer_has_dictionary) {
+        gpr_atm_no_barrier_cas(&channeld->peer_dictionary,
+                               PEER_DICTIONARY_UNKNOWN, PEER_HAS_DICTIONARY);
+      } else {
+        gpr_atm_no_barrier_store(&channeld->peer_dictionary,
+                                 PEER_LACKS_DICTIONARY);
+      }
+      break;
+    }
+  }
+  calld->on_recv_initial_metadata->cb(
+      exec_ctx, calld->on_recv_initial_metadata->cb_arg, error);
 }
 
 static void continue_send_message(grpc_exec_ctx *exec_ctx,
@@ -161,14 +266,39 @@ static void send_done(grpc_exec_ctx *exec_ctx, void *elemp, grpc_error *error) {
   calld->post_send->cb(exec_ctx, calld->post_send->cb_arg, error);
 }
 
-static void finish_send_message(grpc_exec_ctx *exec_ctx,
-                                grpc_call_element *elem) {
+/* Unlike grpc_msg_compress, a message that doesn't shrink is still sent
+   compressed: the peer's inflate state has to see every message that went
+   through ours. */
+static int stream_compress(call_data *calld, gpr_slice_buffer *output) {
+  if (calld->stream_compression_failed) return 0;
+  if (calld->stream_compressor == NULL) {
+    calld->stream_compressor = grpc_msg_stream_compressor_create();
+  }
+  if (!grpc_msg_stream_compress(calld->stream_compressor, &calld->slices,
+                                output)) {
+    grpc_msg_stream_context_destroy(calld->stream_compressor);
+    calld->stream_compressor = NULL;
+    calld->stream_compression_failed = 1;
+    return 0;
+  }
+  return 1;
+}
+
+static void compress_message(grpc_call_element *elem) {
   call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
   int did_compress;
   gpr_slice_buffer tmp;
   gpr_slice_buffer_init(&tmp);
-  did_compress =
-      grpc_msg_compress(calld->compression_algorithm, &calld->slices, &tmp);
+  if (calld->compression_algorithm == GRPC_COMPRESS_STREAM_DEFLATE) {
+    did_compress = stream_compress(calld, &tmp);
+  } else if (calld->compression_algorithm == GRPC_COMPRESS_DICT_DEFLATE) {
+    did_compress =
+        grpc_msg_dict_compress(channeld->dictionary, &calld->slices, &tmp);
+  } else {
+    did_compress =
+        grpc_msg_compress(calld->compression_algorithm, &calld->slices, &tmp);
+  }
   if (did_compress) {
     if (grpc_compression_trace) {
       char *algo_name;
@@ -196,7 +326,11 @@ static void finish_send_message(grpc_exec_ctx *exec_ctx,
   }
 
   gpr_slice_buffer_destroy(&tmp);
+}
 
+static void forward_send_message(grpc_exec_ctx *exec_ctx,
+                                 grpc_call_element *elem) {
+  call_data *calld = elem->call_data;
   grpc_slice_buffer_stream_init(&calld->replacement_stream, &calld->slices,
                                 calld->send_flags);
   calld->send_op->send_message = &calld->replacement_stream.base;
@@ -206,6 +340,33 @@ static void finish_send_message(grpc_exec_ctx *exec_ctx,
   grpc_call_next_op(exec_ctx, elem, calld->send_op);
 }
 
+static void compress_offloaded(grpc_exec_ctx *exec_ctx, void *elemp,
+                               grpc_error *error) {
+  grpc_call_element *elem = elemp;
+  GPR_TIMER_BEGIN("compress_offloaded", 0);
+  compress_message(elem);
+  forward_send_message(exec_ctx, elem);
+  GPR_TIMER_END("compress_offloaded", 0);
+}
+
+/* Large messages are compressed on the executor thread, so that the thread
+   sending them (often a poller, with other streams to serve) isn't held up.
+   The send op only continues down the stack once that is done, which keeps
+   messages in order: there's never more than one send_message in flight per
+   call. */
+static void finish_send_message(grpc_exec_ctx *exec_ctx,
+                                grpc_call_element *elem) {
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+  if (channeld->offload_threshold >= 0 &&
+      calld->slices.length >= (size_t)channeld->offload_threshold) {
+    grpc_executor_push(&calld->compress_offloaded, GRPC_ERROR_NONE);
+    return;
+  }
+  compress_message(elem);
+  forward_send_message(exec_ctx, elem);
+}
+
 static void got_slice(grpc_exec_ctx *exec_ctx, void *elemp, grpc_error *error) {
   grpc_call_element *elem = elemp;
   call_data *calld = elem->call_data;
@@ -235,9 +396,16 @@ static void compress_start_transport_stream_op(grpc_exec_ctx *exec_ctx,
                                                grpc_call_element *elem,
                                                grpc_transport_stream_op *op) {
   call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
 
   GPR_TIMER_BEGIN("compress_start_transport_stream_op", 0);
 
+  if (op->recv_initial_metadata != NULL &&
+      channeld->dictionary_encoding != NULL) {
+    calld->recv_initial_metadata = op->recv_initial_metadata;
+    calld->on_recv_initial_metadata = op->recv_initial_metadata_ready;
+    op->recv_initial_metadata_ready = &calld->recv_initial_metadata_ready;
+  }
   if (op->send_initial_metadata) {
     process_send_initial_metadata(elem, op->send_initial_metadata);
   }
@@ -265,8 +433,14 @@ static grpc_error *init_call_elem(grpc_exec_ctx *exec_ctx,
   /* initialize members */
   gpr_slice_buffer_init(&calld->slices);
   calld->has_compression_algorithm = 0;
+  calld->stream_compressor = NULL;
+  calld->stream_compression_failed = 0;
+  calld->peer_encodings_known = 0;
   grpc_closure_init(&calld->got_slice, got_slice, elem);
   grpc_closure_init(&calld->send_done, send_done, elem);
+  grpc_closure_init(&calld->compress_offloaded, compress_offloaded, elem);
+  grpc_closure_init(&calld->recv_initial_metadata_ready,
+                    recv_initial_metadata_ready, elem);
 
   return GRPC_ERROR_NONE;
 }
@@ -278,6 +452,9 @@ static void destroy_call_elem(grpc_exec_ctx *exec_ctx, grpc_call_element *elem,
   /* grab pointers to our data from the call element */
   call_data *calld = elem->call_data;
   gpr_slice_buffer_destroy(&calld->slices);
+  if (calld->stream_compressor != NULL) {
+    grpc_msg_stream_context_destroy(calld->stream_compressor);
+  }
 }
 
 /* Constructor for channel_data */
@@ -300,6 +477,12 @@ static void init_channel_elem(grpc_exec_ctx *exec_ctx,
     channeld->default_compression_algorithm = GRPC_COMPRESS_NONE;
   }
 
+  channeld->offload_threshold =
+      grpc_compression_offload_threshold_from_channel_args(args->channel_args);
+
+  channeld->dictionary =
+      grpc_compression_dictionary_from_channel_args(args->channel_args);
+
   channeld->supported_compression_algorithms = 1; /* always support identity */
   for (grpc_compression_algorithm algo_idx = 1;
        algo_idx < GRPC_COMPRESS_ALGORITHMS_COUNT; ++algo_idx) {
@@ -310,12 +493,45 @@ static void init_channel_elem(grpc_exec_ctx *exec_ctx,
     channeld->supported_compression_algorithms |= 1u << algo_idx;
   }
 
+  /* dict/deflate is only advertised along with the dictionary's ID, outside of
+     the static accept-encoding values */
+  channeld->accept_encoding = GRPC_MDELEM_ACCEPT_ENCODING_FOR_ALGORITHMS(
+      channeld->supported_compression_algorithms &
+      ~(1u << GRPC_COMPRESS_DICT_DEFLATE));
+  channeld->dictionary_encoding = NULL;
+  gpr_atm_no_barrier_store(&channeld->peer_dictionary, PEER_DICTIONARY_UNKNOWN);
+  if (channeld->dictionary != NULL &&
+      GPR_BITGET(channeld->supported_compression_algorithms,
+                 GRPC_COMPRESS_DICT_DEFLATE)) {
+    const char *encoding =
+        grpc_compression_dictionary_encoding(channeld->dictionary);
+    char *accept_encoding;
+    gpr_asprintf(&accept_encoding, "%s,%s",
+                 grpc_mdstr_as_c_string(channeld->accept_encoding->value),
+                 encoding);
+    channeld->dictionary_encoding = grpc_mdelem_from_metadata_strings(
+        GRPC_MDSTR_GRPC_ENCODING, grpc_mdstr_from_string(encoding));
+    channeld->accept_encoding = grpc_mdelem_from_metadata_strings(
+        GRPC_MDSTR_GRPC_ACCEPT_ENCODING,
+        grpc_mdstr_from_string(accept_encoding));
+    gpr_free(accept_encoding);
+  }
+
   GPR_ASSERT(!args->is_last);
 }
 
 /* Destructor for channel data */
 static void destroy_channel_elem(grpc_exec_ctx *exec_ctx,
-                                 grpc_channel_element *elem) {}
+                                 grpc_channel_element *elem) {
+  channel_data *channeld = elem->channel_data;
+  if (channeld->dictionary != NULL) {
+    grpc_compression_dictionary_unref(channeld->dictionary);
+  }
+  if (channeld->dictionary_encoding != NULL) {
+    GRPC_MDELEM_UNREF(channeld->dictionary_encoding);
+  }
+  GRPC_MDELEM_UNREF(channeld->accept_encoding);
+}
 
 const grpc_channel_filter grpc_compress_filter = {
     compress_start_transport_stream_op,
@@ -158,6 +158,9 @@ static void call_next_handshaker(grpc_exec_ctx* exec_ctx,
                          mgr->state->final_user_data, error);
     return;
   }
+  grpc_handshaker* handshaker = mgr->handshakers[mgr->state->index];
+  gpr_timespec deadline = mgr->state->deadline;
+  grpc_tcp_server_acceptor* acceptor = mgr->state->acceptor;
   grpc_handshaker_done_cb cb = call_next_handshaker;
   // If this is the last handshaker, use the caller-supplied callback
   // and user_data instead of chaining back to this function again.
@@ -165,16 +168,16 @@ static void call_next_handshaker(grpc_exec_ctx* exec_ctx,
     cb = mgr->state->final_cb;
     user_data = mgr->state->final_user_data;
   }
-  // Invoke handshaker.
-  grpc_handshaker_do_handshake(
-      exec_ctx, mgr->handshakers[mgr->state->index], endpoint, args,
-      read_buffer, mgr->state->deadline, mgr->state->acceptor, cb, user_data);
   ++mgr->state->index;
   // If this is the last handshaker, clean up state.
   if (mgr->state->index == mgr->count) {
     gpr_free(mgr->state);
     mgr->state = NULL;
   }
+  // Invoke handshaker. This must come last: the handshaker may invoke cb
+  // before returning, and the final callback may destroy the manager.
+  grpc_handshaker_do_handshake(exec_ctx, handshaker, endpoint, args,
+                               read_buffer, deadline, acceptor, cb, user_data);
 }
 
 void grpc_handshake_manager_do_handshake(
@@ -0,0 +1,416 @@
+//
+// Copyright 2016, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "src/core/lib/channel/max_age_filter.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/transport/transport.h"
+
+#define DEFAULT_MAX_CONNECTION_AGE_MS INT_MAX
+#define DEFAULT_MAX_CONNECTION_AGE_GRACE_MS INT_MAX
+#define DEFAULT_MAX_CONNECTION_IDLE_MS INT_MAX
+// Connection ages are spread by up to this fraction either way, so that the
+// connections made at the same time (eg. after a restart) do not all go away
+// at the same time either.
+#define MAX_CONNECTION_AGE_JITTER 0.1
+// How long a client has to acknowledge the GOAWAY sent at its connection's
+// maximum age (by acking the ping that follows it) before the server sends the
+// final GOAWAY regardless. A client that isn't reading from the connection
+// would otherwise keep it open forever.
+#define MAX_CONNECTION_AGE_GOAWAY_ACK_TIMEOUT_MS 20000
+
+typedef struct channel_data {
+  // The element this is the channel data of.
+  grpc_channel_element* elem;
+  // We take a reference to the channel stack for each timer, and for the
+  // connectivity watch.
+  grpc_channel_stack* channel_stack;
+  // The limits, or gpr_inf_future if unset.
+  gpr_timespec max_connection_age;
+  gpr_timespec max_connection_age_grace;
+  gpr_timespec max_connection_idle;
+  // Number of calls in progress.
+  gpr_atm call_count;
+  // Guards the fields below.
+  gpr_mu mu;
+  // Set once the transport has shut down: no timers are started after this.
+  bool shutdown;
+  bool max_age_timer_pending;
+  bool max_age_grace_timer_pending;
+  bool max_age_goaway_ack_timer_pending;
+  bool max_idle_timer_pending;
+  // When the connection last became idle (its call count dropped to zero).
+  gpr_timespec idle_since;
+  grpc_timer max_age_timer;
+  grpc_timer max_age_grace_timer;
+  grpc_timer max_age_goaway_ack_timer;
+  grpc_timer max_idle_timer;
+  grpc_closure start_timers_after_init;
+  grpc_closure channel_connectivity_changed;
+  grpc_connectivity_state connectivity_state;
+  // Debug data sent with the GOAWAY.
+  gpr_slice goaway_message;
+} channel_data;
+
+static gpr_timespec deadline_from_now(gpr_timespec timeout) {
+  return gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC), timeout);
+}
+
+static gpr_timespec timeout_from_arg(grpc_arg* arg, int default_value) {
+  const grpc_integer_options options = {default_value, 1, INT_MAX};
+  int ms = grpc_channel_arg_get_integer(arg, options);
+  return ms == INT_MAX ? gpr_inf_future(GPR_TIMESPAN)
+                       : gpr_time_from_millis(ms, GPR_TIMESPAN);
+}
+
+static gpr_timespec add_jitter(gpr_timespec timeout) {
+  if (gpr_time_cmp(timeout, gpr_inf_future(GPR_TIMESPAN)) == 0) {
+    return timeout;
+  }
+  uint32_t rng_state = (uint32_t)gpr_now(GPR_CLOCK_REALTIME).tv_nsec;
+  rng_state = (1103515245 * rng_state + 12345) % ((uint32_t)1 << 31);
+  double multiplier =
+      1 + MAX_CONNECTION_AGE_JITTER *
+              (2 * (rng_state / (double)((uint32_t)1 << 31)) - 1);
+  int64_t ms =
+      timeout.tv_sec * GPR_MS_PER_SEC + timeout.tv_nsec / GPR_NS_PER_MS;
+  return gpr_time_from_millis((int64_t)((double)ms * multiplier),
+                              GPR_TIMESPAN);
+}
+
+static void goaway_sent(grpc_exec_ctx* exec_ctx, void* arg,
+                        grpc_error* error) {
+  channel_data* chand = arg;
+  GRPC_CHANNEL_STACK_UNREF(exec_ctx, chand->channel_stack, "max_age goaway");
+}
+
+// Sends a GOAWAY with status OK: the transport lets the calls in progress
+// finish before closing the connection. A graceful GOAWAY is sent in two
+// phases, so that the calls the client starts before seeing it aren't lost; a
+// final one is sent at once (and overrides a graceful one still pending).
+static void send_goaway(grpc_exec_ctx* exec_ctx, grpc_channel_element* elem,
+                        bool graceful) {
+  channel_data* chand = elem->channel_data;
+  // the op refers to goaway_message: keep the channel alive until it has been
+  // consumed
+  GRPC_CHANNEL_STACK_REF(chand->channel_stack, "max_age goaway");
+  grpc_transport_op* op =
+      grpc_make_transport_op(grpc_closure_create(goaway_sent, chand));
+  op->send_goaway = true;
+  op->goaway_status = GRPC_STATUS_OK;
+  op->goaway_message = &chand->goaway_message;
+  op->graceful_goaway = graceful;
+  grpc_channel_next_op(exec_ctx, elem, op);
+}
+
+static void close_max_age_channel(grpc_exec_ctx* exec_ctx, void* arg,
+                                  grpc_error* error);
+static void force_close_max_age_channel(grpc_exec_ctx* exec_ctx, void* arg,
+                                        grpc_error* error);
+static void finish_max_age_goaway(grpc_exec_ctx* exec_ctx, void* arg,
+                                  grpc_error* error);
+static void close_max_idle_channel(grpc_exec_ctx* exec_ctx, void* arg,
+                                   grpc_error* error);
+
+// chand->mu must be held
+static void start_max_idle_timer_locked(grpc_exec_ctx* exec_ctx,
+                                        channel_data* chand,
+                                        gpr_timespec deadline) {
+  chand->max_idle_timer_pending = true;
+  GRPC_CHANNEL_STACK_REF(chand->channel_stack, "max_age max_idle_timer");
+  grpc_timer_init(exec_ctx, &chand->max_idle_timer, deadline,
+                  close_max_idle_channel, chand->elem,
+                  gpr_now(GPR_CLOCK_MONOTONIC));
+}
+
+static void start_timers_after_init(grpc_exec_ctx* exec_ctx, void* arg,
+                                    grpc_error* error) {
+  grpc_channel_element* elem = arg;
+  channel_data* chand = elem->channel_data;
+  gpr_mu_lock(&chand->mu);
+  if (gpr_time_cmp(chand->max_connection_age, gpr_inf_future(GPR_TIMESPAN)) !=
+      0) {
+    chand->max_age_timer_pending = true;
+    GRPC_CHANNEL_STACK_REF(chand->channel_stack, "max_age max_age_timer");
+    grpc_timer_init(exec_ctx, &chand->max_age_timer,
+                    deadline_from_now(chand->max_connection_age),
+                    close_max_age_channel, elem, gpr_now(GPR_CLOCK_MONOTONIC));
+  }
+  if (gpr_time_cmp(chand->max_connection_idle, gpr_inf_future(GPR_TIMESPAN)) !=
+          0 &&
+      gpr_atm_acq_load(&chand->call_count) == 0 &&
+      !chand->max_idle_timer_pending) {
+    start_max_idle_timer_locked(
+        exec_ctx, chand,
+        gpr_time_add(chand->idle_since, chand->max_connection_idle));
+  }
+  gpr_mu_unlock(&chand->mu);
+  // watch the transport, to cancel the timers when it shuts down
+  grpc_transport_op* op = grpc_make_transport_op(NULL);
+  op->on_connectivity_state_change = &chand->channel_connectivity_changed;
+  op->connectivity_state = &chand->connectivity_state;
+  grpc_channel_next_op(exec_ctx, elem, op);
+  // the connectivity watch takes over this closure's ref
+}
+
+static void close_max_age_channel(grpc_exec_ctx* exec_ctx, void* arg,
+                                  grpc_error* error) {
+  grpc_channel_element* elem = arg;
+  channel_data* chand = elem->channel_data;
+  gpr_mu_lock(&chand->mu);
+  chand->max_age_timer_pending = false;
+  bool fire = error == GRPC_ERROR_NONE && !chand->shutdown;
+  if (fire && gpr_time_cmp(chand->max_connection_age_grace,
+                           gpr_inf_future(GPR_TIMESPAN)) != 0) {
+    chand->max_age_grace_timer_pending = true;
+    GRPC_CHANNEL_STACK_REF(chand->channel_stack, "max_age max_age_grace_timer");
+    grpc_timer_init(exec_ctx, &chand->max_age_grace_timer,
+                    deadline_from_now(chand->max_connection_age_grace),
+                    force_close_max_age_channel, elem,
+                    gpr_now(GPR_CLOCK_MONOTONIC));
+  }
+  if (fire) {
+    chand->max_age_goaway_ack_timer_pending = true;
+    GRPC_CHANNEL_STACK_REF(chand->channel_stack,
+                           "max_age max_age_goaway_ack_timer");
+    grpc_timer_init(exec_ctx, &chand->max_age_goaway_ack_timer,
+                    deadline_from_now(gpr_time_from_millis(
+                        MAX_CONNECTION_AGE_GOAWAY_ACK_TIMEOUT_MS,
+                        GPR_TIMESPAN)),
+                    finish_max_age_goaway, elem, gpr_now(GPR_CLOCK_MONOTONIC));
+  }
+  gpr_mu_unlock(&chand->mu);
+  if (fire) {
+    send_goaway(exec_ctx, elem, true);
+  }
+  GRPC_CHANNEL_STACK_UNREF(exec_ctx, chand->channel_stack,
+                           "max_age max_age_timer");
+}
+
+static void finish_max_age_goaway(grpc_exec_ctx* exec_ctx, void* arg,
+                                  grpc_error* error) {
+  grpc_channel_element* elem = arg;
+  channel_data* chand = elem->channel_data;
+  gpr_mu_lock(&chand->mu);
+  chand->max_age_goaway_ack_timer_pending = false;
+  bool fire = error == GRPC_ERROR_NONE && !chand->shutdown;
+  gpr_mu_unlock(&chand->mu);
+  if (fire) {
+    // (the transport ignores it if the client has acked the graceful one)
+    send_goaway(exec_ctx, elem, false);
+  }
+  GRPC_CHANNEL_STACK_UNREF(exec_ctx, chand->channel_stack,
+                           "max_age max_age_goaway_ack_timer");
+}
+
+static void force_close_max_age_channel(grpc_exec_ctx* exec_ctx, void* arg,
+                                        grpc_error* error) {
+  grpc_channel_element* elem = arg;
+  channel_data* chand = elem->channel_data;
+  gpr_mu_lock(&chand->mu);
+  chand->max_age_grace_timer_pending = false;
+  bool fire = error == GRPC_ERROR_NONE && !chand->shutdown;
+  gpr_mu_unlock(&chand->mu);
+  if (fire) {
+    // the calls still running have had their grace period: end them
+    grpc_transport_op* op = grpc_make_transport_op(NULL);
+    op->disconnect_with_error =
+        GRPC_ERROR_CREATE("Max connection age grace period expired");
+    grpc_channel_next_op(exec_ctx, elem, op);
+  }
+  GRPC_CHANNEL_STACK_UNREF(exec_ctx, chand->channel_stack,
+                           "max_age max_age_grace_timer");
+}
+
+static void close_max_idle_channel(grpc_exec_ctx* exec_ctx, void* arg,
+                                   grpc_error* error) {
+  grpc_channel_element* elem = arg;
+  channel_data* chand = elem->channel_data;
+  bool fire = false;
+  gpr_mu_lock(&chand->mu);
+  chand->max_idle_timer_pending = false;
+  // The timer is never cancelled when a call starts: it checks whether the
+  // connection is still idle instead, and restarts itself if the connection
+  // has been busy in the meantime.
+  if (error == GRPC_ERROR_NONE && !chand->shutdown &&
+      gpr_atm_acq_load(&chand->call_count) == 0) {
+    gpr_timespec deadline =
+        gpr_time_add(chand->idle_since, chand->max_connection_idle);
+    if (gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) >= 0) {
+      fire = true;
+    } else {
+      start_max_idle_timer_locked(exec_ctx, chand, deadline);
+    }
+  }
+  gpr_mu_unlock(&chand->mu);
+  if (fire) {
+    // there are no calls for a graceful GOAWAY to protect, and an idle client
+    // may not be reading the connection to ack one: the final GOAWAY closes
+    // the connection right away
+    send_goaway(exec_ctx, elem, false);
+  }
+  GRPC_CHANNEL_STACK_UNREF(exec_ctx, chand->channel_stack,
+                           "max_age max_idle_timer");
+}
+
+static void channel_connectivity_changed(grpc_exec_ctx* exec_ctx, void* arg,
+                                         grpc_error* error) {
+  grpc_channel_element* elem = arg;
+  channel_data* chand = elem->channel_data;
+  if (chand->connectivity_state != GRPC_CHANNEL_SHUTDOWN) {
+    grpc_transport_op* op = grpc_make_transport_op(NULL);
+    op->on_connectivity_state_change = &chand->channel_connectivity_changed;
+    op->connectivity_state = &chand->connectivity_state;
+    grpc_channel_next_op(exec_ctx, elem, op);
+    return;
+  }
+  // the transport is gone: stop the timers, so that they release their
+  // references to the channel stack
+  gpr_mu_lock(&chand->mu);
+  chand->shutdown = true;
+  if (chand->max_age_timer_pending) {
+    grpc_timer_cancel(exec_ctx, &chand->max_age_timer);
+  }
+  if (chand->max_age_grace_timer_pending) {
+    grpc_timer_cancel(exec_ctx, &chand->max_age_grace_timer);
+  }
+  if (chand->max_age_goaway_ack_timer_pending) {
+    grpc_timer_cancel(exec_ctx, &chand->max_age_goaway_ack_timer);
+  }
+  if (chand->max_idle_timer_pending) {
+    grpc_timer_cancel(exec_ctx, &chand->max_idle_timer);
+  }
+  gpr_mu_unlock(&chand->mu);
+  GRPC_CHANNEL_STACK_UNREF(exec_ctx, chand->channel_stack,
+                           "max_age start_timers_after_init");
+}
+
+// Constructor for call_data.
+static grpc_error* init_call_elem(grpc_exec_ctx* exec_ctx,
+                                  grpc_call_element* elem,
+                                  grpc_call_element_args* args) {
+  channel_data* chand = elem->channel_data;
+  gpr_atm_full_fetch_add(&chand->call_count, 1);
+  return GRPC_ERROR_NONE;
+}
+
+// Destructor for call_data.
+static void destroy_call_elem(grpc_exec_ctx* exec_ctx, grpc_call_element* elem,
+                              const grpc_call_final_info* final_info,
+                              void* ignored) {
+  channel_data* chand = elem->channel_data;
+  if (gpr_atm_full_fetch_add(&chand->call_count, -1) == 1 &&
+      gpr_time_cmp(chand->max_connection_idle, gpr_inf_future(GPR_TIMESPAN)) !=
+          0) {
+    gpr_mu_lock(&chand->mu);
+    chand->idle_since = gpr_now(GPR_CLOCK_MONOTONIC);
+    if (!chand->max_idle_timer_pending && !chand->shutdown) {
+      start_max_idle_timer_locked(
+          exec_ctx, chand,
+          gpr_time_add(chand->idle_since, chand->max_connection_idle));
+    }
+    gpr_mu_unlock(&chand->mu);
+  }
+}
+
+bool grpc_max_age_filter_enabled(const grpc_channel_args* args) {
+  return grpc_channel_args_find(args, GRPC_ARG_MAX_CONNECTION_AGE_MS) !=
+             NULL ||
+         grpc_channel_args_find(args, GRPC_ARG_MAX_CONNECTION_IDLE_MS) != NULL;
+}
+
+// Constructor for channel_data.
+static void init_channel_elem(grpc_exec_ctx* exec_ctx,
+                              grpc_channel_element* elem,
+                              grpc_channel_element_args* args) {
+  GPR_ASSERT(!args->is_last);
+  channel_data* chand = elem->channel_data;
+  memset(chand, 0, sizeof(*chand));
+  chand->elem = elem;
+  chand->channel_stack = args->channel_stack;
+  chand->max_connection_age = gpr_inf_future(GPR_TIMESPAN);
+  chand->max_connection_age_grace = gpr_inf_future(GPR_TIMESPAN);
+  chand->max_connection_idle = gpr_inf_future(GPR_TIMESPAN);
+  for (size_t i = 0; i < args->channel_args->num_args; ++i) {
+    grpc_arg* arg = &args->channel_args->args[i];
+    if (strcmp(arg->key, GRPC_ARG_MAX_CONNECTION_AGE_MS) == 0) {
+      chand->max_connection_age = add_jitter(
+          timeout_from_arg(arg, DEFAULT_MAX_CONNECTION_AGE_MS));
+    } else if (strcmp(arg->key, GRPC_ARG_MAX_CONNECTION_AGE_GRACE_MS) == 0) {
+      chand->max_connection_age_grace =
+          timeout_from_arg(arg, DEFAULT_MAX_CONNECTION_AGE_GRACE_MS);
+    } else if (strcmp(arg->key, GRPC_ARG_MAX_CONNECTION_IDLE_MS) == 0) {
+      chand->max_connection_idle =
+          timeout_from_arg(arg, DEFAULT_MAX_CONNECTION_IDLE_MS);
+    }
+  }
+  gpr_atm_no_barrier_store(&chand->call_count, 0);
+  gpr_mu_init(&chand->mu);
+  chand->idle_since = gpr_now(GPR_CLOCK_MONOTONIC);
+  chand->connectivity_state = GRPC_CHANNEL_READY;
+  chand->goaway_message = gpr_slice_from_static_string("max_age");
+  grpc_closure_init(&chand->start_timers_after_init, start_timers_after_init,
+                    elem);
+  grpc_closure_init(&chand->channel_connectivity_changed,
+                    channel_connectivity_changed, elem);
+  // The channel stack is not fully built yet: start the timers (and the
+  // connectivity watch that stops them) once it is.
+  GRPC_CHANNEL_STACK_REF(chand->channel_stack,
+                         "max_age start_timers_after_init");
+  grpc_exec_ctx_sched(exec_ctx, &chand->start_timers_after_init,
+                      GRPC_ERROR_NONE, NULL);
+}
+
+// Destructor for channel_data.
+static void destroy_channel_elem(grpc_exec_ctx* exec_ctx,
+                                 grpc_channel_element* elem) {
+  channel_data* chand = elem->channel_data;
+  gpr_mu_destroy(&chand->mu);
+}
+
+const grpc_channel_filter grpc_max_age_filter = {
+    grpc_call_next_op,
+    grpc_channel_next_op,
+    0,  // sizeof_call_data
+    init_call_elem,
+    grpc_call_stack_ignore_set_pollset_or_pollset_set,
+    destroy_call_elem,
+    sizeof(channel_data),
+    init_channel_elem,
+    destroy_channel_elem,
+    grpc_call_next_get_peer,
+    "max_age"};
@@ -0,0 +1,204 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/lib/channel/shm_handshaker.h"
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/slice_buffer.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/iomgr/shm_endpoint.h"
+#include "src/core/lib/iomgr/timer.h"
+
+typedef struct shm_handshaker {
+  // Base class.  Must be first.
+  grpc_handshaker base;
+
+  bool is_client;
+
+  // State saved while performing the handshake.
+  grpc_endpoint* endpoint;
+  grpc_channel_args* args;
+  grpc_handshaker_done_cb cb;
+  void* user_data;
+
+  // Server side: bytes read while looking for the bootstrap message.
+  gpr_slice_buffer* read_buffer;  // Ownership passes through this object.
+  gpr_slice_buffer incoming;
+  grpc_closure read_closure;
+  grpc_timer timeout_timer;
+
+  gpr_refcount refcount;
+} shm_handshaker;
+
+static void shm_handshaker_unref(shm_handshaker* handshaker) {
+  if (gpr_unref(&handshaker->refcount)) {
+    gpr_slice_buffer_destroy(&handshaker->incoming);
+    gpr_free(handshaker);
+  }
+}
+
+static bool shm_enabled(const grpc_channel_args* args) {
+  const grpc_arg* arg = grpc_channel_args_find(args, GRPC_ARG_SHARED_MEMORY);
+  if (arg == NULL) return false;
+  return grpc_channel_arg_get_integer((grpc_arg*)arg,
+                                      (grpc_integer_options){0, 0, 1}) != 0;
+}
+
+static size_t ring_size(const grpc_channel_args* args) {
+  const grpc_arg* arg =
+      grpc_channel_args_find(args, GRPC_ARG_SHARED_MEMORY_RING_SIZE);
+  if (arg == NULL) return GRPC_SHM_DEFAULT_RING_SIZE;
+  return (size_t)grpc_channel_arg_get_integer(
+      (grpc_arg*)arg,
+      (grpc_integer_options){GRPC_SHM_DEFAULT_RING_SIZE,
+                             GRPC_SHM_MIN_RING_SIZE, GRPC_SHM_MAX_RING_SIZE});
+}
+
+// Only connections over unix sockets can be moved to shared memory.
+static bool is_unix_socket_peer(grpc_endpoint* endpoint) {
+  char* peer = grpc_endpoint_get_peer(endpoint);
+  bool is_unix = strncmp(peer, "unix:", 5) == 0;
+  gpr_free(peer);
+  return is_unix;
+}
+
+static void finish(grpc_exec_ctx* exec_ctx, shm_handshaker* handshaker,
+                   grpc_endpoint* endpoint, grpc_error* error) {
+  handshaker->cb(exec_ctx, endpoint, handshaker->args, handshaker->read_buffer,
+                 handshaker->user_data, error);
+}
+
+// Callback invoked when deadline is exceeded.
+static void on_timeout(grpc_exec_ctx* exec_ctx, void* arg, grpc_error* error) {
+  shm_handshaker* handshaker = arg;
+  if (error == GRPC_ERROR_NONE) {  // Timer fired, rather than being cancelled.
+    grpc_endpoint_shutdown(exec_ctx, handshaker->endpoint);
+  }
+  shm_handshaker_unref(handshaker);
+}
+
+// Server side: callback invoked when the client's first bytes arrive.
+static void on_read_done(grpc_exec_ctx* exec_ctx, void* arg,
+                         grpc_error* error) {
+  shm_handshaker* handshaker = arg;
+  if (error != GRPC_ERROR_NONE) {
+    grpc_timer_cancel(exec_ctx, &handshaker->timeout_timer);
+    finish(exec_ctx, handshaker, handshaker->endpoint, GRPC_ERROR_REF(error));
+    return;
+  }
+  gpr_slice_buffer_move_into(&handshaker->incoming, handshaker->read_buffer);
+  grpc_endpoint* endpoint = handshaker->endpoint;
+  switch (grpc_shm_check_bootstrap(handshaker->read_buffer)) {
+    case GRPC_SHM_BOOTSTRAP_INCOMPLETE:
+      grpc_endpoint_read(exec_ctx, handshaker->endpoint, &handshaker->incoming,
+                         &handshaker->read_closure);
+      return;
+    case GRPC_SHM_BOOTSTRAP_MISMATCH:
+      // A plain HTTP/2 client: hand on what it sent so far.
+      break;
+    case GRPC_SHM_BOOTSTRAP_MATCH:
+      error = grpc_shm_endpoint_accept(exec_ctx, handshaker->endpoint,
+                                       handshaker->read_buffer, &endpoint);
+      break;
+  }
+  grpc_timer_cancel(exec_ctx, &handshaker->timeout_timer);
+  finish(exec_ctx, handshaker, endpoint, error);
+}
+
+//
+// Public handshaker methods
+//
+
+static void shm_handshaker_destroy(grpc_exec_ctx* exec_ctx,
+                                   grpc_handshaker* handshaker_in) {
+  shm_handshaker* handshaker = (shm_handshaker*)handshaker_in;
+  shm_handshaker_unref(handshaker);
+}
+
+static void shm_handshaker_shutdown(grpc_exec_ctx* exec_ctx,
+                                    grpc_handshaker* handshaker) {}
+
+static void shm_handshaker_do_handshake(
+    grpc_exec_ctx* exec_ctx, grpc_handshaker* handshaker_in,
+    grpc_endpoint* endpoint, grpc_channel_args* args,
+    gpr_slice_buffer* read_buffer, gpr_timespec deadline,
+    grpc_tcp_server_acceptor* acceptor, grpc_handshaker_done_cb cb,
+    void* user_data) {
+  shm_handshaker* handshaker = (shm_handshaker*)handshaker_in;
+  // Save state in the handshaker object.
+  handshaker->endpoint = endpoint;
+  handshaker->args = args;
+  handshaker->cb = cb;
+  handshaker->user_data = user_data;
+  handshaker->read_buffer = read_buffer;
+  if (!grpc_shm_endpoint_supported() || !shm_enabled(args) ||
+      !is_unix_socket_peer(endpoint)) {
+    finish(exec_ctx, handshaker, endpoint, GRPC_ERROR_NONE);
+    return;
+  }
+  if (handshaker->is_client) {
+    // Nothing to wait for: the server maps the rings when the bootstrap
+    // message arrives, and whatever we write before then just waits in them.
+    grpc_endpoint* shm_endpoint = endpoint;
+    grpc_error* error = grpc_shm_endpoint_connect(
+        exec_ctx, endpoint, ring_size(args), &shm_endpoint);
+    finish(exec_ctx, handshaker, shm_endpoint, error);
+    return;
+  }
+  grpc_shm_endpoint_prepare_accept(endpoint);
+  // Set timeout timer.  The timer gets a reference to the handshaker.
+  gpr_ref(&handshaker->refcount);
+  grpc_timer_init(exec_ctx, &handshaker->timeout_timer,
+                  gpr_convert_clock_type(deadline, GPR_CLOCK_MONOTONIC),
+                  on_timeout, handshaker, gpr_now(GPR_CLOCK_MONOTONIC));
+  grpc_endpoint_read(exec_ctx, endpoint, &handshaker->incoming,
+                     &handshaker->read_closure);
+}
+
+static const struct grpc_handshaker_vtable shm_handshaker_vtable = {
+    shm_handshaker_destroy, shm_handshaker_shutdown,
+    shm_handshaker_do_handshake};
+
+grpc_handshaker* grpc_shm_handshaker_create(bool is_client) {
+  shm_handshaker* handshaker = gpr_malloc(sizeof(shm_handshaker));
+  memset(handshaker, 0, sizeof(*handshaker));
+  grpc_handshaker_init(&shm_handshaker_vtable, &handshaker->base);
+  handshaker->is_client = is_client;
+  gpr_slice_buffer_init(&handshaker->incoming);
+  grpc_closure_init(&handshaker->read_closure, on_read_done, handshaker);
+  gpr_ref_init(&handshaker->refcount, 1);
+  return &handshaker->base;
+}
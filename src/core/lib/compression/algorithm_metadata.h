@@ -41,7 +41,9 @@
 grpc_mdstr *grpc_compression_algorithm_mdstr(
     grpc_compression_algorithm algorithm);
 
-/** Return compression algorithm based metadata element (grpc-encoding: xxx) */
+/** Return compression algorithm based metadata element (grpc-encoding: xxx),
+ * or NULL for GRPC_COMPRESS_DICT_DEFLATE, whose grpc-encoding also names the
+ * dictionary */
 grpc_mdelem *grpc_compression_encoding_mdelem(
     grpc_compression_algorithm algorithm);
 
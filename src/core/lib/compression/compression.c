@@ -61,6 +61,12 @@ int grpc_compression_algorithm_parse(const char *name, size_t name_length,
     *algorithm = GRPC_COMPRESS_GZIP;
   } else if (strncmp(name, "deflate", name_length) == 0) {
     *algorithm = GRPC_COMPRESS_DEFLATE;
+  } else if (strncmp(name, "stream/deflate", name_length) == 0) {
+    *algorithm = GRPC_COMPRESS_STREAM_DEFLATE;
+  } else if (strncmp(name, "zstd", name_length) == 0) {
+    *algorithm = GRPC_COMPRESS_ZSTD;
+  } else if (strncmp(name, "dict/deflate", name_length) == 0) {
+    *algorithm = GRPC_COMPRESS_DICT_DEFLATE;
   } else {
     return 0;
   }
@@ -81,6 +87,15 @@ int grpc_compression_algorithm_name(grpc_compression_algorithm algorithm,
     case GRPC_COMPRESS_GZIP:
       *name = "gzip";
       return 1;
+    case GRPC_COMPRESS_STREAM_DEFLATE:
+      *name = "stream/deflate";
+      return 1;
+    case GRPC_COMPRESS_ZSTD:
+      *name = "zstd";
+      return 1;
+    case GRPC_COMPRESS_DICT_DEFLATE:
+      *name = "dict/deflate";
+      return 1;
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       return 0;
   }
@@ -92,6 +107,11 @@ grpc_compression_algorithm grpc_compression_algorithm_from_mdstr(
   if (str == GRPC_MDSTR_IDENTITY) return GRPC_COMPRESS_NONE;
   if (str == GRPC_MDSTR_DEFLATE) return GRPC_COMPRESS_DEFLATE;
   if (str == GRPC_MDSTR_GZIP) return GRPC_COMPRESS_GZIP;
+  if (str == GRPC_MDSTR_STREAM_SLASH_DEFLATE) {
+    return GRPC_COMPRESS_STREAM_DEFLATE;
+  }
+  if (str == GRPC_MDSTR_ZSTD) return GRPC_COMPRESS_ZSTD;
+  if (str == GRPC_MDSTR_DICT_SLASH_DEFLATE) return GRPC_COMPRESS_DICT_DEFLATE;
   return GRPC_COMPRESS_ALGORITHMS_COUNT;
 }
 
@@ -104,6 +124,12 @@ grpc_mdstr *grpc_compression_algorithm_mdstr(
       return GRPC_MDSTR_DEFLATE;
     case GRPC_COMPRESS_GZIP:
       return GRPC_MDSTR_GZIP;
+    case GRPC_COMPRESS_STREAM_DEFLATE:
+      return GRPC_MDSTR_STREAM_SLASH_DEFLATE;
+    case GRPC_COMPRESS_ZSTD:
+      return GRPC_MDSTR_ZSTD;
+    case GRPC_COMPRESS_DICT_DEFLATE:
+      return GRPC_MDSTR_DICT_SLASH_DEFLATE;
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       return NULL;
   }
@@ -119,6 +145,10 @@ grpc_mdelem *grpc_compression_encoding_mdelem(
       return GRPC_MDELEM_GRPC_ENCODING_DEFLATE;
     case GRPC_COMPRESS_GZIP:
       return GRPC_MDELEM_GRPC_ENCODING_GZIP;
+    case GRPC_COMPRESS_STREAM_DEFLATE:
+      return GRPC_MDELEM_GRPC_ENCODING_STREAM_SLASH_DEFLATE;
+    case GRPC_COMPRESS_ZSTD:
+      return GRPC_MDELEM_GRPC_ENCODING_ZSTD;
     default:
       break;
   }
@@ -188,6 +218,13 @@ grpc_compression_algorithm grpc_compression_algorithm_for_level(
     }
     if (algos_supported_idx == num_supported) break;
   }
+  /* algorithms outside of the ranking (such as stream/deflate, which only
+   * pays off for streams of similar messages, zstd, which older peers may
+   * not implement, and dict/deflate, which needs a dictionary set up on both
+   * ends) must be requested explicitly */
+  if (algos_supported_idx == 0) {
+    return GRPC_COMPRESS_NONE;
+  }
 
   switch (level) {
     case GRPC_COMPRESS_LEVEL_NONE:
@@ -195,9 +232,9 @@ grpc_compression_algorithm grpc_compression_algorithm_for_level(
     case GRPC_COMPRESS_LEVEL_LOW:
       return sorted_supported_algos[0];
     case GRPC_COMPRESS_LEVEL_MED:
-      return sorted_supported_algos[num_supported / 2];
+      return sorted_supported_algos[algos_supported_idx / 2];
     case GRPC_COMPRESS_LEVEL_HIGH:
-      return sorted_supported_algos[num_supported - 1];
+      return sorted_supported_algos[algos_supported_idx - 1];
     default:
       abort();
   };
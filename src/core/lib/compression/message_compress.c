@@ -33,22 +33,153 @@
 
 #include "src/core/lib/compression/message_compress.h"
 
+#include <limits.h>
 #include <string.h>
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include <grpc/support/string_util.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
 
 #include <zlib.h>
+#include <zstd.h>
 
-#define OUTPUT_BLOCK_SIZE 1024
+#include "src/core/lib/channel/channel_args.h"
 
+/* Output slices start out sized after the input and double in size (within
+   these bounds) when they fill up */
+#define MIN_OUTPUT_BLOCK_SIZE 256
+#define MAX_OUTPUT_BLOCK_SIZE (64 * 1024)
+
+/* Number of idle zlib contexts of each kind kept around for reuse: with the
+   parameters used here a deflate context holds ~256KiB, an inflate one
+   ~40KiB */
+#define MAX_POOLED_CONTEXTS 8
+
+/* zstd's fastest regular level: on typical RPC payloads it compresses about
+   as well as deflate does at its default level, several times faster */
+#define ZSTD_COMPRESSION_LEVEL 1
+
+/* deflate never looks further back than its 32KiB window */
+#define MAX_DICTIONARY_SIZE (32 * 1024)
+
+struct grpc_msg_stream_context {
+  z_stream* zs;
+  int compress;
+};
+
+struct grpc_compression_dictionary {
+  gpr_refcount refs;
+  /* the Adler-32 checksum of the dictionary, which the zlib header of messages
+     compressed against it carries */
+  uint32_t id;
+  /* GRPC_DICT_DEFLATE_ENCODING_PREFIX followed by the id in hex */
+  char* encoding;
+  gpr_slice data;
+};
+
+static gpr_once g_pool_once = GPR_ONCE_INIT;
+static gpr_mu g_pool_mu;
+/* one pool per (inflate/deflate, zlib/gzip) combination */
+#define NUM_POOLS 4
+#define POOL_INDEX(is_deflate, is_gzip) \
+  (((is_deflate) ? 2 : 0) + ((is_gzip) ? 1 : 0))
+static z_stream* g_pool[NUM_POOLS][MAX_POOLED_CONTEXTS];
+static size_t g_pool_count[NUM_POOLS];
+/* idle zstd contexts: decompression contexts at index 0, compression ones at
+   index 1 */
+static void* g_zstd_pool[2][MAX_POOLED_CONTEXTS];
+static size_t g_zstd_pool_count[2];
+
+static void init_pool(void) { gpr_mu_init(&g_pool_mu); }
+
+static void* zalloc_gpr(void* opaque, unsigned int items, unsigned int size) {
+  return gpr_malloc(items * size);
+}
+
+static void zfree_gpr(void* opaque, void* address) { gpr_free(address); }
+
+/* Returns a zlib context ready to start a new stream, reusing a pooled one
+   when possible */
+static z_stream* get_context(int is_deflate, int is_gzip) {
+  const int idx = POOL_INDEX(is_deflate, is_gzip);
+  const int window_bits = 15 | (is_gzip ? 16 : 0);
+  z_stream* zs = NULL;
+  int r;
+
+  gpr_once_init(&g_pool_once, init_pool);
+  gpr_mu_lock(&g_pool_mu);
+  if (g_pool_count[idx] > 0) {
+    zs = g_pool[idx][--g_pool_count[idx]];
+  }
+  gpr_mu_unlock(&g_pool_mu);
+  if (zs != NULL) return zs;
+
+  zs = gpr_malloc(sizeof(*zs));
+  memset(zs, 0, sizeof(*zs));
+  zs->zalloc = zalloc_gpr;
+  zs->zfree = zfree_gpr;
+  if (is_deflate) {
+    r = deflateInit2(zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8,
+                     Z_DEFAULT_STRATEGY);
+  } else {
+    r = inflateInit2(zs, window_bits);
+  }
+  GPR_ASSERT(r == Z_OK);
+  return zs;
+}
+
+static void destroy_context(int is_deflate, z_stream* zs) {
+  if (is_deflate) {
+    deflateEnd(zs);
+  } else {
+    inflateEnd(zs);
+  }
+  gpr_free(zs);
+}
+
+/* Resets 'zs' (whatever state it was left in) and returns it to the pool */
+static void put_context(int is_deflate, int is_gzip, z_stream* zs) {
+  const int idx = POOL_INDEX(is_deflate, is_gzip);
+  int r = is_deflate ? deflateReset(zs) : inflateReset(zs);
+  if (r == Z_OK) {
+    gpr_mu_lock(&g_pool_mu);
+    if (g_pool_count[idx] < MAX_POOLED_CONTEXTS) {
+      g_pool[idx][g_pool_count[idx]++] = zs;
+      zs = NULL;
+    }
+    gpr_mu_unlock(&g_pool_mu);
+  }
+  if (zs != NULL) destroy_context(is_deflate, zs);
+}
+
+/* Called when inflate returns Z_NEED_DICT: the header it just read names the
+   dictionary in zs->adler, which has to be 'dictionary' */
+static int set_inflate_dictionary(z_stream* zs,
+                                  grpc_compression_dictionary* dictionary) {
+  if (dictionary == NULL || dictionary->id != (uint32_t)zs->adler) {
+    gpr_log(GPR_INFO, "zlib: unknown dictionary %08lx", zs->adler);
+    return 0;
+  }
+  return Z_OK == inflateSetDictionary(zs, GPR_SLICE_START_PTR(dictionary->data),
+                                      (uInt)GPR_SLICE_LENGTH(dictionary->data));
+}
+
+/* Feeds all of 'input' through 'flate', using 'final_flush' for the last
+   slice. Output slices start at 'block_size' bytes; if 'max_output' is
+   non-zero, gives up once that much output has been produced. Inflating
+   input that needs a dictionary fails unless it is 'dictionary'. */
 static int zlib_body(z_stream* zs, gpr_slice_buffer* input,
                      gpr_slice_buffer* output,
-                     int (*flate)(z_stream* zs, int flush)) {
+                     int (*flate)(z_stream* zs, int flush), int final_flush,
+                     size_t block_size, size_t max_output,
+                     grpc_compression_dictionary* dictionary) {
   int r;
   int flush;
   size_t i;
-  gpr_slice outbuf = gpr_slice_malloc(OUTPUT_BLOCK_SIZE);
+  size_t produced = 0;
+  gpr_slice outbuf = gpr_slice_malloc(block_size);
   const uInt uint_max = ~(uInt)0;
 
   GPR_ASSERT(GPR_SLICE_LENGTH(outbuf) <= uint_max);
@@ -56,19 +187,28 @@ static int zlib_body(z_stream* zs, gpr_slice_buffer* input,
   zs->next_out = GPR_SLICE_START_PTR(outbuf);
   flush = Z_NO_FLUSH;
   for (i = 0; i < input->count; i++) {
-    if (i == input->count - 1) flush = Z_FINISH;
+    if (i == input->count - 1) flush = final_flush;
     GPR_ASSERT(GPR_SLICE_LENGTH(input->slices[i]) <= uint_max);
     zs->avail_in = (uInt)GPR_SLICE_LENGTH(input->slices[i]);
     zs->next_in = GPR_SLICE_START_PTR(input->slices[i]);
     do {
       if (zs->avail_out == 0) {
+        produced += GPR_SLICE_LENGTH(outbuf);
+        if (max_output != 0 && produced >= max_output) {
+          goto error;
+        }
         gpr_slice_buffer_add_indexed(output, outbuf);
-        outbuf = gpr_slice_malloc(OUTPUT_BLOCK_SIZE);
+        block_size = GPR_MIN(2 * block_size, MAX_OUTPUT_BLOCK_SIZE);
+        outbuf = gpr_slice_malloc(block_size);
         GPR_ASSERT(GPR_SLICE_LENGTH(outbuf) <= uint_max);
         zs->avail_out = (uInt)GPR_SLICE_LENGTH(outbuf);
         zs->next_out = GPR_SLICE_START_PTR(outbuf);
       }
       r = flate(zs, flush);
+      if (r == Z_NEED_DICT) {
+        if (!set_inflate_dictionary(zs, dictionary)) goto error;
+        r = flate(zs, flush);
+      }
       if (r < 0 && r != Z_BUF_ERROR /* not fatal */) {
         gpr_log(GPR_INFO, "zlib error (%d)", r);
         goto error;
@@ -91,58 +231,210 @@ error:
   return 0;
 }
 
-static void* zalloc_gpr(void* opaque, unsigned int items, unsigned int size) {
-  return gpr_malloc(items * size);
+/* Returns a ZSTD_CCtx (if 'is_compress') or ZSTD_DCtx ready to start a new
+   frame, reusing a pooled one when possible */
+static void* get_zstd_context(int is_compress) {
+  void* ctx = NULL;
+
+  gpr_once_init(&g_pool_once, init_pool);
+  gpr_mu_lock(&g_pool_mu);
+  if (g_zstd_pool_count[is_compress] > 0) {
+    ctx = g_zstd_pool[is_compress][--g_zstd_pool_count[is_compress]];
+  }
+  gpr_mu_unlock(&g_pool_mu);
+  if (ctx != NULL) return ctx;
+
+  if (is_compress) {
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    GPR_ASSERT(cctx != NULL);
+    GPR_ASSERT(!ZSTD_isError(ZSTD_CCtx_setParameter(
+        cctx, ZSTD_c_compressionLevel, ZSTD_COMPRESSION_LEVEL)));
+    return cctx;
+  }
+  ctx = ZSTD_createDCtx();
+  GPR_ASSERT(ctx != NULL);
+  return ctx;
 }
 
-static void zfree_gpr(void* opaque, void* address) { gpr_free(address); }
+static void destroy_zstd_context(int is_compress, void* ctx) {
+  if (is_compress) {
+    ZSTD_freeCCtx(ctx);
+  } else {
+    ZSTD_freeDCtx(ctx);
+  }
+}
+
+/* Drops any half-finished frame from 'ctx' (keeping its parameters) and
+   returns it to the pool */
+static void put_zstd_context(int is_compress, void* ctx) {
+  size_t r = is_compress ? ZSTD_CCtx_reset(ctx, ZSTD_reset_session_only)
+                         : ZSTD_DCtx_reset(ctx, ZSTD_reset_session_only);
+  if (!ZSTD_isError(r)) {
+    gpr_mu_lock(&g_pool_mu);
+    if (g_zstd_pool_count[is_compress] < MAX_POOLED_CONTEXTS) {
+      g_zstd_pool[is_compress][g_zstd_pool_count[is_compress]++] = ctx;
+      ctx = NULL;
+    }
+    gpr_mu_unlock(&g_pool_mu);
+  }
+  if (ctx != NULL) destroy_zstd_context(is_compress, ctx);
+}
+
+/* The zstd counterpart of zlib_body: (de)compresses all of 'input' as a
+   single frame */
+static int zstd_body(void* ctx, int is_compress, gpr_slice_buffer* input,
+                     gpr_slice_buffer* output, size_t block_size,
+                     size_t max_output) {
+  size_t i = 0;
+  size_t r = 0;
+  size_t produced = 0;
+  int last;
+  gpr_slice outbuf = gpr_slice_malloc(block_size);
+  ZSTD_outBuffer out;
+  ZSTD_inBuffer in = {NULL, 0, 0};
+
+  out.dst = GPR_SLICE_START_PTR(outbuf);
+  out.size = GPR_SLICE_LENGTH(outbuf);
+  out.pos = 0;
+  /* an empty input still has to go through once, to produce (or check for)
+     a complete frame */
+  do {
+    last = i + 1 >= input->count;
+    if (i < input->count) {
+      in.src = GPR_SLICE_START_PTR(input->slices[i]);
+      in.size = GPR_SLICE_LENGTH(input->slices[i]);
+      in.pos = 0;
+    }
+    for (;;) {
+      if (out.pos == out.size) {
+        produced += out.size;
+        if (max_output != 0 && produced >= max_output) {
+          goto error;
+        }
+        gpr_slice_buffer_add_indexed(output, outbuf);
+        block_size = GPR_MIN(2 * block_size, MAX_OUTPUT_BLOCK_SIZE);
+        outbuf = gpr_slice_malloc(block_size);
+        out.dst = GPR_SLICE_START_PTR(outbuf);
+        out.size = GPR_SLICE_LENGTH(outbuf);
+        out.pos = 0;
+      }
+      if (is_compress) {
+        r = ZSTD_compressStream2(ctx, &out, &in,
+                                 last ? ZSTD_e_end : ZSTD_e_continue);
+      } else {
+        r = ZSTD_decompressStream(ctx, &out, &in);
+      }
+      if (ZSTD_isError(r)) {
+        gpr_log(GPR_INFO, "zstd error: %s", ZSTD_getErrorName(r));
+        goto error;
+      }
+      if (in.pos < in.size) continue;
+      /* zero means the frame is complete and fully flushed; calling the
+         decompressor again past that point would start looking for the next
+         frame */
+      if (r == 0 || (is_compress ? !last : out.pos < out.size)) break;
+    }
+  } while (++i < input->count);
+  if (!is_compress && r != 0) {
+    gpr_log(GPR_INFO, "zstd: truncated frame");
+    goto error;
+  }
+
+  GPR_ASSERT(outbuf.refcount);
+  outbuf.data.refcounted.length = out.pos;
+  gpr_slice_buffer_add_indexed(output, outbuf);
+
+  return 1;
+
+error:
+  gpr_slice_unref(outbuf);
+  return 0;
+}
+
+/* Drops whatever a failed operation appended to 'output' */
+static void truncate_output(gpr_slice_buffer* output, size_t count_before,
+                            size_t length_before) {
+  size_t i;
+  for (i = count_before; i < output->count; i++) {
+    gpr_slice_unref(output->slices[i]);
+  }
+  output->count = count_before;
+  output->length = length_before;
+}
+
+static size_t initial_block_size(size_t input_length) {
+  return GPR_CLAMP(input_length, MIN_OUTPUT_BLOCK_SIZE, MAX_OUTPUT_BLOCK_SIZE);
+}
 
 static int zlib_compress(gpr_slice_buffer* input, gpr_slice_buffer* output,
-                         int gzip) {
-  z_stream zs;
+                         int gzip, int final_flush,
+                         grpc_compression_dictionary* dictionary) {
+  z_stream* zs = get_context(1, gzip);
   int r;
-  size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (gzip ? 16 : 0),
-                   8, Z_DEFAULT_STRATEGY);
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, deflate) && output->length < input->length;
+  if (dictionary != NULL) {
+    GPR_ASSERT(Z_OK ==
+               deflateSetDictionary(zs, GPR_SLICE_START_PTR(dictionary->data),
+                                    (uInt)GPR_SLICE_LENGTH(dictionary->data)));
+  }
+  /* output that is not smaller than the input is of no use: stop as soon as
+     we get there */
+  r = zlib_body(zs, input, output, deflate, final_flush,
+                initial_block_size(input->length), input->length, NULL) &&
+      output->length - length_before < input->length;
   if (!r) {
-    for (i = count_before; i < output->count; i++) {
-      gpr_slice_unref(output->slices[i]);
-    }
-    output->count = count_before;
-    output->length = length_before;
+    truncate_output(output, count_before, length_before);
   }
-  deflateEnd(&zs);
+  put_context(1, gzip, zs);
   return r;
 }
 
 static int zlib_decompress(gpr_slice_buffer* input, gpr_slice_buffer* output,
-                           int gzip) {
-  z_stream zs;
+                           int gzip, int final_flush,
+                           grpc_compression_dictionary* dictionary) {
+  z_stream* zs = get_context(0, gzip);
   int r;
-  size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = inflateInit2(&zs, 15 | (gzip ? 16 : 0));
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, inflate);
+  r = zlib_body(zs, input, output, inflate, final_flush,
+                initial_block_size(2 * input->length), 0, dictionary);
   if (!r) {
-    for (i = count_before; i < output->count; i++) {
-      gpr_slice_unref(output->slices[i]);
-    }
-    output->count = count_before;
-    output->length = length_before;
+    truncate_output(output, count_before, length_before);
   }
-  inflateEnd(&zs);
+  put_context(0, gzip, zs);
+  return r;
+}
+
+static int zstd_compress(gpr_slice_buffer* input, gpr_slice_buffer* output) {
+  void* ctx = get_zstd_context(1);
+  int r;
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  /* lets zstd size its tables after the message, and records the size in the
+     frame header */
+  ZSTD_CCtx_setPledgedSrcSize(ctx, input->length);
+  r = zstd_body(ctx, 1, input, output, initial_block_size(input->length),
+                input->length) &&
+      output->length - length_before < input->length;
+  if (!r) {
+    truncate_output(output, count_before, length_before);
+  }
+  put_zstd_context(1, ctx);
+  return r;
+}
+
+static int zstd_decompress(gpr_slice_buffer* input, gpr_slice_buffer* output) {
+  void* ctx = get_zstd_context(0);
+  int r;
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  r = zstd_body(ctx, 0, input, output, initial_block_size(2 * input->length),
+                0);
+  if (!r) {
+    truncate_output(output, count_before, length_before);
+  }
+  put_zstd_context(0, ctx);
   return r;
 }
 
@@ -162,9 +454,16 @@ static int compress_inner(grpc_compression_algorithm algorithm,
          rely on that here */
       return 0;
     case GRPC_COMPRESS_DEFLATE:
-      return zlib_compress(input, output, 0);
+      return zlib_compress(input, output, 0, Z_FINISH, NULL);
     case GRPC_COMPRESS_GZIP:
-      return zlib_compress(input, output, 1);
+      return zlib_compress(input, output, 1, Z_FINISH, NULL);
+    case GRPC_COMPRESS_STREAM_DEFLATE:
+      /* a lone message is the first (and only) message of a stream */
+      return zlib_compress(input, output, 0, Z_SYNC_FLUSH, NULL);
+    case GRPC_COMPRESS_ZSTD:
+      return zstd_compress(input, output);
+    case GRPC_COMPRESS_DICT_DEFLATE:
+      return zlib_compress(input, output, 0, Z_FINISH, NULL);
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       break;
   }
@@ -181,18 +480,380 @@ int grpc_msg_compress(grpc_compression_algorithm algorithm,
   return 1;
 }
 
+int grpc_msg_dict_compress(grpc_compression_dictionary* dictionary,
+                           gpr_slice_buffer* input, gpr_slice_buffer* output) {
+  if (!zlib_compress(input, output, 0, Z_FINISH, dictionary)) {
+    copy(input, output);
+    return 0;
+  }
+  return 1;
+}
+
 int grpc_msg_decompress(grpc_compression_algorithm algorithm,
                         gpr_slice_buffer* input, gpr_slice_buffer* output) {
   switch (algorithm) {
     case GRPC_COMPRESS_NONE:
       return copy(input, output);
     case GRPC_COMPRESS_DEFLATE:
-      return zlib_decompress(input, output, 0);
+      return zlib_decompress(input, output, 0, Z_FINISH, NULL);
     case GRPC_COMPRESS_GZIP:
-      return zlib_decompress(input, output, 1);
+      return zlib_decompress(input, output, 1, Z_FINISH, NULL);
+    case GRPC_COMPRESS_STREAM_DEFLATE:
+      return zlib_decompress(input, output, 0, Z_SYNC_FLUSH, NULL);
+    case GRPC_COMPRESS_ZSTD:
+      return zstd_decompress(input, output);
+    case GRPC_COMPRESS_DICT_DEFLATE:
+      /* only messages that need no dictionary: see grpc_msg_dict_decompress */
+      return zlib_decompress(input, output, 0, Z_FINISH, NULL);
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       break;
   }
   gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
   return 0;
 }
+
+int grpc_msg_dict_decompress(grpc_compression_dictionary* dictionary,
+                             gpr_slice_buffer* input,
+                             gpr_slice_buffer* output) {
+  return zlib_decompress(input, output, 0, Z_FINISH, dictionary);
+}
+
+static grpc_msg_stream_context* stream_context_create(int compress) {
+  grpc_msg_stream_context* ctx = gpr_malloc(sizeof(*ctx));
+  ctx->zs = get_context(compress, 0);
+  ctx->compress = compress;
+  return ctx;
+}
+
+grpc_msg_stream_context* grpc_msg_stream_compressor_create(void) {
+  return stream_context_create(1);
+}
+
+grpc_msg_stream_context* grpc_msg_stream_decompressor_create(void) {
+  return stream_context_create(0);
+}
+
+void grpc_msg_stream_context_destroy(grpc_msg_stream_context* ctx) {
+  put_context(ctx->compress, 0, ctx->zs);
+  gpr_free(ctx);
+}
+
+int grpc_msg_stream_compress(grpc_msg_stream_context* ctx,
+                             gpr_slice_buffer* input,
+                             gpr_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  GPR_ASSERT(ctx->compress);
+  if (!zlib_body(ctx->zs, input, output, deflate, Z_SYNC_FLUSH,
+                 initial_block_size(input->length), 0, NULL)) {
+    truncate_output(output, count_before, length_before);
+    return 0;
+  }
+  return 1;
+}
+
+int grpc_msg_stream_decompress(grpc_msg_stream_context* ctx,
+                               gpr_slice_buffer* input,
+                               gpr_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  GPR_ASSERT(!ctx->compress);
+  if (!zlib_body(ctx->zs, input, output, inflate, Z_SYNC_FLUSH,
+                 initial_block_size(2 * input->length), 0, NULL)) {
+    truncate_output(output, count_before, length_before);
+    return 0;
+  }
+  return 1;
+}
+
+struct grpc_msg_decompressor {
+  grpc_compression_algorithm algorithm;
+  /* the zlib context, borrowed from the stream for stream/deflate */
+  z_stream* zs;
+  ZSTD_DCtx* dctx;
+  /* the only dictionary a dict/deflate message may need, if any */
+  grpc_compression_dictionary* dictionary;
+  /* set once the end of the deflate stream or zstd frame has been seen */
+  int done;
+};
+
+grpc_msg_decompressor* grpc_msg_decompressor_create(
+    grpc_compression_algorithm algorithm, grpc_msg_stream_context* stream,
+    grpc_compression_dictionary* dictionary) {
+  grpc_msg_decompressor* d;
+  GPR_ASSERT(algorithm > GRPC_COMPRESS_NONE &&
+             algorithm < GRPC_COMPRESS_ALGORITHMS_COUNT);
+  d = gpr_malloc(sizeof(*d));
+  memset(d, 0, sizeof(*d));
+  d->algorithm = algorithm;
+  switch (algorithm) {
+    case GRPC_COMPRESS_DEFLATE:
+      d->zs = get_context(0, 0);
+      break;
+    case GRPC_COMPRESS_DICT_DEFLATE:
+      d->zs = get_context(0, 0);
+      if (dictionary != NULL) {
+        d->dictionary = grpc_compression_dictionary_ref(dictionary);
+      }
+      break;
+    case GRPC_COMPRESS_GZIP:
+      d->zs = get_context(0, 1);
+      break;
+    case GRPC_COMPRESS_STREAM_DEFLATE:
+      GPR_ASSERT(stream != NULL && !stream->compress);
+      d->zs = stream->zs;
+      break;
+    case GRPC_COMPRESS_ZSTD:
+      d->dctx = get_zstd_context(0);
+      break;
+    default:
+      break;
+  }
+  return d;
+}
+
+void grpc_msg_decompressor_destroy(grpc_msg_decompressor* d) {
+  switch (d->algorithm) {
+    case GRPC_COMPRESS_DEFLATE:
+    case GRPC_COMPRESS_GZIP:
+    case GRPC_COMPRESS_DICT_DEFLATE:
+      put_context(0, d->algorithm == GRPC_COMPRESS_GZIP, d->zs);
+      break;
+    case GRPC_COMPRESS_ZSTD:
+      put_zstd_context(0, d->dctx);
+      break;
+    default:
+      break;
+  }
+  if (d->dictionary != NULL) {
+    grpc_compression_dictionary_unref(d->dictionary);
+  }
+  gpr_free(d);
+}
+
+static int inflate_slice(grpc_msg_decompressor* d, gpr_slice slice,
+                         gpr_slice_buffer* output) {
+  z_stream* zs = d->zs;
+  const size_t block_size = initial_block_size(2 * GPR_SLICE_LENGTH(slice));
+  gpr_slice outbuf = gpr_slice_malloc(block_size);
+  int r;
+
+  GPR_ASSERT(GPR_SLICE_LENGTH(slice) <= ~(uInt)0);
+  zs->avail_in = (uInt)GPR_SLICE_LENGTH(slice);
+  zs->next_in = GPR_SLICE_START_PTR(slice);
+  zs->avail_out = (uInt)block_size;
+  zs->next_out = GPR_SLICE_START_PTR(outbuf);
+  /* a full output buffer may mean inflate holds more for us, even once all of
+     the input has been taken in */
+  while (!d->done && (zs->avail_in > 0 || zs->avail_out == 0)) {
+    if (zs->avail_out == 0) {
+      gpr_slice_buffer_add_indexed(output, outbuf);
+      outbuf = gpr_slice_malloc(block_size);
+      zs->avail_out = (uInt)block_size;
+      zs->next_out = GPR_SLICE_START_PTR(outbuf);
+    }
+    r = inflate(zs, Z_SYNC_FLUSH);
+    if (r == Z_NEED_DICT) {
+      if (!set_inflate_dictionary(zs, d->dictionary)) {
+        gpr_slice_unref(outbuf);
+        return 0;
+      }
+      r = inflate(zs, Z_SYNC_FLUSH);
+    }
+    if (r == Z_STREAM_END) {
+      d->done = 1;
+    } else if (r < 0 && r != Z_BUF_ERROR /* not fatal */) {
+      gpr_log(GPR_INFO, "zlib error (%d)", r);
+      gpr_slice_unref(outbuf);
+      return 0;
+    } else if (r == Z_BUF_ERROR && zs->avail_out > 0) {
+      break; /* no progress possible until more input arrives */
+    }
+  }
+  outbuf.data.refcounted.length -= zs->avail_out;
+  if (GPR_SLICE_LENGTH(outbuf) > 0) {
+    gpr_slice_buffer_add_indexed(output, outbuf);
+  } else {
+    gpr_slice_unref(outbuf);
+  }
+  if (zs->avail_in > 0) {
+    gpr_log(GPR_INFO, "zlib: not all input consumed");
+    return 0;
+  }
+  return 1;
+}
+
+static int zstd_decompress_slice(grpc_msg_decompressor* d, gpr_slice slice,
+                                 gpr_slice_buffer* output) {
+  const size_t block_size = initial_block_size(2 * GPR_SLICE_LENGTH(slice));
+  gpr_slice outbuf = gpr_slice_malloc(block_size);
+  ZSTD_inBuffer in;
+  ZSTD_outBuffer out;
+  size_t r;
+
+  in.src = GPR_SLICE_START_PTR(slice);
+  in.size = GPR_SLICE_LENGTH(slice);
+  in.pos = 0;
+  out.dst = GPR_SLICE_START_PTR(outbuf);
+  out.size = block_size;
+  out.pos = 0;
+  /* a full output buffer may mean the decompressor holds more for us, even
+     once all of the input has been taken in */
+  while (!d->done && (in.pos < in.size || out.pos == out.size)) {
+    if (out.pos == out.size) {
+      gpr_slice_buffer_add_indexed(output, outbuf);
+      outbuf = gpr_slice_malloc(block_size);
+      out.dst = GPR_SLICE_START_PTR(outbuf);
+      out.pos = 0;
+    }
+    r = ZSTD_decompressStream(d->dctx, &out, &in);
+    if (ZSTD_isError(r)) {
+      gpr_log(GPR_INFO, "zstd error: %s", ZSTD_getErrorName(r));
+      gpr_slice_unref(outbuf);
+      return 0;
+    }
+    if (r == 0) d->done = 1;
+  }
+  outbuf.data.refcounted.length = out.pos;
+  if (out.pos > 0) {
+    gpr_slice_buffer_add_indexed(output, outbuf);
+  } else {
+    gpr_slice_unref(outbuf);
+  }
+  if (in.pos < in.size) {
+    gpr_log(GPR_INFO, "zstd: data after the end of the frame");
+    return 0;
+  }
+  return 1;
+}
+
+int grpc_msg_decompressor_add(grpc_msg_decompressor* d, gpr_slice slice,
+                              gpr_slice_buffer* output) {
+  size_t count_before = output->count;
+  size_t length_before = output->length;
+  int r;
+  if (GPR_SLICE_LENGTH(slice) == 0) {
+    gpr_slice_unref(slice);
+    return 1;
+  }
+  if (d->algorithm == GRPC_COMPRESS_ZSTD) {
+    r = zstd_decompress_slice(d, slice, output);
+  } else {
+    r = inflate_slice(d, slice, output);
+  }
+  gpr_slice_unref(slice);
+  if (!r) {
+    truncate_output(output, count_before, length_before);
+  }
+  return r;
+}
+
+int grpc_msg_decompressor_finish(grpc_msg_decompressor* d) {
+  /* stream/deflate messages end on a flush point rather than with the end of
+     the stream */
+  return d->done || d->algorithm == GRPC_COMPRESS_STREAM_DEFLATE;
+}
+
+grpc_compression_dictionary* grpc_compression_dictionary_create(
+    const void* data, size_t length) {
+  grpc_compression_dictionary* dict = gpr_malloc(sizeof(*dict));
+  if (length > MAX_DICTIONARY_SIZE) {
+    /* the end of the dictionary is what sits closest to the message */
+    data = (const uint8_t*)data + (length - MAX_DICTIONARY_SIZE);
+    length = MAX_DICTIONARY_SIZE;
+  }
+  gpr_ref_init(&dict->refs, 1);
+  dict->data = gpr_slice_from_copied_buffer(data, length);
+  dict->id = (uint32_t)adler32(adler32(0L, Z_NULL, 0),
+                               GPR_SLICE_START_PTR(dict->data), (uInt)length);
+  gpr_asprintf(&dict->encoding, GRPC_DICT_DEFLATE_ENCODING_PREFIX "%08x",
+               dict->id);
+  return dict;
+}
+
+grpc_compression_dictionary* grpc_compression_dictionary_ref(
+    grpc_compression_dictionary* dict) {
+  gpr_ref(&dict->refs);
+  return dict;
+}
+
+void grpc_compression_dictionary_unref(grpc_compression_dictionary* dict) {
+  if (gpr_unref(&dict->refs)) {
+    gpr_slice_unref(dict->data);
+    gpr_free(dict->encoding);
+    gpr_free(dict);
+  }
+}
+
+const char* grpc_compression_dictionary_encoding(
+    const grpc_compression_dictionary* dict) {
+  return dict->encoding;
+}
+
+static void* dictionary_arg_copy(void* p) {
+  return grpc_compression_dictionary_ref(p);
+}
+
+static void dictionary_arg_destroy(void* p) {
+  grpc_compression_dictionary_unref(p);
+}
+
+static int dictionary_arg_cmp(void* a, void* b) { return GPR_ICMP(a, b); }
+
+static const grpc_arg_pointer_vtable dictionary_arg_vtable = {
+    dictionary_arg_copy, dictionary_arg_destroy, dictionary_arg_cmp};
+
+grpc_arg grpc_compression_dictionary_to_arg(grpc_compression_dictionary* dict) {
+  grpc_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.type = GRPC_ARG_POINTER;
+  arg.key = GRPC_COMPRESSION_CHANNEL_DICTIONARY;
+  arg.value.pointer.p = dict;
+  arg.value.pointer.vtable = &dictionary_arg_vtable;
+  return arg;
+}
+
+grpc_compression_dictionary* grpc_compression_dictionary_from_channel_args(
+    const grpc_channel_args* args) {
+  size_t i;
+  if (args == NULL) return NULL;
+  for (i = 0; i < args->num_args; i++) {
+    if (strcmp(args->args[i].key, GRPC_COMPRESSION_CHANNEL_DICTIONARY) != 0) {
+      continue;
+    }
+    if (args->args[i].type != GRPC_ARG_POINTER) {
+      gpr_log(GPR_ERROR, "Invalid type %d for arg %s", args->args[i].type,
+              GRPC_COMPRESSION_CHANNEL_DICTIONARY);
+      return NULL;
+    }
+    return grpc_compression_dictionary_ref(args->args[i].value.pointer.p);
+  }
+  return NULL;
+}
+
+int grpc_compression_offload_threshold_from_channel_args(
+    const grpc_channel_args* args) {
+  const grpc_arg* arg =
+      grpc_channel_args_find(args, GRPC_ARG_COMPRESSION_OFFLOAD_THRESHOLD);
+  if (arg == NULL) return GRPC_DEFAULT_COMPRESSION_OFFLOAD_THRESHOLD;
+  const grpc_integer_options options = {
+      GRPC_DEFAULT_COMPRESSION_OFFLOAD_THRESHOLD, -1, INT_MAX};
+  return grpc_channel_arg_get_integer((grpc_arg*)arg, options);
+}
+
+void grpc_msg_compress_shutdown(void) {
+  int idx;
+  gpr_once_init(&g_pool_once, init_pool);
+  gpr_mu_lock(&g_pool_mu);
+  for (idx = 0; idx < NUM_POOLS; idx++) {
+    while (g_pool_count[idx] > 0) {
+      destroy_context(idx >= 2, g_pool[idx][--g_pool_count[idx]]);
+    }
+  }
+  for (idx = 0; idx < 2; idx++) {
+    while (g_zstd_pool_count[idx] > 0) {
+      destroy_zstd_context(idx, g_zstd_pool[idx][--g_zstd_pool_count[idx]]);
+    }
+  }
+  gpr_mu_unlock(&g_pool_mu);
+}
@@ -43,10 +43,102 @@
 int grpc_msg_compress(grpc_compression_algorithm algorithm,
                       gpr_slice_buffer* input, gpr_slice_buffer* output);
 
+/* compress 'input' to 'output' with GRPC_COMPRESS_DICT_DEFLATE, against
+   'dictionary' (plain deflate if it is NULL). Same results as
+   grpc_msg_compress. */
+int grpc_msg_dict_compress(grpc_compression_dictionary* dictionary,
+                           gpr_slice_buffer* input, gpr_slice_buffer* output);
+
 /* decompress 'input' to 'output' using 'algorithm'.
    On success, appends slices to output and returns 1.
    On failure, output is unchanged, and returns 0. */
 int grpc_msg_decompress(grpc_compression_algorithm algorithm,
                         gpr_slice_buffer* input, gpr_slice_buffer* output);
 
+/* decompress a GRPC_COMPRESS_DICT_DEFLATE message, which fails if it was
+   compressed against any other dictionary than 'dictionary' (which may be
+   NULL). Same results as grpc_msg_decompress. */
+int grpc_msg_dict_decompress(grpc_compression_dictionary* dictionary,
+                             gpr_slice_buffer* input, gpr_slice_buffer* output);
+
+/* Compression state shared by all the messages of one stream, as used by
+   GRPC_COMPRESS_STREAM_DEFLATE: each message is flushed to a byte boundary
+   instead of ending the deflate stream, so later messages can refer back to
+   the data of earlier ones. A context either compresses or decompresses. */
+typedef struct grpc_msg_stream_context grpc_msg_stream_context;
+
+grpc_msg_stream_context* grpc_msg_stream_compressor_create(void);
+grpc_msg_stream_context* grpc_msg_stream_decompressor_create(void);
+void grpc_msg_stream_context_destroy(grpc_msg_stream_context* ctx);
+
+/* compress 'input' as the next message of the stream, appending the result to
+   'output'. There is no uncompressed fallback: the peer must decompress every
+   message that went through the compressor, in order.
+   On success returns 1. On failure, output is unchanged, returns 0, and the
+   context must not be used any further. */
+int grpc_msg_stream_compress(grpc_msg_stream_context* ctx,
+                             gpr_slice_buffer* input, gpr_slice_buffer* output);
+
+/* decompress the next message of the stream from 'input' to 'output'.
+   On success, appends slices to output and returns 1.
+   On failure, output is unchanged, and returns 0. */
+int grpc_msg_stream_decompress(grpc_msg_stream_context* ctx,
+                               gpr_slice_buffer* input,
+                               gpr_slice_buffer* output);
+
+/* Decompresses a single message piecewise, as its compressed slices arrive,
+   rather than all at once when the whole message is there. */
+typedef struct grpc_msg_decompressor grpc_msg_decompressor;
+
+/* create a decompressor for a message compressed with 'algorithm' (which must
+   not be GRPC_COMPRESS_NONE). For GRPC_COMPRESS_STREAM_DEFLATE the message is
+   decompressed as the next message of 'stream', which must outlive the
+   decompressor. For GRPC_COMPRESS_DICT_DEFLATE, 'dictionary' (which may be
+   NULL) is the only one the message may have been compressed against. Both
+   are ignored for other algorithms. */
+grpc_msg_decompressor* grpc_msg_decompressor_create(
+    grpc_compression_algorithm algorithm, grpc_msg_stream_context* stream,
+    grpc_compression_dictionary* dictionary);
+void grpc_msg_decompressor_destroy(grpc_msg_decompressor* d);
+
+/* decompress the next 'slice' of the message (taking ownership of it),
+   appending whatever output it yields to 'output'.
+   Returns 0 if the data is corrupt, in which case the decompressor must not be
+   fed any further. */
+int grpc_msg_decompressor_add(grpc_msg_decompressor* d, gpr_slice slice,
+                              gpr_slice_buffer* output);
+
+/* returns 1 if the slices added so far make up a complete message, 0 if it was
+   cut short */
+int grpc_msg_decompressor_finish(grpc_msg_decompressor* d);
+
+/* The grpc-encoding of the messages compressed against a dictionary: the
+   prefix followed by the dictionary's Adler-32 checksum, as 8 hex digits. It
+   is also how peers advertise the dictionary in grpc-accept-encoding. */
+#define GRPC_DICT_DEFLATE_ENCODING_PREFIX "dict/deflate/"
+
+grpc_compression_dictionary* grpc_compression_dictionary_ref(
+    grpc_compression_dictionary* dictionary);
+
+/* returns the grpc-encoding naming 'dictionary', which it owns */
+const char* grpc_compression_dictionary_encoding(
+    const grpc_compression_dictionary* dictionary);
+
+/* returns the dictionary set in 'args' (GRPC_COMPRESSION_CHANNEL_DICTIONARY),
+   with a new reference, or NULL if there is none */
+grpc_compression_dictionary* grpc_compression_dictionary_from_channel_args(
+    const grpc_channel_args* args);
+
+/* Compressing a message of this size takes in the order of a millisecond */
+#define GRPC_DEFAULT_COMPRESSION_OFFLOAD_THRESHOLD (64 * 1024)
+
+/* returns the GRPC_ARG_COMPRESSION_OFFLOAD_THRESHOLD set in 'args', or the
+   default: messages of at least this many bytes are (de)compressed on the
+   executor. -1 means never. */
+int grpc_compression_offload_threshold_from_channel_args(
+    const grpc_channel_args* args);
+
+/* release the compression contexts cached for reuse */
+void grpc_msg_compress_shutdown(void);
+
 #endif /* GRPC_CORE_LIB_COMPRESSION_MESSAGE_COMPRESS_H */
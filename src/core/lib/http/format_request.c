@@ -43,17 +43,17 @@
 #include <grpc/support/useful.h>
 #include "src/core/lib/support/string.h"
 
+/* GET and POST requests are made with HTTP/1.1, so that the connection can
+   be kept open for the next request to the same host */
 static void fill_common_header(const grpc_httpcli_request *request,
-                               gpr_strvec *buf, bool connection_close) {
+                               gpr_strvec *buf, bool keep_alive) {
   size_t i;
   gpr_strvec_add(buf, gpr_strdup(request->http.path));
-  gpr_strvec_add(buf, gpr_strdup(" HTTP/1.0\r\n"));
-  /* just in case some crazy server really expects HTTP/1.1 */
+  gpr_strvec_add(buf, gpr_strdup(keep_alive ? " HTTP/1.1\r\n"
+                                            : " HTTP/1.0\r\n"));
   gpr_strvec_add(buf, gpr_strdup("Host: "));
   gpr_strvec_add(buf, gpr_strdup(request->host));
   gpr_strvec_add(buf, gpr_strdup("\r\n"));
-  if (connection_close)
-    gpr_strvec_add(buf, gpr_strdup("Connection: close\r\n"));
   gpr_strvec_add(buf,
                  gpr_strdup("User-Agent: " GRPC_HTTPCLI_USER_AGENT "\r\n"));
   /* user supplied headers */
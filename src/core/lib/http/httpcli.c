@@ -48,14 +48,25 @@
 #include "src/core/lib/iomgr/resolve_address.h"
 #include "src/core/lib/iomgr/sockaddr_utils.h"
 #include "src/core/lib/iomgr/tcp_client.h"
+#include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/support/string.h"
 
+/* how long a connection may sit idle before it is closed rather than reused */
+#define IDLE_CONNECTION_TIMEOUT_MS 30000
+/* the most idle connections a context keeps */
+#define MAX_IDLE_CONNECTIONS 8
+
 typedef struct {
   gpr_slice request_text;
   grpc_http_parser parser;
   grpc_resolved_addresses *addresses;
   size_t next_address;
   grpc_endpoint *ep;
+  /* ep was taken from the connection pool rather than freshly connected */
+  bool reused_connection;
+  /* the request can safely be sent again: only such requests are retried
+     when a reused connection fails */
+  bool idempotent;
   char *host;
   char *ssl_host_override;
   gpr_timespec deadline;
@@ -88,16 +99,165 @@ static void plaintext_handshake(grpc_exec_ctx *exec_ctx, void *arg,
 const grpc_httpcli_handshaker grpc_httpcli_plaintext = {"http",
                                                         plaintext_handshake};
 
+/* A connection left open after a response, waiting to be reused. It is
+   closed if it stays idle for IDLE_CONNECTION_TIMEOUT_MS. */
+typedef struct idle_connection {
+  grpc_httpcli_connection_pool *pool;
+  const grpc_httpcli_handshaker *handshaker;
+  char *host;
+  char *ssl_host_override;
+  /* non-NULL exactly while the connection is in the pool */
+  grpc_endpoint *ep;
+  /* always runs, even when cancelled, and frees the connection */
+  grpc_timer idle_timer;
+  struct idle_connection *next;
+} idle_connection;
+
+struct grpc_httpcli_connection_pool {
+  /* one for the context, and one for each idle connection */
+  gpr_refcount refs;
+  gpr_mu mu;
+  bool shutdown;
+  size_t num_idle;
+  idle_connection *idle;
+};
+
+static grpc_httpcli_connection_pool *connection_pool_create(void) {
+  grpc_httpcli_connection_pool *pool = gpr_malloc(sizeof(*pool));
+  gpr_ref_init(&pool->refs, 1);
+  gpr_mu_init(&pool->mu);
+  pool->shutdown = false;
+  pool->num_idle = 0;
+  pool->idle = NULL;
+  return pool;
+}
+
+static void connection_pool_unref(grpc_httpcli_connection_pool *pool) {
+  if (gpr_unref(&pool->refs)) {
+    GPR_ASSERT(pool->idle == NULL);
+    gpr_mu_destroy(&pool->mu);
+    gpr_free(pool);
+  }
+}
+
+static bool same_target(const idle_connection *c,
+                        const grpc_httpcli_handshaker *handshaker,
+                        const char *host, const char *ssl_host_override) {
+  if (c->handshaker != handshaker || strcmp(c->host, host) != 0) return false;
+  if (c->ssl_host_override == NULL || ssl_host_override == NULL) {
+    return c->ssl_host_override == ssl_host_override;
+  }
+  return strcmp(c->ssl_host_override, ssl_host_override) == 0;
+}
+
+/* pool->mu must be held */
+static void unlink_idle_connection(grpc_httpcli_connection_pool *pool,
+                                   idle_connection *c) {
+  idle_connection **p = &pool->idle;
+  while (*p != c) p = &(*p)->next;
+  *p = c->next;
+  pool->num_idle--;
+}
+
+static void on_idle_timeout(grpc_exec_ctx *exec_ctx, void *arg,
+                            grpc_error *error) {
+  idle_connection *c = arg;
+  grpc_httpcli_connection_pool *pool = c->pool;
+  gpr_mu_lock(&pool->mu);
+  grpc_endpoint *ep = c->ep;
+  if (ep != NULL) {
+    unlink_idle_connection(pool, c);
+    c->ep = NULL;
+  }
+  gpr_mu_unlock(&pool->mu);
+  if (ep != NULL) {
+    grpc_endpoint_destroy(exec_ctx, ep);
+  }
+  gpr_free(c->host);
+  gpr_free(c->ssl_host_override);
+  gpr_free(c);
+  connection_pool_unref(pool);
+}
+
+/* Returns an idle connection to the target, or NULL if there is none */
+static grpc_endpoint *take_idle_connection(
+    grpc_exec_ctx *exec_ctx, grpc_httpcli_connection_pool *pool,
+    const grpc_httpcli_handshaker *handshaker, const char *host,
+    const char *ssl_host_override) {
+  idle_connection *c;
+  grpc_endpoint *ep = NULL;
+  gpr_mu_lock(&pool->mu);
+  for (c = pool->idle; c != NULL; c = c->next) {
+    if (same_target(c, handshaker, host, ssl_host_override)) {
+      unlink_idle_connection(pool, c);
+      ep = c->ep;
+      c->ep = NULL;
+      /* under the lock: once it is released, the timer may free c */
+      grpc_timer_cancel(exec_ctx, &c->idle_timer);
+      break;
+    }
+  }
+  gpr_mu_unlock(&pool->mu);
+  return ep;
+}
+
+/* Keeps \a ep for reuse. Returns false, leaving \a ep to the caller, if the
+   pool is full or shut down. */
+static bool put_idle_connection(grpc_exec_ctx *exec_ctx,
+                                grpc_httpcli_connection_pool *pool,
+                                const grpc_httpcli_handshaker *handshaker,
+                                const char *host, const char *ssl_host_override,
+                                grpc_endpoint *ep) {
+  gpr_mu_lock(&pool->mu);
+  if (pool->shutdown || pool->num_idle == MAX_IDLE_CONNECTIONS) {
+    gpr_mu_unlock(&pool->mu);
+    return false;
+  }
+  idle_connection *c = gpr_malloc(sizeof(*c));
+  c->pool = pool;
+  c->handshaker = handshaker;
+  c->host = gpr_strdup(host);
+  c->ssl_host_override = gpr_strdup(ssl_host_override);
+  c->ep = ep;
+  c->next = pool->idle;
+  pool->idle = c;
+  pool->num_idle++;
+  gpr_ref(&pool->refs);
+  /* start the timer under the lock, so that it cannot be cancelled by
+     take_idle_connection before it is started */
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  grpc_timer_init(
+      exec_ctx, &c->idle_timer,
+      gpr_time_add(now, gpr_time_from_millis(IDLE_CONNECTION_TIMEOUT_MS,
+                                             GPR_TIMESPAN)),
+      on_idle_timeout, c, now);
+  gpr_mu_unlock(&pool->mu);
+  return true;
+}
+
 void grpc_httpcli_context_init(grpc_httpcli_context *context) {
   context->pollset_set = grpc_pollset_set_create();
+  context->connection_pool = connection_pool_create();
 }
 
 void grpc_httpcli_context_destroy(grpc_httpcli_context *context) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_httpcli_connection_pool *pool = context->connection_pool;
+  /* close the idle connections: their timers' callbacks do the work */
+  gpr_mu_lock(&pool->mu);
+  pool->shutdown = true;
+  for (idle_connection *c = pool->idle; c != NULL; c = c->next) {
+    grpc_timer_cancel(&exec_ctx, &c->idle_timer);
+  }
+  gpr_mu_unlock(&pool->mu);
+  connection_pool_unref(pool);
+  grpc_exec_ctx_finish(&exec_ctx);
   grpc_pollset_set_destroy(context->pollset_set);
 }
 
 static void next_address(grpc_exec_ctx *exec_ctx, internal_request *req,
                          grpc_error *due_to_error);
+static void on_resolved(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error);
 
 static void finish(grpc_exec_ctx *exec_ctx, internal_request *req,
                    grpc_error *error) {
@@ -108,7 +268,12 @@ static void finish(grpc_exec_ctx *exec_ctx, internal_request *req,
   if (req->addresses != NULL) {
     grpc_resolved_addresses_destroy(req->addresses);
   }
-  if (req->ep != NULL) {
+  if (req->ep != NULL &&
+      !(error == GRPC_ERROR_NONE &&
+        grpc_http_parser_can_reuse_connection(&req->parser) &&
+        put_idle_connection(exec_ctx, req->context->connection_pool,
+                            req->handshaker, req->host, req->ssl_host_override,
+                            req->ep))) {
     grpc_endpoint_destroy(exec_ctx, req->ep);
   }
   gpr_slice_unref(req->request_text);
@@ -133,6 +298,34 @@ static void append_error(internal_request *req, grpc_error *error) {
   gpr_free(addr_text);
 }
 
+static void start_resolve(grpc_exec_ctx *exec_ctx, internal_request *req) {
+  grpc_resolve_address(exec_ctx, req->host, req->handshaker->default_port,
+                       grpc_closure_create(on_resolved, req), &req->addresses);
+}
+
+/* the connection failed before any of the response arrived */
+static void connection_failed(grpc_exec_ctx *exec_ctx, internal_request *req,
+                              grpc_error *error) {
+  if (req->ep != NULL) {
+    grpc_endpoint_destroy(exec_ctx, req->ep);
+    req->ep = NULL;
+  }
+  if (req->reused_connection) {
+    /* the server may close an idle connection just as it is reused: in that
+       case, start over with a new one, unless the server may have acted on
+       the request already */
+    req->reused_connection = false;
+    if (!req->idempotent) {
+      finish(exec_ctx, req, error);
+      return;
+    }
+    GRPC_ERROR_UNREF(error);
+    start_resolve(exec_ctx, req);
+    return;
+  }
+  next_address(exec_ctx, req, error);
+}
+
 static void do_read(grpc_exec_ctx *exec_ctx, internal_request *req) {
   grpc_endpoint_read(exec_ctx, req->ep, &req->incoming, &req->on_read);
 }
@@ -154,10 +347,18 @@ static void on_read(grpc_exec_ctx *exec_ctx, void *user_data,
     }
   }
 
-  if (error == GRPC_ERROR_NONE) {
+  /* with a keep-alive connection, the server will not close the connection
+     to mark the end of the response */
+  if (grpc_http_parser_is_complete(&req->parser)) {
+    if (error != GRPC_ERROR_NONE) {
+      grpc_endpoint_destroy(exec_ctx, req->ep);
+      req->ep = NULL;
+    }
+    finish(exec_ctx, req, GRPC_ERROR_NONE);
+  } else if (error == GRPC_ERROR_NONE) {
     do_read(exec_ctx, req);
   } else if (!req->have_read_byte) {
-    next_address(exec_ctx, req, GRPC_ERROR_REF(error));
+    connection_failed(exec_ctx, req, GRPC_ERROR_REF(error));
   } else {
     finish(exec_ctx, req, grpc_http_parser_eof(&req->parser));
   }
@@ -172,11 +373,12 @@ static void done_write(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
   if (error == GRPC_ERROR_NONE) {
     on_written(exec_ctx, req);
   } else {
-    next_address(exec_ctx, req, GRPC_ERROR_REF(error));
+    connection_failed(exec_ctx, req, GRPC_ERROR_REF(error));
   }
 }
 
 static void start_write(grpc_exec_ctx *exec_ctx, internal_request *req) {
+  gpr_slice_buffer_reset_and_unref(&req->outgoing);
   gpr_slice_ref(req->request_text);
   gpr_slice_buffer_add(&req->outgoing, req->request_text);
   grpc_endpoint_write(exec_ctx, req->ep, &req->outgoing, &req->done_write);
@@ -245,10 +447,12 @@ static void internal_request_begin(grpc_exec_ctx *exec_ctx,
                                    const grpc_httpcli_request *request,
                                    gpr_timespec deadline, grpc_closure *on_done,
                                    grpc_httpcli_response *response,
-                                   const char *name, gpr_slice request_text) {
+                                   const char *name, gpr_slice request_text,
+                                   bool idempotent) {
   internal_request *req = gpr_malloc(sizeof(internal_request));
   memset(req, 0, sizeof(*req));
   req->request_text = request_text;
+  req->idempotent = idempotent;
   grpc_http_parser_init(&req->parser, GRPC_HTTP_RESPONSE, response);
   req->on_done = on_done;
   req->deadline = deadline;
@@ -268,8 +472,15 @@ static void internal_request_begin(grpc_exec_ctx *exec_ctx,
   GPR_ASSERT(pollent);
   grpc_polling_entity_add_to_pollset_set(exec_ctx, req->pollent,
                                          req->context->pollset_set);
-  grpc_resolve_address(exec_ctx, request->host, req->handshaker->default_port,
-                       grpc_closure_create(on_resolved, req), &req->addresses);
+  req->ep = take_idle_connection(exec_ctx, context->connection_pool,
+                                 req->handshaker, req->host,
+                                 req->ssl_host_override);
+  if (req->ep != NULL) {
+    req->reused_connection = true;
+    start_write(exec_ctx, req);
+    return;
+  }
+  start_resolve(exec_ctx, req);
 }
 
 void grpc_httpcli_get(grpc_exec_ctx *exec_ctx, grpc_httpcli_context *context,
@@ -285,7 +496,7 @@ void grpc_httpcli_get(grpc_exec_ctx *exec_ctx, grpc_httpcli_context *context,
   gpr_asprintf(&name, "HTTP:GET:%s:%s", request->host, request->http.path);
   internal_request_begin(exec_ctx, context, pollent, request, deadline, on_done,
                          response, name,
-                         grpc_httpcli_format_get_request(request));
+                         grpc_httpcli_format_get_request(request), true);
   gpr_free(name);
 }
 
@@ -304,7 +515,7 @@ void grpc_httpcli_post(grpc_exec_ctx *exec_ctx, grpc_httpcli_context *context,
   gpr_asprintf(&name, "HTTP:POST:%s:%s", request->host, request->http.path);
   internal_request_begin(
       exec_ctx, context, pollent, request, deadline, on_done, response, name,
-      grpc_httpcli_format_post_request(request, body_bytes, body_size));
+      grpc_httpcli_format_post_request(request, body_bytes, body_size), false);
   gpr_free(name);
 }
 
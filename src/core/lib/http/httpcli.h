@@ -47,11 +47,15 @@
 /* User agent this library reports */
 #define GRPC_HTTPCLI_USER_AGENT "grpc-httpcli/0.0"
 
-/* Tracks in-progress http requests
+typedef struct grpc_httpcli_connection_pool grpc_httpcli_connection_pool;
+
+/* Tracks in-progress http requests, and keeps the connections they leave
+   open for reuse by later requests to the same host
    TODO(ctiller): allow caching and capturing multiple requests for the
                   same content and combining them */
 typedef struct grpc_httpcli_context {
   grpc_pollset_set *pollset_set;
+  grpc_httpcli_connection_pool *connection_pool;
 } grpc_httpcli_context;
 
 typedef struct {
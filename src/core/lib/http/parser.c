@@ -33,13 +33,17 @@
 
 #include "src/core/lib/http/parser.h"
 
+#include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/useful.h>
 
+#include "src/core/lib/support/string.h"
+
 int grpc_http1_trace = 0;
 
 static char *buf2str(void *buffer, size_t length) {
@@ -64,6 +68,8 @@ static grpc_error *handle_response_line(grpc_http_parser *parser) {
   if (cur == end || *cur < '0' || *cur++ > '1') {
     return GRPC_ERROR_CREATE("Expected HTTP/1.0 or HTTP/1.1");
   }
+  /* HTTP/1.1 connections are persistent unless the headers say otherwise */
+  parser->keep_alive = cur[-1] == '1';
   if (cur == end || *cur++ != ' ') return GRPC_ERROR_CREATE("Expected ' '");
   if (cur == end || *cur < '1' || *cur++ > '9')
     return GRPC_ERROR_CREATE("Expected status code");
@@ -114,6 +120,7 @@ static grpc_error *handle_request_line(grpc_http_parser *parser) {
       parser->http.request->version = GRPC_HTTP_HTTP10;
     } else if (vers_minor == 1) {
       parser->http.request->version = GRPC_HTTP_HTTP11;
+      parser->keep_alive = true;
     } else {
       return GRPC_ERROR_CREATE(
           "Expected one of HTTP/1.0, HTTP/1.1, or HTTP/2.0");
@@ -142,6 +149,52 @@ static grpc_error *handle_first_line(grpc_http_parser *parser) {
   GPR_UNREACHABLE_CODE(return GRPC_ERROR_CREATE("Should never reach here"));
 }
 
+/* returns true if the comma separated list \a value ends with \a token */
+static bool ends_with_token(const char *value, const char *token) {
+  size_t length = strlen(value);
+  const size_t token_length = strlen(token);
+  while (length > 0 &&
+         (value[length - 1] == ' ' || value[length - 1] == '\t')) {
+    length--;
+  }
+  if (length < token_length) return false;
+  const char *start = value + length - token_length;
+  for (size_t i = 0; i < token_length; i++) {
+    if (tolower((unsigned char)start[i]) != token[i]) return false;
+  }
+  return start == value || start[-1] == ',' || start[-1] == ' ' ||
+         start[-1] == '\t';
+}
+
+/* picks out the headers that say how the message ends */
+static grpc_error *handle_framing_header(grpc_http_parser *parser,
+                                         const grpc_http_header *hdr) {
+  if (gpr_stricmp(hdr->key, "Content-Length") == 0) {
+    const char *cur = hdr->value;
+    size_t length = 0;
+    if (*cur == 0) return GRPC_ERROR_CREATE("Empty Content-Length");
+    for (; *cur != 0; cur++) {
+      if (*cur < '0' || *cur > '9' || length > (SIZE_MAX - 9) / 10) {
+        return GRPC_ERROR_CREATE("Invalid Content-Length");
+      }
+      length = length * 10 + (size_t)(*cur - '0');
+    }
+    parser->have_content_length = true;
+    parser->content_length = length;
+  } else if (gpr_stricmp(hdr->key, "Transfer-Encoding") == 0) {
+    if (ends_with_token(hdr->value, "chunked")) {
+      parser->body_framing = GRPC_HTTP_BODY_CHUNKED;
+    }
+  } else if (gpr_stricmp(hdr->key, "Connection") == 0) {
+    if (ends_with_token(hdr->value, "close")) {
+      parser->keep_alive = false;
+    } else if (ends_with_token(hdr->value, "keep-alive")) {
+      parser->keep_alive = true;
+    }
+  }
+  return GRPC_ERROR_NONE;
+}
+
 static grpc_error *add_header(grpc_http_parser *parser) {
   uint8_t *beg = parser->cur_line;
   uint8_t *cur = beg;
@@ -175,6 +228,9 @@ static grpc_error *add_header(grpc_http_parser *parser) {
   GPR_ASSERT((size_t)(end - cur) >= parser->cur_line_end_length);
   hdr.value = buf2str(cur, (size_t)(end - cur) - parser->cur_line_end_length);
 
+  error = handle_framing_header(parser, &hdr);
+  if (error != GRPC_ERROR_NONE) goto done;
+
   switch (parser->type) {
     case GRPC_HTTP_RESPONSE:
       hdr_count = &parser->http.response->hdr_count;
@@ -201,6 +257,18 @@ done:
   return error;
 }
 
+static void start_body(grpc_http_parser *parser) {
+  /* a chunked encoding overrides any Content-Length */
+  if (parser->body_framing == GRPC_HTTP_BODY_CHUNKED) {
+    parser->body_state = GRPC_HTTP_CHUNK_SIZE;
+  } else if (parser->have_content_length) {
+    parser->body_framing = GRPC_HTTP_BODY_LENGTH;
+    parser->body_remaining = parser->content_length;
+    parser->body_state = parser->body_remaining == 0 ? GRPC_HTTP_BODY_COMPLETE
+                                                     : GRPC_HTTP_BODY_DATA;
+  }
+}
+
 static grpc_error *finish_line(grpc_http_parser *parser,
                                bool *found_body_start) {
   grpc_error *err;
@@ -213,6 +281,7 @@ static grpc_error *finish_line(grpc_http_parser *parser,
     case GRPC_HTTP_HEADERS:
       if (parser->cur_line_length == parser->cur_line_end_length) {
         parser->state = GRPC_HTTP_BODY;
+        start_body(parser);
         *found_body_start = true;
         break;
       }
@@ -277,6 +346,80 @@ static bool check_line(grpc_http_parser *parser) {
   return false;
 }
 
+static int hex_digit_value(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static grpc_error *finish_chunk_line(grpc_http_parser *parser) {
+  const size_t length = parser->cur_line_length - parser->cur_line_end_length;
+  size_t i;
+  switch (parser->body_state) {
+    case GRPC_HTTP_CHUNK_SIZE:
+      parser->body_remaining = 0;
+      /* the size may be followed by chunk extensions, which are ignored */
+      for (i = 0; i < length; i++) {
+        const int digit = hex_digit_value(parser->cur_line[i]);
+        if (digit < 0) break;
+        if (parser->body_remaining > (SIZE_MAX >> 4)) {
+          return GRPC_ERROR_CREATE("Chunk size too large");
+        }
+        parser->body_remaining = (parser->body_remaining << 4) | (size_t)digit;
+      }
+      if (i == 0) return GRPC_ERROR_CREATE("Expected chunk size");
+      parser->body_state = parser->body_remaining == 0
+                               ? GRPC_HTTP_CHUNK_TRAILERS
+                               : GRPC_HTTP_BODY_DATA;
+      break;
+    case GRPC_HTTP_CHUNK_DATA_END:
+      if (length != 0) return GRPC_ERROR_CREATE("Expected end of chunk");
+      parser->body_state = GRPC_HTTP_CHUNK_SIZE;
+      break;
+    case GRPC_HTTP_CHUNK_TRAILERS:
+      /* trailers are ignored; an empty line ends them and the message */
+      if (length == 0) parser->body_state = GRPC_HTTP_BODY_COMPLETE;
+      break;
+    case GRPC_HTTP_BODY_DATA:
+    case GRPC_HTTP_BODY_COMPLETE:
+      GPR_UNREACHABLE_CODE(return GRPC_ERROR_CREATE("Should never reach here"));
+  }
+  parser->cur_line_length = 0;
+  return GRPC_ERROR_NONE;
+}
+
+static grpc_error *addbyte_framed_body(grpc_http_parser *parser,
+                                       uint8_t byte) {
+  grpc_error *err;
+  switch (parser->body_state) {
+    case GRPC_HTTP_BODY_DATA:
+      err = addbyte_body(parser, byte);
+      if (--parser->body_remaining == 0) {
+        parser->body_state =
+            parser->body_framing == GRPC_HTTP_BODY_CHUNKED
+                ? GRPC_HTTP_CHUNK_DATA_END
+                : GRPC_HTTP_BODY_COMPLETE;
+      }
+      return err;
+    case GRPC_HTTP_CHUNK_SIZE:
+    case GRPC_HTTP_CHUNK_DATA_END:
+    case GRPC_HTTP_CHUNK_TRAILERS:
+      if (parser->cur_line_length >= GRPC_HTTP_PARSER_MAX_HEADER_LENGTH) {
+        return GRPC_ERROR_CREATE("Chunk line too long");
+      }
+      parser->cur_line[parser->cur_line_length] = byte;
+      parser->cur_line_length++;
+      if (check_line(parser)) {
+        return finish_chunk_line(parser);
+      }
+      return GRPC_ERROR_NONE;
+    case GRPC_HTTP_BODY_COMPLETE:
+      return GRPC_ERROR_CREATE("Unexpected data after body");
+  }
+  GPR_UNREACHABLE_CODE(return GRPC_ERROR_NONE);
+}
+
 static grpc_error *addbyte(grpc_http_parser *parser, uint8_t byte,
                            bool *found_body_start) {
   switch (parser->state) {
@@ -295,7 +438,10 @@ static grpc_error *addbyte(grpc_http_parser *parser, uint8_t byte,
       }
       return GRPC_ERROR_NONE;
     case GRPC_HTTP_BODY:
-      return addbyte_body(parser, byte);
+      if (parser->body_framing == GRPC_HTTP_BODY_TO_EOF) {
+        return addbyte_body(parser, byte);
+      }
+      return addbyte_framed_body(parser, byte);
   }
   GPR_UNREACHABLE_CODE(return GRPC_ERROR_NONE);
 }
@@ -351,3 +497,13 @@ grpc_error *grpc_http_parser_eof(grpc_http_parser *parser) {
   }
   return GRPC_ERROR_NONE;
 }
+
+bool grpc_http_parser_is_complete(const grpc_http_parser *parser) {
+  return parser->state == GRPC_HTTP_BODY &&
+         parser->body_framing != GRPC_HTTP_BODY_TO_EOF &&
+         parser->body_state == GRPC_HTTP_BODY_COMPLETE;
+}
+
+bool grpc_http_parser_can_reuse_connection(const grpc_http_parser *parser) {
+  return grpc_http_parser_is_complete(parser) && parser->keep_alive;
+}
@@ -34,6 +34,8 @@
 #ifndef GRPC_CORE_LIB_HTTP_PARSER_H
 #define GRPC_CORE_LIB_HTTP_PARSER_H
 
+#include <stdbool.h>
+
 #include <grpc/support/port_platform.h>
 #include <grpc/support/slice.h>
 #include "src/core/lib/iomgr/error.h"
@@ -53,6 +55,25 @@ typedef enum {
   GRPC_HTTP_BODY
 } grpc_http_parser_state;
 
+/* How the end of a message body is found */
+typedef enum {
+  /* no length was given: the body runs to the end of the stream */
+  GRPC_HTTP_BODY_TO_EOF,
+  /* Content-Length */
+  GRPC_HTTP_BODY_LENGTH,
+  /* Transfer-Encoding: chunked */
+  GRPC_HTTP_BODY_CHUNKED
+} grpc_http_body_framing;
+
+/* Progress through a body that does not run to the end of the stream */
+typedef enum {
+  GRPC_HTTP_BODY_DATA,
+  GRPC_HTTP_CHUNK_SIZE,
+  GRPC_HTTP_CHUNK_DATA_END,
+  GRPC_HTTP_CHUNK_TRAILERS,
+  GRPC_HTTP_BODY_COMPLETE
+} grpc_http_body_state;
+
 typedef enum {
   GRPC_HTTP_HTTP10,
   GRPC_HTTP_HTTP11,
@@ -104,6 +125,17 @@ typedef struct {
   size_t body_capacity;
   size_t hdr_capacity;
 
+  grpc_http_body_framing body_framing;
+  grpc_http_body_state body_state;
+  /* bytes left in the body (GRPC_HTTP_BODY_LENGTH) or the current chunk */
+  size_t body_remaining;
+  /* the Content-Length header, if there was one */
+  bool have_content_length;
+  size_t content_length;
+  /* whether the sender expects the connection to stay open after this
+     message */
+  bool keep_alive;
+
   uint8_t cur_line[GRPC_HTTP_PARSER_MAX_HEADER_LENGTH];
   size_t cur_line_length;
   size_t cur_line_end_length;
@@ -118,6 +150,16 @@ grpc_error *grpc_http_parser_parse(grpc_http_parser *parser, gpr_slice slice,
                                    size_t *start_of_body);
 grpc_error *grpc_http_parser_eof(grpc_http_parser *parser);
 
+/* Returns true once the whole message has been parsed, without waiting for
+   the end of the stream: its headers gave the length of the body, or it was
+   chunked and the last chunk has arrived. */
+bool grpc_http_parser_is_complete(const grpc_http_parser *parser);
+
+/* Returns true if the message is complete and the connection it arrived on
+   can carry another one (HTTP/1.1 without "Connection: close", or HTTP/1.0
+   with "Connection: keep-alive"). */
+bool grpc_http_parser_can_reuse_connection(const grpc_http_parser *parser);
+
 void grpc_http_request_destroy(grpc_http_request *request);
 void grpc_http_response_destroy(grpc_http_response *response);
 
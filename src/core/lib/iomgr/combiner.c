@@ -53,6 +53,16 @@ int grpc_combiner_trace = 0;
 #define STATE_UNORPHANED 1
 #define STATE_ELEM_COUNT_LOW_BIT 2
 
+// A visit is the span during which a combiner is continuously executed by one
+// exec_ctx. Once a visit exceeds either of these budgets, the combiner yields:
+// to the workqueue if it has one and is covered by a poller (so that an idle
+// poller can pick it up), otherwise to the back of the exec_ctx's list of
+// active combiners (so that the other combiners there get a turn).
+#define MAX_CLOSURES_PER_VISIT 64
+#define MAX_VISIT_DURATION_MICROS 1000
+// how many closures to execute between checks of the visit's duration
+#define VISIT_CLOCK_CHECK_INTERVAL 8
+
 struct grpc_combiner {
   grpc_combiner *next_combiner_on_this_exec_ctx;
   grpc_workqueue *optional_workqueue;
@@ -68,6 +78,17 @@ struct grpc_combiner {
   bool final_list_covered_by_poller;
   grpc_closure_list final_list;
   grpc_closure offload;
+  // the current visit: only accessed while the combiner is active
+  gpr_timespec visit_start;
+  size_t visit_closures;
+  // statistics: written only while the combiner is active, but may be read
+  // from any thread via grpc_combiner_get_stats
+  gpr_atm stats_visits;
+  gpr_atm stats_closures;
+  gpr_atm stats_offloads;
+  gpr_atm stats_budget_yields;
+  gpr_atm stats_max_queue_depth;
+  gpr_atm stats_time_held_micros;
 };
 
 static void offload(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error);
@@ -101,6 +122,13 @@ grpc_combiner *grpc_combiner_create(grpc_workqueue *optional_workqueue) {
   gpr_mpscq_init(&lock->queue);
   grpc_closure_list_init(&lock->final_list);
   grpc_closure_init(&lock->offload, offload, lock);
+  lock->visit_closures = 0;
+  gpr_atm_no_barrier_store(&lock->stats_visits, 0);
+  gpr_atm_no_barrier_store(&lock->stats_closures, 0);
+  gpr_atm_no_barrier_store(&lock->stats_offloads, 0);
+  gpr_atm_no_barrier_store(&lock->stats_budget_yields, 0);
+  gpr_atm_no_barrier_store(&lock->stats_max_queue_depth, 0);
+  gpr_atm_no_barrier_store(&lock->stats_time_held_micros, 0);
   GRPC_COMBINER_TRACE(gpr_log(GPR_DEBUG, "C:%p create", lock));
   return lock;
 }
@@ -122,8 +150,57 @@ void grpc_combiner_destroy(grpc_exec_ctx *exec_ctx, grpc_combiner *lock) {
   }
 }
 
+static void stats_add(gpr_atm *stat, gpr_atm delta) {
+  gpr_atm_no_barrier_store(stat, gpr_atm_no_barrier_load(stat) + delta);
+}
+
+static void start_visit(grpc_combiner *lock) {
+  lock->visit_start = gpr_now(GPR_CLOCK_MONOTONIC);
+  lock->visit_closures = 0;
+  stats_add(&lock->stats_visits, 1);
+}
+
+static void end_visit(grpc_combiner *lock) {
+  gpr_timespec held =
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), lock->visit_start);
+  stats_add(&lock->stats_closures, (gpr_atm)lock->visit_closures);
+  stats_add(&lock->stats_time_held_micros,
+            (gpr_atm)(held.tv_sec * GPR_US_PER_SEC +
+                      held.tv_nsec / GPR_NS_PER_US));
+}
+
+static bool visit_budget_exhausted(grpc_combiner *lock) {
+  if (lock->visit_closures >= MAX_CLOSURES_PER_VISIT) return true;
+  if (lock->visit_closures % VISIT_CLOCK_CHECK_INTERVAL != 0) return false;
+  gpr_timespec held =
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), lock->visit_start);
+  return gpr_time_cmp(held, gpr_time_from_micros(MAX_VISIT_DURATION_MICROS,
+                                                 GPR_TIMESPAN)) >= 0;
+}
+
+static void note_queue_depth(grpc_combiner *lock, gpr_atm depth) {
+  if (depth > gpr_atm_no_barrier_load(&lock->stats_max_queue_depth)) {
+    gpr_atm_no_barrier_store(&lock->stats_max_queue_depth, depth);
+  }
+}
+
+void grpc_combiner_get_stats(grpc_combiner *lock, grpc_combiner_stats *stats) {
+  stats->queue_depth = (size_t)(gpr_atm_acq_load(&lock->state) >> 1);
+  stats->max_queue_depth =
+      (size_t)gpr_atm_no_barrier_load(&lock->stats_max_queue_depth);
+  stats->visits = (size_t)gpr_atm_no_barrier_load(&lock->stats_visits);
+  stats->closures_executed =
+      (size_t)gpr_atm_no_barrier_load(&lock->stats_closures);
+  stats->offloads = (size_t)gpr_atm_no_barrier_load(&lock->stats_offloads);
+  stats->budget_yields =
+      (size_t)gpr_atm_no_barrier_load(&lock->stats_budget_yields);
+  stats->time_held_micros =
+      (int64_t)gpr_atm_no_barrier_load(&lock->stats_time_held_micros);
+}
+
 static void push_last_on_exec_ctx(grpc_exec_ctx *exec_ctx,
                                   grpc_combiner *lock) {
+  start_visit(lock);
   lock->next_combiner_on_this_exec_ctx = NULL;
   if (exec_ctx->active_combiner == NULL) {
     exec_ctx->active_combiner = exec_ctx->last_combiner = lock;
@@ -178,14 +255,21 @@ static void offload(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
   push_last_on_exec_ctx(exec_ctx, lock);
 }
 
-static void queue_offload(grpc_exec_ctx *exec_ctx, grpc_combiner *lock) {
-  move_next(exec_ctx);
+// hand the (inactive) lock over to its workqueue
+static void offload_inactive(grpc_exec_ctx *exec_ctx, grpc_combiner *lock) {
   GRPC_COMBINER_TRACE(gpr_log(GPR_DEBUG, "C:%p queue_offload --> %p", lock,
                               lock->optional_workqueue));
+  stats_add(&lock->stats_offloads, 1);
   grpc_workqueue_enqueue(exec_ctx, lock->optional_workqueue, &lock->offload,
                          GRPC_ERROR_NONE);
 }
 
+static void queue_offload(grpc_exec_ctx *exec_ctx, grpc_combiner *lock) {
+  move_next(exec_ctx);
+  end_visit(lock);
+  offload_inactive(exec_ctx, lock);
+}
+
 bool grpc_combiner_continue_exec_ctx(grpc_exec_ctx *exec_ctx) {
   GPR_TIMER_BEGIN("combiner.continue_exec_ctx", 0);
   grpc_combiner *lock = exec_ctx->active_combiner;
@@ -234,6 +318,7 @@ bool grpc_combiner_continue_exec_ctx(grpc_exec_ctx *exec_ctx) {
     GPR_TIMER_BEGIN("combiner.exec1", 0);
     grpc_closure *cl = (grpc_closure *)n;
     error_data err = unpack_error_data(cl->error_data.scratch);
+    lock->visit_closures++;
     cl->cb(exec_ctx, cl->cb_arg, err.error);
     if (err.covered_by_poller) {
       gpr_atm_no_barrier_fetch_add(&lock->elements_covered_by_poller, -1);
@@ -252,6 +337,7 @@ bool grpc_combiner_continue_exec_ctx(grpc_exec_ctx *exec_ctx) {
           gpr_log(GPR_DEBUG, "C:%p execute_final[%d] c=%p", lock, loops, c));
       grpc_closure *next = c->next_data.next;
       grpc_error *error = c->error_data.error;
+      lock->visit_closures++;
       c->cb(exec_ctx, c->cb_arg, error);
       GRPC_ERROR_UNREF(error);
       c = next;
@@ -262,6 +348,14 @@ bool grpc_combiner_continue_exec_ctx(grpc_exec_ctx *exec_ctx) {
   GPR_TIMER_MARK("unref", 0);
   move_next(exec_ctx);
   lock->time_to_execute_final_list = false;
+  // once the count drops to zero the lock may be taken, or destroyed, by
+  // another thread: finish with the visit and the statistics before that
+  gpr_atm state = gpr_atm_no_barrier_load(&lock->state);
+  note_queue_depth(lock, state >> 1);
+  bool visit_ended = (state >> 1) == 1;
+  if (visit_ended) {
+    end_visit(lock);
+  }
   gpr_atm old_state =
       gpr_atm_full_fetch_add(&lock->state, -STATE_ELEM_COUNT_LOW_BIT);
   GRPC_COMBINER_TRACE(
@@ -299,6 +393,25 @@ bool grpc_combiner_continue_exec_ctx(grpc_exec_ctx *exec_ctx) {
       GPR_TIMER_END("combiner.continue_exec_ctx", 0);
       GPR_UNREACHABLE_CODE(return true);
   }
+  if (visit_ended) {
+    // more work was queued after all: it continues in a new visit
+    start_visit(lock);
+  }
+  if (visit_budget_exhausted(lock)) {
+    // this lock has had the thread for long enough: let others have a turn
+    GPR_TIMER_MARK("yield_exhausted_budget", 0);
+    GRPC_COMBINER_TRACE(gpr_log(GPR_DEBUG, "C:%p budget exhausted closures=%d",
+                                lock, (int)lock->visit_closures));
+    end_visit(lock);
+    stats_add(&lock->stats_budget_yields, 1);
+    if (lock->optional_workqueue != NULL && is_covered_by_poller(lock)) {
+      offload_inactive(exec_ctx, lock);
+    } else {
+      push_last_on_exec_ctx(exec_ctx, lock);
+    }
+    GPR_TIMER_END("combiner.continue_exec_ctx", 0);
+    return true;
+  }
   push_first_on_exec_ctx(exec_ctx, lock);
   GPR_TIMER_END("combiner.continue_exec_ctx", 0);
   return true;
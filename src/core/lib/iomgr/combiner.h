@@ -35,6 +35,7 @@
 #define GRPC_CORE_LIB_IOMGR_COMBINER_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <grpc/support/atm.h>
 #include "src/core/lib/iomgr/exec_ctx.h"
@@ -61,6 +62,29 @@ void grpc_combiner_execute_finally(grpc_exec_ctx *exec_ctx, grpc_combiner *lock,
 
 bool grpc_combiner_continue_exec_ctx(grpc_exec_ctx *exec_ctx);
 
+// Counters describing how a combiner has been executed.
+// A visit is a span of execution of the combiner by one thread: a visit ends
+// when the combiner runs out of work, when it is offloaded to its workqueue,
+// or when it exhausts its per-visit budget of closures and time.
+typedef struct {
+  // number of closures currently queued (including a pending final list)
+  size_t queue_depth;
+  // most closures ever seen queued at once
+  size_t max_queue_depth;
+  size_t visits;
+  size_t closures_executed;
+  // number of times the combiner was handed off to its workqueue
+  size_t offloads;
+  // number of visits ended by exhausting the budget
+  size_t budget_yields;
+  // total time spent executing the combiner
+  int64_t time_held_micros;
+} grpc_combiner_stats;
+
+// Fill \a stats for \a lock. May be called from any thread: counters are
+// updated without synchronization, so may lag slightly.
+void grpc_combiner_get_stats(grpc_combiner *lock, grpc_combiner_stats *stats);
+
 extern int grpc_combiner_trace;
 
 #endif /* GRPC_CORE_LIB_IOMGR_COMBINER_H */
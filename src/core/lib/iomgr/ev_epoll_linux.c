@@ -43,10 +43,12 @@
 #include <errno.h>
 #include <poll.h>
 #include <pthread.h>
+#include <linux/futex.h>
 #include <signal.h>
 #include <string.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include <grpc/support/alloc.h>
@@ -57,6 +59,7 @@
 
 #include "src/core/lib/iomgr/ev_posix.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
+#include "src/core/lib/iomgr/pollset_set_members.h"
 #include "src/core/lib/iomgr/wakeup_fd_posix.h"
 #include "src/core/lib/iomgr/workqueue.h"
 #include "src/core/lib/profiling/timers.h"
@@ -209,12 +212,28 @@ typedef struct polling_island {
 /*******************************************************************************
  * Pollset Declarations
  */
+
+/* Only one worker of a pollset at a time, its designated poller, waits in
+   epoll_pwait(). The others park on a futex until they are kicked, or promoted
+   to designated poller when the current one leaves. Values of
+   grpc_pollset_worker.park_state, which only change with the pollset's mu
+   held: */
+typedef enum {
+  WORKER_POLLING,  /* the designated poller */
+  WORKER_PARKED,   /* waiting on park_state */
+  WORKER_PROMOTED, /* woken up to become the designated poller */
+  WORKER_DONE      /* on its way out of pollset_work(): no need to kick it */
+} worker_park_state;
+
 struct grpc_pollset_worker {
   /* Thread id of this worker */
   pthread_t pt_id;
 
   /* Used to prevent a worker from getting kicked multiple times */
   gpr_atm is_kicked;
+  /* a worker_park_state; an int since it is also the futex word parked
+     workers wait on */
+  int park_state;
   struct grpc_pollset_worker *next;
   struct grpc_pollset_worker *prev;
 };
@@ -222,6 +241,8 @@ struct grpc_pollset_worker {
 struct grpc_pollset {
   gpr_mu mu;
   grpc_pollset_worker root_worker;
+  /* The worker in epoll_pwait() (or about to be), if any */
+  grpc_pollset_worker *poller;
   bool kicked_without_pollers;
 
   bool shutting_down;          /* Is the pollset shutting down ? */
@@ -244,17 +265,18 @@ struct grpc_pollset {
 struct grpc_pollset_set {
   gpr_mu mu;
 
-  size_t pollset_count;
-  size_t pollset_capacity;
-  grpc_pollset **pollsets;
-
-  size_t pollset_set_count;
-  size_t pollset_set_capacity;
-  struct grpc_pollset_set **pollset_sets;
-
-  size_t fd_count;
-  size_t fd_capacity;
-  grpc_fd **fds;
+  /* Rather than handing its fds down to the pollset_sets added to it, a
+     pollset_set takes on the pollsets of those sets. So pollsets holds the
+     pollsets added to this set or to any set below it, and each is counted
+     once for being added here and once for each child set that has it.
+     Locks are always taken child before parent. */
+  grpc_pollset_set_members pollsets;
+  /* the pollset_sets this one has been added to */
+  grpc_pollset_set_members parents;
+  /* the pollset_sets added to this one, so that it can take itself out of
+     their parents when it is destroyed before they are deleted from it */
+  grpc_pollset_set_members children;
+  grpc_pollset_set_members fds;
 };
 
 /*******************************************************************************
@@ -1199,26 +1221,57 @@ static void remove_worker(grpc_pollset *p, grpc_pollset_worker *worker) {
   worker->next->prev = worker->prev;
 }
 
-static grpc_pollset_worker *pop_front_worker(grpc_pollset *p) {
-  if (pollset_has_workers(p)) {
-    grpc_pollset_worker *w = p->root_worker.next;
-    remove_worker(p, w);
-    return w;
-  } else {
-    return NULL;
+static void push_front_worker(grpc_pollset *p, grpc_pollset_worker *worker) {
+  worker->prev = &p->root_worker;
+  worker->next = worker->prev->next;
+  worker->prev->next = worker->next->prev = worker;
+}
+
+static void futex_wait(int *addr, int val, int timeout_ms) {
+  struct timespec ts;
+  struct timespec *tsp = NULL;
+  if (timeout_ms >= 0) {
+    ts.tv_sec = timeout_ms / GPR_MS_PER_SEC;
+    ts.tv_nsec = (timeout_ms % GPR_MS_PER_SEC) * GPR_NS_PER_MS;
+    tsp = &ts;
   }
+  syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, tsp, NULL, 0);
 }
 
-static void push_back_worker(grpc_pollset *p, grpc_pollset_worker *worker) {
-  worker->next = &p->root_worker;
-  worker->prev = worker->next->prev;
-  worker->prev->next = worker->next->prev = worker;
+static void futex_wake(int *addr) {
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
 }
 
-static void push_front_worker(grpc_pollset *p, grpc_pollset_worker *worker) {
-  worker->prev = &p->root_worker;
-  worker->next = worker->prev->next;
-  worker->prev->next = worker->next->prev = worker;
+/* p->mu must be held */
+static grpc_pollset_worker *first_parked_worker(grpc_pollset *p) {
+  grpc_pollset_worker *worker;
+  for (worker = p->root_worker.next; worker != &p->root_worker;
+       worker = worker->next) {
+    if (worker->park_state == WORKER_PARKED) return worker;
+  }
+  return NULL;
+}
+
+/* p->mu must be held */
+static void wake_parked_worker(grpc_pollset_worker *worker, int park_state) {
+  GPR_ASSERT(worker->park_state == WORKER_PARKED);
+  worker->park_state = park_state;
+  futex_wake(&worker->park_state);
+}
+
+/* Get a worker out of pollset_work(): parked workers just need to be woken up,
+   only the designated poller has to be signalled out of epoll_pwait().
+   p->mu must be held */
+static grpc_error *kick_worker(grpc_pollset_worker *worker) {
+  switch (worker->park_state) {
+    case WORKER_PARKED:
+      wake_parked_worker(worker, WORKER_DONE);
+      return GRPC_ERROR_NONE;
+    case WORKER_DONE:
+      return GRPC_ERROR_NONE;
+    default:
+      return pollset_worker_kick(worker);
+  }
 }
 
 /* p->mu must be held before calling this function */
@@ -1235,7 +1288,7 @@ static grpc_error *pollset_kick(grpc_pollset *p,
         for (worker = p->root_worker.next; worker != &p->root_worker;
              worker = worker->next) {
           if (gpr_tls_get(&g_current_thread_worker) != (intptr_t)worker) {
-            append_error(&error, pollset_worker_kick(worker), err_desc);
+            append_error(&error, kick_worker(worker), err_desc);
           }
         }
         GPR_TIMER_END("pollset_kick.broadcast", 0);
@@ -1245,7 +1298,7 @@ static grpc_error *pollset_kick(grpc_pollset *p,
     } else {
       GPR_TIMER_MARK("kicked_specifically", 0);
       if (gpr_tls_get(&g_current_thread_worker) != (intptr_t)worker) {
-        append_error(&error, pollset_worker_kick(worker), err_desc);
+        append_error(&error, kick_worker(worker), err_desc);
       }
     }
   } else if (gpr_tls_get(&g_current_thread_pollset) != (intptr_t)p) {
@@ -1257,12 +1310,17 @@ static grpc_error *pollset_kick(grpc_pollset *p,
        g_current_thread_pollset is != p */
 
     GPR_TIMER_MARK("kick_anonymous", 0);
-    worker = pop_front_worker(p);
+    /* Rather wake up a parked worker than interrupt the designated poller,
+       which keeps watching the fds. If there are neither, any workers left are
+       on their way out of pollset_work() already. */
+    worker = first_parked_worker(p);
     if (worker != NULL) {
       GPR_TIMER_MARK("finally_kick", 0);
-      push_back_worker(p, worker);
-      append_error(&error, pollset_worker_kick(worker), err_desc);
-    } else {
+      wake_parked_worker(worker, WORKER_DONE);
+    } else if (p->poller != NULL) {
+      GPR_TIMER_MARK("finally_kick", 0);
+      append_error(&error, pollset_worker_kick(p->poller), err_desc);
+    } else if (!pollset_has_workers(p)) {
       GPR_TIMER_MARK("kicked_no_pollers", 0);
       p->kicked_without_pollers = true;
     }
@@ -1282,6 +1340,7 @@ static void pollset_init(grpc_pollset *pollset, gpr_mu **mu) {
   *mu = &pollset->mu;
 
   pollset->root_worker.next = pollset->root_worker.prev = &pollset->root_worker;
+  pollset->poller = NULL;
   pollset->kicked_without_pollers = false;
 
   pollset->shutting_down = false;
@@ -1549,6 +1608,29 @@ static void pollset_work_and_unlock(grpc_exec_ctx *exec_ctx,
   GPR_TIMER_END("pollset_work_and_unlock", 0);
 }
 
+/* Parks a worker that is not the designated poller until it is kicked, it is
+   promoted to designated poller or the deadline passes. Returns true if it was
+   promoted. pollset->mu must be held; it is released while the worker is
+   parked */
+static bool park_worker(grpc_pollset *pollset, grpc_pollset_worker *worker,
+                        gpr_timespec now, gpr_timespec deadline) {
+  int timeout_ms;
+  worker->park_state = WORKER_PARKED;
+  while ((timeout_ms = poll_deadline_to_millis_timeout(deadline, now)) != 0) {
+    gpr_mu_unlock(&pollset->mu);
+    GRPC_SCHEDULING_START_BLOCKING_REGION;
+    futex_wait(&worker->park_state, WORKER_PARKED, timeout_ms);
+    GRPC_SCHEDULING_END_BLOCKING_REGION;
+    gpr_mu_lock(&pollset->mu);
+    if (worker->park_state != WORKER_PARKED) break;
+    now = gpr_now(now.clock_type);
+  }
+  if (worker->park_state == WORKER_PARKED) {
+    worker->park_state = WORKER_DONE;
+  }
+  return worker->park_state == WORKER_PROMOTED;
+}
+
 /* pollset->mu lock must be held by the caller before calling this.
    The function pollset_work() may temporarily release the lock (pollset->mu)
    during the course of its execution but it will always re-acquire the lock and
@@ -1566,6 +1648,7 @@ static grpc_error *pollset_work(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
   worker.next = worker.prev = NULL;
   worker.pt_id = pthread_self();
   gpr_atm_no_barrier_store(&worker.is_kicked, (gpr_atm)0);
+  worker.park_state = WORKER_POLLING;
 
   *worker_hdl = &worker;
 
@@ -1587,9 +1670,12 @@ static grpc_error *pollset_work(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
        results in a new epoll-fd to wait on) and that the worker should not
        spend time waiting in epoll_pwait().
 
+       Only the designated poller needs the signal: the other workers are
+       parked on a futex instead (see park_worker()), and kicking them is just
+       a futex wake-up.
+
        A worker can be kicked anytime from the point it is added to the pollset
-       via push_front_worker() (or push_back_worker()) to the point it is
-       removed via remove_worker().
+       via push_front_worker() to the point it is removed via remove_worker().
        If the worker is kicked before/during it calls epoll_pwait(), it should
        immediately exit from epoll_wait(). If the worker is kicked after it
        returns from epoll_wait(), then nothing really needs to be done.
@@ -1616,8 +1702,33 @@ static grpc_error *pollset_work(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
 
     push_front_worker(pollset, &worker); /* Add worker to pollset */
 
-    pollset_work_and_unlock(exec_ctx, pollset, &worker, timeout_ms,
-                            &g_orig_sigmask, &error);
+    if (pollset->poller == NULL) {
+      pollset->poller = &worker;
+    } else if (park_worker(pollset, &worker, now, deadline)) {
+      GPR_ASSERT(pollset->poller == &worker);
+      worker.park_state = WORKER_POLLING;
+      timeout_ms = poll_deadline_to_millis_timeout(deadline,
+                                                   gpr_now(now.clock_type));
+    }
+
+    if (pollset->poller == &worker) {
+      pollset_work_and_unlock(exec_ctx, pollset, &worker, timeout_ms,
+                              &g_orig_sigmask, &error);
+
+      /* Hand polling over to a parked worker before running the closures the
+         events we got scheduled, so that the fds stay watched meanwhile */
+      gpr_mu_lock(&pollset->mu);
+      pollset->poller = NULL;
+      worker.park_state = WORKER_DONE;
+      if (!pollset->shutting_down) {
+        grpc_pollset_worker *next_poller = first_parked_worker(pollset);
+        if (next_poller != NULL) {
+          pollset->poller = next_poller;
+          wake_parked_worker(next_poller, WORKER_PROMOTED);
+        }
+      }
+    }
+    gpr_mu_unlock(&pollset->mu);
     grpc_exec_ctx_flush(exec_ctx);
 
     gpr_mu_lock(&pollset->mu);
@@ -1782,20 +1893,33 @@ retry:
 
 static grpc_pollset_set *pollset_set_create(void) {
   grpc_pollset_set *pollset_set = gpr_malloc(sizeof(*pollset_set));
-  memset(pollset_set, 0, sizeof(*pollset_set));
   gpr_mu_init(&pollset_set->mu);
+  grpc_pollset_set_members_init(&pollset_set->pollsets);
+  grpc_pollset_set_members_init(&pollset_set->parents);
+  grpc_pollset_set_members_init(&pollset_set->children);
+  grpc_pollset_set_members_init(&pollset_set->fds);
   return pollset_set;
 }
 
 static void pollset_set_destroy(grpc_pollset_set *pollset_set) {
   size_t i;
+  /* a set still added to a parent would be left in its children, and locked
+     by the parent's destroy after being freed */
+  GPR_ASSERT(pollset_set->parents.count == 0);
+  for (i = 0; i < pollset_set->children.count; i++) {
+    grpc_pollset_set *child = pollset_set->children.members[i].member;
+    gpr_mu_lock(&child->mu);
+    grpc_pollset_set_members_remove(&child->parents, pollset_set);
+    gpr_mu_unlock(&child->mu);
+  }
   gpr_mu_destroy(&pollset_set->mu);
-  for (i = 0; i < pollset_set->fd_count; i++) {
-    GRPC_FD_UNREF(pollset_set->fds[i], "pollset_set");
+  for (i = 0; i < pollset_set->fds.count; i++) {
+    GRPC_FD_UNREF(pollset_set->fds.members[i].member, "pollset_set");
   }
-  gpr_free(pollset_set->pollsets);
-  gpr_free(pollset_set->pollset_sets);
-  gpr_free(pollset_set->fds);
+  grpc_pollset_set_members_destroy(&pollset_set->pollsets);
+  grpc_pollset_set_members_destroy(&pollset_set->parents);
+  grpc_pollset_set_members_destroy(&pollset_set->children);
+  grpc_pollset_set_members_destroy(&pollset_set->fds);
   gpr_free(pollset_set);
 }
 
@@ -1803,37 +1927,20 @@ static void pollset_set_add_fd(grpc_exec_ctx *exec_ctx,
                                grpc_pollset_set *pollset_set, grpc_fd *fd) {
   size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  if (pollset_set->fd_count == pollset_set->fd_capacity) {
-    pollset_set->fd_capacity = GPR_MAX(8, 2 * pollset_set->fd_capacity);
-    pollset_set->fds = gpr_realloc(
-        pollset_set->fds, pollset_set->fd_capacity * sizeof(*pollset_set->fds));
-  }
-  GRPC_FD_REF(fd, "pollset_set");
-  pollset_set->fds[pollset_set->fd_count++] = fd;
-  for (i = 0; i < pollset_set->pollset_count; i++) {
-    pollset_add_fd(exec_ctx, pollset_set->pollsets[i], fd);
-  }
-  for (i = 0; i < pollset_set->pollset_set_count; i++) {
-    pollset_set_add_fd(exec_ctx, pollset_set->pollset_sets[i], fd);
+  if (grpc_pollset_set_members_add(&pollset_set->fds, fd)) {
+    GRPC_FD_REF(fd, "pollset_set");
+    for (i = 0; i < pollset_set->pollsets.count; i++) {
+      pollset_add_fd(exec_ctx, pollset_set->pollsets.members[i].member, fd);
+    }
   }
   gpr_mu_unlock(&pollset_set->mu);
 }
 
 static void pollset_set_del_fd(grpc_exec_ctx *exec_ctx,
                                grpc_pollset_set *pollset_set, grpc_fd *fd) {
-  size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  for (i = 0; i < pollset_set->fd_count; i++) {
-    if (pollset_set->fds[i] == fd) {
-      pollset_set->fd_count--;
-      GPR_SWAP(grpc_fd *, pollset_set->fds[i],
-               pollset_set->fds[pollset_set->fd_count]);
-      GRPC_FD_UNREF(fd, "pollset_set");
-      break;
-    }
-  }
-  for (i = 0; i < pollset_set->pollset_set_count; i++) {
-    pollset_set_del_fd(exec_ctx, pollset_set->pollset_sets[i], fd);
+  if (grpc_pollset_set_members_del(&pollset_set->fds, fd)) {
+    GRPC_FD_UNREF(fd, "pollset_set");
   }
   gpr_mu_unlock(&pollset_set->mu);
 }
@@ -1841,25 +1948,24 @@ static void pollset_set_del_fd(grpc_exec_ctx *exec_ctx,
 static void pollset_set_add_pollset(grpc_exec_ctx *exec_ctx,
                                     grpc_pollset_set *pollset_set,
                                     grpc_pollset *pollset) {
-  size_t i, j;
+  size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  if (pollset_set->pollset_count == pollset_set->pollset_capacity) {
-    pollset_set->pollset_capacity =
-        GPR_MAX(8, 2 * pollset_set->pollset_capacity);
-    pollset_set->pollsets =
-        gpr_realloc(pollset_set->pollsets, pollset_set->pollset_capacity *
-                                               sizeof(*pollset_set->pollsets));
-  }
-  pollset_set->pollsets[pollset_set->pollset_count++] = pollset;
-  for (i = 0, j = 0; i < pollset_set->fd_count; i++) {
-    if (fd_is_orphaned(pollset_set->fds[i])) {
-      GRPC_FD_UNREF(pollset_set->fds[i], "pollset_set");
-    } else {
-      pollset_add_fd(exec_ctx, pollset, pollset_set->fds[i]);
-      pollset_set->fds[j++] = pollset_set->fds[i];
+  if (grpc_pollset_set_members_add(&pollset_set->pollsets, pollset)) {
+    for (i = 0; i < pollset_set->fds.count;) {
+      grpc_fd *fd = pollset_set->fds.members[i].member;
+      if (fd_is_orphaned(fd)) {
+        grpc_pollset_set_members_remove_at(&pollset_set->fds, i);
+        GRPC_FD_UNREF(fd, "pollset_set");
+      } else {
+        pollset_add_fd(exec_ctx, pollset, fd);
+        i++;
+      }
+    }
+    for (i = 0; i < pollset_set->parents.count; i++) {
+      pollset_set_add_pollset(exec_ctx, pollset_set->parents.members[i].member,
+                              pollset);
     }
   }
-  pollset_set->fd_count = j;
   gpr_mu_unlock(&pollset_set->mu);
 }
 
@@ -1868,12 +1974,10 @@ static void pollset_set_del_pollset(grpc_exec_ctx *exec_ctx,
                                     grpc_pollset *pollset) {
   size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  for (i = 0; i < pollset_set->pollset_count; i++) {
-    if (pollset_set->pollsets[i] == pollset) {
-      pollset_set->pollset_count--;
-      GPR_SWAP(grpc_pollset *, pollset_set->pollsets[i],
-               pollset_set->pollsets[pollset_set->pollset_count]);
-      break;
+  if (grpc_pollset_set_members_del(&pollset_set->pollsets, pollset)) {
+    for (i = 0; i < pollset_set->parents.count; i++) {
+      pollset_set_del_pollset(exec_ctx, pollset_set->parents.members[i].member,
+                              pollset);
     }
   }
   gpr_mu_unlock(&pollset_set->mu);
@@ -1882,41 +1986,33 @@ static void pollset_set_del_pollset(grpc_exec_ctx *exec_ctx,
 static void pollset_set_add_pollset_set(grpc_exec_ctx *exec_ctx,
                                         grpc_pollset_set *bag,
                                         grpc_pollset_set *item) {
-  size_t i, j;
+  size_t i;
+  gpr_mu_lock(&item->mu);
   gpr_mu_lock(&bag->mu);
-  if (bag->pollset_set_count == bag->pollset_set_capacity) {
-    bag->pollset_set_capacity = GPR_MAX(8, 2 * bag->pollset_set_capacity);
-    bag->pollset_sets =
-        gpr_realloc(bag->pollset_sets,
-                    bag->pollset_set_capacity * sizeof(*bag->pollset_sets));
-  }
-  bag->pollset_sets[bag->pollset_set_count++] = item;
-  for (i = 0, j = 0; i < bag->fd_count; i++) {
-    if (fd_is_orphaned(bag->fds[i])) {
-      GRPC_FD_UNREF(bag->fds[i], "pollset_set");
-    } else {
-      pollset_set_add_fd(exec_ctx, item, bag->fds[i]);
-      bag->fds[j++] = bag->fds[i];
+  grpc_pollset_set_members_add(&bag->children, item);
+  gpr_mu_unlock(&bag->mu);
+  if (grpc_pollset_set_members_add(&item->parents, bag)) {
+    for (i = 0; i < item->pollsets.count; i++) {
+      pollset_set_add_pollset(exec_ctx, bag, item->pollsets.members[i].member);
     }
   }
-  bag->fd_count = j;
-  gpr_mu_unlock(&bag->mu);
+  gpr_mu_unlock(&item->mu);
 }
 
 static void pollset_set_del_pollset_set(grpc_exec_ctx *exec_ctx,
                                         grpc_pollset_set *bag,
                                         grpc_pollset_set *item) {
   size_t i;
+  gpr_mu_lock(&item->mu);
   gpr_mu_lock(&bag->mu);
-  for (i = 0; i < bag->pollset_set_count; i++) {
-    if (bag->pollset_sets[i] == item) {
-      bag->pollset_set_count--;
-      GPR_SWAP(grpc_pollset_set *, bag->pollset_sets[i],
-               bag->pollset_sets[bag->pollset_set_count]);
-      break;
+  grpc_pollset_set_members_del(&bag->children, item);
+  gpr_mu_unlock(&bag->mu);
+  if (grpc_pollset_set_members_del(&item->parents, bag)) {
+    for (i = 0; i < item->pollsets.count; i++) {
+      pollset_set_del_pollset(exec_ctx, bag, item->pollsets.members[i].member);
     }
   }
-  gpr_mu_unlock(&bag->mu);
+  gpr_mu_unlock(&item->mu);
 }
 
 /* Test helper functions
@@ -52,6 +52,7 @@
 #include <grpc/support/useful.h>
 
 #include "src/core/lib/iomgr/iomgr_internal.h"
+#include "src/core/lib/iomgr/pollset_set_members.h"
 #include "src/core/lib/iomgr/wakeup_fd_cv.h"
 #include "src/core/lib/iomgr/wakeup_fd_posix.h"
 #include "src/core/lib/profiling/timers.h"
@@ -200,9 +201,6 @@ struct grpc_pollset {
 static void pollset_add_fd(grpc_exec_ctx *exec_ctx, grpc_pollset *pollset,
                            struct grpc_fd *fd);
 
-static void pollset_set_add_fd(grpc_exec_ctx *exec_ctx,
-                               grpc_pollset_set *pollset_set, grpc_fd *fd);
-
 /* Convert a timespec to milliseconds:
    - very small or negative poll times are clamped to zero to do a
      non-blocking poll (which becomes spin polling)
@@ -234,17 +232,18 @@ static int pollset_has_workers(grpc_pollset *pollset);
 struct grpc_pollset_set {
   gpr_mu mu;
 
-  size_t pollset_count;
-  size_t pollset_capacity;
-  grpc_pollset **pollsets;
-
-  size_t pollset_set_count;
-  size_t pollset_set_capacity;
-  struct grpc_pollset_set **pollset_sets;
-
-  size_t fd_count;
-  size_t fd_capacity;
-  grpc_fd **fds;
+  /* Rather than handing its fds down to the pollset_sets added to it, a
+     pollset_set takes on the pollsets of those sets. So pollsets holds the
+     pollsets added to this set or to any set below it, and each is counted
+     once for being added here and once for each child set that has it.
+     Locks are always taken child before parent. */
+  grpc_pollset_set_members pollsets;
+  /* the pollset_sets this one has been added to */
+  grpc_pollset_set_members parents;
+  /* the pollset_sets added to this one, so that it can take itself out of
+     their parents when it is destroyed before they are deleted from it */
+  grpc_pollset_set_members children;
+  grpc_pollset_set_members fds;
 };
 
 /*******************************************************************************
@@ -1129,45 +1128,57 @@ static int poll_deadline_to_millis_timeout(gpr_timespec deadline,
 
 static grpc_pollset_set *pollset_set_create(void) {
   grpc_pollset_set *pollset_set = gpr_malloc(sizeof(*pollset_set));
-  memset(pollset_set, 0, sizeof(*pollset_set));
   gpr_mu_init(&pollset_set->mu);
+  grpc_pollset_set_members_init(&pollset_set->pollsets);
+  grpc_pollset_set_members_init(&pollset_set->parents);
+  grpc_pollset_set_members_init(&pollset_set->children);
+  grpc_pollset_set_members_init(&pollset_set->fds);
   return pollset_set;
 }
 
 static void pollset_set_destroy(grpc_pollset_set *pollset_set) {
   size_t i;
+  /* a set still added to a parent would be left in its children, and locked
+     by the parent's destroy after being freed */
+  GPR_ASSERT(pollset_set->parents.count == 0);
+  for (i = 0; i < pollset_set->children.count; i++) {
+    grpc_pollset_set *child = pollset_set->children.members[i].member;
+    gpr_mu_lock(&child->mu);
+    grpc_pollset_set_members_remove(&child->parents, pollset_set);
+    gpr_mu_unlock(&child->mu);
+  }
   gpr_mu_destroy(&pollset_set->mu);
-  for (i = 0; i < pollset_set->fd_count; i++) {
-    GRPC_FD_UNREF(pollset_set->fds[i], "pollset_set");
+  for (i = 0; i < pollset_set->fds.count; i++) {
+    GRPC_FD_UNREF(pollset_set->fds.members[i].member, "pollset_set");
   }
-  gpr_free(pollset_set->pollsets);
-  gpr_free(pollset_set->pollset_sets);
-  gpr_free(pollset_set->fds);
+  grpc_pollset_set_members_destroy(&pollset_set->pollsets);
+  grpc_pollset_set_members_destroy(&pollset_set->parents);
+  grpc_pollset_set_members_destroy(&pollset_set->children);
+  grpc_pollset_set_members_destroy(&pollset_set->fds);
   gpr_free(pollset_set);
 }
 
 static void pollset_set_add_pollset(grpc_exec_ctx *exec_ctx,
                                     grpc_pollset_set *pollset_set,
                                     grpc_pollset *pollset) {
-  size_t i, j;
+  size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  if (pollset_set->pollset_count == pollset_set->pollset_capacity) {
-    pollset_set->pollset_capacity =
-        GPR_MAX(8, 2 * pollset_set->pollset_capacity);
-    pollset_set->pollsets =
-        gpr_realloc(pollset_set->pollsets, pollset_set->pollset_capacity *
-                                               sizeof(*pollset_set->pollsets));
-  }
-  pollset_set->pollsets[pollset_set->pollset_count++] = pollset;
-  for (i = 0, j = 0; i < pollset_set->fd_count; i++) {
-    if (fd_is_orphaned(pollset_set->fds[i])) {
-      GRPC_FD_UNREF(pollset_set->fds[i], "pollset_set");
-    } else {
-      pollset_add_fd(exec_ctx, pollset, pollset_set->fds[i]);
-      pollset_set->fds[j++] = pollset_set->fds[i];
+  if (grpc_pollset_set_members_add(&pollset_set->pollsets, pollset)) {
+    for (i = 0; i < pollset_set->fds.count;) {
+      grpc_fd *fd = pollset_set->fds.members[i].member;
+      if (fd_is_orphaned(fd)) {
+        grpc_pollset_set_members_remove_at(&pollset_set->fds, i);
+        GRPC_FD_UNREF(fd, "pollset_set");
+      } else {
+        pollset_add_fd(exec_ctx, pollset, fd);
+        i++;
+      }
+    }
+    for (i = 0; i < pollset_set->parents.count; i++) {
+      pollset_set_add_pollset(exec_ctx, pollset_set->parents.members[i].member,
+                              pollset);
     }
   }
-  pollset_set->fd_count = j;
   gpr_mu_unlock(&pollset_set->mu);
 }
 
@@ -1176,12 +1187,10 @@ static void pollset_set_del_pollset(grpc_exec_ctx *exec_ctx,
                                     grpc_pollset *pollset) {
   size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  for (i = 0; i < pollset_set->pollset_count; i++) {
-    if (pollset_set->pollsets[i] == pollset) {
-      pollset_set->pollset_count--;
-      GPR_SWAP(grpc_pollset *, pollset_set->pollsets[i],
-               pollset_set->pollsets[pollset_set->pollset_count]);
-      break;
+  if (grpc_pollset_set_members_del(&pollset_set->pollsets, pollset)) {
+    for (i = 0; i < pollset_set->parents.count; i++) {
+      pollset_set_del_pollset(exec_ctx, pollset_set->parents.members[i].member,
+                              pollset);
     }
   }
   gpr_mu_unlock(&pollset_set->mu);
@@ -1190,78 +1199,53 @@ static void pollset_set_del_pollset(grpc_exec_ctx *exec_ctx,
 static void pollset_set_add_pollset_set(grpc_exec_ctx *exec_ctx,
                                         grpc_pollset_set *bag,
                                         grpc_pollset_set *item) {
-  size_t i, j;
+  size_t i;
+  gpr_mu_lock(&item->mu);
   gpr_mu_lock(&bag->mu);
-  if (bag->pollset_set_count == bag->pollset_set_capacity) {
-    bag->pollset_set_capacity = GPR_MAX(8, 2 * bag->pollset_set_capacity);
-    bag->pollset_sets =
-        gpr_realloc(bag->pollset_sets,
-                    bag->pollset_set_capacity * sizeof(*bag->pollset_sets));
-  }
-  bag->pollset_sets[bag->pollset_set_count++] = item;
-  for (i = 0, j = 0; i < bag->fd_count; i++) {
-    if (fd_is_orphaned(bag->fds[i])) {
-      GRPC_FD_UNREF(bag->fds[i], "pollset_set");
-    } else {
-      pollset_set_add_fd(exec_ctx, item, bag->fds[i]);
-      bag->fds[j++] = bag->fds[i];
+  grpc_pollset_set_members_add(&bag->children, item);
+  gpr_mu_unlock(&bag->mu);
+  if (grpc_pollset_set_members_add(&item->parents, bag)) {
+    for (i = 0; i < item->pollsets.count; i++) {
+      pollset_set_add_pollset(exec_ctx, bag, item->pollsets.members[i].member);
     }
   }
-  bag->fd_count = j;
-  gpr_mu_unlock(&bag->mu);
+  gpr_mu_unlock(&item->mu);
 }
 
 static void pollset_set_del_pollset_set(grpc_exec_ctx *exec_ctx,
                                         grpc_pollset_set *bag,
                                         grpc_pollset_set *item) {
   size_t i;
+  gpr_mu_lock(&item->mu);
   gpr_mu_lock(&bag->mu);
-  for (i = 0; i < bag->pollset_set_count; i++) {
-    if (bag->pollset_sets[i] == item) {
-      bag->pollset_set_count--;
-      GPR_SWAP(grpc_pollset_set *, bag->pollset_sets[i],
-               bag->pollset_sets[bag->pollset_set_count]);
-      break;
+  grpc_pollset_set_members_del(&bag->children, item);
+  gpr_mu_unlock(&bag->mu);
+  if (grpc_pollset_set_members_del(&item->parents, bag)) {
+    for (i = 0; i < item->pollsets.count; i++) {
+      pollset_set_del_pollset(exec_ctx, bag, item->pollsets.members[i].member);
     }
   }
-  gpr_mu_unlock(&bag->mu);
+  gpr_mu_unlock(&item->mu);
 }
 
 static void pollset_set_add_fd(grpc_exec_ctx *exec_ctx,
                                grpc_pollset_set *pollset_set, grpc_fd *fd) {
   size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  if (pollset_set->fd_count == pollset_set->fd_capacity) {
-    pollset_set->fd_capacity = GPR_MAX(8, 2 * pollset_set->fd_capacity);
-    pollset_set->fds = gpr_realloc(
-        pollset_set->fds, pollset_set->fd_capacity * sizeof(*pollset_set->fds));
-  }
-  GRPC_FD_REF(fd, "pollset_set");
-  pollset_set->fds[pollset_set->fd_count++] = fd;
-  for (i = 0; i < pollset_set->pollset_count; i++) {
-    pollset_add_fd(exec_ctx, pollset_set->pollsets[i], fd);
-  }
-  for (i = 0; i < pollset_set->pollset_set_count; i++) {
-    pollset_set_add_fd(exec_ctx, pollset_set->pollset_sets[i], fd);
+  if (grpc_pollset_set_members_add(&pollset_set->fds, fd)) {
+    GRPC_FD_REF(fd, "pollset_set");
+    for (i = 0; i < pollset_set->pollsets.count; i++) {
+      pollset_add_fd(exec_ctx, pollset_set->pollsets.members[i].member, fd);
+    }
   }
   gpr_mu_unlock(&pollset_set->mu);
 }
 
 static void pollset_set_del_fd(grpc_exec_ctx *exec_ctx,
                                grpc_pollset_set *pollset_set, grpc_fd *fd) {
-  size_t i;
   gpr_mu_lock(&pollset_set->mu);
-  for (i = 0; i < pollset_set->fd_count; i++) {
-    if (pollset_set->fds[i] == fd) {
-      pollset_set->fd_count--;
-      GPR_SWAP(grpc_fd *, pollset_set->fds[i],
-               pollset_set->fds[pollset_set->fd_count]);
-      GRPC_FD_UNREF(fd, "pollset_set");
-      break;
-    }
-  }
-  for (i = 0; i < pollset_set->pollset_set_count; i++) {
-    pollset_set_del_fd(exec_ctx, pollset_set->pollset_sets[i], fd);
+  if (grpc_pollset_set_members_del(&pollset_set->fds, fd)) {
+    GRPC_FD_UNREF(fd, "pollset_set");
   }
   gpr_mu_unlock(&pollset_set->mu);
 }
@@ -39,7 +39,10 @@
 /* A grpc_pollset_set is a set of pollsets that are interested in an
    action. Adding a pollset to a pollset_set automatically adds any
    fd's (etc) that have been registered with the set_set to that pollset.
-   Registering fd's automatically adds them to all current pollsets. */
+   Registering fd's automatically adds them to all current pollsets.
+
+   A pollset_set must be deleted from every pollset_set it was added to before
+   it is destroyed. Those it was added to may be destroyed first. */
 
 typedef struct grpc_pollset_set grpc_pollset_set;
 
@@ -0,0 +1,164 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/lib/iomgr/pollset_set_members.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/useful.h>
+
+/* sets up to this size are searched linearly, without an index */
+#define MAX_UNINDEXED_MEMBERS 8
+
+static size_t hash_member(void *member) {
+  /* the finalizer of MurmurHash3: members are pointers, whose low bits are
+     mostly zero */
+  uint64_t h = (uint64_t)(uintptr_t)member;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return (size_t)h;
+}
+
+/* the slot holding member, or the empty slot it would go into */
+static size_t find_slot(const grpc_pollset_set_members *m, void *member) {
+  size_t mask = m->slot_count - 1;
+  size_t slot = hash_member(member) & mask;
+  while (m->slots[slot] != 0 &&
+         m->members[m->slots[slot] - 1].member != member) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+/* the index of member in m->members, or m->count if it is not there */
+static size_t find_index(const grpc_pollset_set_members *m, void *member) {
+  size_t i;
+  if (m->slots == NULL) {
+    for (i = 0; i < m->count && m->members[i].member != member; i++) {
+    }
+    return i;
+  }
+  i = m->slots[find_slot(m, member)];
+  return i == 0 ? m->count : i - 1;
+}
+
+static void rebuild_index(grpc_pollset_set_members *m) {
+  size_t i;
+  gpr_free(m->slots);
+  /* capacity is a power of two, and the index is kept at most half full */
+  m->slot_count = 2 * m->capacity;
+  m->slots = gpr_malloc(m->slot_count * sizeof(*m->slots));
+  memset(m->slots, 0, m->slot_count * sizeof(*m->slots));
+  for (i = 0; i < m->count; i++) {
+    m->slots[find_slot(m, m->members[i].member)] = i + 1;
+  }
+}
+
+/* empties slot, moving later entries of its probe sequence back so that
+   lookups never stop early at the hole */
+static void erase_slot(grpc_pollset_set_members *m, size_t slot) {
+  size_t mask = m->slot_count - 1;
+  size_t hole = slot;
+  m->slots[hole] = 0;
+  for (;;) {
+    size_t home;
+    slot = (slot + 1) & mask;
+    if (m->slots[slot] == 0) return;
+    home = hash_member(m->members[m->slots[slot] - 1].member) & mask;
+    /* the entry can fill the hole unless its home slot lies between the hole
+       and where it is now */
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      m->slots[hole] = m->slots[slot];
+      m->slots[slot] = 0;
+      hole = slot;
+    }
+  }
+}
+
+void grpc_pollset_set_members_init(grpc_pollset_set_members *m) {
+  memset(m, 0, sizeof(*m));
+}
+
+void grpc_pollset_set_members_destroy(grpc_pollset_set_members *m) {
+  gpr_free(m->members);
+  gpr_free(m->slots);
+}
+
+bool grpc_pollset_set_members_add(grpc_pollset_set_members *m, void *member) {
+  size_t i = find_index(m, member);
+  if (i < m->count) {
+    m->members[i].count++;
+    return false;
+  }
+  if (m->count == m->capacity) {
+    m->capacity = GPR_MAX(MAX_UNINDEXED_MEMBERS, 2 * m->capacity);
+    m->members = gpr_realloc(m->members, m->capacity * sizeof(*m->members));
+    if (m->capacity > MAX_UNINDEXED_MEMBERS) rebuild_index(m);
+  }
+  m->members[m->count].member = member;
+  m->members[m->count].count = 1;
+  m->count++;
+  if (m->slots != NULL) m->slots[find_slot(m, member)] = m->count;
+  return true;
+}
+
+bool grpc_pollset_set_members_del(grpc_pollset_set_members *m, void *member) {
+  size_t i = find_index(m, member);
+  if (i == m->count || --m->members[i].count > 0) return false;
+  grpc_pollset_set_members_remove_at(m, i);
+  return true;
+}
+
+bool grpc_pollset_set_members_remove(grpc_pollset_set_members *m,
+                                     void *member) {
+  size_t i = find_index(m, member);
+  if (i == m->count) return false;
+  grpc_pollset_set_members_remove_at(m, i);
+  return true;
+}
+
+void grpc_pollset_set_members_remove_at(grpc_pollset_set_members *m,
+                                        size_t index) {
+  size_t last = m->count - 1;
+  if (m->slots != NULL) {
+    erase_slot(m, find_slot(m, m->members[index].member));
+    if (index != last) {
+      m->slots[find_slot(m, m->members[last].member)] = index + 1;
+    }
+  }
+  m->members[index] = m->members[last];
+  m->count = last;
+}
@@ -0,0 +1,87 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_IOMGR_POLLSET_SET_MEMBERS_H
+#define GRPC_CORE_LIB_IOMGR_POLLSET_SET_MEMBERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* The members of one kind (pollsets, parent pollset_sets or fds) of a posix
+   pollset_set.
+
+   Members are counted: adding a member that is already there only bumps its
+   count, and it leaves the set once it has been deleted as many times as it
+   was added. A pollset_set uses this to stop passing a pollset up to its
+   parents when it already had it from somewhere else.
+
+   Members are kept in a dense array that can be walked by index. Small sets
+   are searched linearly; larger ones keep an open addressed index beside the
+   array, so adding and deleting stay O(1) for sets with tens of thousands of
+   members. */
+
+typedef struct {
+  void *member;
+  size_t count;
+} grpc_pollset_set_member;
+
+typedef struct {
+  grpc_pollset_set_member *members;
+  size_t count;
+  size_t capacity;
+  /* for each slot, the index into members plus one, or zero if the slot is
+     empty; NULL while the set is small enough to scan */
+  size_t *slots;
+  size_t slot_count;
+} grpc_pollset_set_members;
+
+void grpc_pollset_set_members_init(grpc_pollset_set_members *m);
+void grpc_pollset_set_members_destroy(grpc_pollset_set_members *m);
+
+/* Adds one count of member: returns true if it was not in the set before */
+bool grpc_pollset_set_members_add(grpc_pollset_set_members *m, void *member);
+
+/* Drops one count of member: returns true if that took it out of the set */
+bool grpc_pollset_set_members_del(grpc_pollset_set_members *m, void *member);
+
+/* Takes member out of the set whatever its count: returns true if it was
+   there */
+bool grpc_pollset_set_members_remove(grpc_pollset_set_members *m,
+                                     void *member);
+
+/* Takes the member at index out of the set whatever its count; the last
+   member moves to index */
+void grpc_pollset_set_members_remove_at(grpc_pollset_set_members *m,
+                                        size_t index);
+
+#endif /* GRPC_CORE_LIB_IOMGR_POLLSET_SET_MEMBERS_H */
@@ -0,0 +1,100 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_IOMGR_SHM_ENDPOINT_H
+#define GRPC_CORE_LIB_IOMGR_SHM_ENDPOINT_H
+/*
+   Shared memory endpoint: a byte stream between two processes on the same
+   host that never goes through the kernel. Each direction is a single
+   producer/single consumer ring buffer in a memfd mapped by both processes.
+   A side only sleeps (on an eventfd) when its ring is empty for reading or
+   full for writing, and its peer only signals the eventfd when told the side
+   is asleep, so a busy connection moves bytes without any system calls.
+
+   The connection is set up over an existing unix socket tcp endpoint, the
+   'control' endpoint: the client passes the memfd and the eventfds to the
+   server in a bootstrap message. The control endpoint then stays open for as
+   long as the shm endpoint, so that each side notices the other going away.
+
+   Neither side trusts the other: the server only accepts a memfd sealed
+   against resizing and descriptors that really are eventfds, and a ring
+   position the peer publishes that is out of range fails the endpoint.
+*/
+
+#include <stdbool.h>
+
+#include <grpc/support/slice_buffer.h>
+
+#include "src/core/lib/iomgr/endpoint.h"
+
+#define GRPC_SHM_DEFAULT_RING_SIZE (1024 * 1024)
+#define GRPC_SHM_MIN_RING_SIZE (4 * 1024)
+#define GRPC_SHM_MAX_RING_SIZE (256 * 1024 * 1024)
+
+typedef enum {
+  /* not enough bytes yet to tell */
+  GRPC_SHM_BOOTSTRAP_INCOMPLETE,
+  /* the bytes start with a bootstrap message */
+  GRPC_SHM_BOOTSTRAP_MATCH,
+  /* the bytes are something else: the client speaks plain HTTP/2 */
+  GRPC_SHM_BOOTSTRAP_MISMATCH
+} grpc_shm_bootstrap_status;
+
+/* Returns true if shm endpoints are available on this platform */
+bool grpc_shm_endpoint_supported(void);
+
+/* Client side: set up a connection with rings of ring_size bytes (rounded up
+   to a power of two) and send its bootstrap message over control, which must
+   be a tcp endpoint over a unix socket with nothing written to it yet.
+   On success sets *ep, which takes ownership of control. */
+grpc_error *grpc_shm_endpoint_connect(grpc_exec_ctx *exec_ctx,
+                                      grpc_endpoint *control, size_t ring_size,
+                                      grpc_endpoint **ep);
+
+/* Server side: have control keep the descriptors a bootstrap message
+   carries. Call before reading from it. */
+void grpc_shm_endpoint_prepare_accept(grpc_endpoint *control);
+
+/* Server side: check whether the first bytes read from a control endpoint
+   are a bootstrap message */
+grpc_shm_bootstrap_status grpc_shm_check_bootstrap(gpr_slice_buffer *buffer);
+
+/* Server side: complete the connection whose bootstrap message (as matched by
+   grpc_shm_check_bootstrap) is in buffer, which is emptied.
+   On success sets *ep, which takes ownership of control. */
+grpc_error *grpc_shm_endpoint_accept(grpc_exec_ctx *exec_ctx,
+                                     grpc_endpoint *control,
+                                     gpr_slice_buffer *buffer,
+                                     grpc_endpoint **ep);
+
+#endif /* GRPC_CORE_LIB_IOMGR_SHM_ENDPOINT_H */
@@ -0,0 +1,776 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#ifdef GPR_LINUX_EVENTFD
+
+#include "src/core/lib/iomgr/shm_endpoint.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/log.h>
+#include <grpc/support/string_util.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/tcp_posix.h"
+#include "src/core/lib/profiling/timers.h"
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS 1033
+#define F_GET_SEALS 1034
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#endif
+
+/* Seals the memfd must carry, so that neither side can truncate the region
+   under the other's mapping */
+#define REQUIRED_SEALS (F_SEAL_SHRINK | F_SEAL_GROW)
+
+#define BOOTSTRAP_MAGIC "GRPC-SHM"
+#define BOOTSTRAP_MAGIC_LENGTH 8
+#define BOOTSTRAP_VERSION 1
+/* magic, version, ring size */
+#define BOOTSTRAP_LENGTH (BOOTSTRAP_MAGIC_LENGTH + 4 + 4)
+
+/* Eventfds passed in the bootstrap message, after the memfd. Ring 0 carries
+   data from the client to the server, ring 1 from the server to the client.
+   The producer of a ring signals its data eventfd, the consumer its space
+   eventfd. */
+#define RING_DATA_EVENTFD(ring) (2 * (ring))
+#define RING_SPACE_EVENTFD(ring) (2 * (ring) + 1)
+#define NUM_EVENTFDS 4
+
+/* Shared ring state, at the start of each ring's part of the mapping.
+   Positions count the bytes ever written and read, so the ring holds
+   write_pos - read_pos bytes. The peer can store anything here, so a
+   position it publishes is only trusted once it is within the ring size of
+   our own. */
+typedef struct {
+  /* advanced by the producer only */
+  gpr_atm write_pos;
+  char pad0[GPR_CACHELINE_SIZE - sizeof(gpr_atm)];
+  /* advanced by the consumer only */
+  gpr_atm read_pos;
+  char pad1[GPR_CACHELINE_SIZE - sizeof(gpr_atm)];
+  /* set by the consumer before sleeping on the data eventfd */
+  gpr_atm reader_waiting;
+  /* set by the producer before sleeping on the space eventfd */
+  gpr_atm writer_waiting;
+  /* set by either side once it is done with the connection */
+  gpr_atm closed;
+  char pad2[GPR_CACHELINE_SIZE - 3 * sizeof(gpr_atm)];
+} shm_ring_header;
+
+typedef struct {
+  shm_ring_header *header;
+  uint8_t *data;
+  size_t size;
+  /* the position we advance: read_pos for rx, write_pos for tx. The shared
+     copy is only ever published, never read back. */
+  size_t pos;
+} shm_ring;
+
+typedef struct {
+  grpc_endpoint base;
+  gpr_refcount refcount;
+  char *peer_string;
+
+  void *map;
+  size_t map_size;
+  shm_ring rx;
+  shm_ring tx;
+
+  /* signalled by the peer when rx gets data, or is closed */
+  grpc_fd *rx_data_fd;
+  /* signalled by the peer when tx gets space, or is closed */
+  grpc_fd *tx_space_fd;
+  /* the peer's counterparts, signalled by us */
+  int peer_data_fd;
+  int peer_space_fd;
+
+  /* the unix socket the connection was set up over; reading it only ever
+     yields the peer going away */
+  grpc_endpoint *control;
+  gpr_slice_buffer control_buffer;
+  grpc_closure control_read_closure;
+
+  gpr_slice_buffer *incoming_buffer;
+  grpc_closure *read_cb;
+  bool read_armed;
+  grpc_closure read_closure;
+
+  gpr_slice_buffer *outgoing_buffer;
+  /** slice within outgoing_buffer to write next */
+  size_t outgoing_slice_idx;
+  /** byte within outgoing_buffer->slices[outgoing_slice_idx] to write next */
+  size_t outgoing_byte_idx;
+  grpc_closure *write_cb;
+  bool write_armed;
+  grpc_closure write_closure;
+} grpc_shm_endpoint;
+
+static size_t map_size_for_ring(size_t ring_size) {
+  return 2 * (sizeof(shm_ring_header) + ring_size);
+}
+
+static void ring_init(shm_ring *ring, void *map, size_t ring_size,
+                      int index) {
+  uint8_t *base =
+      (uint8_t *)map + (size_t)index * (sizeof(shm_ring_header) + ring_size);
+  ring->header = (shm_ring_header *)base;
+  ring->data = base + sizeof(shm_ring_header);
+  ring->size = ring_size;
+  ring->pos = 0;
+}
+
+/* Sets *avail to the bytes the peer has written to ring. Returns false if
+   its write position is behind our read position or more than a ring ahead
+   of it. */
+static bool ring_readable(shm_ring *ring, size_t *avail) {
+  *avail = (size_t)gpr_atm_acq_load(&ring->header->write_pos) - ring->pos;
+  return *avail <= ring->size;
+}
+
+/* Sets *space to the bytes that can be written to ring. Returns false if the
+   peer's read position is ahead of our write position or more than a ring
+   behind it. */
+static bool ring_writable(shm_ring *ring, size_t *space) {
+  size_t used = ring->pos - (size_t)gpr_atm_acq_load(&ring->header->read_pos);
+  *space = ring->size - used;
+  return used <= ring->size;
+}
+
+static grpc_error *ring_corrupted_error(void) {
+  return GRPC_ERROR_CREATE("Shared memory ring positions are inconsistent");
+}
+
+static bool ring_closed(shm_ring *ring) {
+  return gpr_atm_acq_load(&ring->header->closed) != 0;
+}
+
+static void signal_eventfd(int fd) {
+  int err;
+  do {
+    err = eventfd_write(fd, 1);
+  } while (err < 0 && errno == EINTR);
+  /* EAGAIN means the counter is saturated: the peer will wake up anyway */
+}
+
+static void drain_eventfd(grpc_fd *fd) {
+  eventfd_t value;
+  int err;
+  do {
+    err = eventfd_read(grpc_fd_wrapped_fd(fd), &value);
+  } while (err < 0 && errno == EINTR);
+}
+
+/* Called after moving one of our positions: if the peer went to sleep waiting
+   for that, wake it up. The full barrier pairs with the one the peer issues
+   between setting its waiting flag and looking at our position one last
+   time, so that either it sees the move or we see the flag. */
+static void wake_peer(gpr_atm *waiting, int fd) {
+  gpr_atm_full_barrier();
+  if (gpr_atm_no_barrier_load(waiting) && gpr_atm_full_xchg(waiting, 0)) {
+    signal_eventfd(fd);
+  }
+}
+
+static void close_rings(grpc_shm_endpoint *shm) {
+  gpr_atm_rel_store(&shm->tx.header->closed, 1);
+  gpr_atm_rel_store(&shm->rx.header->closed, 1);
+  signal_eventfd(shm->peer_data_fd);
+  signal_eventfd(shm->peer_space_fd);
+}
+
+static void shm_free(grpc_exec_ctx *exec_ctx, grpc_shm_endpoint *shm) {
+  grpc_fd_orphan(exec_ctx, shm->rx_data_fd, NULL, NULL, "shm_endpoint");
+  grpc_fd_orphan(exec_ctx, shm->tx_space_fd, NULL, NULL, "shm_endpoint");
+  close(shm->peer_data_fd);
+  close(shm->peer_space_fd);
+  munmap(shm->map, shm->map_size);
+  grpc_endpoint_destroy(exec_ctx, shm->control);
+  gpr_slice_buffer_destroy(&shm->control_buffer);
+  gpr_free(shm->peer_string);
+  gpr_free(shm);
+}
+
+static void shm_unref(grpc_exec_ctx *exec_ctx, grpc_shm_endpoint *shm) {
+  if (gpr_unref(&shm->refcount)) {
+    shm_free(exec_ctx, shm);
+  }
+}
+
+static void shm_ref(grpc_shm_endpoint *shm) { gpr_ref(&shm->refcount); }
+
+static void on_control_read(grpc_exec_ctx *exec_ctx, void *arg,
+                            grpc_error *error) {
+  grpc_shm_endpoint *shm = arg;
+  if (error == GRPC_ERROR_NONE) {
+    /* nothing is meant to be sent on the control socket any more */
+    gpr_slice_buffer_reset_and_unref(&shm->control_buffer);
+    grpc_endpoint_read(exec_ctx, shm->control, &shm->control_buffer,
+                       &shm->control_read_closure);
+    return;
+  }
+  /* the peer is gone, or we are shutting down: fail anything waiting */
+  grpc_fd_shutdown(exec_ctx, shm->rx_data_fd);
+  grpc_fd_shutdown(exec_ctx, shm->tx_space_fd);
+  shm_unref(exec_ctx, shm);
+}
+
+static void call_read_cb(grpc_exec_ctx *exec_ctx, grpc_shm_endpoint *shm,
+                         grpc_error *error) {
+  grpc_closure *cb = shm->read_cb;
+  shm->read_cb = NULL;
+  shm->incoming_buffer = NULL;
+  grpc_closure_run(exec_ctx, cb, error);
+  shm_unref(exec_ctx, shm);
+}
+
+static void shm_continue_read(grpc_exec_ctx *exec_ctx,
+                              grpc_shm_endpoint *shm) {
+  shm_ring *rx = &shm->rx;
+  size_t avail;
+  if (!ring_readable(rx, &avail)) goto corrupted;
+  if (avail == 0) {
+    gpr_atm_no_barrier_store(&rx->header->reader_waiting, 1);
+    gpr_atm_full_barrier();
+    if (!ring_readable(rx, &avail)) goto corrupted;
+    if (avail == 0 && !ring_closed(rx)) {
+      shm->read_armed = true;
+      grpc_fd_notify_on_read(exec_ctx, shm->rx_data_fd, &shm->read_closure);
+      return;
+    }
+    gpr_atm_full_xchg(&rx->header->reader_waiting, 0);
+    /* a close is published after the last write, so recheck */
+    if (!ring_readable(rx, &avail)) goto corrupted;
+    if (avail == 0) {
+      call_read_cb(exec_ctx, shm, GRPC_ERROR_CREATE("EOF"));
+      return;
+    }
+  }
+
+  GPR_TIMER_BEGIN("shm_continue_read", 0);
+  size_t offset = rx->pos & (rx->size - 1);
+  size_t first = GPR_MIN(avail, rx->size - offset);
+  gpr_slice slice = gpr_slice_malloc(avail);
+  memcpy(GPR_SLICE_START_PTR(slice), rx->data + offset, first);
+  memcpy(GPR_SLICE_START_PTR(slice) + first, rx->data, avail - first);
+  rx->pos += avail;
+  gpr_atm_rel_store(&rx->header->read_pos, (gpr_atm)rx->pos);
+  wake_peer(&rx->header->writer_waiting, shm->peer_space_fd);
+  gpr_slice_buffer_add(shm->incoming_buffer, slice);
+  GPR_TIMER_END("shm_continue_read", 0);
+  call_read_cb(exec_ctx, shm, GRPC_ERROR_NONE);
+  return;
+
+corrupted:
+  gpr_atm_no_barrier_store(&rx->header->reader_waiting, 0);
+  call_read_cb(exec_ctx, shm, ring_corrupted_error());
+}
+
+static void shm_handle_read(grpc_exec_ctx *exec_ctx, void *arg,
+                            grpc_error *error) {
+  grpc_shm_endpoint *shm = arg;
+  if (shm->read_armed) {
+    shm->read_armed = false;
+    drain_eventfd(shm->rx_data_fd);
+  }
+  if (error != GRPC_ERROR_NONE) {
+    gpr_slice_buffer_reset_and_unref(shm->incoming_buffer);
+    call_read_cb(exec_ctx, shm, GRPC_ERROR_REF(error));
+  } else {
+    shm_continue_read(exec_ctx, shm);
+  }
+}
+
+static void shm_read(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                     gpr_slice_buffer *incoming_buffer, grpc_closure *cb) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  GPR_ASSERT(shm->read_cb == NULL);
+  shm->read_cb = cb;
+  shm->incoming_buffer = incoming_buffer;
+  gpr_slice_buffer_reset_and_unref(incoming_buffer);
+  shm_ref(shm);
+  grpc_exec_ctx_sched(exec_ctx, &shm->read_closure, GRPC_ERROR_NONE, NULL);
+}
+
+/* copy as much of the outgoing buffer into tx as fits. Returns true if done,
+   false if pending; if returning true, *error is set */
+static bool shm_flush(grpc_shm_endpoint *shm, grpc_error **error) {
+  shm_ring *tx = &shm->tx;
+  gpr_slice_buffer *buf = shm->outgoing_buffer;
+  if (ring_closed(tx)) {
+    *error = GRPC_ERROR_CREATE("Shared memory connection closed");
+    return true;
+  }
+  size_t space;
+  if (!ring_writable(tx, &space)) {
+    *error = ring_corrupted_error();
+    return true;
+  }
+  if (space == 0) return false;
+
+  GPR_TIMER_BEGIN("shm_flush", 0);
+  size_t start = tx->pos;
+  size_t pos = start;
+  while (space > 0 && shm->outgoing_slice_idx < buf->count) {
+    gpr_slice slice = buf->slices[shm->outgoing_slice_idx];
+    size_t offset = pos & (tx->size - 1);
+    size_t n = GPR_MIN(GPR_SLICE_LENGTH(slice) - shm->outgoing_byte_idx,
+                       GPR_MIN(space, tx->size - offset));
+    memcpy(tx->data + offset,
+           GPR_SLICE_START_PTR(slice) + shm->outgoing_byte_idx, n);
+    pos += n;
+    space -= n;
+    shm->outgoing_byte_idx += n;
+    if (shm->outgoing_byte_idx == GPR_SLICE_LENGTH(slice)) {
+      shm->outgoing_slice_idx++;
+      shm->outgoing_byte_idx = 0;
+    }
+  }
+  if (pos != start) {
+    tx->pos = pos;
+    gpr_atm_rel_store(&tx->header->write_pos, (gpr_atm)pos);
+    wake_peer(&tx->header->reader_waiting, shm->peer_data_fd);
+  }
+  GPR_TIMER_END("shm_flush", 0);
+  if (shm->outgoing_slice_idx == buf->count) {
+    *error = GRPC_ERROR_NONE;
+    return true;
+  }
+  return false;
+}
+
+static void call_write_cb(grpc_exec_ctx *exec_ctx, grpc_shm_endpoint *shm,
+                          grpc_error *error) {
+  grpc_closure *cb = shm->write_cb;
+  shm->write_cb = NULL;
+  shm->outgoing_buffer = NULL;
+  grpc_exec_ctx_sched(exec_ctx, cb, error, NULL);
+  shm_unref(exec_ctx, shm);
+}
+
+static void shm_continue_write(grpc_exec_ctx *exec_ctx,
+                               grpc_shm_endpoint *shm) {
+  shm_ring *tx = &shm->tx;
+  grpc_error *error;
+  size_t space;
+  while (!shm_flush(shm, &error)) {
+    gpr_atm_no_barrier_store(&tx->header->writer_waiting, 1);
+    gpr_atm_full_barrier();
+    /* (if the positions are bad, the next flush reports it) */
+    if (ring_writable(tx, &space) && space == 0 && !ring_closed(tx)) {
+      shm->write_armed = true;
+      grpc_fd_notify_on_read(exec_ctx, shm->tx_space_fd, &shm->write_closure);
+      return;
+    }
+    gpr_atm_full_xchg(&tx->header->writer_waiting, 0);
+  }
+  call_write_cb(exec_ctx, shm, error);
+}
+
+static void shm_handle_write(grpc_exec_ctx *exec_ctx, void *arg,
+                             grpc_error *error) {
+  grpc_shm_endpoint *shm = arg;
+  if (shm->write_armed) {
+    shm->write_armed = false;
+    drain_eventfd(shm->tx_space_fd);
+  }
+  if (error != GRPC_ERROR_NONE) {
+    call_write_cb(exec_ctx, shm, GRPC_ERROR_REF(error));
+  } else {
+    shm_continue_write(exec_ctx, shm);
+  }
+}
+
+static void shm_write(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                      gpr_slice_buffer *buf, grpc_closure *cb) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  grpc_error *error;
+  GPR_ASSERT(shm->write_cb == NULL);
+  if (buf->length == 0) {
+    grpc_exec_ctx_sched(exec_ctx, cb, GRPC_ERROR_NONE, NULL);
+    return;
+  }
+  shm->outgoing_buffer = buf;
+  shm->outgoing_slice_idx = 0;
+  shm->outgoing_byte_idx = 0;
+  if (shm_flush(shm, &error)) {
+    shm->outgoing_buffer = NULL;
+    grpc_exec_ctx_sched(exec_ctx, cb, error, NULL);
+    return;
+  }
+  shm->write_cb = cb;
+  shm_ref(shm);
+  shm_continue_write(exec_ctx, shm);
+}
+
+static grpc_workqueue *shm_get_workqueue(grpc_endpoint *ep) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  return grpc_fd_get_workqueue(shm->rx_data_fd);
+}
+
+static void shm_add_to_pollset(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                               grpc_pollset *pollset) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  grpc_pollset_add_fd(exec_ctx, pollset, shm->rx_data_fd);
+  grpc_pollset_add_fd(exec_ctx, pollset, shm->tx_space_fd);
+  grpc_endpoint_add_to_pollset(exec_ctx, shm->control, pollset);
+}
+
+static void shm_add_to_pollset_set(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
+                                   grpc_pollset_set *pollset_set) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  grpc_pollset_set_add_fd(exec_ctx, pollset_set, shm->rx_data_fd);
+  grpc_pollset_set_add_fd(exec_ctx, pollset_set, shm->tx_space_fd);
+  grpc_endpoint_add_to_pollset_set(exec_ctx, shm->control, pollset_set);
+}
+
+static void shm_shutdown(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  close_rings(shm);
+  grpc_fd_shutdown(exec_ctx, shm->rx_data_fd);
+  grpc_fd_shutdown(exec_ctx, shm->tx_space_fd);
+  grpc_endpoint_shutdown(exec_ctx, shm->control);
+}
+
+static void shm_destroy(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  /* let the peer see end of stream, and stop watching the control socket */
+  close_rings(shm);
+  grpc_endpoint_shutdown(exec_ctx, shm->control);
+  shm_unref(exec_ctx, shm);
+}
+
+static char *shm_get_peer(grpc_endpoint *ep) {
+  grpc_shm_endpoint *shm = (grpc_shm_endpoint *)ep;
+  return gpr_strdup(shm->peer_string);
+}
+
+static const grpc_endpoint_vtable vtable = {shm_read,
+                                            shm_write,
+                                            shm_get_workqueue,
+                                            shm_add_to_pollset,
+                                            shm_add_to_pollset_set,
+                                            shm_shutdown,
+                                            shm_destroy,
+                                            shm_get_peer};
+
+/* side is 0 for the client, 1 for the server. Takes ownership of control, the
+   mapping, and the eventfds. */
+static grpc_endpoint *shm_endpoint_create(grpc_exec_ctx *exec_ctx,
+                                          grpc_endpoint *control, void *map,
+                                          size_t ring_size, int side,
+                                          const int *eventfds) {
+  grpc_shm_endpoint *shm = gpr_malloc(sizeof(*shm));
+  char *name;
+  memset(shm, 0, sizeof(*shm));
+  shm->base.vtable = &vtable;
+  /* one for the caller, one for the control socket read */
+  gpr_ref_init(&shm->refcount, 2);
+  shm->peer_string = grpc_endpoint_get_peer(control);
+  shm->map = map;
+  shm->map_size = map_size_for_ring(ring_size);
+  ring_init(&shm->tx, map, ring_size, side);
+  ring_init(&shm->rx, map, ring_size, 1 - side);
+
+  gpr_asprintf(&name, "shm-rx-data:%s", shm->peer_string);
+  shm->rx_data_fd = grpc_fd_create(eventfds[RING_DATA_EVENTFD(1 - side)], name);
+  gpr_free(name);
+  gpr_asprintf(&name, "shm-tx-space:%s", shm->peer_string);
+  shm->tx_space_fd = grpc_fd_create(eventfds[RING_SPACE_EVENTFD(side)], name);
+  gpr_free(name);
+  shm->peer_data_fd = eventfds[RING_DATA_EVENTFD(side)];
+  shm->peer_space_fd = eventfds[RING_SPACE_EVENTFD(1 - side)];
+
+  grpc_closure_init(&shm->read_closure, shm_handle_read, shm);
+  grpc_closure_init(&shm->write_closure, shm_handle_write, shm);
+
+  shm->control = control;
+  gpr_slice_buffer_init(&shm->control_buffer);
+  grpc_closure_init(&shm->control_read_closure, on_control_read, shm);
+  grpc_endpoint_read(exec_ctx, control, &shm->control_buffer,
+                     &shm->control_read_closure);
+  return &shm->base;
+}
+
+static size_t round_ring_size(size_t ring_size) {
+  size_t size = GRPC_SHM_MIN_RING_SIZE;
+  while (size < ring_size && size < GRPC_SHM_MAX_RING_SIZE) size <<= 1;
+  return size;
+}
+
+static void close_fds(const int *fds, size_t count) {
+  size_t i;
+  for (i = 0; i < count; i++) {
+    if (fds[i] >= 0) close(fds[i]);
+  }
+}
+
+static void put_uint32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)(value >> 24);
+  p[1] = (uint8_t)(value >> 16);
+  p[2] = (uint8_t)(value >> 8);
+  p[3] = (uint8_t)value;
+}
+
+static uint32_t get_uint32(const uint8_t *p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void copy_bootstrap(gpr_slice_buffer *buffer, uint8_t *bootstrap) {
+  size_t copied = 0;
+  size_t i;
+  for (i = 0; i < buffer->count && copied < BOOTSTRAP_LENGTH; i++) {
+    gpr_slice slice = buffer->slices[i];
+    size_t n = GPR_MIN(GPR_SLICE_LENGTH(slice), BOOTSTRAP_LENGTH - copied);
+    memcpy(bootstrap + copied, GPR_SLICE_START_PTR(slice), n);
+    copied += n;
+  }
+}
+
+bool grpc_shm_endpoint_supported(void) { return true; }
+
+grpc_error *grpc_shm_endpoint_connect(grpc_exec_ctx *exec_ctx,
+                                      grpc_endpoint *control, size_t ring_size,
+                                      grpc_endpoint **ep) {
+  /* the memfd, then the eventfds */
+  int fds[1 + NUM_EVENTFDS] = {-1, -1, -1, -1, -1};
+  uint8_t bootstrap[BOOTSTRAP_LENGTH];
+  void *map = MAP_FAILED;
+  size_t map_size;
+  grpc_error *error = GRPC_ERROR_NONE;
+  size_t i;
+
+  ring_size = round_ring_size(ring_size);
+  map_size = map_size_for_ring(ring_size);
+#ifdef __NR_memfd_create
+  fds[0] = (int)syscall(__NR_memfd_create, "grpc-shm",
+                        MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fds[0] < 0) {
+    error = GRPC_OS_ERROR(errno, "memfd_create");
+    goto done;
+  }
+#else
+  error = GRPC_ERROR_CREATE("memfd_create is not available");
+  goto done;
+#endif
+  if (ftruncate(fds[0], (off_t)map_size) != 0) {
+    error = GRPC_OS_ERROR(errno, "ftruncate");
+    goto done;
+  }
+  if (fcntl(fds[0], F_ADD_SEALS, REQUIRED_SEALS) != 0) {
+    error = GRPC_OS_ERROR(errno, "fcntl(F_ADD_SEALS)");
+    goto done;
+  }
+  for (i = 0; i < NUM_EVENTFDS; i++) {
+    fds[1 + i] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fds[1 + i] < 0) {
+      error = GRPC_OS_ERROR(errno, "eventfd");
+      goto done;
+    }
+  }
+  /* a fresh memfd reads as zeroes: both rings start out empty and open */
+  map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+  if (map == MAP_FAILED) {
+    error = GRPC_OS_ERROR(errno, "mmap");
+    goto done;
+  }
+
+  memcpy(bootstrap, BOOTSTRAP_MAGIC, BOOTSTRAP_MAGIC_LENGTH);
+  put_uint32(bootstrap + BOOTSTRAP_MAGIC_LENGTH, BOOTSTRAP_VERSION);
+  put_uint32(bootstrap + BOOTSTRAP_MAGIC_LENGTH + 4, (uint32_t)ring_size);
+  error = grpc_tcp_send_fds(control, bootstrap, sizeof(bootstrap), fds,
+                            GPR_ARRAY_SIZE(fds));
+  if (error != GRPC_ERROR_NONE) goto done;
+
+  close(fds[0]);
+  *ep = shm_endpoint_create(exec_ctx, control, map, ring_size, 0, fds + 1);
+  return GRPC_ERROR_NONE;
+
+done:
+  if (map != MAP_FAILED) munmap(map, map_size);
+  close_fds(fds, GPR_ARRAY_SIZE(fds));
+  return error;
+}
+
+void grpc_shm_endpoint_prepare_accept(grpc_endpoint *control) {
+  grpc_tcp_accept_passed_fds(control);
+}
+
+/* Checks that fd is an eventfd, and makes it non-blocking so that signalling
+   a saturated counter can't block us. Eventfds are anonymous inodes, which
+   share one inode number; of those, only eventfds accept writes. Writing
+   zero leaves the counter alone. */
+static grpc_error *check_eventfd(int fd, const struct stat *eventfd_st) {
+  struct stat st;
+  int flags;
+  if (fstat(fd, &st) != 0) {
+    return GRPC_OS_ERROR(errno, "fstat");
+  }
+  if (st.st_dev != eventfd_st->st_dev || st.st_ino != eventfd_st->st_ino) {
+    return GRPC_ERROR_CREATE("Shared memory bootstrap passed a non-eventfd");
+  }
+  flags = fcntl(fd, F_GETFL);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    return GRPC_OS_ERROR(errno, "fcntl");
+  }
+  if (eventfd_write(fd, 0) != 0) {
+    return GRPC_ERROR_CREATE("Shared memory bootstrap passed a non-eventfd");
+  }
+  return GRPC_ERROR_NONE;
+}
+
+static grpc_error *check_eventfds(const int *fds) {
+  struct stat eventfd_st;
+  grpc_error *error = GRPC_ERROR_NONE;
+  size_t i;
+  int fd = eventfd(0, EFD_CLOEXEC);
+  if (fd < 0) {
+    return GRPC_OS_ERROR(errno, "eventfd");
+  }
+  if (fstat(fd, &eventfd_st) != 0) {
+    error = GRPC_OS_ERROR(errno, "fstat");
+  }
+  close(fd);
+  for (i = 0; i < NUM_EVENTFDS && error == GRPC_ERROR_NONE; i++) {
+    error = check_eventfd(fds[i], &eventfd_st);
+  }
+  return error;
+}
+
+grpc_shm_bootstrap_status grpc_shm_check_bootstrap(gpr_slice_buffer *buffer) {
+  size_t matched = 0;
+  size_t i;
+  for (i = 0; i < buffer->count && matched < BOOTSTRAP_MAGIC_LENGTH; i++) {
+    gpr_slice slice = buffer->slices[i];
+    size_t n = GPR_MIN(GPR_SLICE_LENGTH(slice),
+                       BOOTSTRAP_MAGIC_LENGTH - matched);
+    if (memcmp(GPR_SLICE_START_PTR(slice), BOOTSTRAP_MAGIC + matched, n) !=
+        0) {
+      return GRPC_SHM_BOOTSTRAP_MISMATCH;
+    }
+    matched += n;
+  }
+  return buffer->length < BOOTSTRAP_LENGTH ? GRPC_SHM_BOOTSTRAP_INCOMPLETE
+                                           : GRPC_SHM_BOOTSTRAP_MATCH;
+}
+
+grpc_error *grpc_shm_endpoint_accept(grpc_exec_ctx *exec_ctx,
+                                     grpc_endpoint *control,
+                                     gpr_slice_buffer *buffer,
+                                     grpc_endpoint **ep) {
+  int fds[1 + NUM_EVENTFDS];
+  uint8_t bootstrap[BOOTSTRAP_LENGTH];
+  size_t num_fds;
+  size_t ring_size;
+  size_t map_size;
+  struct stat st;
+  int seals;
+  void *map;
+  grpc_error *error = GRPC_ERROR_NONE;
+
+  GPR_ASSERT(buffer->length >= BOOTSTRAP_LENGTH);
+  num_fds = grpc_tcp_take_passed_fds(control, fds, GPR_ARRAY_SIZE(fds));
+  if (buffer->length != BOOTSTRAP_LENGTH) {
+    error = GRPC_ERROR_CREATE("Unexpected data after shared memory bootstrap");
+    goto done;
+  }
+  if (num_fds != GPR_ARRAY_SIZE(fds)) {
+    error = GRPC_ERROR_CREATE("Shared memory bootstrap is missing descriptors");
+    goto done;
+  }
+  copy_bootstrap(buffer, bootstrap);
+  gpr_slice_buffer_reset_and_unref(buffer);
+  if (get_uint32(bootstrap + BOOTSTRAP_MAGIC_LENGTH) != BOOTSTRAP_VERSION) {
+    error = GRPC_ERROR_CREATE("Unsupported shared memory bootstrap version");
+    goto done;
+  }
+  ring_size = get_uint32(bootstrap + BOOTSTRAP_MAGIC_LENGTH + 4);
+  if (ring_size != round_ring_size(ring_size)) {
+    error = GRPC_ERROR_CREATE("Bad shared memory ring size");
+    goto done;
+  }
+  map_size = map_size_for_ring(ring_size);
+  /* an unsealed region could be truncated by the peer, and reading our
+     mapping would then raise SIGBUS */
+  seals = fcntl(fds[0], F_GET_SEALS);
+  if (seals < 0 || (seals & REQUIRED_SEALS) != REQUIRED_SEALS) {
+    error = GRPC_ERROR_CREATE("Shared memory region is not sealed");
+    goto done;
+  }
+  if (fstat(fds[0], &st) != 0) {
+    error = GRPC_OS_ERROR(errno, "fstat");
+    goto done;
+  }
+  if ((size_t)st.st_size < map_size) {
+    error = GRPC_ERROR_CREATE("Shared memory region is too small");
+    goto done;
+  }
+  error = check_eventfds(fds + 1);
+  if (error != GRPC_ERROR_NONE) goto done;
+  map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+  if (map == MAP_FAILED) {
+    error = GRPC_OS_ERROR(errno, "mmap");
+    goto done;
+  }
+
+  close(fds[0]);
+  *ep = shm_endpoint_create(exec_ctx, control, map, ring_size, 1, fds + 1);
+  return GRPC_ERROR_NONE;
+
+done:
+  close_fds(fds, num_fds);
+  return error;
+}
+
+#endif /* GPR_LINUX_EVENTFD */
@@ -0,0 +1,61 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#ifndef GPR_LINUX_EVENTFD
+
+#include "src/core/lib/iomgr/shm_endpoint.h"
+
+bool grpc_shm_endpoint_supported(void) { return false; }
+
+grpc_error *grpc_shm_endpoint_connect(grpc_exec_ctx *exec_ctx,
+                                      grpc_endpoint *control, size_t ring_size,
+                                      grpc_endpoint **ep) {
+  return GRPC_ERROR_CREATE("Shared memory endpoints are not supported");
+}
+
+void grpc_shm_endpoint_prepare_accept(grpc_endpoint *control) {}
+
+grpc_shm_bootstrap_status grpc_shm_check_bootstrap(gpr_slice_buffer *buffer) {
+  return GRPC_SHM_BOOTSTRAP_MISMATCH;
+}
+
+grpc_error *grpc_shm_endpoint_accept(grpc_exec_ctx *exec_ctx,
+                                     grpc_endpoint *control,
+                                     gpr_slice_buffer *buffer,
+                                     grpc_endpoint **ep) {
+  return GRPC_ERROR_CREATE("Shared memory endpoints are not supported");
+}
+
+#endif
@@ -46,16 +46,22 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef GPR_LINUX_SENDFILE
+#include <sys/sendfile.h>
+#endif
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/slice.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/time.h>
+#include <grpc/support/useful.h>
 
 #include "src/core/lib/debug/trace.h"
 #include "src/core/lib/iomgr/ev_posix.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/support/slice_mapped_file.h"
 #include "src/core/lib/support/string.h"
 
 #ifdef GPR_HAVE_MSG_NOSIGNAL
@@ -64,6 +70,12 @@
 #define SENDMSG_FLAGS 0
 #endif
 
+#ifdef GPR_LINUX_SENDFILE
+#define SENDMSG_MORE_FLAG MSG_MORE
+#else
+#define SENDMSG_MORE_FLAG 0
+#endif
+
 #ifdef GPR_MSG_IOVLEN_TYPE
 typedef GPR_MSG_IOVLEN_TYPE msg_iovlen_type;
 #else
@@ -90,6 +102,8 @@ typedef struct {
   size_t outgoing_slice_idx;
   /** byte within outgoing_buffer->slices[outgoing_slice_idx] to write next */
   size_t outgoing_byte_idx;
+  /** send mapped file slices with sendfile() rather than from their mapping */
+  bool use_sendfile;
 
   grpc_closure *read_cb;
   grpc_closure *write_cb;
@@ -100,6 +114,11 @@ typedef struct {
   grpc_closure write_closure;
 
   char *peer_string;
+
+  /* file descriptors passed by the peer, kept if accept_passed_fds is set */
+  bool accept_passed_fds;
+  int passed_fds[GRPC_TCP_MAX_PASSED_FDS];
+  size_t num_passed_fds;
 } grpc_tcp;
 
 static void tcp_handle_read(grpc_exec_ctx *exec_ctx, void *arg /* grpc_tcp */,
@@ -113,6 +132,10 @@ static void tcp_shutdown(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep) {
 }
 
 static void tcp_free(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
+  size_t i;
+  for (i = 0; i < tcp->num_passed_fds; i++) {
+    close(tcp->passed_fds[i]);
+  }
   grpc_fd_orphan(exec_ctx, tcp->em_fd, tcp->release_fd_cb, tcp->release_fd,
                  "tcp_unref_orphan");
   gpr_slice_buffer_destroy(&tcp->last_read_buffer);
@@ -180,10 +203,37 @@ static void call_read_cb(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp,
   grpc_closure_run(exec_ctx, cb, error);
 }
 
+/* keep the file descriptors carried by SCM_RIGHTS messages in 'msg' */
+static void collect_passed_fds(grpc_tcp *tcp, struct msghdr *msg) {
+  struct cmsghdr *cmsg;
+  for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+    size_t count;
+    size_t i;
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+    count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    for (i = 0; i < count; i++) {
+      int fd;
+      memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+      if (tcp->num_passed_fds < GRPC_TCP_MAX_PASSED_FDS) {
+        tcp->passed_fds[tcp->num_passed_fds++] = fd;
+      } else {
+        close(fd);
+      }
+    }
+  }
+}
+
 #define MAX_READ_IOVEC 4
 static void tcp_continue_read(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
   struct msghdr msg;
   struct iovec iov[MAX_READ_IOVEC];
+  union {
+    char buf[CMSG_SPACE(sizeof(int) * GRPC_TCP_MAX_PASSED_FDS)];
+    struct cmsghdr align;
+  } control;
+  int recv_flags = 0;
   ssize_t read_bytes;
   size_t i;
 
@@ -208,10 +258,17 @@ static void tcp_continue_read(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
   msg.msg_control = NULL;
   msg.msg_controllen = 0;
   msg.msg_flags = 0;
+  if (tcp->accept_passed_fds) {
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+#ifdef MSG_CMSG_CLOEXEC
+    recv_flags = MSG_CMSG_CLOEXEC;
+#endif
+  }
 
   GPR_TIMER_BEGIN("recvmsg", 0);
   do {
-    read_bytes = recvmsg(tcp->fd, &msg, 0);
+    read_bytes = recvmsg(tcp->fd, &msg, recv_flags);
   } while (read_bytes < 0 && errno == EINTR);
   GPR_TIMER_END("recvmsg", read_bytes >= 0);
 
@@ -235,6 +292,9 @@ static void tcp_continue_read(grpc_exec_ctx *exec_ctx, grpc_tcp *tcp) {
     call_read_cb(exec_ctx, tcp, GRPC_ERROR_CREATE("EOF"));
     TCP_UNREF(exec_ctx, tcp, "read");
   } else {
+    if (msg.msg_controllen > 0) {
+      collect_passed_fds(tcp, &msg);
+    }
     GPR_ASSERT((size_t)read_bytes <= tcp->incoming_buffer->length);
     if ((size_t)read_bytes < tcp->incoming_buffer->length) {
       gpr_slice_buffer_trim_end(
@@ -283,6 +343,59 @@ static void tcp_read(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
   }
 }
 
+static bool is_mapped_file_slice(gpr_slice slice) {
+  int fd;
+  int64_t offset;
+  return gpr_slice_get_mapped_file_range(slice, &fd, &offset);
+}
+
+/* Sends what is left of the mapped file slice at outgoing_slice_idx with
+   sendfile(). Returns false if the socket is full. If it returns true, *error
+   is set, and outgoing_slice_idx and outgoing_byte_idx are updated. sendfile()
+   not being usable only disables it (the slice then gets sent from its
+   mapping). */
+static bool tcp_sendfile(grpc_tcp *tcp, grpc_error **error) {
+#ifdef GPR_LINUX_SENDFILE
+  gpr_slice slice = tcp->outgoing_buffer->slices[tcp->outgoing_slice_idx];
+  int file_fd;
+  int64_t file_offset;
+  off_t offset;
+  ssize_t sent_length;
+
+  GPR_ASSERT(gpr_slice_get_mapped_file_range(slice, &file_fd, &file_offset));
+  offset = (off_t)(file_offset + (int64_t)tcp->outgoing_byte_idx);
+  GPR_TIMER_BEGIN("sendfile", 1);
+  do {
+    sent_length = sendfile(tcp->fd, file_fd, &offset,
+                           GPR_SLICE_LENGTH(slice) - tcp->outgoing_byte_idx);
+  } while (sent_length < 0 && errno == EINTR);
+  GPR_TIMER_END("sendfile", 0);
+
+  *error = GRPC_ERROR_NONE;
+  if (sent_length < 0) {
+    if (errno == EAGAIN) {
+      return false;
+    } else if (errno == EINVAL || errno == ENOSYS) {
+      tcp->use_sendfile = false;
+    } else {
+      *error = GRPC_OS_ERROR(errno, "sendfile");
+    }
+  } else if (sent_length == 0) {
+    *error = GRPC_ERROR_CREATE("sendfile: file truncated");
+  } else {
+    tcp->outgoing_byte_idx += (size_t)sent_length;
+    if (tcp->outgoing_byte_idx == GPR_SLICE_LENGTH(slice)) {
+      tcp->outgoing_slice_idx++;
+      tcp->outgoing_byte_idx = 0;
+    }
+  }
+#else
+  tcp->use_sendfile = false;
+  *error = GRPC_ERROR_NONE;
+#endif
+  return true;
+}
+
 /* returns true if done, false if pending; if returning true, *error is set */
 #define MAX_WRITE_IOVEC 1000
 static bool tcp_flush(grpc_tcp *tcp, grpc_error **error) {
@@ -294,14 +407,35 @@ static bool tcp_flush(grpc_tcp *tcp, grpc_error **error) {
   size_t trailing;
   size_t unwind_slice_idx;
   size_t unwind_byte_idx;
+  int flags;
 
   for (;;) {
+    if (tcp->use_sendfile &&
+        is_mapped_file_slice(
+            tcp->outgoing_buffer->slices[tcp->outgoing_slice_idx])) {
+      if (!tcp_sendfile(tcp, error)) return false;
+      if (*error != GRPC_ERROR_NONE ||
+          tcp->outgoing_slice_idx == tcp->outgoing_buffer->count) {
+        return true;
+      }
+      continue;
+    }
+
     sending_length = 0;
     unwind_slice_idx = tcp->outgoing_slice_idx;
     unwind_byte_idx = tcp->outgoing_byte_idx;
+    flags = SENDMSG_FLAGS;
     for (iov_size = 0; tcp->outgoing_slice_idx != tcp->outgoing_buffer->count &&
                        iov_size != MAX_WRITE_IOVEC;
          iov_size++) {
+      if (tcp->use_sendfile &&
+          is_mapped_file_slice(
+              tcp->outgoing_buffer->slices[tcp->outgoing_slice_idx])) {
+        /* sent with sendfile() next: hold on to what we send now (typically
+           a DATA frame header) until then */
+        flags |= SENDMSG_MORE_FLAG;
+        break;
+      }
       iov[iov_size].iov_base =
           GPR_SLICE_START_PTR(
               tcp->outgoing_buffer->slices[tcp->outgoing_slice_idx]) +
@@ -327,7 +461,7 @@ static bool tcp_flush(grpc_tcp *tcp, grpc_error **error) {
     GPR_TIMER_BEGIN("sendmsg", 1);
     do {
       /* TODO(klempner): Cork if this is a partial write */
-      sent_length = sendmsg(tcp->fd, &msg, SENDMSG_FLAGS);
+      sent_length = sendmsg(tcp->fd, &msg, flags);
     } while (sent_length < 0 && errno == EINTR);
     GPR_TIMER_END("sendmsg", 0);
 
@@ -492,6 +626,13 @@ grpc_endpoint *grpc_tcp_create(grpc_fd *em_fd, size_t slice_size,
   tcp->slice_size = slice_size;
   tcp->iov_size = 1;
   tcp->finished_edge = true;
+#ifdef GPR_LINUX_SENDFILE
+  tcp->use_sendfile = true;
+#else
+  tcp->use_sendfile = false;
+#endif
+  tcp->accept_passed_fds = false;
+  tcp->num_passed_fds = 0;
   /* paired with unref in grpc_tcp_destroy */
   gpr_ref_init(&tcp->refcount, 1);
   tcp->em_fd = em_fd;
@@ -512,6 +653,68 @@ int grpc_tcp_fd(grpc_endpoint *ep) {
   return grpc_fd_wrapped_fd(tcp->em_fd);
 }
 
+void grpc_tcp_accept_passed_fds(grpc_endpoint *ep) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  GPR_ASSERT(ep->vtable == &vtable);
+  tcp->accept_passed_fds = true;
+}
+
+size_t grpc_tcp_take_passed_fds(grpc_endpoint *ep, int *fds, size_t max_fds) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  size_t count = GPR_MIN(max_fds, tcp->num_passed_fds);
+  GPR_ASSERT(ep->vtable == &vtable);
+  memcpy(fds, tcp->passed_fds, count * sizeof(int));
+  memmove(tcp->passed_fds, tcp->passed_fds + count,
+          (tcp->num_passed_fds - count) * sizeof(int));
+  tcp->num_passed_fds -= count;
+  return count;
+}
+
+grpc_error *grpc_tcp_send_fds(grpc_endpoint *ep, const void *data,
+                              size_t length, const int *fds, size_t nfds) {
+  grpc_tcp *tcp = (grpc_tcp *)ep;
+  struct msghdr msg;
+  struct iovec iov;
+  union {
+    char buf[CMSG_SPACE(sizeof(int) * GRPC_TCP_MAX_PASSED_FDS)];
+    struct cmsghdr align;
+  } control;
+  struct cmsghdr *cmsg;
+  ssize_t sent_length;
+
+  GPR_ASSERT(ep->vtable == &vtable);
+  GPR_ASSERT(tcp->write_cb == NULL);
+  GPR_ASSERT(length > 0);
+  GPR_ASSERT(nfds > 0 && nfds <= GRPC_TCP_MAX_PASSED_FDS);
+
+  iov.iov_base = (void *)data;
+  iov.iov_len = length;
+  memset(&control, 0, sizeof(control));
+  msg.msg_name = NULL;
+  msg.msg_namelen = 0;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = CMSG_SPACE(sizeof(int) * nfds);
+  msg.msg_flags = 0;
+  cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * nfds);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * nfds);
+
+  do {
+    sent_length = sendmsg(tcp->fd, &msg, SENDMSG_FLAGS);
+  } while (sent_length < 0 && errno == EINTR);
+  if (sent_length < 0) {
+    return GRPC_OS_ERROR(errno, "sendmsg");
+  }
+  if ((size_t)sent_length != length) {
+    return GRPC_ERROR_CREATE("Short write while passing file descriptors");
+  }
+  return GRPC_ERROR_NONE;
+}
+
 void grpc_tcp_destroy_and_release_fd(grpc_exec_ctx *exec_ctx, grpc_endpoint *ep,
                                      int *fd, grpc_closure *done) {
   grpc_tcp *tcp = (grpc_tcp *)ep;
@@ -49,6 +49,9 @@
 
 #define GRPC_TCP_DEFAULT_READ_SLICE_SIZE 8192
 
+/* The most file descriptors passed over a (unix socket) tcp endpoint at once */
+#define GRPC_TCP_MAX_PASSED_FDS 8
+
 extern int grpc_tcp_trace;
 
 /* Create a tcp endpoint given a file desciptor and a read slice size.
@@ -62,6 +65,25 @@ grpc_endpoint *grpc_tcp_create(grpc_fd *fd, size_t read_slice_size,
  */
 int grpc_tcp_fd(grpc_endpoint *ep);
 
+/* Keep the file descriptors the peer passes over the connection (SCM_RIGHTS
+   messages on a unix socket) instead of dropping them. Up to
+   GRPC_TCP_MAX_PASSED_FDS are kept until taken by grpc_tcp_take_passed_fds;
+   any left over are closed with the endpoint.
+   Requires: ep must be a tcp endpoint. */
+void grpc_tcp_accept_passed_fds(grpc_endpoint *ep);
+
+/* Move up to max_fds of the file descriptors passed so far into fds, oldest
+   first, and return how many there were. The caller owns them.
+   Requires: ep must be a tcp endpoint. */
+size_t grpc_tcp_take_passed_fds(grpc_endpoint *ep, int *fds, size_t max_fds);
+
+/* Send length bytes of data along with nfds file descriptors, synchronously.
+   Only meant for small messages on an otherwise idle connection: fails rather
+   than blocking if the data cannot all go out at once.
+   Requires: ep must be a tcp endpoint with no write pending. */
+grpc_error *grpc_tcp_send_fds(grpc_endpoint *ep, const void *data,
+                              size_t length, const int *fds, size_t nfds);
+
 /* Destroy the tcp endpoint without closing its fd. *fd will be set and done
  * will be called when the endpoint is destroyed.
  * Requires: ep must be a tcp endpoint and fd must not be NULL. */
@@ -33,6 +33,9 @@
 
 #include "src/core/lib/iomgr/timer.h"
 
+#include <string.h>
+
+#include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/useful.h>
@@ -46,6 +49,19 @@
 #define ADD_DEADLINE_SCALE 0.33
 #define MIN_QUEUE_WINDOW_DURATION 0.01
 #define MAX_QUEUE_WINDOW_DURATION 1
+/* Must be a power of 2 */
+#define BUCKET_CACHE_SIZE 64
+
+/* The timers created by grpc_timer_init_coalesced() on a shard with the same
+   (rounded) deadline. */
+typedef struct grpc_timer_bucket {
+  /* Stands in for the timers of the bucket in the shard's heap or list */
+  grpc_timer entry;
+  /* The deadline, in milliseconds */
+  int64_t deadline_ms;
+  /* Sentinel of the list of the timers in the bucket */
+  grpc_timer timers;
+} grpc_timer_bucket;
 
 typedef struct {
   gpr_mu mu;
@@ -60,6 +76,10 @@ typedef struct {
   grpc_timer_heap heap;
   /* This holds timers whose deadline is >= queue_deadline_cap. */
   grpc_timer list;
+  /* The latest bucket created for each deadline (modulo the cache size), for
+     new coalesced timers to join. Buckets that miss the cache still work, they
+     just coalesce fewer timers. */
+  grpc_timer_bucket *bucket_cache[BUCKET_CACHE_SIZE];
 } shard_type;
 
 /* Protects g_shard_queue */
@@ -98,6 +118,7 @@ void grpc_timer_list_init(gpr_timespec now) {
     shard->shard_queue_index = i;
     grpc_timer_heap_init(&shard->heap);
     shard->list.next = shard->list.prev = &shard->list;
+    memset(shard->bucket_cache, 0, sizeof(shard->bucket_cache));
     shard->min_deadline = compute_min_deadline(shard);
     g_shard_queue[i] = shard;
   }
@@ -146,6 +167,26 @@ static void list_remove(grpc_timer *timer) {
   timer->prev->next = timer->next;
 }
 
+/* Returns the bucket if the heap or list entry 'timer' stands for one */
+static grpc_timer_bucket *entry_bucket(grpc_timer *timer) {
+  return timer->bucket != NULL && &timer->bucket->entry == timer
+             ? timer->bucket
+             : NULL;
+}
+
+static grpc_timer_bucket **bucket_cache_slot(shard_type *shard,
+                                             int64_t deadline_ms) {
+  return &shard->bucket_cache[(size_t)deadline_ms & (BUCKET_CACHE_SIZE - 1)];
+}
+
+/* Takes an empty bucket that is out of the shard's heap and list for good.
+   REQUIRES: shard->mu locked */
+static void destroy_bucket(shard_type *shard, grpc_timer_bucket *bucket) {
+  grpc_timer_bucket **slot = bucket_cache_slot(shard, bucket->deadline_ms);
+  if (*slot == bucket) *slot = NULL;
+  gpr_free(bucket);
+}
+
 static void swap_adjacent_shards_in_queue(uint32_t first_shard_queue_index) {
   shard_type *temp;
   temp = g_shard_queue[first_shard_queue_index];
@@ -173,16 +214,57 @@ static void note_deadline_change(shard_type *shard) {
   }
 }
 
-void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
-                     gpr_timespec deadline, grpc_iomgr_cb_func timer_cb,
-                     void *timer_cb_arg, gpr_timespec now) {
+/* Adds the timer to the bucket for its deadline, creating the bucket if
+   needed. Returns the entry to add to the shard's heap or list, NULL if the
+   timer joined an existing bucket.
+   REQUIRES: shard->mu locked */
+static grpc_timer *add_to_bucket(shard_type *shard, grpc_timer *timer,
+                                 int64_t deadline_ms) {
+  grpc_timer_bucket **slot = bucket_cache_slot(shard, deadline_ms);
+  grpc_timer_bucket *bucket = *slot;
+  grpc_timer *entry = NULL;
+  if (bucket == NULL || bucket->deadline_ms != deadline_ms) {
+    bucket = gpr_malloc(sizeof(*bucket));
+    bucket->entry.deadline = timer->deadline;
+    bucket->entry.triggered = 0;
+    bucket->entry.bucket = bucket;
+    bucket->deadline_ms = deadline_ms;
+    bucket->timers.next = bucket->timers.prev = &bucket->timers;
+    *slot = bucket;
+    entry = &bucket->entry;
+  }
+  timer->bucket = bucket;
+  timer->heap_index = INVALID_HEAP_INDEX;
+  list_join(&bucket->timers, timer);
+  return entry;
+}
+
+static void timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+                       gpr_timespec deadline, bool coalesce,
+                       grpc_iomgr_cb_func timer_cb, void *timer_cb_arg,
+                       gpr_timespec now) {
   int is_first_timer = 0;
+  int64_t deadline_ms = 0;
+  grpc_timer *entry = timer;
   shard_type *shard = &g_shards[shard_idx(timer)];
   GPR_ASSERT(deadline.clock_type == g_clock_type);
   GPR_ASSERT(now.clock_type == g_clock_type);
   grpc_closure_init(&timer->closure, timer_cb, timer_cb_arg);
+  /* (deadlines that would overflow deadline_ms, like infinite ones, are not
+     worth coalescing anyway) */
+  if (coalesce && deadline.tv_sec >= 0 &&
+      deadline.tv_sec < INT64_MAX / GPR_MS_PER_SEC - 1) {
+    /* round up, so that the timer never fires early */
+    deadline_ms = deadline.tv_sec * GPR_MS_PER_SEC +
+                  (deadline.tv_nsec + GPR_NS_PER_MS - 1) / GPR_NS_PER_MS;
+    deadline.tv_sec = deadline_ms / GPR_MS_PER_SEC;
+    deadline.tv_nsec = (int32_t)(deadline_ms % GPR_MS_PER_SEC) * GPR_NS_PER_MS;
+  } else {
+    coalesce = false;
+  }
   timer->deadline = deadline;
   timer->triggered = 0;
+  timer->bucket = NULL;
 
   if (!g_initialized) {
     timer->triggered = 1;
@@ -204,11 +286,16 @@ void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
   gpr_mu_lock(&shard->mu);
   grpc_time_averaged_stats_add_sample(&shard->stats,
                                       ts_to_dbl(gpr_time_sub(deadline, now)));
-  if (gpr_time_cmp(deadline, shard->queue_deadline_cap) < 0) {
-    is_first_timer = grpc_timer_heap_add(&shard->heap, timer);
+  if (coalesce) {
+    entry = add_to_bucket(shard, timer, deadline_ms);
+  }
+  if (entry == NULL) {
+    /* joined a bucket that is queued already */
+  } else if (gpr_time_cmp(deadline, shard->queue_deadline_cap) < 0) {
+    is_first_timer = grpc_timer_heap_add(&shard->heap, entry);
   } else {
-    timer->heap_index = INVALID_HEAP_INDEX;
-    list_join(&shard->list, timer);
+    entry->heap_index = INVALID_HEAP_INDEX;
+    list_join(&shard->list, entry);
   }
   gpr_mu_unlock(&shard->mu);
 
@@ -238,6 +325,29 @@ void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
   }
 }
 
+void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+                     gpr_timespec deadline, grpc_iomgr_cb_func timer_cb,
+                     void *timer_cb_arg, gpr_timespec now) {
+  timer_init(exec_ctx, timer, deadline, false, timer_cb, timer_cb_arg, now);
+}
+
+void grpc_timer_init_coalesced(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+                               gpr_timespec deadline,
+                               grpc_iomgr_cb_func timer_cb, void *timer_cb_arg,
+                               gpr_timespec now) {
+  timer_init(exec_ctx, timer, deadline, true, timer_cb, timer_cb_arg, now);
+}
+
+/* Removes a heap or list entry from the shard.
+   REQUIRES: shard->mu locked */
+static void remove_entry(shard_type *shard, grpc_timer *entry) {
+  if (entry->heap_index == INVALID_HEAP_INDEX) {
+    list_remove(entry);
+  } else {
+    grpc_timer_heap_remove(&shard->heap, entry);
+  }
+}
+
 void grpc_timer_cancel(grpc_exec_ctx *exec_ctx, grpc_timer *timer) {
   if (!g_initialized) {
     /* must have already been cancelled, also the shard mutex is invalid */
@@ -249,10 +359,15 @@ void grpc_timer_cancel(grpc_exec_ctx *exec_ctx, grpc_timer *timer) {
   if (!timer->triggered) {
     grpc_exec_ctx_sched(exec_ctx, &timer->closure, GRPC_ERROR_CANCELLED, NULL);
     timer->triggered = 1;
-    if (timer->heap_index == INVALID_HEAP_INDEX) {
+    if (timer->bucket != NULL) {
+      grpc_timer_bucket *bucket = timer->bucket;
       list_remove(timer);
+      if (bucket->timers.next == &bucket->timers) {
+        remove_entry(shard, &bucket->entry);
+        destroy_bucket(shard, bucket);
+      }
     } else {
-      grpc_timer_heap_remove(&shard->heap, timer);
+      remove_entry(shard, timer);
     }
   }
   gpr_mu_unlock(&shard->mu);
@@ -287,8 +402,8 @@ static int refill_queue(shard_type *shard, gpr_timespec now) {
   return !grpc_timer_heap_is_empty(&shard->heap);
 }
 
-/* This pops the next non-cancelled timer with deadline <= now from the
-   queue, or returns NULL if there isn't one.
+/* This pops the next entry (a timer or a bucket of timers) with deadline <=
+   now from the queue, or returns NULL if there isn't one.
    REQUIRES: shard->mu locked */
 static grpc_timer *pop_one(shard_type *shard, gpr_timespec now) {
   grpc_timer *timer;
@@ -311,10 +426,24 @@ static size_t pop_timers(grpc_exec_ctx *exec_ctx, shard_type *shard,
                          grpc_error *error) {
   size_t n = 0;
   grpc_timer *timer;
+  grpc_timer_bucket *bucket;
   gpr_mu_lock(&shard->mu);
   while ((timer = pop_one(shard, now))) {
-    grpc_exec_ctx_sched(exec_ctx, &timer->closure, GRPC_ERROR_REF(error), NULL);
-    n++;
+    bucket = entry_bucket(timer);
+    if (bucket == NULL) {
+      grpc_exec_ctx_sched(exec_ctx, &timer->closure, GRPC_ERROR_REF(error),
+                          NULL);
+      n++;
+      continue;
+    }
+    for (timer = bucket->timers.next; timer != &bucket->timers;
+         timer = timer->next) {
+      timer->triggered = 1;
+      grpc_exec_ctx_sched(exec_ctx, &timer->closure, GRPC_ERROR_REF(error),
+                          NULL);
+      n++;
+    }
+    destroy_bucket(shard, bucket);
   }
   *new_min_deadline = compute_min_deadline(shard);
   gpr_mu_unlock(&shard->mu);
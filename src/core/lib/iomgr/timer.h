@@ -45,6 +45,9 @@ typedef struct grpc_timer {
   int triggered;
   struct grpc_timer *next;
   struct grpc_timer *prev;
+  /* for timers created with grpc_timer_init_coalesced(): the bucket the timer
+     shares with the others with the same deadline, NULL otherwise */
+  struct grpc_timer_bucket *bucket;
   grpc_closure closure;
 } grpc_timer;
 
@@ -58,6 +61,17 @@ void grpc_timer_init(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
                      gpr_timespec deadline, grpc_iomgr_cb_func timer_cb,
                      void *timer_cb_arg, gpr_timespec now);
 
+/* Like grpc_timer_init(), for the many timers that need no better than
+   millisecond precision, like call deadlines: the deadline is rounded up to
+   the next millisecond, and timers that end up with the same deadline share a
+   single entry in the timer queue. Adding such a timer to an existing entry, or
+   cancelling it while other timers remain in the entry, is a constant time
+   list operation. */
+void grpc_timer_init_coalesced(grpc_exec_ctx *exec_ctx, grpc_timer *timer,
+                               gpr_timespec deadline,
+                               grpc_iomgr_cb_func timer_cb, void *timer_cb_arg,
+                               gpr_timespec now);
+
 /* Note that there is no timer destroy function. This is because the
    timer is a one-time occurrence with a guarantee that the callback will
    be called exactly once, either at expiration or cancellation. Thus, all
@@ -0,0 +1,80 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/lib/support/byte_class.h"
+
+#ifdef GPR_HAS_SSSE3_TARGET
+#include <tmmintrin.h>
+#endif
+
+static size_t span_scalar(const gpr_byte_class *cls, const uint8_t *bytes,
+                          size_t length) {
+  size_t i;
+  for (i = 0; i < length; i++) {
+    uint8_t c = bytes[i];
+    if (c >= 0x80 || ((cls->rows[c & 15] >> (c >> 4)) & 1) == 0) break;
+  }
+  return i;
+}
+
+#ifdef GPR_HAS_SSSE3_TARGET
+__attribute__((target("ssse3"))) static size_t span_ssse3(
+    const gpr_byte_class *cls, const uint8_t *bytes, size_t length) {
+  const __m128i rows = _mm_loadu_si128((const __m128i *)cls->rows);
+  /* bit selected by each high nibble: none for 8 and above */
+  const __m128i columns = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0,
+                                        0, 0, 0, 0, 0);
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  size_t i;
+  for (i = 0; i + 16 <= length; i += 16) {
+    __m128i in = _mm_loadu_si128((const __m128i *)(bytes + i));
+    __m128i row = _mm_shuffle_epi8(rows, _mm_and_si128(in, nibble));
+    __m128i column = _mm_shuffle_epi8(
+        columns, _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+    int outside = _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_and_si128(row, column), _mm_setzero_si128()));
+    if (outside != 0) return i + (size_t)__builtin_ctz((unsigned)outside);
+  }
+  return i + span_scalar(cls, bytes + i, length - i);
+}
+#endif
+
+size_t gpr_byte_class_span(const gpr_byte_class *cls, const uint8_t *bytes,
+                           size_t length) {
+#ifdef GPR_HAS_SSSE3_TARGET
+  if (length >= 16 && __builtin_cpu_supports("ssse3")) {
+    return span_ssse3(cls, bytes, length);
+  }
+#endif
+  return span_scalar(cls, bytes, length);
+}
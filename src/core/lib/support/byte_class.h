@@ -0,0 +1,53 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_SUPPORT_BYTE_CLASS_H
+#define GRPC_CORE_LIB_SUPPORT_BYTE_CLASS_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+/* A set of ascii7 characters, laid out so that a whole vector of bytes can be
+   tested against it at once: c is in the set if bit (c >> 4) of rows[c & 15]
+   is set. Bytes of 0x80 and above are never in the set.
+   Instances are generated by tools/codegen/core/gen_percent_encoding_tables.c
+   and tools/codegen/core/gen_legal_metadata_characters.c */
+typedef struct gpr_byte_class { uint8_t rows[16]; } gpr_byte_class;
+
+/* returns the length of the longest prefix of bytes[0..length) made only of
+   characters in cls */
+size_t gpr_byte_class_span(const gpr_byte_class *cls, const uint8_t *bytes,
+                           size_t length);
+
+#endif /* GRPC_CORE_LIB_SUPPORT_BYTE_CLASS_H */
@@ -33,6 +33,8 @@
 
 #include "src/core/lib/support/percent_encoding.h"
 
+#include <string.h>
+
 #include <grpc/support/log.h>
 
 const uint8_t gpr_url_percent_encoding_unreserved_bytes[256 / 8] = {
@@ -43,42 +45,68 @@ const uint8_t gpr_compatible_percent_encoding_unreserved_bytes[256 / 8] = {
     0x00, 0x00, 0x00, 0x00, 0xdf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
     0xff, 0xff, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+const gpr_byte_class gpr_url_percent_encoding_unreserved_class = {
+    {0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf0, 0x50,
+     0x50, 0x54, 0xd4, 0x70}};
+const gpr_byte_class gpr_compatible_percent_encoding_unreserved_class = {
+    {0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xf8, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc,
+     0xfc, 0xfc, 0xfc, 0x7c}};
 
 static bool is_unreserved_character(uint8_t c,
                                     const uint8_t *unreserved_bytes) {
   return ((unreserved_bytes[c / 8] >> (c % 8)) & 1) != 0;
 }
 
+/* number of unreserved bytes at the start of [p, end) */
+static size_t unreserved_span(const uint8_t *p, const uint8_t *end,
+                              const uint8_t *unreserved_bytes) {
+  const uint8_t *start = p;
+  if (unreserved_bytes == gpr_url_percent_encoding_unreserved_bytes) {
+    return gpr_byte_class_span(&gpr_url_percent_encoding_unreserved_class, p,
+                               (size_t)(end - p));
+  }
+  if (unreserved_bytes == gpr_compatible_percent_encoding_unreserved_bytes) {
+    return gpr_byte_class_span(
+        &gpr_compatible_percent_encoding_unreserved_class, p,
+        (size_t)(end - p));
+  }
+  while (p != end && is_unreserved_character(*p, unreserved_bytes)) p++;
+  return (size_t)(p - start);
+}
+
 gpr_slice gpr_percent_encode_slice(gpr_slice slice,
                                    const uint8_t *unreserved_bytes) {
   static const uint8_t hex[] = "0123456789ABCDEF";
 
-  // first pass: count the number of bytes needed to output this string
-  size_t output_length = 0;
   const uint8_t *slice_start = GPR_SLICE_START_PTR(slice);
   const uint8_t *slice_end = GPR_SLICE_END_PTR(slice);
+  // skip over the leading unreserved bytes, usually all of them
+  const uint8_t *first_reserved =
+      slice_start + unreserved_span(slice_start, slice_end, unreserved_bytes);
   const uint8_t *p;
-  bool any_reserved_bytes = false;
-  for (p = slice_start; p < slice_end; p++) {
-    bool unres = is_unreserved_character(*p, unreserved_bytes);
-    output_length += unres ? 1 : 3;
-    any_reserved_bytes |= !unres;
-  }
-  // no unreserved bytes: return the string unmodified
-  if (!any_reserved_bytes) {
+  // no reserved bytes: return the string unmodified
+  if (first_reserved == slice_end) {
     return gpr_slice_ref(slice);
   }
-  // second pass: actually encode
+  // first pass: count the number of bytes needed to output this string
+  size_t output_length = (size_t)(first_reserved - slice_start);
+  for (p = first_reserved; p < slice_end; p++) {
+    output_length += is_unreserved_character(*p, unreserved_bytes) ? 1 : 3;
+  }
+  // second pass: actually encode, copying runs of unreserved bytes whole
   gpr_slice out = gpr_slice_malloc(output_length);
   uint8_t *q = GPR_SLICE_START_PTR(out);
-  for (p = slice_start; p < slice_end; p++) {
-    if (is_unreserved_character(*p, unreserved_bytes)) {
-      *q++ = *p;
-    } else {
-      *q++ = '%';
-      *q++ = hex[*p >> 4];
-      *q++ = hex[*p & 15];
-    }
+  p = slice_start;
+  while (p < slice_end) {
+    size_t run = unreserved_span(p, slice_end, unreserved_bytes);
+    memcpy(q, p, run);
+    p += run;
+    q += run;
+    if (p == slice_end) break;
+    *q++ = '%';
+    *q++ = hex[*p >> 4];
+    *q++ = hex[*p & 15];
+    p++;
   }
   GPR_ASSERT(q == GPR_SLICE_END_PTR(out));
   return out;
@@ -102,8 +130,9 @@ bool gpr_strict_percent_decode_slice(gpr_slice slice_in,
                                      gpr_slice *slice_out) {
   const uint8_t *p = GPR_SLICE_START_PTR(slice_in);
   const uint8_t *in_end = GPR_SLICE_END_PTR(slice_in);
-  size_t out_length = 0;
+  size_t out_length = unreserved_span(p, in_end, unreserved_bytes);
   bool any_percent_encoded_stuff = false;
+  p += out_length;
   while (p != in_end) {
     if (*p == '%') {
       if (!valid_hex(++p, in_end)) return false;
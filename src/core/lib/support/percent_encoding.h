@@ -45,6 +45,8 @@
 
 #include <grpc/support/slice.h>
 
+#include "src/core/lib/support/byte_class.h"
+
 /* URL percent encoding spec bitfield (usabel as 'unreserved_bytes' in
    gpr_percent_encode_slice, gpr_strict_percent_decode_slice).
    Flags [A-Za-z0-9-_.~] as unreserved bytes for the percent encoding routines
@@ -56,6 +58,12 @@ extern const uint8_t gpr_url_percent_encoding_unreserved_bytes[256 / 8];
    percent encoding routines */
 extern const uint8_t gpr_compatible_percent_encoding_unreserved_bytes[256 / 8];
 
+/* The same sets of unreserved bytes as gpr_byte_class, for scanning ahead
+   many bytes at a time; used internally when one of the bitfields above is
+   passed in */
+extern const gpr_byte_class gpr_url_percent_encoding_unreserved_class;
+extern const gpr_byte_class gpr_compatible_percent_encoding_unreserved_class;
+
 /* Percent-encode a slice, returning the new slice (this cannot fail):
    unreserved_bytes is a bitfield indicating which bytes are considered
    unreserved and thus do not need percent encoding */
@@ -43,30 +43,59 @@
 /* grow a buffer; requires GRPC_SLICE_BUFFER_INLINE_ELEMENTS > 1 */
 #define GROW(x) (3 * (x) / 2)
 
+/* Slices taken off the front of a buffer just advance 'slices' past them, so
+   the array starts at the beginning of its storage only when nothing was
+   taken off. The storage is storage.inlined until the buffer first grows, and
+   storage.base_slices from then on. A buffer never shrinks, so it uses the
+   inlined array exactly when its capacity is that of the inlined array. */
+static int is_inlined(gpr_slice_buffer *sb) {
+  return sb->capacity == GRPC_SLICE_BUFFER_INLINE_ELEMENTS;
+}
+
+/* start of the storage the slices of sb live in */
+static gpr_slice *base_slices(gpr_slice_buffer *sb) {
+  return is_inlined(sb) ? sb->storage.inlined : sb->storage.base_slices;
+}
+
 static void maybe_embiggen(gpr_slice_buffer *sb) {
-  if (sb->count == sb->capacity) {
-    sb->capacity = GROW(sb->capacity);
-    GPR_ASSERT(sb->capacity > sb->count);
-    if (sb->slices == sb->inlined) {
-      sb->slices = gpr_malloc(sb->capacity * sizeof(gpr_slice));
-      memcpy(sb->slices, sb->inlined, sb->count * sizeof(gpr_slice));
-    } else {
-      sb->slices = gpr_realloc(sb->slices, sb->capacity * sizeof(gpr_slice));
-    }
+  gpr_slice *base = base_slices(sb);
+  /* number of slices taken off the front, whose room is free */
+  size_t offset = (size_t)(sb->slices - base);
+  size_t capacity;
+  if (offset + sb->count < sb->capacity) return;
+  if (offset != 0) {
+    /* slide the slices back over the room left by those taken off the
+       front, so the room gets reused */
+    memmove(base, sb->slices, sb->count * sizeof(gpr_slice));
+    sb->slices = base;
+    /* only worth it, rather than growing, when that frees enough room to pay
+       for the copy */
+    if (offset >= sb->count / 2) return;
+  }
+  capacity = GROW(sb->capacity);
+  GPR_ASSERT(capacity > sb->count);
+  if (is_inlined(sb)) {
+    base = gpr_malloc(capacity * sizeof(gpr_slice));
+    memcpy(base, sb->storage.inlined, sb->count * sizeof(gpr_slice));
+  } else {
+    base = gpr_realloc(base, capacity * sizeof(gpr_slice));
   }
+  sb->storage.base_slices = base;
+  sb->capacity = capacity;
+  sb->slices = base;
 }
 
 void gpr_slice_buffer_init(gpr_slice_buffer *sb) {
   sb->count = 0;
   sb->length = 0;
   sb->capacity = GRPC_SLICE_BUFFER_INLINE_ELEMENTS;
-  sb->slices = sb->inlined;
+  sb->slices = sb->storage.inlined;
 }
 
 void gpr_slice_buffer_destroy(gpr_slice_buffer *sb) {
   gpr_slice_buffer_reset_and_unref(sb);
-  if (sb->slices != sb->inlined) {
-    gpr_free(sb->slices);
+  if (!is_inlined(sb)) {
+    gpr_free(base_slices(sb));
   }
 }
 
@@ -162,35 +191,48 @@ void gpr_slice_buffer_reset_and_unref(gpr_slice_buffer *sb) {
 
   sb->count = 0;
   sb->length = 0;
+  sb->slices = base_slices(sb);
 }
 
 void gpr_slice_buffer_swap(gpr_slice_buffer *a, gpr_slice_buffer *b) {
-  GPR_SWAP(size_t, a->count, b->count);
-  GPR_SWAP(size_t, a->capacity, b->capacity);
-  GPR_SWAP(size_t, a->length, b->length);
+  gpr_slice *a_base = base_slices(a);
+  gpr_slice *b_base = base_slices(b);
+  gpr_slice *temp_slices;
 
-  if (a->slices == a->inlined) {
-    if (b->slices == b->inlined) {
-      /* swap contents of inlined buffer */
+  if (is_inlined(a)) {
+    if (is_inlined(b)) {
+      /* swap contents of inlined buffer, moving them to its start */
       gpr_slice temp[GRPC_SLICE_BUFFER_INLINE_ELEMENTS];
-      memcpy(temp, a->slices, b->count * sizeof(gpr_slice));
-      memcpy(a->slices, b->slices, a->count * sizeof(gpr_slice));
-      memcpy(b->slices, temp, b->count * sizeof(gpr_slice));
+      memcpy(temp, a->slices, a->count * sizeof(gpr_slice));
+      memcpy(a->storage.inlined, b->slices, b->count * sizeof(gpr_slice));
+      memcpy(b->storage.inlined, temp, a->count * sizeof(gpr_slice));
+      a->slices = a->storage.inlined;
+      b->slices = b->storage.inlined;
     } else {
       /* a is inlined, b is not - copy a inlined into b, fix pointers */
-      a->slices = b->slices;
-      b->slices = b->inlined;
-      memcpy(b->slices, a->inlined, b->count * sizeof(gpr_slice));
+      temp_slices = b->slices;
+      memcpy(b->storage.inlined, a->slices, a->count * sizeof(gpr_slice));
+      a->storage.base_slices = b_base;
+      a->slices = temp_slices;
+      b->slices = b->storage.inlined;
     }
-  } else if (b->slices == b->inlined) {
+  } else if (is_inlined(b)) {
     /* b is inlined, a is not - copy b inlined int a, fix pointers */
-    b->slices = a->slices;
-    a->slices = a->inlined;
-    memcpy(a->slices, b->inlined, a->count * sizeof(gpr_slice));
+    temp_slices = a->slices;
+    memcpy(a->storage.inlined, b->slices, b->count * sizeof(gpr_slice));
+    b->storage.base_slices = a_base;
+    b->slices = temp_slices;
+    a->slices = a->storage.inlined;
   } else {
     /* no inlining: easy swap */
+    a->storage.base_slices = b_base;
+    b->storage.base_slices = a_base;
     GPR_SWAP(gpr_slice *, a->slices, b->slices);
   }
+
+  GPR_SWAP(size_t, a->count, b->count);
+  GPR_SWAP(size_t, a->capacity, b->capacity);
+  GPR_SWAP(size_t, a->length, b->length);
 }
 
 void gpr_slice_buffer_move_into(gpr_slice_buffer *src, gpr_slice_buffer *dst) {
@@ -207,6 +249,7 @@ void gpr_slice_buffer_move_into(gpr_slice_buffer *src, gpr_slice_buffer *dst) {
   gpr_slice_buffer_addn(dst, src->slices, src->count);
   src->count = 0;
   src->length = 0;
+  src->slices = base_slices(src);
 }
 
 void gpr_slice_buffer_move_first(gpr_slice_buffer *src, size_t n,
@@ -220,7 +263,7 @@ void gpr_slice_buffer_move_first(gpr_slice_buffer *src, size_t n,
     return;
   }
   src_idx = 0;
-  while (src_idx < src->capacity) {
+  while (src_idx < src->count) {
     gpr_slice slice = src->slices[src_idx];
     size_t slice_len = GPR_SLICE_LENGTH(slice);
     if (n > slice_len) {
@@ -240,8 +283,7 @@ void gpr_slice_buffer_move_first(gpr_slice_buffer *src, size_t n,
     }
   }
   GPR_ASSERT(dst->length == output_len);
-  memmove(src->slices, src->slices + src_idx,
-          sizeof(gpr_slice) * (src->count - src_idx));
+  src->slices += src_idx;
   src->count -= src_idx;
   src->length = new_input_len;
   GPR_ASSERT(src->count > 0);
@@ -275,8 +317,9 @@ gpr_slice gpr_slice_buffer_take_first(gpr_slice_buffer *sb) {
   gpr_slice slice;
   GPR_ASSERT(sb->count > 0);
   slice = sb->slices[0];
-  memmove(&sb->slices[0], &sb->slices[1], (sb->count - 1) * sizeof(gpr_slice));
+  sb->slices++;
   sb->count--;
+  if (sb->count == 0) sb->slices = base_slices(sb);
   sb->length -= GPR_SLICE_LENGTH(slice);
   return slice;
 }
@@ -0,0 +1,161 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#ifdef GPR_POSIX_FILE
+
+#include "src/core/lib/support/slice_mapped_file.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/sync.h>
+
+typedef struct {
+  gpr_slice_refcount base;
+  gpr_refcount refs;
+  int fd;
+  /* the mapping, which starts at file_offset in the file */
+  void *map_start;
+  size_t map_length;
+  int64_t file_offset;
+} mapped_file_refcount;
+
+static void mapped_file_ref(void *p) {
+  mapped_file_refcount *r = p;
+  gpr_ref(&r->refs);
+}
+
+static void mapped_file_unref(void *p) {
+  mapped_file_refcount *r = p;
+  if (gpr_unref(&r->refs)) {
+    munmap(r->map_start, r->map_length);
+    close(r->fd);
+    gpr_free(r);
+  }
+}
+
+static int posix_advice(gpr_slice_map_advice advice) {
+  switch (advice) {
+    case GPR_SLICE_MAP_ADVICE_SEQUENTIAL:
+      return POSIX_MADV_SEQUENTIAL;
+    case GPR_SLICE_MAP_ADVICE_RANDOM:
+      return POSIX_MADV_RANDOM;
+    case GPR_SLICE_MAP_ADVICE_WILLNEED:
+      return POSIX_MADV_WILLNEED;
+    default:
+      return POSIX_MADV_NORMAL;
+  }
+}
+
+int gpr_slice_from_mapped_file(int fd, int64_t offset, size_t length,
+                               gpr_slice_map_advice advice, gpr_slice *slice) {
+  int64_t page_size = sysconf(_SC_PAGESIZE);
+  int64_t map_offset;
+  size_t map_length;
+  mapped_file_refcount *r;
+  struct stat st;
+  void *map_start;
+  int dup_fd;
+
+  if (offset < 0) {
+    errno = EINVAL;
+    return 0;
+  }
+  /* touching a page past the end of the file raises SIGBUS, so such a range is
+     refused up front */
+  if (fstat(fd, &st) != 0) {
+    return 0;
+  }
+  if (S_ISREG(st.st_mode) &&
+      (offset > st.st_size ||
+       (uint64_t)length > (uint64_t)(st.st_size - offset))) {
+    errno = EINVAL;
+    return 0;
+  }
+  if (length == 0) {
+    *slice = gpr_empty_slice();
+    return 1;
+  }
+  /* mmap() wants a page aligned offset */
+  map_offset = offset - offset % page_size;
+  map_length = length + (size_t)(offset - map_offset);
+  map_start = mmap(NULL, map_length, PROT_READ, MAP_SHARED, fd,
+                   (off_t)map_offset);
+  if (map_start == MAP_FAILED) {
+    return 0;
+  }
+  dup_fd = dup(fd);
+  if (dup_fd < 0) {
+    int dup_errno = errno;
+    munmap(map_start, map_length);
+    errno = dup_errno;
+    return 0;
+  }
+  /* only a hint: failing to apply it is harmless */
+  if (advice != GPR_SLICE_MAP_ADVICE_NORMAL) {
+    posix_madvise(map_start, map_length, posix_advice(advice));
+  }
+
+  r = gpr_malloc(sizeof(*r));
+  r->base.ref = mapped_file_ref;
+  r->base.unref = mapped_file_unref;
+  gpr_ref_init(&r->refs, 1);
+  r->fd = dup_fd;
+  r->map_start = map_start;
+  r->map_length = map_length;
+  r->file_offset = map_offset;
+  slice->refcount = &r->base;
+  slice->data.refcounted.bytes =
+      (uint8_t *)map_start + (size_t)(offset - map_offset);
+  slice->data.refcounted.length = length;
+  return 1;
+}
+
+int gpr_slice_get_mapped_file_range(gpr_slice slice, int *fd, int64_t *offset) {
+  mapped_file_refcount *r;
+  if (slice.refcount == NULL || slice.refcount->ref != mapped_file_ref) {
+    return 0;
+  }
+  r = (mapped_file_refcount *)slice.refcount;
+  *fd = r->fd;
+  *offset = r->file_offset +
+            (int64_t)(slice.data.refcounted.bytes - (uint8_t *)r->map_start);
+  return 1;
+}
+
+#endif /* GPR_POSIX_FILE */
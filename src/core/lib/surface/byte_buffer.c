@@ -32,6 +32,10 @@
  */
 
 #include <grpc/byte_buffer.h>
+
+#include <errno.h>
+#include <string.h>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
@@ -55,6 +59,20 @@ grpc_byte_buffer *grpc_raw_compressed_byte_buffer_create(
   return bb;
 }
 
+grpc_byte_buffer *grpc_raw_byte_buffer_from_file(int fd, int64_t offset,
+                                                 size_t length) {
+  grpc_byte_buffer *bb;
+  gpr_slice slice;
+  if (!gpr_slice_from_mapped_file(fd, offset, length,
+                                  GPR_SLICE_MAP_ADVICE_NORMAL, &slice)) {
+    gpr_log(GPR_ERROR, "grpc_raw_byte_buffer_from_file: %s", strerror(errno));
+    return NULL;
+  }
+  bb = grpc_raw_byte_buffer_create(&slice, 1);
+  gpr_slice_unref(slice);
+  return bb;
+}
+
 grpc_byte_buffer *grpc_raw_byte_buffer_from_reader(
     grpc_byte_buffer_reader *reader) {
   grpc_byte_buffer *bb = gpr_malloc(sizeof(grpc_byte_buffer));
@@ -130,3 +130,15 @@ gpr_slice grpc_byte_buffer_reader_readall(grpc_byte_buffer_reader *reader) {
   }
   return out_slice;
 }
+
+gpr_slice grpc_byte_buffer_reader_readall_shared(
+    grpc_byte_buffer_reader *reader) {
+  gpr_slice out_slice;
+  /* a lone slice is already what the caller wants: share it */
+  if (reader->current.index + 1 ==
+      reader->buffer_out->data.raw.slice_buffer.count) {
+    GPR_ASSERT(grpc_byte_buffer_reader_next(reader, &out_slice));
+    return out_slice;
+  }
+  return grpc_byte_buffer_reader_readall(reader);
+}
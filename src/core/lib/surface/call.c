@@ -46,6 +46,8 @@
 
 #include "src/core/lib/channel/channel_stack.h"
 #include "src/core/lib/compression/algorithm_metadata.h"
+#include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/support/string.h"
@@ -162,6 +164,11 @@ struct grpc_call {
 
   /* Compression algorithm for *incoming* data */
   grpc_compression_algorithm incoming_compression_algorithm;
+  /* Set when the incoming data is compressed against a dict/deflate
+     dictionary that isn't the channel's */
+  bool incoming_dictionary_unknown;
+  /* Inflate state for incoming stream/deflate messages, created on first use */
+  grpc_msg_stream_context *stream_decompressor;
   /* Supported encodings (compression algorithms), a bitset */
   uint32_t encodings_accepted_by_peer;
 
@@ -183,6 +190,15 @@ struct grpc_call {
   grpc_slice_buffer_stream sending_stream;
   grpc_byte_stream *receiving_stream;
   grpc_byte_buffer **receiving_buffer;
+  /* number of bytes of receiving_stream read so far */
+  size_t receiving_length;
+  /* decompresses the message being received as its slices arrive */
+  grpc_msg_decompressor *receiving_decompressor;
+  /* set if the message being received is large enough to be decompressed on
+     the executor: its slices are then gathered in receiving_compressed */
+  bool receiving_offloaded;
+  gpr_slice_buffer receiving_compressed;
+  grpc_closure receiving_decompress_offloaded;
   gpr_slice receiving_slice;
   grpc_closure receiving_slice_ready;
   grpc_closure receiving_stream_ready;
@@ -235,6 +251,7 @@ grpc_error *grpc_call_create(const grpc_call_create_args *args,
   *out_call = call;
   memset(call, 0, sizeof(grpc_call));
   gpr_mu_init(&call->mu);
+  gpr_slice_buffer_init(&call->receiving_compressed);
   call->channel = args->channel;
   call->cq = args->cq;
   call->parent = args->parent_call;
@@ -405,6 +422,13 @@ static void destroy_call(grpc_exec_ctx *exec_ctx, void *call,
   if (c->receiving_stream != NULL) {
     grpc_byte_stream_destroy(exec_ctx, c->receiving_stream);
   }
+  if (c->receiving_decompressor != NULL) {
+    grpc_msg_decompressor_destroy(c->receiving_decompressor);
+  }
+  gpr_slice_buffer_destroy(&c->receiving_compressed);
+  if (c->stream_decompressor != NULL) {
+    grpc_msg_stream_context_destroy(c->stream_decompressor);
+  }
   gpr_mu_destroy(&c->mu);
   for (i = 0; i < STATUS_SOURCE_COUNT; i++) {
     if (c->status[i].details) {
@@ -489,12 +513,32 @@ uint32_t grpc_call_test_only_get_message_flags(grpc_call *call) {
 
 static void destroy_encodings_accepted_by_peer(void *p) { return; }
 
+static bool is_dictionary_encoding(gpr_slice encoding) {
+  const size_t prefix_length = strlen(GRPC_DICT_DEFLATE_ENCODING_PREFIX);
+  return GPR_SLICE_LENGTH(encoding) > prefix_length &&
+         0 == memcmp(GPR_SLICE_START_PTR(encoding),
+                     GRPC_DICT_DEFLATE_ENCODING_PREFIX, prefix_length);
+}
+
+/* Returns true if the dict/deflate 'encoding' names the channel's dictionary */
+static bool is_channel_dictionary(grpc_call *call, gpr_slice encoding) {
+  grpc_compression_dictionary *dictionary =
+      grpc_channel_compression_dictionary(call->channel);
+  const char *name;
+  if (dictionary == NULL) return false;
+  name = grpc_compression_dictionary_encoding(dictionary);
+  return GPR_SLICE_LENGTH(encoding) == strlen(name) &&
+         0 == memcmp(GPR_SLICE_START_PTR(encoding), name, strlen(name));
+}
+
 static void set_encodings_accepted_by_peer(grpc_call *call, grpc_mdelem *mdel) {
   size_t i;
   grpc_compression_algorithm algorithm;
   gpr_slice_buffer accept_encoding_parts;
   gpr_slice accept_encoding_slice;
   void *accepted_user_data;
+  /* the bitset only depends on the value, unless it lists dictionaries */
+  bool cacheable = true;
 
   accepted_user_data =
       grpc_mdelem_get_user_data(mdel, destroy_encodings_accepted_by_peer);
@@ -515,7 +559,14 @@ static void set_encodings_accepted_by_peer(grpc_call *call, grpc_mdelem *mdel) {
   for (i = 0; i < accept_encoding_parts.count; i++) {
     const gpr_slice *accept_encoding_entry_slice =
         &accept_encoding_parts.slices[i];
-    if (grpc_compression_algorithm_parse(
+    if (is_dictionary_encoding(*accept_encoding_entry_slice)) {
+      /* of the dictionaries the peer has, only the channel's is of any use */
+      if (is_channel_dictionary(call, *accept_encoding_entry_slice)) {
+        GPR_BITSET(&call->encodings_accepted_by_peer,
+                   GRPC_COMPRESS_DICT_DEFLATE);
+      }
+      cacheable = false;
+    } else if (grpc_compression_algorithm_parse(
             (const char *)GPR_SLICE_START_PTR(*accept_encoding_entry_slice),
             GPR_SLICE_LENGTH(*accept_encoding_entry_slice), &algorithm)) {
       GPR_BITSET(&call->encodings_accepted_by_peer, algorithm);
@@ -531,9 +582,11 @@ static void set_encodings_accepted_by_peer(grpc_call *call, grpc_mdelem *mdel) {
 
   gpr_slice_buffer_destroy(&accept_encoding_parts);
 
-  grpc_mdelem_set_user_data(
-      mdel, destroy_encodings_accepted_by_peer,
-      (void *)(((uintptr_t)call->encodings_accepted_by_peer) + 1));
+  if (cacheable) {
+    grpc_mdelem_set_user_data(
+        mdel, destroy_encodings_accepted_by_peer,
+        (void *)(((uintptr_t)call->encodings_accepted_by_peer) + 1));
+  }
 }
 
 uint32_t grpc_call_test_only_get_encodings_accepted_by_peer(grpc_call *call) {
@@ -909,9 +962,16 @@ static uint32_t decode_status(grpc_mdelem *md) {
   return status;
 }
 
-static grpc_compression_algorithm decode_compression(grpc_mdelem *md) {
+static grpc_compression_algorithm decode_compression(grpc_call *call,
+                                                     grpc_mdelem *md) {
   grpc_compression_algorithm algorithm =
       grpc_compression_algorithm_from_mdstr(md->value);
+  if (algorithm == GRPC_COMPRESS_ALGORITHMS_COUNT &&
+      is_dictionary_encoding(md->value->slice)) {
+    call->incoming_dictionary_unknown =
+        !is_channel_dictionary(call, md->value->slice);
+    return GRPC_COMPRESS_DICT_DEFLATE;
+  }
   if (algorithm == GRPC_COMPRESS_ALGORITHMS_COUNT) {
     const char *md_c_str = grpc_mdstr_as_c_string(md->value);
     gpr_log(GPR_ERROR,
@@ -964,7 +1024,7 @@ static grpc_mdelem *recv_initial_filter(void *callp, grpc_mdelem *elem) {
     return NULL;
   } else if (elem->key == GRPC_MDSTR_GRPC_ENCODING) {
     GPR_TIMER_BEGIN("incoming_compression_algorithm", 0);
-    set_incoming_compression_algorithm(call, decode_compression(elem));
+    set_incoming_compression_algorithm(call, decode_compression(call, elem));
     GPR_TIMER_END("incoming_compression_algorithm", 0);
     return NULL;
   } else if (elem->key == GRPC_MDSTR_GRPC_ACCEPT_ENCODING) {
@@ -1066,26 +1126,101 @@ static void post_batch_completion(grpc_exec_ctx *exec_ctx,
   }
 }
 
+/* Compressed messages are decompressed here, a slice at a time as they are
+   read, rather than all at once by the application's byte buffer reader: the
+   work is spread over the reads and the message is complete as soon as its
+   last slice is in. Large messages are the exception: their slices are only
+   gathered here, and decompressed on the executor once the last one is in. */
+static int add_receiving_slice(grpc_call *call, gpr_slice slice) {
+  gpr_slice_buffer *dest = &(*call->receiving_buffer)->data.raw.slice_buffer;
+  call->receiving_length += GPR_SLICE_LENGTH(slice);
+  if (call->receiving_decompressor == NULL) {
+    gpr_slice_buffer_add(dest, slice);
+    return 1;
+  }
+  if (call->receiving_offloaded) {
+    gpr_slice_buffer_add(&call->receiving_compressed, slice);
+    return 1;
+  }
+  return grpc_msg_decompressor_add(call->receiving_decompressor, slice, dest);
+}
+
+static void finish_decompressing(grpc_exec_ctx *exec_ctx, batch_control *bctl,
+                                 int corrupt) {
+  grpc_call *call = bctl->call;
+  if (call->receiving_decompressor != NULL) {
+    if (!grpc_msg_decompressor_finish(call->receiving_decompressor)) {
+      corrupt = 1;
+    }
+    grpc_msg_decompressor_destroy(call->receiving_decompressor);
+    call->receiving_decompressor = NULL;
+  }
+  if (corrupt) {
+    grpc_byte_buffer_destroy(*call->receiving_buffer);
+    *call->receiving_buffer = NULL;
+    close_with_status(exec_ctx, call, GRPC_STATUS_INTERNAL,
+                      "Failed to decompress message");
+  }
+  if (gpr_unref(&bctl->steps_to_complete)) {
+    post_batch_completion(exec_ctx, bctl);
+  }
+}
+
+static void receiving_decompress_offloaded(grpc_exec_ctx *exec_ctx,
+                                           void *bctlp, grpc_error *error) {
+  batch_control *bctl = bctlp;
+  grpc_call *call = bctl->call;
+  gpr_slice_buffer *dest = &(*call->receiving_buffer)->data.raw.slice_buffer;
+  int corrupt = 0;
+  GPR_TIMER_BEGIN("receiving_decompress_offloaded", 0);
+  while (call->receiving_compressed.count > 0) {
+    gpr_slice slice = gpr_slice_buffer_take_first(&call->receiving_compressed);
+    if (!grpc_msg_decompressor_add(call->receiving_decompressor, slice, dest)) {
+      gpr_slice_buffer_reset_and_unref(&call->receiving_compressed);
+      corrupt = 1;
+    }
+  }
+  finish_decompressing(exec_ctx, bctl, corrupt);
+  GPR_TIMER_END("receiving_decompress_offloaded", 0);
+}
+
+/* Decompressing a large message would hold up the thread that read its last
+   slice (often a poller, with other streams to serve), so that is left to the
+   executor: the batch only completes once it is done. */
+static void finish_receiving_message(grpc_exec_ctx *exec_ctx,
+                                     batch_control *bctl, int corrupt) {
+  grpc_call *call = bctl->call;
+  call->receiving_message = 0;
+  grpc_byte_stream_destroy(exec_ctx, call->receiving_stream);
+  call->receiving_stream = NULL;
+  if (call->receiving_offloaded) {
+    call->receiving_offloaded = false;
+    if (!corrupt) {
+      grpc_executor_push(&call->receiving_decompress_offloaded,
+                         GRPC_ERROR_NONE);
+      return;
+    }
+    gpr_slice_buffer_reset_and_unref(&call->receiving_compressed);
+  }
+  finish_decompressing(exec_ctx, bctl, corrupt);
+}
+
 static void continue_receiving_slices(grpc_exec_ctx *exec_ctx,
                                       batch_control *bctl) {
   grpc_call *call = bctl->call;
   for (;;) {
-    size_t remaining = call->receiving_stream->length -
-                       (*call->receiving_buffer)->data.raw.slice_buffer.length;
+    size_t remaining = call->receiving_stream->length - call->receiving_length;
     if (remaining == 0) {
-      call->receiving_message = 0;
-      grpc_byte_stream_destroy(exec_ctx, call->receiving_stream);
-      call->receiving_stream = NULL;
-      if (gpr_unref(&bctl->steps_to_complete)) {
-        post_batch_completion(exec_ctx, bctl);
-      }
+      finish_receiving_message(exec_ctx, bctl, 0);
       return;
     }
     if (grpc_byte_stream_next(exec_ctx, call->receiving_stream,
                               &call->receiving_slice, remaining,
                               &call->receiving_slice_ready)) {
-      gpr_slice_buffer_add(&(*call->receiving_buffer)->data.raw.slice_buffer,
-                           call->receiving_slice);
+      if (!add_receiving_slice(call, call->receiving_slice)) {
+        finish_receiving_message(exec_ctx, bctl, 1);
+        return;
+      }
     } else {
       return;
     }
@@ -1098,15 +1233,23 @@ static void receiving_slice_ready(grpc_exec_ctx *exec_ctx, void *bctlp,
   grpc_call *call = bctl->call;
 
   if (error == GRPC_ERROR_NONE) {
-    gpr_slice_buffer_add(&(*call->receiving_buffer)->data.raw.slice_buffer,
-                         call->receiving_slice);
-    continue_receiving_slices(exec_ctx, bctl);
+    if (add_receiving_slice(call, call->receiving_slice)) {
+      continue_receiving_slices(exec_ctx, bctl);
+    } else {
+      finish_receiving_message(exec_ctx, bctl, 1);
+    }
   } else {
     if (grpc_trace_operation_failures) {
       GRPC_LOG_IF_ERROR("receiving_slice_ready", GRPC_ERROR_REF(error));
     }
     grpc_byte_stream_destroy(exec_ctx, call->receiving_stream);
     call->receiving_stream = NULL;
+    if (call->receiving_decompressor != NULL) {
+      grpc_msg_decompressor_destroy(call->receiving_decompressor);
+      call->receiving_decompressor = NULL;
+    }
+    call->receiving_offloaded = false;
+    gpr_slice_buffer_reset_and_unref(&call->receiving_compressed);
     grpc_byte_buffer_destroy(*call->receiving_buffer);
     *call->receiving_buffer = NULL;
     if (gpr_unref(&bctl->steps_to_complete)) {
@@ -1126,12 +1269,25 @@ static void process_data_after_md(grpc_exec_ctx *exec_ctx,
     }
   } else {
     call->test_only_last_message_flags = call->receiving_stream->flags;
+    *call->receiving_buffer = grpc_raw_byte_buffer_create(NULL, 0);
+    call->receiving_length = 0;
     if ((call->receiving_stream->flags & GRPC_WRITE_INTERNAL_COMPRESS) &&
         (call->incoming_compression_algorithm > GRPC_COMPRESS_NONE)) {
-      *call->receiving_buffer = grpc_raw_compressed_byte_buffer_create(
-          NULL, 0, call->incoming_compression_algorithm);
-    } else {
-      *call->receiving_buffer = grpc_raw_byte_buffer_create(NULL, 0);
+      if (call->incoming_compression_algorithm ==
+              GRPC_COMPRESS_STREAM_DEFLATE &&
+          call->stream_decompressor == NULL) {
+        call->stream_decompressor = grpc_msg_stream_decompressor_create();
+      }
+      call->receiving_decompressor = grpc_msg_decompressor_create(
+          call->incoming_compression_algorithm, call->stream_decompressor,
+          grpc_channel_compression_dictionary(call->channel));
+      int threshold = grpc_channel_compression_offload_threshold(call->channel);
+      if (threshold >= 0 &&
+          call->receiving_stream->length >= (uint32_t)threshold) {
+        call->receiving_offloaded = true;
+        grpc_closure_init(&call->receiving_decompress_offloaded,
+                          receiving_decompress_offloaded, bctl);
+      }
     }
     grpc_closure_init(&call->receiving_slice_ready, receiving_slice_ready,
                       bctl);
@@ -1185,6 +1341,12 @@ static void validate_filtered_metadata(grpc_exec_ctx *exec_ctx,
                    algo_name);
       gpr_log(GPR_ERROR, "%s", error_msg);
       close_with_status(exec_ctx, call, GRPC_STATUS_UNIMPLEMENTED, error_msg);
+    } else if (call->incoming_dictionary_unknown) {
+      /* peers only use the dictionaries we advertise, unless they were
+         configured with a different one than ours */
+      error_msg = gpr_strdup("Unknown compression dictionary.");
+      gpr_log(GPR_ERROR, "%s", error_msg);
+      close_with_status(exec_ctx, call, GRPC_STATUS_UNIMPLEMENTED, error_msg);
     } else {
       call->incoming_compression_algorithm = algo;
     }
@@ -42,6 +42,7 @@
 #include <grpc/support/string_util.h>
 
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/iomgr/iomgr.h"
 #include "src/core/lib/support/string.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -65,6 +66,11 @@ typedef struct registered_call {
 struct grpc_channel {
   int is_client;
   grpc_compression_options compression_options;
+  /* the dictionary of GRPC_COMPRESS_DICT_DEFLATE, sent and received */
+  grpc_compression_dictionary *compression_dictionary;
+  /* received messages of at least this many (compressed) bytes are
+     decompressed on the executor */
+  int compression_offload_threshold;
   grpc_mdelem *default_authority;
 
   gpr_mu registered_call_mu;
@@ -164,6 +170,10 @@ grpc_channel *grpc_channel_create(grpc_exec_ctx *exec_ctx, const char *target,
             0x1; /* always support no compression */
       }
     }
+    channel->compression_dictionary =
+        grpc_compression_dictionary_from_channel_args(args);
+    channel->compression_offload_threshold =
+        grpc_compression_offload_threshold_from_channel_args(args);
     grpc_channel_args_destroy(args);
   }
 
@@ -325,6 +335,9 @@ static void destroy_channel(grpc_exec_ctx *exec_ctx, void *arg,
   if (channel->default_authority != NULL) {
     GRPC_MDELEM_UNREF(channel->default_authority);
   }
+  if (channel->compression_dictionary != NULL) {
+    grpc_compression_dictionary_unref(channel->compression_dictionary);
+  }
   gpr_mu_destroy(&channel->registered_call_mu);
   gpr_free(channel->target);
   gpr_free(channel);
@@ -353,6 +366,15 @@ grpc_compression_options grpc_channel_compression_options(
   return channel->compression_options;
 }
 
+grpc_compression_dictionary *grpc_channel_compression_dictionary(
+    const grpc_channel *channel) {
+  return channel->compression_dictionary;
+}
+
+int grpc_channel_compression_offload_threshold(const grpc_channel *channel) {
+  return channel->compression_offload_threshold;
+}
+
 grpc_mdelem *grpc_channel_get_reffed_status_elem(grpc_channel *channel, int i) {
   char tmp[GPR_LTOA_MIN_BUFSIZE];
   switch (i) {
@@ -87,4 +87,14 @@ void grpc_channel_internal_unref(grpc_exec_ctx *exec_ctx,
 grpc_compression_options grpc_channel_compression_options(
     const grpc_channel *channel);
 
+/** Return the channel's (borrowed) GRPC_COMPRESS_DICT_DEFLATE dictionary, or
+    NULL if it has none. */
+grpc_compression_dictionary *grpc_channel_compression_dictionary(
+    const grpc_channel *channel);
+
+/** Return the size from which the channel's received messages are
+    decompressed on the executor (GRPC_ARG_COMPRESSION_OFFLOAD_THRESHOLD), or
+    -1 if they never are. */
+int grpc_channel_compression_offload_threshold(const grpc_channel *channel);
+
 #endif /* GRPC_CORE_LIB_SURFACE_CHANNEL_H */
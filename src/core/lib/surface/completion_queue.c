@@ -41,6 +41,7 @@
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/time.h>
+#include <grpc/support/tls.h>
 
 #include "src/core/lib/iomgr/pollset.h"
 #include "src/core/lib/iomgr/timer.h"
@@ -84,6 +85,16 @@ struct grpc_completion_queue {
   plucker pluckers[GRPC_MAX_COMPLETION_QUEUE_PLUCKERS];
   grpc_closure pollset_shutdown_done;
 
+  /** for a sharded queue (see grpc_completion_queue_create_sharded): all of
+      its shards, the first of which is the queue handed to the application,
+      and our index among them; NULL for a plain queue */
+  grpc_completion_queue **shards;
+  size_t num_shards;
+  size_t shard_index;
+  /** number of threads committed to waiting on our pollset: an event queued
+      on a sibling shard that has none of its own kicks one of them */
+  gpr_atm num_waiters;
+
 #ifndef NDEBUG
   void **outstanding_tags;
   size_t outstanding_tag_count;
@@ -99,6 +110,11 @@ struct grpc_completion_queue {
 static gpr_mu g_freelist_mu;
 static grpc_completion_queue *g_freelist;
 
+/* 1 + a serial number handed out to each thread the first time it uses a
+   sharded queue, which picks its home shard (0 means not handed out yet) */
+GPR_TLS_DECL(g_thread_serial);
+static gpr_atm g_next_thread_serial;
+
 int grpc_cq_pluck_trace;
 int grpc_cq_event_timeout_trace;
 
@@ -113,10 +129,14 @@ int grpc_cq_event_timeout_trace;
 static void on_pollset_shutdown_done(grpc_exec_ctx *exec_ctx, void *cc,
                                      grpc_error *error);
 
-void grpc_cq_global_init(void) { gpr_mu_init(&g_freelist_mu); }
+void grpc_cq_global_init(void) {
+  gpr_mu_init(&g_freelist_mu);
+  gpr_tls_init(&g_thread_serial);
+}
 
 void grpc_cq_global_shutdown(void) {
   gpr_mu_destroy(&g_freelist_mu);
+  gpr_tls_destroy(&g_thread_serial);
   while (g_freelist) {
     grpc_completion_queue *next = g_freelist->next_free;
     grpc_pollset_destroy(POLLSET_FROM_CQ(g_freelist));
@@ -165,6 +185,10 @@ grpc_completion_queue *grpc_completion_queue_create(void *reserved) {
   cc->is_non_listening_server_cq = 0;
   cc->num_pluckers = 0;
   gpr_atm_no_barrier_store(&cc->things_queued_ever, 0);
+  cc->shards = NULL;
+  cc->num_shards = 1;
+  cc->shard_index = 0;
+  gpr_atm_no_barrier_store(&cc->num_waiters, 0);
 #ifndef NDEBUG
   cc->outstanding_tag_count = 0;
 #endif
@@ -175,6 +199,39 @@ grpc_completion_queue *grpc_completion_queue_create(void *reserved) {
   return cc;
 }
 
+grpc_completion_queue *grpc_completion_queue_create_sharded(size_t num_shards) {
+  grpc_completion_queue **shards;
+  size_t i;
+  GPR_ASSERT(num_shards > 0);
+  shards = gpr_malloc(num_shards * sizeof(*shards));
+  for (i = 0; i < num_shards; i++) {
+    shards[i] = grpc_completion_queue_create(NULL);
+    shards[i]->shards = shards;
+    shards[i]->num_shards = num_shards;
+    shards[i]->shard_index = i;
+  }
+  return shards[0];
+}
+
+size_t grpc_cq_num_shards(grpc_completion_queue *cc) { return cc->num_shards; }
+
+grpc_completion_queue *grpc_cq_shard(grpc_completion_queue *cc, size_t index) {
+  GPR_ASSERT(index < cc->num_shards);
+  return cc->shards == NULL ? cc : cc->shards[index];
+}
+
+grpc_completion_queue *grpc_cq_shard_for_current_thread(
+    grpc_completion_queue *cc) {
+  intptr_t serial;
+  if (cc->shards == NULL) return cc;
+  serial = gpr_tls_get(&g_thread_serial);
+  if (serial == 0) {
+    serial = gpr_atm_no_barrier_fetch_add(&g_next_thread_serial, 1) + 1;
+    gpr_tls_set(&g_thread_serial, serial);
+  }
+  return cc->shards[(size_t)(serial - 1) % cc->num_shards];
+}
+
 #ifdef GRPC_CQ_REF_COUNT_DEBUG
 void grpc_cq_internal_ref(grpc_completion_queue *cc, const char *reason,
                           const char *file, int line) {
@@ -210,6 +267,45 @@ void grpc_cq_internal_unref(grpc_completion_queue *cc) {
   }
 }
 
+/* Pick a sibling shard to kick for an event just queued on cc, which has no
+   waiter of its own to take it, and ref it for kick_sibling. Called with
+   cc->mu held: the shards aren't destroyed until cc has returned its last
+   event, which it can't do before we let go of it. A waiter increments its
+   num_waiters before it looks for events on the other shards, under their
+   locks, so either it finds this event or we see it waiting. */
+static grpc_completion_queue *sibling_to_kick(grpc_completion_queue *cc) {
+  size_t i;
+  if (cc->shards == NULL || gpr_atm_no_barrier_load(&cc->num_waiters) > 0) {
+    return NULL;
+  }
+  for (i = 1; i < cc->num_shards; i++) {
+    grpc_completion_queue *sibling =
+        cc->shards[(cc->shard_index + i) % cc->num_shards];
+    if (gpr_atm_no_barrier_load(&sibling->num_waiters) > 0) {
+      GRPC_CQ_INTERNAL_REF(sibling, "kick");
+      return sibling;
+    }
+  }
+  return NULL;
+}
+
+static void kick_sibling(grpc_completion_queue *sibling) {
+  grpc_error *kick_error = GRPC_ERROR_NONE;
+  if (sibling == NULL) return;
+  gpr_mu_lock(sibling->mu);
+  if (!sibling->shutdown) {
+    kick_error = grpc_pollset_kick(POLLSET_FROM_CQ(sibling), NULL);
+  }
+  gpr_mu_unlock(sibling->mu);
+  if (kick_error != GRPC_ERROR_NONE) {
+    const char *msg = grpc_error_string(kick_error);
+    gpr_log(GPR_ERROR, "Kick failed: %s", msg);
+    grpc_error_free_string(msg);
+    GRPC_ERROR_UNREF(kick_error);
+  }
+  GRPC_CQ_INTERNAL_UNREF(sibling, "kick");
+}
+
 void grpc_cq_begin_op(grpc_completion_queue *cc, void *tag) {
 #ifndef NDEBUG
   gpr_mu_lock(cc->mu);
@@ -237,6 +333,7 @@ void grpc_cq_end_op(grpc_exec_ctx *exec_ctx, grpc_completion_queue *cc,
   int shutdown;
   int i;
   grpc_pollset_worker *pluck_worker;
+  grpc_completion_queue *sibling;
 #ifndef NDEBUG
   int found = 0;
 #endif
@@ -289,6 +386,7 @@ void grpc_cq_end_op(grpc_exec_ctx *exec_ctx, grpc_completion_queue *cc,
     }
     grpc_error *kick_error =
         grpc_pollset_kick(POLLSET_FROM_CQ(cc), pluck_worker);
+    sibling = sibling_to_kick(cc);
     gpr_mu_unlock(cc->mu);
     if (kick_error != GRPC_ERROR_NONE) {
       const char *msg = grpc_error_string(kick_error);
@@ -296,6 +394,7 @@ void grpc_cq_end_op(grpc_exec_ctx *exec_ctx, grpc_completion_queue *cc,
       grpc_error_free_string(msg);
       GRPC_ERROR_UNREF(kick_error);
     }
+    kick_sibling(sibling);
   } else {
     cc->completed_tail->next =
         ((uintptr_t)storage) | (1u & (uintptr_t)cc->completed_tail->next);
@@ -305,7 +404,9 @@ void grpc_cq_end_op(grpc_exec_ctx *exec_ctx, grpc_completion_queue *cc,
     cc->shutdown = 1;
     grpc_pollset_shutdown(exec_ctx, POLLSET_FROM_CQ(cc),
                           &cc->pollset_shutdown_done);
+    sibling = sibling_to_kick(cc);
     gpr_mu_unlock(cc->mu);
+    kick_sibling(sibling);
   }
 
   GPR_TIMER_END("grpc_cq_end_op", 0);
@@ -368,28 +469,44 @@ static void dump_pending_tags(grpc_completion_queue *cc) {
 static void dump_pending_tags(grpc_completion_queue *cc) {}
 #endif
 
-grpc_event grpc_completion_queue_next(grpc_completion_queue *cc,
-                                      gpr_timespec deadline, void *reserved) {
+/* Takes the oldest completion queued on cc, if any. Called with cc->mu held. */
+static grpc_cq_completion *pop_completion(grpc_completion_queue *cc) {
+  grpc_cq_completion *c;
+  if (cc->completed_tail == &cc->completed_head) return NULL;
+  c = (grpc_cq_completion *)cc->completed_head.next;
+  cc->completed_head.next = c->next & ~(uintptr_t)1;
+  if (c == cc->completed_tail) {
+    cc->completed_tail = &cc->completed_head;
+  }
+  return c;
+}
+
+/* Takes the oldest completion queued on one of the other shards of cc, if
+   any, starting with the one after cc. Called without cc->mu held. */
+static grpc_cq_completion *steal_completion(grpc_completion_queue *cc) {
+  size_t i;
+  for (i = 1; i < cc->num_shards; i++) {
+    grpc_completion_queue *sibling =
+        cc->shards[(cc->shard_index + i) % cc->num_shards];
+    grpc_cq_completion *c;
+    gpr_mu_lock(sibling->mu);
+    c = pop_completion(sibling);
+    gpr_mu_unlock(sibling->mu);
+    if (c != NULL) return c;
+  }
+  return NULL;
+}
+
+/* grpc_completion_queue_next on a single queue, or on a single shard of a
+   sharded queue, in which case events are also taken from the other shards
+   when this one has none */
+static grpc_event cq_next(grpc_completion_queue *cc, gpr_timespec deadline) {
   grpc_event ret;
   grpc_pollset_worker *worker = NULL;
   gpr_timespec now;
 
-  GPR_TIMER_BEGIN("grpc_completion_queue_next", 0);
-
-  GRPC_API_TRACE(
-      "grpc_completion_queue_next("
-      "cc=%p, "
-      "deadline=gpr_timespec { tv_sec: %" PRId64
-      ", tv_nsec: %d, clock_type: %d }, "
-      "reserved=%p)",
-      5, (cc, deadline.tv_sec, deadline.tv_nsec, (int)deadline.clock_type,
-          reserved));
-  GPR_ASSERT(!reserved);
-
   dump_pending_tags(cc);
 
-  deadline = gpr_convert_clock_type(deadline, GPR_CLOCK_MONOTONIC);
-
   GRPC_CQ_INTERNAL_REF(cc, "next");
   gpr_mu_lock(cc->mu);
   cq_is_finished_arg is_finished_arg = {
@@ -413,12 +530,8 @@ grpc_event grpc_completion_queue_next(grpc_completion_queue *cc,
       c->done(&exec_ctx, c->done_arg, c);
       break;
     }
-    if (cc->completed_tail != &cc->completed_head) {
-      grpc_cq_completion *c = (grpc_cq_completion *)cc->completed_head.next;
-      cc->completed_head.next = c->next & ~(uintptr_t)1;
-      if (c == cc->completed_tail) {
-        cc->completed_tail = &cc->completed_head;
-      }
+    grpc_cq_completion *c = pop_completion(cc);
+    if (c != NULL) {
       gpr_mu_unlock(cc->mu);
       ret.type = GRPC_OP_COMPLETE;
       ret.success = c->next & 1u;
@@ -440,6 +553,20 @@ grpc_event grpc_completion_queue_next(grpc_completion_queue *cc,
       dump_pending_tags(cc);
       break;
     }
+    if (cc->shards != NULL) {
+      /* Nothing here: before waiting, take an event queued on another shard.
+         Count ourselves as a waiter first, so that one queued there once we've
+         looked kicks us (see sibling_to_kick). */
+      gpr_atm_full_fetch_add(&cc->num_waiters, 1);
+      gpr_mu_unlock(cc->mu);
+      c = steal_completion(cc);
+      gpr_mu_lock(cc->mu);
+      if (c != NULL) {
+        gpr_atm_full_fetch_add(&cc->num_waiters, -1);
+        is_finished_arg.stolen_completion = c;
+        continue;
+      }
+    }
     /* Check alarms - these are a global resource so we just ping
        each time through on every pollset.
        May update deadline to ensure timely wakeups.
@@ -447,6 +574,7 @@ grpc_event grpc_completion_queue_next(grpc_completion_queue *cc,
     gpr_timespec iteration_deadline = deadline;
     if (grpc_timer_check(&exec_ctx, now, &iteration_deadline)) {
       GPR_TIMER_MARK("alarm_triggered", 0);
+      if (cc->shards != NULL) gpr_atm_full_fetch_add(&cc->num_waiters, -1);
       gpr_mu_unlock(cc->mu);
       grpc_exec_ctx_flush(&exec_ctx);
       gpr_mu_lock(cc->mu);
@@ -454,6 +582,7 @@ grpc_event grpc_completion_queue_next(grpc_completion_queue *cc,
     } else {
       grpc_error *err = grpc_pollset_work(&exec_ctx, POLLSET_FROM_CQ(cc),
                                           &worker, now, iteration_deadline);
+      if (cc->shards != NULL) gpr_atm_full_fetch_add(&cc->num_waiters, -1);
       if (err != GRPC_ERROR_NONE) {
         gpr_mu_unlock(cc->mu);
         const char *msg = grpc_error_string(err);
@@ -473,6 +602,60 @@ grpc_event grpc_completion_queue_next(grpc_completion_queue *cc,
   grpc_exec_ctx_finish(&exec_ctx);
   GPR_ASSERT(is_finished_arg.stolen_completion == NULL);
 
+  return ret;
+}
+
+/* The index of the shard of the sharded queue cc the calling thread should
+   wait on. Events queued on a shard nobody waits on are handed to a waiter of
+   another shard, but its pollset isn't polled: someone must always wait on the
+   first shard, the only one the server accepts new channels on, and the home
+   shard of the thread is only preferred as long as it's not polled by someone
+   else while another shard isn't. */
+static size_t shard_to_wait_on(grpc_completion_queue *cc) {
+  size_t home = grpc_cq_shard_for_current_thread(cc)->shard_index;
+  size_t i;
+  if (gpr_atm_no_barrier_load(&cc->shards[0]->num_waiters) == 0) return 0;
+  if (gpr_atm_no_barrier_load(&cc->shards[home]->num_waiters) == 0) {
+    return home;
+  }
+  for (i = 1; i < cc->num_shards; i++) {
+    if (gpr_atm_no_barrier_load(&cc->shards[i]->num_waiters) == 0) return i;
+  }
+  return home;
+}
+
+grpc_event grpc_completion_queue_next(grpc_completion_queue *cc,
+                                      gpr_timespec deadline, void *reserved) {
+  grpc_event ret;
+  size_t first;
+  size_t i;
+
+  GPR_TIMER_BEGIN("grpc_completion_queue_next", 0);
+
+  GRPC_API_TRACE(
+      "grpc_completion_queue_next("
+      "cc=%p, "
+      "deadline=gpr_timespec { tv_sec: %" PRId64
+      ", tv_nsec: %d, clock_type: %d }, "
+      "reserved=%p)",
+      5, (cc, deadline.tv_sec, deadline.tv_nsec, (int)deadline.clock_type,
+          reserved));
+  GPR_ASSERT(!reserved);
+
+  deadline = gpr_convert_clock_type(deadline, GPR_CLOCK_MONOTONIC);
+
+  if (cc->shards == NULL) {
+    ret = cq_next(cc, deadline);
+  } else {
+    /* wait on the shard picked by shard_to_wait_on, or on the next one that
+       isn't drained yet once it is */
+    first = shard_to_wait_on(cc);
+    for (i = 0; i < cc->num_shards; i++) {
+      ret = cq_next(cc->shards[(first + i) % cc->num_shards], deadline);
+      if (ret.type != GRPC_QUEUE_SHUTDOWN) break;
+    }
+  }
+
   GPR_TIMER_END("grpc_completion_queue_next", 0);
 
   return ret;
@@ -543,6 +726,9 @@ grpc_event grpc_completion_queue_pluck(grpc_completion_queue *cc, void *tag,
 
   GPR_TIMER_BEGIN("grpc_completion_queue_pluck", 0);
 
+  /* the tag may be queued on any shard */
+  GPR_ASSERT(cc->shards == NULL);
+
   if (grpc_cq_pluck_trace) {
     GRPC_API_TRACE(
         "grpc_completion_queue_pluck("
@@ -668,10 +854,9 @@ done:
 
 /* Shutdown simply drops a ref that we reserved at creation time; if we drop
    to zero here, then enter shutdown mode and wake up any waiters */
-void grpc_completion_queue_shutdown(grpc_completion_queue *cc) {
+static void cq_shutdown(grpc_completion_queue *cc) {
   grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
   GPR_TIMER_BEGIN("grpc_completion_queue_shutdown", 0);
-  GRPC_API_TRACE("grpc_completion_queue_shutdown(cc=%p)", 1, (cc));
   gpr_mu_lock(cc->mu);
   if (cc->shutdown_called) {
     gpr_mu_unlock(cc->mu);
@@ -690,11 +875,39 @@ void grpc_completion_queue_shutdown(grpc_completion_queue *cc) {
   GPR_TIMER_END("grpc_completion_queue_shutdown", 0);
 }
 
+void grpc_completion_queue_shutdown(grpc_completion_queue *cc) {
+  size_t i;
+  GRPC_API_TRACE("grpc_completion_queue_shutdown(cc=%p)", 1, (cc));
+  if (cc->shards == NULL) {
+    cq_shutdown(cc);
+  } else {
+    for (i = 0; i < cc->num_shards; i++) {
+      cq_shutdown(cc->shards[i]);
+    }
+  }
+}
+
 void grpc_completion_queue_destroy(grpc_completion_queue *cc) {
+  grpc_completion_queue **shards = cc->shards;
+  size_t num_shards = cc->num_shards;
+  size_t i;
   GRPC_API_TRACE("grpc_completion_queue_destroy(cc=%p)", 1, (cc));
   GPR_TIMER_BEGIN("grpc_completion_queue_destroy", 0);
   grpc_completion_queue_shutdown(cc);
-  GRPC_CQ_INTERNAL_UNREF(cc, "destroy");
+  if (shards == NULL) {
+    GRPC_CQ_INTERNAL_UNREF(cc, "destroy");
+  } else {
+    /* the shards may outlive us for a while (see sibling_to_kick), but they
+       no longer get any event to share */
+    for (i = 0; i < num_shards; i++) {
+      grpc_completion_queue *shard = shards[i];
+      gpr_mu_lock(shard->mu);
+      shard->shards = NULL;
+      gpr_mu_unlock(shard->mu);
+      GRPC_CQ_INTERNAL_UNREF(shard, "destroy");
+    }
+    gpr_free(shards);
+  }
   GPR_TIMER_END("grpc_completion_queue_destroy", 0);
 }
 
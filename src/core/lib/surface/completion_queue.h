@@ -39,6 +39,10 @@
 #include <grpc/grpc.h>
 #include "src/core/lib/iomgr/pollset.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* These trace flags default to 1. The corresponding lines are only traced
    if grpc_api_trace is also truthy */
 extern int grpc_cq_pluck_trace;
@@ -94,6 +98,29 @@ void grpc_cq_end_op(grpc_exec_ctx *exec_ctx, grpc_completion_queue *cc,
 grpc_pollset *grpc_cq_pollset(grpc_completion_queue *cc);
 grpc_completion_queue *grpc_cq_from_pollset(grpc_pollset *ps);
 
+/* Create a completion queue made of \a num_shards (> 0) shards, each with its
+   own lock and pollset, behind a single handle (the returned queue, which is
+   also the first shard). Each thread has a home shard, where
+   grpc_completion_queue_next on the handle waits unless another shard has
+   nobody waiting on it; it takes events queued on the other shards when the
+   one it waits on has none, and an event queued on a shard nobody waits on
+   kicks a thread waiting on another one. Shutting down or
+   destroying the handle does so for all the shards, and
+   grpc_completion_queue_next returns GRPC_QUEUE_SHUTDOWN once they're all
+   drained. Plucking isn't supported. */
+grpc_completion_queue *grpc_completion_queue_create_sharded(size_t num_shards);
+
+/* Number of shards of \a cc, and the \a index-th of them: a queue that isn't
+   sharded is its own single shard. */
+size_t grpc_cq_num_shards(grpc_completion_queue *cc);
+grpc_completion_queue *grpc_cq_shard(grpc_completion_queue *cc, size_t index);
+
+/* The home shard of the calling thread in \a cc, which is where operations
+   started on \a cc from this thread should complete; \a cc itself if it
+   isn't sharded. */
+grpc_completion_queue *grpc_cq_shard_for_current_thread(
+    grpc_completion_queue *cc);
+
 void grpc_cq_mark_non_listening_server_cq(grpc_completion_queue *cc);
 bool grpc_cq_is_non_listening_server_cq(grpc_completion_queue *cc);
 void grpc_cq_mark_server_cq(grpc_completion_queue *cc);
@@ -102,4 +129,8 @@ int grpc_cq_is_server_cq(grpc_completion_queue *cc);
 void grpc_cq_global_init(void);
 void grpc_cq_global_shutdown(void);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* GRPC_CORE_LIB_SURFACE_COMPLETION_QUEUE_H */
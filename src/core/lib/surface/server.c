@@ -45,6 +45,7 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/connected_channel.h"
 #include "src/core/lib/iomgr/iomgr.h"
+#include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/support/stack_lockfree.h"
 #include "src/core/lib/support/string.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -229,6 +230,11 @@ struct grpc_server {
 
   /** when did we print the last shutdown progress message */
   gpr_timespec last_shutdown_message_time;
+
+  /** cancels the calls still running at the deadline passed to
+      grpc_server_drain_and_notify */
+  bool drain_timer_pending;
+  grpc_timer drain_timer;
 };
 
 #define SERVER_FROM_CALL_ELEM(elem) \
@@ -275,7 +281,8 @@ static void shutdown_cleanup(grpc_exec_ctx *exec_ctx, void *arg,
 }
 
 static void send_shutdown(grpc_exec_ctx *exec_ctx, grpc_channel *channel,
-                          int send_goaway, grpc_error *send_disconnect) {
+                          int send_goaway, bool graceful_goaway,
+                          grpc_error *send_disconnect) {
   struct shutdown_cleanup_args *sc = gpr_malloc(sizeof(*sc));
   grpc_closure_init(&sc->closure, shutdown_cleanup, sc);
   grpc_transport_op *op = grpc_make_transport_op(&sc->closure);
@@ -286,6 +293,7 @@ static void send_shutdown(grpc_exec_ctx *exec_ctx, grpc_channel *channel,
   sc->slice = gpr_slice_from_copied_string("Server shutdown");
   op->goaway_message = &sc->slice;
   op->goaway_status = GRPC_STATUS_OK;
+  op->graceful_goaway = graceful_goaway;
   op->disconnect_with_error = send_disconnect;
 
   elem = grpc_channel_stack_element(grpc_channel_get_channel_stack(channel), 0);
@@ -295,11 +303,12 @@ static void send_shutdown(grpc_exec_ctx *exec_ctx, grpc_channel *channel,
 static void channel_broadcaster_shutdown(grpc_exec_ctx *exec_ctx,
                                          channel_broadcaster *cb,
                                          bool send_goaway,
+                                         bool graceful_goaway,
                                          grpc_error *force_disconnect) {
   size_t i;
 
   for (i = 0; i < cb->num_channels; i++) {
-    send_shutdown(exec_ctx, cb->channels[i], send_goaway,
+    send_shutdown(exec_ctx, cb->channels[i], send_goaway, graceful_goaway,
                   GRPC_ERROR_REF(force_disconnect));
     GRPC_CHANNEL_INTERNAL_UNREF(exec_ctx, cb->channels[i], "broadcast");
   }
@@ -730,6 +739,9 @@ static void maybe_finish_shutdown(grpc_exec_ctx *exec_ctx,
     return;
   }
   server->shutdown_published = 1;
+  if (server->drain_timer_pending) {
+    grpc_timer_cancel(exec_ctx, &server->drain_timer);
+  }
   for (i = 0; i < server->num_shutdown_tags; i++) {
     server_ref(server);
     grpc_cq_end_op(exec_ctx, server->shutdown_tags[i].cq,
@@ -968,11 +980,10 @@ const grpc_channel_filter grpc_server_top_filter = {
     "server",
 };
 
-static void register_completion_queue(grpc_server *server,
-                                      grpc_completion_queue *cq,
-                                      bool is_non_listening, void *reserved) {
+static void register_completion_queue_shard(grpc_server *server,
+                                            grpc_completion_queue *cq,
+                                            bool is_non_listening) {
   size_t i, n;
-  GPR_ASSERT(!reserved);
   for (i = 0; i < server->cq_count; i++) {
     if (server->cqs[i] == cq) return;
   }
@@ -990,6 +1001,20 @@ static void register_completion_queue(grpc_server *server,
   server->cqs[n] = cq;
 }
 
+static void register_completion_queue(grpc_server *server,
+                                      grpc_completion_queue *cq,
+                                      bool is_non_listening, void *reserved) {
+  size_t i;
+  GPR_ASSERT(!reserved);
+  /* each shard of a sharded queue is a queue of its own for the server, but
+     only the first one, which someone always waits on while anyone waits on
+     the queue, listens for new channels */
+  for (i = 0; i < grpc_cq_num_shards(cq); i++) {
+    register_completion_queue_shard(server, grpc_cq_shard(cq, i),
+                                    is_non_listening || i > 0);
+  }
+}
+
 void grpc_server_register_completion_queue(grpc_server *server,
                                            grpc_completion_queue *cq,
                                            void *reserved) {
@@ -1226,24 +1251,24 @@ static void listener_destroy_done(grpc_exec_ctx *exec_ctx, void *s,
   gpr_mu_unlock(&server->mu_global);
 }
 
-void grpc_server_shutdown_and_notify(grpc_server *server,
-                                     grpc_completion_queue *cq, void *tag) {
+/* graceful_goaway: whether the goaways sent to the connections should wait
+   for a ping round trip with the client (see grpc_transport_op). Nothing
+   may be polling an idle client channel, so a plain shutdown doesn't. */
+static void shutdown_and_notify(grpc_exec_ctx *exec_ctx, grpc_server *server,
+                                grpc_completion_queue *cq, void *tag,
+                                bool graceful_goaway) {
   listener *l;
   shutdown_tag *sdt;
   channel_broadcaster broadcaster;
-  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
-
-  GRPC_API_TRACE("grpc_server_shutdown_and_notify(server=%p, cq=%p, tag=%p)", 3,
-                 (server, cq, tag));
 
   /* lock, and gather up some stuff to do */
   gpr_mu_lock(&server->mu_global);
   grpc_cq_begin_op(cq, tag);
   if (server->shutdown_published) {
-    grpc_cq_end_op(&exec_ctx, cq, tag, GRPC_ERROR_NONE, done_published_shutdown,
+    grpc_cq_end_op(exec_ctx, cq, tag, GRPC_ERROR_NONE, done_published_shutdown,
                    NULL, gpr_malloc(sizeof(grpc_cq_completion)));
     gpr_mu_unlock(&server->mu_global);
-    goto done;
+    return;
   }
   server->shutdown_tags =
       gpr_realloc(server->shutdown_tags,
@@ -1253,7 +1278,7 @@ void grpc_server_shutdown_and_notify(grpc_server *server,
   sdt->cq = cq;
   if (gpr_atm_acq_load(&server->shutdown_flag)) {
     gpr_mu_unlock(&server->mu_global);
-    goto done;
+    return;
   }
 
   server->last_shutdown_message_time = gpr_now(GPR_CLOCK_REALTIME);
@@ -1264,38 +1289,94 @@ void grpc_server_shutdown_and_notify(grpc_server *server,
 
   /* collect all unregistered then registered calls */
   gpr_mu_lock(&server->mu_call);
-  kill_pending_work_locked(&exec_ctx, server,
+  kill_pending_work_locked(exec_ctx, server,
                            GRPC_ERROR_CREATE("Server Shutdown"));
   gpr_mu_unlock(&server->mu_call);
 
-  maybe_finish_shutdown(&exec_ctx, server);
+  maybe_finish_shutdown(exec_ctx, server);
   gpr_mu_unlock(&server->mu_global);
 
   /* Shutdown listeners */
   for (l = server->listeners; l; l = l->next) {
     grpc_closure_init(&l->destroy_done, listener_destroy_done, server);
-    l->destroy(&exec_ctx, server, l->arg, &l->destroy_done);
+    l->destroy(exec_ctx, server, l->arg, &l->destroy_done);
   }
 
-  channel_broadcaster_shutdown(&exec_ctx, &broadcaster, true /* send_goaway */,
-                               GRPC_ERROR_NONE);
+  channel_broadcaster_shutdown(exec_ctx, &broadcaster, true /* send_goaway */,
+                               graceful_goaway, GRPC_ERROR_NONE);
+}
 
-done:
+void grpc_server_shutdown_and_notify(grpc_server *server,
+                                     grpc_completion_queue *cq, void *tag) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  GRPC_API_TRACE("grpc_server_shutdown_and_notify(server=%p, cq=%p, tag=%p)", 3,
+                 (server, cq, tag));
+
+  shutdown_and_notify(&exec_ctx, server, cq, tag, false);
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
-void grpc_server_cancel_all_calls(grpc_server *server) {
+static void cancel_all_calls(grpc_exec_ctx *exec_ctx, grpc_server *server,
+                             grpc_error *error) {
   channel_broadcaster broadcaster;
+
+  gpr_mu_lock(&server->mu_global);
+  channel_broadcaster_init(server, &broadcaster);
+  gpr_mu_unlock(&server->mu_global);
+
+  channel_broadcaster_shutdown(exec_ctx, &broadcaster, false /* send_goaway */,
+                               false, error);
+}
+
+void grpc_server_cancel_all_calls(grpc_server *server) {
   grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
 
   GRPC_API_TRACE("grpc_server_cancel_all_calls(server=%p)", 1, (server));
 
+  cancel_all_calls(&exec_ctx, server,
+                   GRPC_ERROR_CREATE("Cancelling all calls"));
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+static void drain_deadline_reached(grpc_exec_ctx *exec_ctx, void *arg,
+                                   grpc_error *error) {
+  grpc_server *server = arg;
   gpr_mu_lock(&server->mu_global);
-  channel_broadcaster_init(server, &broadcaster);
+  server->drain_timer_pending = false;
   gpr_mu_unlock(&server->mu_global);
+  if (error == GRPC_ERROR_NONE) {
+    cancel_all_calls(
+        exec_ctx, server,
+        grpc_error_set_int(GRPC_ERROR_CREATE("Server drain timed out"),
+                           GRPC_ERROR_INT_GRPC_STATUS,
+                           GRPC_STATUS_UNAVAILABLE));
+  }
+  server_unref(exec_ctx, server);
+}
+
+void grpc_server_drain_and_notify(grpc_server *server, gpr_timespec deadline,
+                                  grpc_completion_queue *cq, void *tag) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
 
-  channel_broadcaster_shutdown(&exec_ctx, &broadcaster, false /* send_goaway */,
-                               GRPC_ERROR_CREATE("Cancelling all calls"));
+  GRPC_API_TRACE(
+      "grpc_server_drain_and_notify(server=%p, deadline=gpr_timespec { "
+      "tv_sec: %" PRId64 ", tv_nsec: %d, clock_type: %d }, cq=%p, tag=%p)",
+      6, (server, deadline.tv_sec, deadline.tv_nsec, (int)deadline.clock_type,
+          cq, tag));
+
+  shutdown_and_notify(&exec_ctx, server, cq, tag, true);
+
+  gpr_mu_lock(&server->mu_global);
+  if (!server->shutdown_published && !server->drain_timer_pending) {
+    server->drain_timer_pending = true;
+    server_ref(server);
+    grpc_timer_init(&exec_ctx, &server->drain_timer,
+                    gpr_convert_clock_type(deadline, GPR_CLOCK_MONOTONIC),
+                    drain_deadline_reached, server,
+                    gpr_now(GPR_CLOCK_MONOTONIC));
+  }
+  gpr_mu_unlock(&server->mu_global);
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
@@ -1410,6 +1491,9 @@ grpc_call_error grpc_server_request_call(
       "cq_bound_to_call=%p, cq_for_notification=%p, tag=%p)",
       7, (server, call, details, initial_metadata, cq_bound_to_call,
           cq_for_notification, tag));
+  /* calls requested on a sharded queue are for the calling thread's shard */
+  cq_bound_to_call = grpc_cq_shard_for_current_thread(cq_bound_to_call);
+  cq_for_notification = grpc_cq_shard_for_current_thread(cq_for_notification);
   size_t cq_idx;
   for (cq_idx = 0; cq_idx < server->cq_count; cq_idx++) {
     if (server->cqs[cq_idx] == cq_for_notification) {
@@ -1454,6 +1538,9 @@ grpc_call_error grpc_server_request_registered_call(
       9, (server, rmp, call, deadline, initial_metadata, optional_payload,
           cq_bound_to_call, cq_for_notification, tag));
 
+  /* calls requested on a sharded queue are for the calling thread's shard */
+  cq_bound_to_call = grpc_cq_shard_for_current_thread(cq_bound_to_call);
+  cq_for_notification = grpc_cq_shard_for_current_thread(cq_for_notification);
   size_t cq_idx;
   for (cq_idx = 0; cq_idx < server->cq_count; cq_idx++) {
     if (server->cqs[cq_idx] == cq_for_notification) {
@@ -36,35 +36,27 @@
 
 #include <grpc/support/port_platform.h>
 
-static int conforms_to(const char *s, size_t len, const uint8_t *legal_bits) {
-  const char *p = s;
-  const char *e = s + len;
-  for (; p != e; p++) {
-    int idx = (uint8_t)*p;
-    int byte = idx / 8;
-    int bit = idx % 8;
-    if ((legal_bits[byte] & (1 << bit)) == 0) return 0;
-  }
-  return 1;
+#include "src/core/lib/support/byte_class.h"
+
+static int conforms_to(const char *s, size_t len, const gpr_byte_class *legal) {
+  return gpr_byte_class_span(legal, (const uint8_t *)s, len) == len;
 }
 
 int grpc_header_key_is_legal(const char *key, size_t length) {
-  static const uint8_t legal_header_bits[256 / 8] = {
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0xff, 0x03, 0x00, 0x00, 0x00,
-      0x80, 0xfe, 0xff, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  static const gpr_byte_class legal_header_class = {
+      {0x88, 0xc8, 0xc8, 0xc8, 0xc8, 0xc8, 0xc8, 0xc8, 0xc8, 0xc8, 0xc0, 0x40,
+       0x40, 0x44, 0x44, 0x60}};
   if (length == 0) {
     return 0;
   }
-  return conforms_to(key, length, legal_header_bits);
+  return conforms_to(key, length, &legal_header_class);
 }
 
 int grpc_header_nonbin_value_is_legal(const char *value, size_t length) {
-  static const uint8_t legal_header_bits[256 / 8] = {
-      0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-      0xff, 0xff, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-  return conforms_to(value, length, legal_header_bits);
+  static const gpr_byte_class legal_header_class = {
+      {0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc, 0xfc,
+       0xfc, 0xfc, 0xfc, 0x7c}};
+  return conforms_to(value, length, &legal_header_class);
 }
 
 int grpc_is_binary_header(const char *key, size_t length) {
@@ -43,18 +43,27 @@ struct grpc_mdstr_hash_table {
   gpr_refcount refs;
   size_t num_entries;
   size_t size;
+  // True if every key is in the slot its hash maps to, so that a lookup
+  // never needs more than one probe.
+  bool collision_free;
   grpc_mdstr_hash_table_entry* entries;
 };
 
+// The most table sizes tried when looking for one without collisions.
+#define MAX_COLLISION_FREE_ATTEMPTS 256
+
 // Helper function for insert and get operations that performs quadratic
 // probing (https://en.wikipedia.org/wiki/Quadratic_probing).
+// The probe offsets are the triangular numbers, which visit every slot of a
+// table whose size is a power of two.
 static size_t grpc_mdstr_hash_table_find_index(
     const grpc_mdstr_hash_table* table, const grpc_mdstr* key,
     bool find_empty) {
   for (size_t i = 0; i < table->size; ++i) {
-    const size_t idx = (key->hash + i * i) % table->size;
+    const size_t idx = (key->hash + i * (i + 1) / 2) % table->size;
     if (table->entries[idx].key == NULL) return find_empty ? idx : table->size;
     if (table->entries[idx].key == key) return idx;
+    if (table->collision_free) break;
   }
   return table->size;  // Not found.
 }
@@ -72,15 +81,53 @@ static void grpc_mdstr_hash_table_add(
   entry->vtable = vtable;
 }
 
+// Returns a table size, between two and eight times the number of entries,
+// at which no two keys of \a entries share a slot; or 0 if none was found.
+// Keys hash differently from process to process, so this is worked out
+// again for each table.
+static size_t find_collision_free_size(size_t num_entries,
+                                       grpc_mdstr_hash_table_entry* entries) {
+  const size_t max_size = num_entries * 8;
+  bool* used = gpr_malloc(sizeof(*used) * max_size);
+  size_t size = num_entries * 2;
+  for (size_t attempt = 0;
+       attempt < MAX_COLLISION_FREE_ATTEMPTS && size <= max_size;
+       ++attempt, ++size) {
+    memset(used, 0, sizeof(*used) * size);
+    size_t i;
+    for (i = 0; i < num_entries; ++i) {
+      const size_t idx = entries[i].key->hash % size;
+      if (used[idx]) break;
+      used[idx] = true;
+    }
+    if (i == num_entries) {
+      gpr_free(used);
+      return size;
+    }
+  }
+  gpr_free(used);
+  return 0;
+}
+
 grpc_mdstr_hash_table* grpc_mdstr_hash_table_create(
     size_t num_entries, grpc_mdstr_hash_table_entry* entries) {
   grpc_mdstr_hash_table* table = gpr_malloc(sizeof(*table));
   memset(table, 0, sizeof(*table));
   gpr_ref_init(&table->refs, 1);
   table->num_entries = num_entries;
-  // Quadratic probing gets best performance when the table is no more
-  // than half full.
-  table->size = num_entries * 2;
+  // Tables are built once and looked up on every call, so it is worth
+  // searching for a size at which each key gets a slot of its own.
+  // Failing that, quadratic probing gets best performance when the table
+  // is no more than half full, and only reaches every slot if its size is a
+  // power of two.
+  if (num_entries > 0) {
+    table->size = find_collision_free_size(num_entries, entries);
+  }
+  table->collision_free = table->size != 0;
+  if (!table->collision_free) {
+    table->size = 1;
+    while (table->size < num_entries * 2) table->size <<= 1;
+  }
   const size_t entry_size = sizeof(grpc_mdstr_hash_table_entry) * table->size;
   table->entries = gpr_malloc(entry_size);
   memset(table->entries, 0, entry_size);
@@ -40,6 +40,9 @@
  * (https://en.wikipedia.org/wiki/Open_addressing) with quadratic
  * probing (https://en.wikipedia.org/wiki/Quadratic_probing).
  *
+ * Where possible, the table is sized so that no two keys share a slot, and
+ * every lookup takes a single probe.
+ *
  * The keys are \a grpc_mdstr objects.  The values are arbitrary pointers
  * with a common vtable.
  *
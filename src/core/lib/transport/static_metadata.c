@@ -45,21 +45,29 @@ grpc_mdstr grpc_static_mdstr_table[GRPC_STATIC_MDSTR_COUNT];
 
 grpc_mdelem grpc_static_mdelem_table[GRPC_STATIC_MDELEM_COUNT];
 uintptr_t grpc_static_mdelem_user_data[GRPC_STATIC_MDELEM_COUNT] = {
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 4, 8, 6, 2, 4, 8, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    0,  0,  0,  0, 0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0, 0, 0,  0,  0,  4,  8,  16, 32, 24, 12, 28, 20, 6,  14,
+    30, 22, 2,  4, 8, 16, 32, 24, 12, 28, 20, 6,  14, 30, 22, 10, 26, 18,
+    10, 26, 18, 0, 0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0, 0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0, 0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0};
 
 const uint8_t grpc_static_metadata_elem_indices[GRPC_STATIC_MDELEM_COUNT * 2] =
-    {11, 33, 10, 33, 12, 33, 12, 50, 13, 33, 14, 33, 15, 33, 16, 33, 17, 33,
-     19, 33, 20, 33, 21, 33, 22, 33, 23, 33, 24, 33, 25, 33, 26, 33, 27, 33,
-     28, 18, 28, 33, 29, 33, 30, 33, 34, 33, 35, 33, 36, 33, 37, 33, 40, 31,
-     40, 32, 40, 49, 40, 54, 40, 55, 40, 56, 40, 57, 41, 31, 41, 49, 41, 54,
-     46, 0,  46, 1,  46, 2,  51, 33, 58, 33, 59, 33, 60, 33, 61, 33, 62, 33,
-     63, 33, 64, 33, 65, 33, 66, 33, 67, 33, 68, 33, 69, 38, 69, 71, 69, 74,
-     70, 82, 70, 83, 72, 33, 73, 33, 75, 33, 76, 33, 77, 33, 78, 33, 79, 39,
-     79, 52, 79, 53, 80, 33, 81, 33, 84, 3,  84, 4,  84, 5,  84, 6,  84, 7,
-     84, 8,  84, 9,  85, 33, 86, 87, 88, 33, 89, 33, 90, 33, 91, 33, 92, 33};
+    {11,  40,  10,  40,  12,  40,  12,  57,  13,  40,  14,  40,  15,  40,  16,
+     40,  17,  40,  19,  40,  20,  40,  21,  40,  22,  40,  23,  40,  24,  40,
+     25,  40,  26,  40,  27,  40,  28,  18,  28,  40,  29,  40,  30,  40,  41,
+     40,  42,  40,  43,  40,  44,  40,  47,  31,  47,  32,  47,  33,  47,  34,
+     47,  35,  47,  36,  47,  37,  47,  38,  47,  56,  47,  58,  47,  59,  47,
+     60,  47,  64,  47,  65,  47,  66,  47,  67,  47,  68,  47,  69,  47,  70,
+     47,  71,  47,  72,  47,  73,  47,  74,  47,  75,  47,  76,  47,  77,  47,
+     78,  47,  79,  47,  107, 47,  108, 47,  117, 48,  31,  48,  56,  48,  64,
+     48,  107, 48,  117, 53,  0,   53,  1,   53,  2,   61,  40,  80,  40,  81,
+     40,  82,  40,  83,  40,  84,  40,  85,  40,  86,  40,  87,  40,  88,  40,
+     89,  40,  90,  40,  91,  45,  91,  93,  91,  96,  92,  104, 92,  105, 94,
+     40,  95,  40,  97,  40,  98,  40,  99,  40,  100, 40,  101, 46,  101, 62,
+     101, 63,  102, 40,  103, 40,  106, 3,   106, 4,   106, 5,   106, 6,   106,
+     7,   106, 8,   106, 9,   109, 40,  110, 111, 112, 40,  113, 40,  114, 40,
+     115, 40,  116, 40};
 
 const char *const grpc_static_metadata_strings[GRPC_STATIC_MDSTR_COUNT] = {
     "0",
@@ -95,6 +103,13 @@ const char *const grpc_static_metadata_strings[GRPC_STATIC_MDSTR_COUNT] = {
     "date",
     "deflate",
     "deflate,gzip",
+    "deflate,gzip,stream/deflate",
+    "deflate,gzip,stream/deflate,zstd",
+    "deflate,gzip,zstd",
+    "deflate,stream/deflate",
+    "deflate,stream/deflate,zstd",
+    "deflate,zstd",
+    "dict/deflate",
     "",
     "etag",
     "expect",
@@ -113,13 +128,28 @@ const char *const grpc_static_metadata_strings[GRPC_STATIC_MDSTR_COUNT] = {
     "grpc-tracing-bin",
     "gzip",
     "gzip, deflate",
+    "gzip,stream/deflate",
+    "gzip,stream/deflate,zstd",
+    "gzip,zstd",
     "host",
     "http",
     "https",
     "identity",
     "identity,deflate",
     "identity,deflate,gzip",
+    "identity,deflate,gzip,stream/deflate",
+    "identity,deflate,gzip,stream/deflate,zstd",
+    "identity,deflate,gzip,zstd",
+    "identity,deflate,stream/deflate",
+    "identity,deflate,stream/deflate,zstd",
+    "identity,deflate,zstd",
     "identity,gzip",
+    "identity,gzip,stream/deflate",
+    "identity,gzip,stream/deflate,zstd",
+    "identity,gzip,zstd",
+    "identity,stream/deflate",
+    "identity,stream/deflate,zstd",
+    "identity,zstd",
     "if-match",
     "if-modified-since",
     "if-none-match",
@@ -147,6 +177,8 @@ const char *const grpc_static_metadata_strings[GRPC_STATIC_MDSTR_COUNT] = {
     "/",
     "/index.html",
     ":status",
+    "stream/deflate",
+    "stream/deflate,zstd",
     "strict-transport-security",
     "te",
     "trailers",
@@ -154,7 +186,13 @@ const char *const grpc_static_metadata_strings[GRPC_STATIC_MDSTR_COUNT] = {
     "user-agent",
     "vary",
     "via",
-    "www-authenticate"};
+    "www-authenticate",
+    "zstd"};
 
-const uint8_t grpc_static_accept_encoding_metadata[8] = {0,  29, 26, 30,
-                                                         28, 32, 27, 31};
+const uint8_t grpc_static_accept_encoding_metadata[32] = {0,  38, 26, 39, 34,
+                                                          47, 27, 40, 54, 51,
+                                                          31, 44, 35, 48, 28,
+                                                          41, 56, 53, 33, 46,
+                                                          37, 50, 30, 43, 55,
+                                                          52, 32, 45, 36, 49,
+                                                          29, 42};
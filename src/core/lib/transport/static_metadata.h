@@ -44,7 +44,7 @@
 
 #include "src/core/lib/transport/metadata.h"
 
-#define GRPC_STATIC_MDSTR_COUNT 93
+#define GRPC_STATIC_MDSTR_COUNT 118
 extern grpc_mdstr grpc_static_mdstr_table[GRPC_STATIC_MDSTR_COUNT];
 /* "0" */
 #define GRPC_MDSTR_0 (&grpc_static_mdstr_table[0])
@@ -112,129 +112,196 @@ extern grpc_mdstr grpc_static_mdstr_table[GRPC_STATIC_MDSTR_COUNT];
 #define GRPC_MDSTR_DEFLATE (&grpc_static_mdstr_table[31])
 /* "deflate,gzip" */
 #define GRPC_MDSTR_DEFLATE_COMMA_GZIP (&grpc_static_mdstr_table[32])
+/* "deflate,gzip,stream/deflate" */
+#define GRPC_MDSTR_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdstr_table[33])
+/* "deflate,gzip,stream/deflate,zstd" */
+#define GRPC_MDSTR_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[34])
+/* "deflate,gzip,zstd" */
+#define GRPC_MDSTR_DEFLATE_COMMA_GZIP_COMMA_ZSTD (&grpc_static_mdstr_table[35])
+/* "deflate,stream/deflate" */
+#define GRPC_MDSTR_DEFLATE_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdstr_table[36])
+/* "deflate,stream/deflate,zstd" */
+#define GRPC_MDSTR_DEFLATE_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[37])
+/* "deflate,zstd" */
+#define GRPC_MDSTR_DEFLATE_COMMA_ZSTD (&grpc_static_mdstr_table[38])
+/* "dict/deflate" */
+#define GRPC_MDSTR_DICT_SLASH_DEFLATE (&grpc_static_mdstr_table[39])
 /* "" */
-#define GRPC_MDSTR_EMPTY (&grpc_static_mdstr_table[33])
+#define GRPC_MDSTR_EMPTY (&grpc_static_mdstr_table[40])
 /* "etag" */
-#define GRPC_MDSTR_ETAG (&grpc_static_mdstr_table[34])
+#define GRPC_MDSTR_ETAG (&grpc_static_mdstr_table[41])
 /* "expect" */
-#define GRPC_MDSTR_EXPECT (&grpc_static_mdstr_table[35])
+#define GRPC_MDSTR_EXPECT (&grpc_static_mdstr_table[42])
 /* "expires" */
-#define GRPC_MDSTR_EXPIRES (&grpc_static_mdstr_table[36])
+#define GRPC_MDSTR_EXPIRES (&grpc_static_mdstr_table[43])
 /* "from" */
-#define GRPC_MDSTR_FROM (&grpc_static_mdstr_table[37])
+#define GRPC_MDSTR_FROM (&grpc_static_mdstr_table[44])
 /* "GET" */
-#define GRPC_MDSTR_GET (&grpc_static_mdstr_table[38])
+#define GRPC_MDSTR_GET (&grpc_static_mdstr_table[45])
 /* "grpc" */
-#define GRPC_MDSTR_GRPC (&grpc_static_mdstr_table[39])
+#define GRPC_MDSTR_GRPC (&grpc_static_mdstr_table[46])
 /* "grpc-accept-encoding" */
-#define GRPC_MDSTR_GRPC_ACCEPT_ENCODING (&grpc_static_mdstr_table[40])
+#define GRPC_MDSTR_GRPC_ACCEPT_ENCODING (&grpc_static_mdstr_table[47])
 /* "grpc-encoding" */
-#define GRPC_MDSTR_GRPC_ENCODING (&grpc_static_mdstr_table[41])
+#define GRPC_MDSTR_GRPC_ENCODING (&grpc_static_mdstr_table[48])
 /* "grpc-internal-encoding-request" */
-#define GRPC_MDSTR_GRPC_INTERNAL_ENCODING_REQUEST (&grpc_static_mdstr_table[42])
+#define GRPC_MDSTR_GRPC_INTERNAL_ENCODING_REQUEST (&grpc_static_mdstr_table[49])
 /* "grpc-message" */
-#define GRPC_MDSTR_GRPC_MESSAGE (&grpc_static_mdstr_table[43])
+#define GRPC_MDSTR_GRPC_MESSAGE (&grpc_static_mdstr_table[50])
 /* "grpc-payload-bin" */
-#define GRPC_MDSTR_GRPC_PAYLOAD_BIN (&grpc_static_mdstr_table[44])
+#define GRPC_MDSTR_GRPC_PAYLOAD_BIN (&grpc_static_mdstr_table[51])
 /* "grpc-stats-bin" */
-#define GRPC_MDSTR_GRPC_STATS_BIN (&grpc_static_mdstr_table[45])
+#define GRPC_MDSTR_GRPC_STATS_BIN (&grpc_static_mdstr_table[52])
 /* "grpc-status" */
-#define GRPC_MDSTR_GRPC_STATUS (&grpc_static_mdstr_table[46])
+#define GRPC_MDSTR_GRPC_STATUS (&grpc_static_mdstr_table[53])
 /* "grpc-timeout" */
-#define GRPC_MDSTR_GRPC_TIMEOUT (&grpc_static_mdstr_table[47])
+#define GRPC_MDSTR_GRPC_TIMEOUT (&grpc_static_mdstr_table[54])
 /* "grpc-tracing-bin" */
-#define GRPC_MDSTR_GRPC_TRACING_BIN (&grpc_static_mdstr_table[48])
+#define GRPC_MDSTR_GRPC_TRACING_BIN (&grpc_static_mdstr_table[55])
 /* "gzip" */
-#define GRPC_MDSTR_GZIP (&grpc_static_mdstr_table[49])
+#define GRPC_MDSTR_GZIP (&grpc_static_mdstr_table[56])
 /* "gzip, deflate" */
-#define GRPC_MDSTR_GZIP_COMMA_DEFLATE (&grpc_static_mdstr_table[50])
+#define GRPC_MDSTR_GZIP_COMMA_DEFLATE (&grpc_static_mdstr_table[57])
+/* "gzip,stream/deflate" */
+#define GRPC_MDSTR_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdstr_table[58])
+/* "gzip,stream/deflate,zstd" */
+#define GRPC_MDSTR_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[59])
+/* "gzip,zstd" */
+#define GRPC_MDSTR_GZIP_COMMA_ZSTD (&grpc_static_mdstr_table[60])
 /* "host" */
-#define GRPC_MDSTR_HOST (&grpc_static_mdstr_table[51])
+#define GRPC_MDSTR_HOST (&grpc_static_mdstr_table[61])
 /* "http" */
-#define GRPC_MDSTR_HTTP (&grpc_static_mdstr_table[52])
+#define GRPC_MDSTR_HTTP (&grpc_static_mdstr_table[62])
 /* "https" */
-#define GRPC_MDSTR_HTTPS (&grpc_static_mdstr_table[53])
+#define GRPC_MDSTR_HTTPS (&grpc_static_mdstr_table[63])
 /* "identity" */
-#define GRPC_MDSTR_IDENTITY (&grpc_static_mdstr_table[54])
+#define GRPC_MDSTR_IDENTITY (&grpc_static_mdstr_table[64])
 /* "identity,deflate" */
-#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE (&grpc_static_mdstr_table[55])
+#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE (&grpc_static_mdstr_table[65])
 /* "identity,deflate,gzip" */
 #define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE_COMMA_GZIP \
-  (&grpc_static_mdstr_table[56])
+  (&grpc_static_mdstr_table[66])
+/* "identity,deflate,gzip,stream/deflate" */
+#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdstr_table[67])
+/* "identity,deflate,gzip,stream/deflate,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[68])
+/* "identity,deflate,gzip,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE_COMMA_GZIP_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[69])
+/* "identity,deflate,stream/deflate" */
+#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdstr_table[70])
+/* "identity,deflate,stream/deflate,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[71])
+/* "identity,deflate,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[72])
 /* "identity,gzip" */
-#define GRPC_MDSTR_IDENTITY_COMMA_GZIP (&grpc_static_mdstr_table[57])
+#define GRPC_MDSTR_IDENTITY_COMMA_GZIP (&grpc_static_mdstr_table[73])
+/* "identity,gzip,stream/deflate" */
+#define GRPC_MDSTR_IDENTITY_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdstr_table[74])
+/* "identity,gzip,stream/deflate,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[75])
+/* "identity,gzip,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_GZIP_COMMA_ZSTD (&grpc_static_mdstr_table[76])
+/* "identity,stream/deflate" */
+#define GRPC_MDSTR_IDENTITY_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdstr_table[77])
+/* "identity,stream/deflate,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[78])
+/* "identity,zstd" */
+#define GRPC_MDSTR_IDENTITY_COMMA_ZSTD (&grpc_static_mdstr_table[79])
 /* "if-match" */
-#define GRPC_MDSTR_IF_MATCH (&grpc_static_mdstr_table[58])
+#define GRPC_MDSTR_IF_MATCH (&grpc_static_mdstr_table[80])
 /* "if-modified-since" */
-#define GRPC_MDSTR_IF_MODIFIED_SINCE (&grpc_static_mdstr_table[59])
+#define GRPC_MDSTR_IF_MODIFIED_SINCE (&grpc_static_mdstr_table[81])
 /* "if-none-match" */
-#define GRPC_MDSTR_IF_NONE_MATCH (&grpc_static_mdstr_table[60])
+#define GRPC_MDSTR_IF_NONE_MATCH (&grpc_static_mdstr_table[82])
 /* "if-range" */
-#define GRPC_MDSTR_IF_RANGE (&grpc_static_mdstr_table[61])
+#define GRPC_MDSTR_IF_RANGE (&grpc_static_mdstr_table[83])
 /* "if-unmodified-since" */
-#define GRPC_MDSTR_IF_UNMODIFIED_SINCE (&grpc_static_mdstr_table[62])
+#define GRPC_MDSTR_IF_UNMODIFIED_SINCE (&grpc_static_mdstr_table[84])
 /* "last-modified" */
-#define GRPC_MDSTR_LAST_MODIFIED (&grpc_static_mdstr_table[63])
+#define GRPC_MDSTR_LAST_MODIFIED (&grpc_static_mdstr_table[85])
 /* "lb-cost-bin" */
-#define GRPC_MDSTR_LB_COST_BIN (&grpc_static_mdstr_table[64])
+#define GRPC_MDSTR_LB_COST_BIN (&grpc_static_mdstr_table[86])
 /* "lb-token" */
-#define GRPC_MDSTR_LB_TOKEN (&grpc_static_mdstr_table[65])
+#define GRPC_MDSTR_LB_TOKEN (&grpc_static_mdstr_table[87])
 /* "link" */
-#define GRPC_MDSTR_LINK (&grpc_static_mdstr_table[66])
+#define GRPC_MDSTR_LINK (&grpc_static_mdstr_table[88])
 /* "location" */
-#define GRPC_MDSTR_LOCATION (&grpc_static_mdstr_table[67])
+#define GRPC_MDSTR_LOCATION (&grpc_static_mdstr_table[89])
 /* "max-forwards" */
-#define GRPC_MDSTR_MAX_FORWARDS (&grpc_static_mdstr_table[68])
+#define GRPC_MDSTR_MAX_FORWARDS (&grpc_static_mdstr_table[90])
 /* ":method" */
-#define GRPC_MDSTR_METHOD (&grpc_static_mdstr_table[69])
+#define GRPC_MDSTR_METHOD (&grpc_static_mdstr_table[91])
 /* ":path" */
-#define GRPC_MDSTR_PATH (&grpc_static_mdstr_table[70])
+#define GRPC_MDSTR_PATH (&grpc_static_mdstr_table[92])
 /* "POST" */
-#define GRPC_MDSTR_POST (&grpc_static_mdstr_table[71])
+#define GRPC_MDSTR_POST (&grpc_static_mdstr_table[93])
 /* "proxy-authenticate" */
-#define GRPC_MDSTR_PROXY_AUTHENTICATE (&grpc_static_mdstr_table[72])
+#define GRPC_MDSTR_PROXY_AUTHENTICATE (&grpc_static_mdstr_table[94])
 /* "proxy-authorization" */
-#define GRPC_MDSTR_PROXY_AUTHORIZATION (&grpc_static_mdstr_table[73])
+#define GRPC_MDSTR_PROXY_AUTHORIZATION (&grpc_static_mdstr_table[95])
 /* "PUT" */
-#define GRPC_MDSTR_PUT (&grpc_static_mdstr_table[74])
+#define GRPC_MDSTR_PUT (&grpc_static_mdstr_table[96])
 /* "range" */
-#define GRPC_MDSTR_RANGE (&grpc_static_mdstr_table[75])
+#define GRPC_MDSTR_RANGE (&grpc_static_mdstr_table[97])
 /* "referer" */
-#define GRPC_MDSTR_REFERER (&grpc_static_mdstr_table[76])
+#define GRPC_MDSTR_REFERER (&grpc_static_mdstr_table[98])
 /* "refresh" */
-#define GRPC_MDSTR_REFRESH (&grpc_static_mdstr_table[77])
+#define GRPC_MDSTR_REFRESH (&grpc_static_mdstr_table[99])
 /* "retry-after" */
-#define GRPC_MDSTR_RETRY_AFTER (&grpc_static_mdstr_table[78])
+#define GRPC_MDSTR_RETRY_AFTER (&grpc_static_mdstr_table[100])
 /* ":scheme" */
-#define GRPC_MDSTR_SCHEME (&grpc_static_mdstr_table[79])
+#define GRPC_MDSTR_SCHEME (&grpc_static_mdstr_table[101])
 /* "server" */
-#define GRPC_MDSTR_SERVER (&grpc_static_mdstr_table[80])
+#define GRPC_MDSTR_SERVER (&grpc_static_mdstr_table[102])
 /* "set-cookie" */
-#define GRPC_MDSTR_SET_COOKIE (&grpc_static_mdstr_table[81])
+#define GRPC_MDSTR_SET_COOKIE (&grpc_static_mdstr_table[103])
 /* "/" */
-#define GRPC_MDSTR_SLASH (&grpc_static_mdstr_table[82])
+#define GRPC_MDSTR_SLASH (&grpc_static_mdstr_table[104])
 /* "/index.html" */
-#define GRPC_MDSTR_SLASH_INDEX_DOT_HTML (&grpc_static_mdstr_table[83])
+#define GRPC_MDSTR_SLASH_INDEX_DOT_HTML (&grpc_static_mdstr_table[105])
 /* ":status" */
-#define GRPC_MDSTR_STATUS (&grpc_static_mdstr_table[84])
+#define GRPC_MDSTR_STATUS (&grpc_static_mdstr_table[106])
+/* "stream/deflate" */
+#define GRPC_MDSTR_STREAM_SLASH_DEFLATE (&grpc_static_mdstr_table[107])
+/* "stream/deflate,zstd" */
+#define GRPC_MDSTR_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdstr_table[108])
 /* "strict-transport-security" */
-#define GRPC_MDSTR_STRICT_TRANSPORT_SECURITY (&grpc_static_mdstr_table[85])
+#define GRPC_MDSTR_STRICT_TRANSPORT_SECURITY (&grpc_static_mdstr_table[109])
 /* "te" */
-#define GRPC_MDSTR_TE (&grpc_static_mdstr_table[86])
+#define GRPC_MDSTR_TE (&grpc_static_mdstr_table[110])
 /* "trailers" */
-#define GRPC_MDSTR_TRAILERS (&grpc_static_mdstr_table[87])
+#define GRPC_MDSTR_TRAILERS (&grpc_static_mdstr_table[111])
 /* "transfer-encoding" */
-#define GRPC_MDSTR_TRANSFER_ENCODING (&grpc_static_mdstr_table[88])
+#define GRPC_MDSTR_TRANSFER_ENCODING (&grpc_static_mdstr_table[112])
 /* "user-agent" */
-#define GRPC_MDSTR_USER_AGENT (&grpc_static_mdstr_table[89])
+#define GRPC_MDSTR_USER_AGENT (&grpc_static_mdstr_table[113])
 /* "vary" */
-#define GRPC_MDSTR_VARY (&grpc_static_mdstr_table[90])
+#define GRPC_MDSTR_VARY (&grpc_static_mdstr_table[114])
 /* "via" */
-#define GRPC_MDSTR_VIA (&grpc_static_mdstr_table[91])
+#define GRPC_MDSTR_VIA (&grpc_static_mdstr_table[115])
 /* "www-authenticate" */
-#define GRPC_MDSTR_WWW_AUTHENTICATE (&grpc_static_mdstr_table[92])
+#define GRPC_MDSTR_WWW_AUTHENTICATE (&grpc_static_mdstr_table[116])
+/* "zstd" */
+#define GRPC_MDSTR_ZSTD (&grpc_static_mdstr_table[117])
 
-#define GRPC_STATIC_MDELEM_COUNT 81
+#define GRPC_STATIC_MDELEM_COUNT 107
 extern grpc_mdelem grpc_static_mdelem_table[GRPC_STATIC_MDELEM_COUNT];
 extern uintptr_t grpc_static_mdelem_user_data[GRPC_STATIC_MDELEM_COUNT];
 /* "accept-charset": "" */
@@ -297,122 +364,198 @@ extern uintptr_t grpc_static_mdelem_user_data[GRPC_STATIC_MDELEM_COUNT];
 /* "grpc-accept-encoding": "deflate,gzip" */
 #define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_DEFLATE_COMMA_GZIP \
   (&grpc_static_mdelem_table[27])
+/* "grpc-accept-encoding": "deflate,gzip,stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[28])
+/* "grpc-accept-encoding": "deflate,gzip,stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[29])
+/* "grpc-accept-encoding": "deflate,gzip,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_DEFLATE_COMMA_GZIP_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[30])
+/* "grpc-accept-encoding": "deflate,stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_DEFLATE_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[31])
+/* "grpc-accept-encoding": "deflate,stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_DEFLATE_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[32])
+/* "grpc-accept-encoding": "deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[33])
 /* "grpc-accept-encoding": "gzip" */
-#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_GZIP (&grpc_static_mdelem_table[28])
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_GZIP (&grpc_static_mdelem_table[34])
+/* "grpc-accept-encoding": "gzip,stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[35])
+/* "grpc-accept-encoding": "gzip,stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[36])
+/* "grpc-accept-encoding": "gzip,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_GZIP_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[37])
 /* "grpc-accept-encoding": "identity" */
 #define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY \
-  (&grpc_static_mdelem_table[29])
+  (&grpc_static_mdelem_table[38])
 /* "grpc-accept-encoding": "identity,deflate" */
 #define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE \
-  (&grpc_static_mdelem_table[30])
+  (&grpc_static_mdelem_table[39])
 /* "grpc-accept-encoding": "identity,deflate,gzip" */
 #define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_GZIP \
-  (&grpc_static_mdelem_table[31])
+  (&grpc_static_mdelem_table[40])
+/* "grpc-accept-encoding": "identity,deflate,gzip,stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[41])
+/* "grpc-accept-encoding": "identity,deflate,gzip,stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[42])
+/* "grpc-accept-encoding": "identity,deflate,gzip,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_GZIP_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[43])
+/* "grpc-accept-encoding": "identity,deflate,stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[44])
+/* "grpc-accept-encoding": "identity,deflate,stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[45])
+/* "grpc-accept-encoding": "identity,deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[46])
 /* "grpc-accept-encoding": "identity,gzip" */
 #define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_GZIP \
-  (&grpc_static_mdelem_table[32])
+  (&grpc_static_mdelem_table[47])
+/* "grpc-accept-encoding": "identity,gzip,stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[48])
+/* "grpc-accept-encoding": "identity,gzip,stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_GZIP_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[49])
+/* "grpc-accept-encoding": "identity,gzip,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_GZIP_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[50])
+/* "grpc-accept-encoding": "identity,stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[51])
+/* "grpc-accept-encoding": "identity,stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[52])
+/* "grpc-accept-encoding": "identity,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_IDENTITY_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[53])
+/* "grpc-accept-encoding": "stream/deflate" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[54])
+/* "grpc-accept-encoding": "stream/deflate,zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_STREAM_SLASH_DEFLATE_COMMA_ZSTD \
+  (&grpc_static_mdelem_table[55])
+/* "grpc-accept-encoding": "zstd" */
+#define GRPC_MDELEM_GRPC_ACCEPT_ENCODING_ZSTD (&grpc_static_mdelem_table[56])
 /* "grpc-encoding": "deflate" */
-#define GRPC_MDELEM_GRPC_ENCODING_DEFLATE (&grpc_static_mdelem_table[33])
+#define GRPC_MDELEM_GRPC_ENCODING_DEFLATE (&grpc_static_mdelem_table[57])
 /* "grpc-encoding": "gzip" */
-#define GRPC_MDELEM_GRPC_ENCODING_GZIP (&grpc_static_mdelem_table[34])
+#define GRPC_MDELEM_GRPC_ENCODING_GZIP (&grpc_static_mdelem_table[58])
 /* "grpc-encoding": "identity" */
-#define GRPC_MDELEM_GRPC_ENCODING_IDENTITY (&grpc_static_mdelem_table[35])
+#define GRPC_MDELEM_GRPC_ENCODING_IDENTITY (&grpc_static_mdelem_table[59])
+/* "grpc-encoding": "stream/deflate" */
+#define GRPC_MDELEM_GRPC_ENCODING_STREAM_SLASH_DEFLATE \
+  (&grpc_static_mdelem_table[60])
+/* "grpc-encoding": "zstd" */
+#define GRPC_MDELEM_GRPC_ENCODING_ZSTD (&grpc_static_mdelem_table[61])
 /* "grpc-status": "0" */
-#define GRPC_MDELEM_GRPC_STATUS_0 (&grpc_static_mdelem_table[36])
+#define GRPC_MDELEM_GRPC_STATUS_0 (&grpc_static_mdelem_table[62])
 /* "grpc-status": "1" */
-#define GRPC_MDELEM_GRPC_STATUS_1 (&grpc_static_mdelem_table[37])
+#define GRPC_MDELEM_GRPC_STATUS_1 (&grpc_static_mdelem_table[63])
 /* "grpc-status": "2" */
-#define GRPC_MDELEM_GRPC_STATUS_2 (&grpc_static_mdelem_table[38])
+#define GRPC_MDELEM_GRPC_STATUS_2 (&grpc_static_mdelem_table[64])
 /* "host": "" */
-#define GRPC_MDELEM_HOST_EMPTY (&grpc_static_mdelem_table[39])
+#define GRPC_MDELEM_HOST_EMPTY (&grpc_static_mdelem_table[65])
 /* "if-match": "" */
-#define GRPC_MDELEM_IF_MATCH_EMPTY (&grpc_static_mdelem_table[40])
+#define GRPC_MDELEM_IF_MATCH_EMPTY (&grpc_static_mdelem_table[66])
 /* "if-modified-since": "" */
-#define GRPC_MDELEM_IF_MODIFIED_SINCE_EMPTY (&grpc_static_mdelem_table[41])
+#define GRPC_MDELEM_IF_MODIFIED_SINCE_EMPTY (&grpc_static_mdelem_table[67])
 /* "if-none-match": "" */
-#define GRPC_MDELEM_IF_NONE_MATCH_EMPTY (&grpc_static_mdelem_table[42])
+#define GRPC_MDELEM_IF_NONE_MATCH_EMPTY (&grpc_static_mdelem_table[68])
 /* "if-range": "" */
-#define GRPC_MDELEM_IF_RANGE_EMPTY (&grpc_static_mdelem_table[43])
+#define GRPC_MDELEM_IF_RANGE_EMPTY (&grpc_static_mdelem_table[69])
 /* "if-unmodified-since": "" */
-#define GRPC_MDELEM_IF_UNMODIFIED_SINCE_EMPTY (&grpc_static_mdelem_table[44])
+#define GRPC_MDELEM_IF_UNMODIFIED_SINCE_EMPTY (&grpc_static_mdelem_table[70])
 /* "last-modified": "" */
-#define GRPC_MDELEM_LAST_MODIFIED_EMPTY (&grpc_static_mdelem_table[45])
+#define GRPC_MDELEM_LAST_MODIFIED_EMPTY (&grpc_static_mdelem_table[71])
 /* "lb-cost-bin": "" */
-#define GRPC_MDELEM_LB_COST_BIN_EMPTY (&grpc_static_mdelem_table[46])
+#define GRPC_MDELEM_LB_COST_BIN_EMPTY (&grpc_static_mdelem_table[72])
 /* "lb-token": "" */
-#define GRPC_MDELEM_LB_TOKEN_EMPTY (&grpc_static_mdelem_table[47])
+#define GRPC_MDELEM_LB_TOKEN_EMPTY (&grpc_static_mdelem_table[73])
 /* "link": "" */
-#define GRPC_MDELEM_LINK_EMPTY (&grpc_static_mdelem_table[48])
+#define GRPC_MDELEM_LINK_EMPTY (&grpc_static_mdelem_table[74])
 /* "location": "" */
-#define GRPC_MDELEM_LOCATION_EMPTY (&grpc_static_mdelem_table[49])
+#define GRPC_MDELEM_LOCATION_EMPTY (&grpc_static_mdelem_table[75])
 /* "max-forwards": "" */
-#define GRPC_MDELEM_MAX_FORWARDS_EMPTY (&grpc_static_mdelem_table[50])
+#define GRPC_MDELEM_MAX_FORWARDS_EMPTY (&grpc_static_mdelem_table[76])
 /* ":method": "GET" */
-#define GRPC_MDELEM_METHOD_GET (&grpc_static_mdelem_table[51])
+#define GRPC_MDELEM_METHOD_GET (&grpc_static_mdelem_table[77])
 /* ":method": "POST" */
-#define GRPC_MDELEM_METHOD_POST (&grpc_static_mdelem_table[52])
+#define GRPC_MDELEM_METHOD_POST (&grpc_static_mdelem_table[78])
 /* ":method": "PUT" */
-#define GRPC_MDELEM_METHOD_PUT (&grpc_static_mdelem_table[53])
+#define GRPC_MDELEM_METHOD_PUT (&grpc_static_mdelem_table[79])
 /* ":path": "/" */
-#define GRPC_MDELEM_PATH_SLASH (&grpc_static_mdelem_table[54])
+#define GRPC_MDELEM_PATH_SLASH (&grpc_static_mdelem_table[80])
 /* ":path": "/index.html" */
-#define GRPC_MDELEM_PATH_SLASH_INDEX_DOT_HTML (&grpc_static_mdelem_table[55])
+#define GRPC_MDELEM_PATH_SLASH_INDEX_DOT_HTML (&grpc_static_mdelem_table[81])
 /* "proxy-authenticate": "" */
-#define GRPC_MDELEM_PROXY_AUTHENTICATE_EMPTY (&grpc_static_mdelem_table[56])
+#define GRPC_MDELEM_PROXY_AUTHENTICATE_EMPTY (&grpc_static_mdelem_table[82])
 /* "proxy-authorization": "" */
-#define GRPC_MDELEM_PROXY_AUTHORIZATION_EMPTY (&grpc_static_mdelem_table[57])
+#define GRPC_MDELEM_PROXY_AUTHORIZATION_EMPTY (&grpc_static_mdelem_table[83])
 /* "range": "" */
-#define GRPC_MDELEM_RANGE_EMPTY (&grpc_static_mdelem_table[58])
+#define GRPC_MDELEM_RANGE_EMPTY (&grpc_static_mdelem_table[84])
 /* "referer": "" */
-#define GRPC_MDELEM_REFERER_EMPTY (&grpc_static_mdelem_table[59])
+#define GRPC_MDELEM_REFERER_EMPTY (&grpc_static_mdelem_table[85])
 /* "refresh": "" */
-#define GRPC_MDELEM_REFRESH_EMPTY (&grpc_static_mdelem_table[60])
+#define GRPC_MDELEM_REFRESH_EMPTY (&grpc_static_mdelem_table[86])
 /* "retry-after": "" */
-#define GRPC_MDELEM_RETRY_AFTER_EMPTY (&grpc_static_mdelem_table[61])
+#define GRPC_MDELEM_RETRY_AFTER_EMPTY (&grpc_static_mdelem_table[87])
 /* ":scheme": "grpc" */
-#define GRPC_MDELEM_SCHEME_GRPC (&grpc_static_mdelem_table[62])
+#define GRPC_MDELEM_SCHEME_GRPC (&grpc_static_mdelem_table[88])
 /* ":scheme": "http" */
-#define GRPC_MDELEM_SCHEME_HTTP (&grpc_static_mdelem_table[63])
+#define GRPC_MDELEM_SCHEME_HTTP (&grpc_static_mdelem_table[89])
 /* ":scheme": "https" */
-#define GRPC_MDELEM_SCHEME_HTTPS (&grpc_static_mdelem_table[64])
+#define GRPC_MDELEM_SCHEME_HTTPS (&grpc_static_mdelem_table[90])
 /* "server": "" */
-#define GRPC_MDELEM_SERVER_EMPTY (&grpc_static_mdelem_table[65])
+#define GRPC_MDELEM_SERVER_EMPTY (&grpc_static_mdelem_table[91])
 /* "set-cookie": "" */
-#define GRPC_MDELEM_SET_COOKIE_EMPTY (&grpc_static_mdelem_table[66])
+#define GRPC_MDELEM_SET_COOKIE_EMPTY (&grpc_static_mdelem_table[92])
 /* ":status": "200" */
-#define GRPC_MDELEM_STATUS_200 (&grpc_static_mdelem_table[67])
+#define GRPC_MDELEM_STATUS_200 (&grpc_static_mdelem_table[93])
 /* ":status": "204" */
-#define GRPC_MDELEM_STATUS_204 (&grpc_static_mdelem_table[68])
+#define GRPC_MDELEM_STATUS_204 (&grpc_static_mdelem_table[94])
 /* ":status": "206" */
-#define GRPC_MDELEM_STATUS_206 (&grpc_static_mdelem_table[69])
+#define GRPC_MDELEM_STATUS_206 (&grpc_static_mdelem_table[95])
 /* ":status": "304" */
-#define GRPC_MDELEM_STATUS_304 (&grpc_static_mdelem_table[70])
+#define GRPC_MDELEM_STATUS_304 (&grpc_static_mdelem_table[96])
 /* ":status": "400" */
-#define GRPC_MDELEM_STATUS_400 (&grpc_static_mdelem_table[71])
+#define GRPC_MDELEM_STATUS_400 (&grpc_static_mdelem_table[97])
 /* ":status": "404" */
-#define GRPC_MDELEM_STATUS_404 (&grpc_static_mdelem_table[72])
+#define GRPC_MDELEM_STATUS_404 (&grpc_static_mdelem_table[98])
 /* ":status": "500" */
-#define GRPC_MDELEM_STATUS_500 (&grpc_static_mdelem_table[73])
+#define GRPC_MDELEM_STATUS_500 (&grpc_static_mdelem_table[99])
 /* "strict-transport-security": "" */
 #define GRPC_MDELEM_STRICT_TRANSPORT_SECURITY_EMPTY \
-  (&grpc_static_mdelem_table[74])
+  (&grpc_static_mdelem_table[100])
 /* "te": "trailers" */
-#define GRPC_MDELEM_TE_TRAILERS (&grpc_static_mdelem_table[75])
+#define GRPC_MDELEM_TE_TRAILERS (&grpc_static_mdelem_table[101])
 /* "transfer-encoding": "" */
-#define GRPC_MDELEM_TRANSFER_ENCODING_EMPTY (&grpc_static_mdelem_table[76])
+#define GRPC_MDELEM_TRANSFER_ENCODING_EMPTY (&grpc_static_mdelem_table[102])
 /* "user-agent": "" */
-#define GRPC_MDELEM_USER_AGENT_EMPTY (&grpc_static_mdelem_table[77])
+#define GRPC_MDELEM_USER_AGENT_EMPTY (&grpc_static_mdelem_table[103])
 /* "vary": "" */
-#define GRPC_MDELEM_VARY_EMPTY (&grpc_static_mdelem_table[78])
+#define GRPC_MDELEM_VARY_EMPTY (&grpc_static_mdelem_table[104])
 /* "via": "" */
-#define GRPC_MDELEM_VIA_EMPTY (&grpc_static_mdelem_table[79])
+#define GRPC_MDELEM_VIA_EMPTY (&grpc_static_mdelem_table[105])
 /* "www-authenticate": "" */
-#define GRPC_MDELEM_WWW_AUTHENTICATE_EMPTY (&grpc_static_mdelem_table[80])
+#define GRPC_MDELEM_WWW_AUTHENTICATE_EMPTY (&grpc_static_mdelem_table[106])
 
 extern const uint8_t
     grpc_static_metadata_elem_indices[GRPC_STATIC_MDELEM_COUNT * 2];
 extern const char *const grpc_static_metadata_strings[GRPC_STATIC_MDSTR_COUNT];
-extern const uint8_t grpc_static_accept_encoding_metadata[8];
+extern const uint8_t grpc_static_accept_encoding_metadata[32];
 #define GRPC_MDELEM_ACCEPT_ENCODING_FOR_ALGORITHMS(algs) \
   (&grpc_static_mdelem_table[grpc_static_accept_encoding_metadata[(algs)]])
 #endif /* GRPC_CORE_LIB_TRANSPORT_STATIC_METADATA_H */
@@ -182,6 +182,10 @@ typedef struct grpc_transport_op {
   /** what should the goaway contain? */
   grpc_status_code goaway_status;
   gpr_slice *goaway_message;
+  /** should the goaway be sent in two phases, so that the streams the peer
+      starts before it sees the goaway are not lost? The second phase needs
+      the peer to keep reading from the connection. */
+  bool graceful_goaway;
   /** set the callback for accepting new streams;
       this is a permanent callback, unlike the other one-shot closures.
       If true, the callback is set to set_accept_stream_fn, with its
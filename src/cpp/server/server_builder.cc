@@ -35,6 +35,7 @@
 
 #include <grpc++/impl/service_type.h>
 #include <grpc++/server.h>
+#include <grpc++/sharded_completion_queue.h>
 #include <grpc/support/log.h>
 #include <grpc/support/useful.h>
 
@@ -77,6 +78,18 @@ std::unique_ptr<ServerCompletionQueue> ServerBuilder::AddCompletionQueue(
   return std::unique_ptr<ServerCompletionQueue>(cq);
 }
 
+std::unique_ptr<ShardedServerCompletionQueue>
+ServerBuilder::AddShardedCompletionQueue(size_t num_shards) {
+  if (num_shards == 0) {
+    gpr_log(GPR_ERROR, "A sharded completion queue needs at least one shard");
+    return nullptr;
+  }
+  ShardedServerCompletionQueue* cq =
+      new ShardedServerCompletionQueue(num_shards);
+  cqs_.push_back(cq);
+  return std::unique_ptr<ShardedServerCompletionQueue>(cq);
+}
+
 ServerBuilder& ServerBuilder::RegisterService(Service* service) {
   services_.emplace_back(new NamedService(service));
   return *this;
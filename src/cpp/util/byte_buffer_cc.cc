@@ -83,6 +83,15 @@ Status ByteBuffer::Dump(std::vector<Slice>* slices) const {
   return Status::OK;
 }
 
+Status ByteBuffer::SetFromFile(int fd, int64_t offset, size_t length) {
+  grpc_byte_buffer* buf = grpc_raw_byte_buffer_from_file(fd, offset, length);
+  if (buf == nullptr) {
+    return Status(StatusCode::INVALID_ARGUMENT, "Couldn't map the file range");
+  }
+  set_buffer(buf);
+  return Status::OK;
+}
+
 size_t ByteBuffer::Length() const {
   if (buffer_) {
     return grpc_byte_buffer_length(buffer_);
@@ -43,6 +43,14 @@ Slice::Slice(gpr_slice slice, AddRef) : slice_(gpr_slice_ref(slice)) {}
 
 Slice::Slice(gpr_slice slice, StealRef) : slice_(slice) {}
 
+Slice::Slice(int fd, int64_t offset, size_t length, MapAdvice advice) {
+  if (!gpr_slice_from_mapped_file(fd, offset, length,
+                                  static_cast<gpr_slice_map_advice>(advice),
+                                  &slice_)) {
+    slice_ = gpr_empty_slice();
+  }
+}
+
 Slice::Slice(const Slice& other) : slice_(gpr_slice_ref(other.slice_)) {}
 
 }  // namespace grpc
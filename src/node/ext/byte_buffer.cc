@@ -33,13 +33,17 @@
 
 #include <string.h>
 
+#include <vector>
+
 #include <node.h>
 #include <nan.h>
+#include <uv.h>
 #include "grpc/grpc.h"
 #include "grpc/byte_buffer_reader.h"
 #include "grpc/support/slice.h"
 
 #include "byte_buffer.h"
+#include "call.h"
 
 namespace grpc {
 namespace node {
@@ -52,21 +56,79 @@ using v8::Object;
 using v8::Number;
 using v8::Value;
 
-grpc_byte_buffer *BufferToByteBuffer(Local<Value> buffer) {
+namespace {
+/* Buffers shorter than this are copied: that is cheaper than keeping them
+   alive until the core is done with them */
+const size_t kMinUncopiedBufferLength = 4096;
+
+/* The slices that refer to sent Buffers can be released on any thread, but the
+   handles that keep the Buffers alive can only be reset on the JavaScript
+   thread, so released handles are queued and deleted from the event loop */
+typedef struct buffer_release_state {
+  uv_mutex_t mutex;
+  uv_async_t async;
+  std::vector<PersistentValue *> *released;
+  bool initialized;
+} buffer_release_state;
+
+buffer_release_state release_state;
+
+NAUV_WORK_CB(DeleteReleasedBuffers) {
+  std::vector<PersistentValue *> released;
+  uv_mutex_lock(&release_state.mutex);
+  released.swap(*release_state.released);
+  uv_mutex_unlock(&release_state.mutex);
+  for (size_t i = 0; i < released.size(); i++) {
+    delete released[i];
+  }
+}
+
+void InitBufferRelease() {
+  if (release_state.initialized) {
+    return;
+  }
+  release_state.released = new std::vector<PersistentValue *>();
+  uv_mutex_init(&release_state.mutex);
+  uv_async_init(uv_default_loop(), &release_state.async,
+                DeleteReleasedBuffers);
+  uv_unref((uv_handle_t*)&release_state.async);
+  release_state.initialized = true;
+}
+
+void release_buffer(void *handle) {
+  uv_mutex_lock(&release_state.mutex);
+  release_state.released->push_back(static_cast<PersistentValue *>(handle));
+  bool first = release_state.released->size() == 1;
+  uv_mutex_unlock(&release_state.mutex);
+  if (first) {
+    uv_async_send(&release_state.async);
+  }
+}
+
+void unref_slice(char *data, void *hint) {
+  gpr_slice *slice = static_cast<gpr_slice *>(hint);
+  gpr_slice_unref(*slice);
+  delete slice;
+}
+}  // namespace
+
+grpc_byte_buffer *BufferToByteBuffer(Local<Value> buffer, bool no_copy) {
   Nan::HandleScope scope;
-  int length = ::node::Buffer::Length(buffer);
+  size_t length = ::node::Buffer::Length(buffer);
   char *data = ::node::Buffer::Data(buffer);
-  gpr_slice slice = gpr_slice_malloc(length);
-  memcpy(GPR_SLICE_START_PTR(slice), data, length);
+  gpr_slice slice;
+  if (!no_copy || length < kMinUncopiedBufferLength) {
+    slice = gpr_slice_from_copied_buffer(data, length);
+  } else {
+    InitBufferRelease();
+    slice = gpr_slice_new_with_user_data(data, length, release_buffer,
+                                         new PersistentValue(buffer));
+  }
   grpc_byte_buffer *byte_buffer(grpc_raw_byte_buffer_create(&slice, 1));
   gpr_slice_unref(slice);
   return byte_buffer;
 }
 
-namespace {
-void delete_buffer(char *data, void *hint) { delete[] data; }
-}
-
 Local<Value> ByteBufferToBuffer(grpc_byte_buffer *buffer) {
   Nan::EscapableHandleScope scope;
   if (buffer == NULL) {
@@ -77,16 +139,22 @@ Local<Value> ByteBufferToBuffer(grpc_byte_buffer *buffer) {
     Nan::ThrowError("Error initializing byte buffer reader.");
     return scope.Escape(Nan::Undefined());
   }
-  gpr_slice slice = grpc_byte_buffer_reader_readall(&reader);
-  size_t length = GPR_SLICE_LENGTH(slice);
-  char *result = new char[length];
-  memcpy(result, GPR_SLICE_START_PTR(slice), length);
-  gpr_slice_unref(slice);
+  // The Buffer refers to the slice, which it keeps a reference to. The slice
+  // is kept on the heap because a small one holds its bytes inline. readall
+  // always copies, so JavaScript can't modify bytes the core shares.
+  gpr_slice *slice = new gpr_slice(grpc_byte_buffer_reader_readall(&reader));
+  grpc_byte_buffer_reader_destroy(&reader);
+  char *data = reinterpret_cast<char *>(GPR_SLICE_START_PTR(*slice));
+  size_t length = GPR_SLICE_LENGTH(*slice);
   return scope.Escape(MakeFastBuffer(
-      Nan::NewBuffer(result, length, delete_buffer, NULL).ToLocalChecked()));
+      Nan::NewBuffer(data, length, unref_slice, slice).ToLocalChecked()));
 }
 
 Local<Value> MakeFastBuffer(Local<Value> slowBuffer) {
+#if NODE_MODULE_VERSION >= NODE_4_0_MODULE_VERSION
+  // Buffers are always fast, and the constructor would copy this one
+  return slowBuffer;
+#else
   Nan::EscapableHandleScope scope;
   Local<Object> globalObj = Nan::GetCurrentContext()->Global();
   Local<Function> bufferConstructor = Local<Function>::Cast(
@@ -98,6 +166,7 @@ Local<Value> MakeFastBuffer(Local<Value> slowBuffer) {
   };
   Local<Object> fastBuffer = bufferConstructor->NewInstance(3, consArgs);
   return scope.Escape(fastBuffer);
+#endif
 }
 }  // namespace node
 }  // namespace grpc
@@ -43,11 +43,20 @@
 namespace grpc {
 namespace node {
 
+/* A write flag handled by the Node extension rather than the core: send the
+   Buffer without copying it. It is kept alive until the core is done with it,
+   and must not be modified after it is written. */
+const uint32_t kWriteNoCopy = 0x80000000u;
+
 /* Convert a Node.js Buffer to grpc_byte_buffer. Requires that
-   ::node::Buffer::HasInstance(buffer) */
-grpc_byte_buffer *BufferToByteBuffer(v8::Local<v8::Value> buffer);
+   ::node::Buffer::HasInstance(buffer). If no_copy is set, a large Buffer is
+   not copied: the byte buffer refers to (and keeps alive) the Buffer, which
+   must not be modified afterwards */
+grpc_byte_buffer *BufferToByteBuffer(v8::Local<v8::Value> buffer,
+                                     bool no_copy);
 
-/* Convert a grpc_byte_buffer to a Node.js Buffer */
+/* Convert a grpc_byte_buffer to a Node.js Buffer. The Buffer owns a copy of
+   the data, made once */
 v8::Local<v8::Value> ByteBufferToBuffer(grpc_byte_buffer *buffer);
 
 /* Convert a ::node::Buffer to a fast Buffer, as defined in the Node
@@ -250,14 +250,16 @@ class SendMessageOp : public Op {
     Local<Object> object_value = Nan::To<Object>(value).ToLocalChecked();
     MaybeLocal<Value> maybe_flag_value = Nan::Get(
         object_value, Nan::New("grpcWriteFlags").ToLocalChecked());
+    uint32_t flags = 0;
     if (!maybe_flag_value.IsEmpty()) {
       Local<Value> flag_value = maybe_flag_value.ToLocalChecked();
       if (flag_value->IsUint32()) {
         Maybe<uint32_t> maybe_flag = Nan::To<uint32_t>(flag_value);
-        out->flags = maybe_flag.FromMaybe(0) & GRPC_WRITE_USED_MASK;
+        flags = maybe_flag.FromMaybe(0);
+        out->flags = flags & GRPC_WRITE_USED_MASK;
       }
     }
-    send_message = BufferToByteBuffer(value);
+    send_message = BufferToByteBuffer(value, (flags & kWriteNoCopy) != 0);
     out->data.send_message = send_message;
     PersistentValue *handle = new PersistentValue(value);
     resources->handles.push_back(unique_ptr<PersistentValue>(handle));
@@ -31,6 +31,9 @@
  *
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <node.h>
 #include <nan.h>
 
@@ -38,6 +41,7 @@
 #include "grpc/support/log.h"
 #include "grpc/support/time.h"
 #include "completion_queue_async_worker.h"
+#include "completion_queue_poller.h"
 #include "call.h"
 
 namespace grpc {
@@ -52,6 +56,8 @@ using v8::Value;
 
 grpc_completion_queue *CompletionQueueAsyncWorker::queue;
 
+bool CompletionQueueAsyncWorker::use_thread_pool;
+
 // Invariants: current_threads <= max_queue_threads
 // (current_threads == max_queue_threads) || (waiting_next_calls == 0)
 
@@ -74,6 +80,10 @@ void CompletionQueueAsyncWorker::Execute() {
 grpc_completion_queue *CompletionQueueAsyncWorker::GetQueue() { return queue; }
 
 void CompletionQueueAsyncWorker::Next() {
+  if (!use_thread_pool) {
+    CompletionQueuePoller::Next();
+    return;
+  }
   Nan::HandleScope scope;
   if (current_threads < max_queue_threads) {
     current_threads += 1;
@@ -92,6 +102,11 @@ void CompletionQueueAsyncWorker::Init(Local<Object> exports) {
   current_threads = 0;
   waiting_next_calls = 0;
   queue = grpc_completion_queue_create(NULL);
+  const char *polling = getenv("GRPC_NODE_CQ_POLLING");
+  use_thread_pool = polling != NULL && strcmp(polling, "threadpool") == 0;
+  if (!use_thread_pool) {
+    CompletionQueuePoller::Init(queue);
+  }
 }
 
 void CompletionQueueAsyncWorker::HandleOKCallback() {
@@ -41,7 +41,10 @@ namespace grpc {
 namespace node {
 
 /* A worker that asynchronously calls completion_queue_next, and queues onto the
-   node event loop a call to the function stored in the event's tag. */
+   node event loop a call to the function stored in the event's tag.
+   Workers are only used if GRPC_NODE_CQ_POLLING is set to "threadpool": the
+   queue is otherwise polled by a CompletionQueuePoller, which the static
+   functions of this class hand off to. */
 class CompletionQueueAsyncWorker : public Nan::AsyncWorker {
  public:
   CompletionQueueAsyncWorker();
@@ -74,6 +77,9 @@ class CompletionQueueAsyncWorker : public Nan::AsyncWorker {
 
   static grpc_completion_queue *queue;
 
+  // When false, the queue is polled by a CompletionQueuePoller instead
+  static bool use_thread_pool;
+
   // Number of grpc_completion_queue_next calls in the thread pool
   static int current_threads;
   // Number of grpc_completion_queue_next calls waiting to enter the thread pool
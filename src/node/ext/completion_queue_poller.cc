@@ -0,0 +1,154 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <utility>
+#include <vector>
+
+#include <node.h>
+#include <nan.h>
+#include <uv.h>
+
+#include "grpc/grpc.h"
+#include "grpc/support/log.h"
+#include "grpc/support/time.h"
+#include "completion_queue_poller.h"
+#include "call.h"
+
+namespace grpc {
+namespace node {
+
+using v8::Local;
+using v8::Value;
+
+typedef struct poller_state {
+  grpc_completion_queue *queue;
+  uv_thread_t thread;
+  uv_mutex_t mutex;
+  // Signalled when the poller thread has events to wait for again
+  uv_cond_t cv;
+  uv_async_t async;
+  // Events the poller thread has yet to get out of the queue. Guarded by mutex
+  int outstanding_events;
+  // Events the event loop has yet to handle. Guarded by mutex
+  std::vector<grpc_event> *ready_events;
+  // The batch of events being handled. Only used on the event loop thread;
+  // swapped with ready_events so that neither has to allocate once warm
+  std::vector<grpc_event> *handled_events;
+  // Events that Next was called for and that have not been handled yet. Only
+  // used on the event loop thread: the async handle is referenced while it is
+  // not 0
+  int pending_events;
+} poller_state;
+
+poller_state grpc_poller_state;
+
+static void PollerThread(void *arg) {
+  poller_state *state = &grpc_poller_state;
+  uv_mutex_lock(&state->mutex);
+  for (;;) {
+    while (state->outstanding_events == 0) {
+      uv_cond_wait(&state->cv, &state->mutex);
+    }
+    uv_mutex_unlock(&state->mutex);
+    /* An event is known to be coming, so this doesn't block forever */
+    grpc_event event = grpc_completion_queue_next(
+        state->queue, gpr_inf_future(GPR_CLOCK_REALTIME), NULL);
+    uv_mutex_lock(&state->mutex);
+    state->outstanding_events -= 1;
+    state->ready_events->push_back(event);
+    /* If there were events already, the event loop has yet to take them, and
+       will take this one along with them */
+    if (state->ready_events->size() == 1) {
+      uv_async_send(&state->async);
+    }
+  }
+}
+
+NAUV_WORK_CB(HandleEventsCallback) {
+  poller_state *state = &grpc_poller_state;
+  uv_mutex_lock(&state->mutex);
+  std::swap(state->ready_events, state->handled_events);
+  uv_mutex_unlock(&state->mutex);
+  std::vector<grpc_event> *events = state->handled_events;
+  for (size_t i = 0; i < events->size(); i++) {
+    Nan::HandleScope scope;
+    grpc_event event = (*events)[i];
+    state->pending_events -= 1;
+    if (state->pending_events == 0) {
+      uv_unref((uv_handle_t*)&state->async);
+    }
+    Nan::Callback *callback = GetTagCallback(event.tag);
+    if (event.success) {
+      Local<Value> argv[] = {Nan::Null(), GetTagNodeValue(event.tag)};
+      callback->Call(2, argv);
+    } else {
+      Local<Value> argv[] = {
+        Nan::Error("The async function encountered an error")};
+      callback->Call(1, argv);
+    }
+    DestroyTag(event.tag);
+  }
+  events->clear();
+}
+
+void CompletionQueuePoller::Init(grpc_completion_queue *queue) {
+  poller_state *state = &grpc_poller_state;
+  state->queue = queue;
+  state->outstanding_events = 0;
+  state->ready_events = new std::vector<grpc_event>();
+  state->handled_events = new std::vector<grpc_event>();
+  state->pending_events = 0;
+  uv_mutex_init(&state->mutex);
+  uv_cond_init(&state->cv);
+  uv_async_init(uv_default_loop(), &state->async, HandleEventsCallback);
+  uv_unref((uv_handle_t*)&state->async);
+  GPR_ASSERT(uv_thread_create(&state->thread, PollerThread, NULL) == 0);
+}
+
+void CompletionQueuePoller::Next() {
+  poller_state *state = &grpc_poller_state;
+  if (state->pending_events == 0) {
+    uv_ref((uv_handle_t*)&state->async);
+  }
+  state->pending_events += 1;
+  uv_mutex_lock(&state->mutex);
+  state->outstanding_events += 1;
+  if (state->outstanding_events == 1) {
+    uv_cond_signal(&state->cv);
+  }
+  uv_mutex_unlock(&state->mutex);
+}
+
+}  // namespace node
+}  // namespace grpc
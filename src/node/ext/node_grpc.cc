@@ -42,6 +42,7 @@
 #include "grpc/support/log.h"
 #include "grpc/support/time.h"
 
+#include "byte_buffer.h"
 #include "call.h"
 #include "call_credentials.h"
 #include "channel.h"
@@ -255,6 +256,8 @@ void InitWriteFlags(Local<Object> exports) {
   Nan::Set(write_flags, Nan::New("BUFFER_HINT").ToLocalChecked(), BUFFER_HINT);
   Local<Value> NO_COMPRESS(Nan::New<Uint32, uint32_t>(GRPC_WRITE_NO_COMPRESS));
   Nan::Set(write_flags, Nan::New("NO_COMPRESS").ToLocalChecked(), NO_COMPRESS);
+  Local<Value> NO_COPY(Nan::New<Uint32, uint32_t>(grpc::node::kWriteNoCopy));
+  Nan::Set(write_flags, Nan::New("NO_COPY").ToLocalChecked(), NO_COPY);
 }
 
 void InitLogConstants(Local<Object> exports) {
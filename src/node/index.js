@@ -186,7 +186,9 @@ exports.propagate = grpc.propagate;
 exports.callError = grpc.callError;
 
 /**
- * Write flag name to code number mapping
+ * Write flag name to code number mapping. With NO_COPY, a large serialized
+ * message is sent without being copied, so the Buffer returned by the
+ * serializer must not be modified after it is written.
  */
 exports.writeFlags = grpc.writeFlags;
 
@@ -667,14 +667,14 @@ class _ChannelCallState(object):
 def _run_channel_spin_thread(state):
   def channel_spin():
     while True:
-      event = state.completion_queue.poll()
-      completed_call = event.tag(event)
-      if completed_call is not None:
-        with state.lock:
-          state.managed_calls.remove(completed_call)
-          if not state.managed_calls:
-            state.managed_calls = None
-            return
+      for event in state.completion_queue.poll_batch():
+        completed_call = event.tag(event)
+        if completed_call is not None:
+          with state.lock:
+            state.managed_calls.remove(completed_call)
+            if not state.managed_calls:
+              state.managed_calls = None
+              return
 
   def stop_channel_spin(timeout):
     with state.lock:
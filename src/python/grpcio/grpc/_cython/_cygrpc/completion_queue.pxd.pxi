@@ -33,5 +33,9 @@ cdef class CompletionQueue:
   cdef grpc_completion_queue *c_completion_queue
   cdef bint is_shutting_down
   cdef bint is_shutdown
+  # the alarm kicking a poll of the queue to handle signals, if any
+  cdef grpc_alarm *c_signal_alarm
 
   cdef _interpret_event(self, grpc_event event)
+  cdef grpc_event _next(self, gpr_timespec c_deadline) except *
+  cdef _finish_signal_kick(self)
@@ -29,11 +29,96 @@
 
 cimport cpython
 
+import errno
+import os
+import signal
 import threading
 import time
 
+try:
+  import fcntl
+except ImportError:
+  fcntl = None
+
 cdef int _INTERRUPT_CHECK_PERIOD_MS = 200
 
+cdef enum:
+  # The most events returned by one CompletionQueue.poll_batch
+  _POLL_BATCH_SIZE = 32
+
+# Python runs signal handlers on the main thread, between bytecodes, which a
+# main thread blocked in the core never gets to. Rather than waking up
+# periodically to look for them, a poll on the main thread installs a pipe as
+# the signal module's wakeup fd, and a thread reading from the pipe kicks the
+# polled queue with an alarm whenever a signal is received. When the wakeup fd
+# is already in use by the application, polls check periodically instead.
+# All of this state is guarded by the GIL.
+cdef enum _SignalHandling:
+  # the calling thread doesn't handle signals
+  _SIGNALS_ELSEWHERE
+  _SIGNALS_KICKED
+  _SIGNALS_CHECKED_PERIODICALLY
+
+# The tag of the alarms kicking polls
+cdef char _SIGNAL_KICK_TAG
+
+cdef int _signal_wakeup_fd = -1
+# The queue the main thread is polling, if any
+cdef CompletionQueue _signal_polled_queue = None
+
+
+def _watch_signal_wakeups(read_fd):
+  while True:
+    try:
+      received = os.read(read_fd, 128)
+    except OSError as error:
+      if error.errno == errno.EINTR:
+        continue
+      return
+    if not received:
+      return
+    _kick_signal_polled_queue()
+
+
+cdef _kick_signal_polled_queue():
+  cdef CompletionQueue queue = _signal_polled_queue
+  if (queue is not None and queue.c_signal_alarm == NULL and
+      not queue.is_shutting_down):
+    queue.c_signal_alarm = grpc_alarm_create(
+        queue.c_completion_queue, gpr_inf_past(GPR_CLOCK_MONOTONIC),
+        &_SIGNAL_KICK_TAG)
+
+
+def _start_signal_watcher():
+  if fcntl is None:
+    return -1
+  try:
+    read_fd, write_fd = os.pipe()
+  except OSError:
+    return -1
+  fcntl.fcntl(write_fd, fcntl.F_SETFL,
+              fcntl.fcntl(write_fd, fcntl.F_GETFL) | os.O_NONBLOCK)
+  watcher = threading.Thread(target=_watch_signal_wakeups, args=(read_fd,))
+  watcher.daemon = True
+  watcher.start()
+  return write_fd
+
+
+cdef _SignalHandling _signal_handling() except *:
+  global _signal_wakeup_fd
+  if not isinstance(threading.current_thread(), threading._MainThread):
+    return _SIGNALS_ELSEWHERE
+  previous_fd = signal.set_wakeup_fd(_signal_wakeup_fd)
+  if previous_fd != -1 and previous_fd != _signal_wakeup_fd:
+    signal.set_wakeup_fd(previous_fd)
+    return _SIGNALS_CHECKED_PERIODICALLY
+  if _signal_wakeup_fd == -1:
+    _signal_wakeup_fd = _start_signal_watcher()
+    if _signal_wakeup_fd == -1:
+      return _SIGNALS_CHECKED_PERIODICALLY
+    signal.set_wakeup_fd(_signal_wakeup_fd)
+  return _SIGNALS_KICKED
+
 
 cdef class CompletionQueue:
 
@@ -43,6 +128,7 @@ cdef class CompletionQueue:
       self.c_completion_queue = grpc_completion_queue_create(NULL)
     self.is_shutting_down = False
     self.is_shutdown = False
+    self.c_signal_alarm = NULL
 
   cdef _interpret_event(self, grpc_event event):
     cdef OperationTag tag = None
@@ -80,36 +166,94 @@ cdef class CompletionQueue:
           request_call_details, request_metadata, tag.is_new_request,
           batch_operations)
 
-  def poll(self, Timespec deadline=None):
-    # We name this 'poll' to avoid problems with CPython's expectations for
-    # 'special' methods (like next and __next__).
+  cdef grpc_event _next(self, gpr_timespec c_deadline) except *:
+    global _signal_polled_queue
     cdef gpr_timespec c_increment
     cdef gpr_timespec c_timeout
-    cdef gpr_timespec c_deadline
-    with nogil:
-      c_increment = gpr_time_from_millis(_INTERRUPT_CHECK_PERIOD_MS, GPR_TIMESPAN)
-      c_deadline = gpr_inf_future(GPR_CLOCK_REALTIME)
-      if deadline is not None:
-        c_deadline = deadline.c_time
-      
-      while True:
-        c_timeout = gpr_time_add(gpr_now(GPR_CLOCK_REALTIME), c_increment)
-        if gpr_time_cmp(c_timeout, c_deadline) > 0:
+    cdef grpc_event c_event
+    cdef _SignalHandling signal_handling = _signal_handling()
+    if signal_handling == _SIGNALS_KICKED:
+      _signal_polled_queue = self
+    try:
+      if signal_handling != _SIGNALS_ELSEWHERE:
+        # (including those received before the queue could be kicked)
+        cpython.PyErr_CheckSignals()
+      with nogil:
+        c_increment = gpr_time_from_millis(
+            _INTERRUPT_CHECK_PERIOD_MS, GPR_TIMESPAN)
+        while True:
           c_timeout = c_deadline
-        event = grpc_completion_queue_next(
-          self.c_completion_queue, c_timeout, NULL)
-        if event.type != GRPC_QUEUE_TIMEOUT or gpr_time_cmp(c_timeout, c_deadline) == 0:
-          break;
-        
-        # Handle any signals
-        with gil:
-          cpython.PyErr_CheckSignals()
-    return self._interpret_event(event)
+          if signal_handling == _SIGNALS_CHECKED_PERIODICALLY:
+            c_timeout = gpr_time_add(gpr_now(GPR_CLOCK_REALTIME), c_increment)
+            if gpr_time_cmp(c_timeout, c_deadline) > 0:
+              c_timeout = c_deadline
+          c_event = grpc_completion_queue_next(
+            self.c_completion_queue, c_timeout, NULL)
+          if (c_event.type == GRPC_OP_COMPLETE and
+              c_event.tag == &_SIGNAL_KICK_TAG):
+            with gil:
+              self._finish_signal_kick()
+              cpython.PyErr_CheckSignals()
+          elif (c_event.type != GRPC_QUEUE_TIMEOUT or
+                gpr_time_cmp(c_timeout, c_deadline) == 0):
+            break
+          else:
+            # Handle any signals
+            with gil:
+              cpython.PyErr_CheckSignals()
+    finally:
+      if signal_handling == _SIGNALS_KICKED:
+        _signal_polled_queue = None
+    return c_event
+
+  cdef _finish_signal_kick(self):
+    grpc_alarm_destroy(self.c_signal_alarm)
+    self.c_signal_alarm = NULL
+
+  def poll(self, Timespec deadline=None):
+    # We name this 'poll' to avoid problems with CPython's expectations for
+    # 'special' methods (like next and __next__).
+    cdef gpr_timespec c_deadline = gpr_inf_future(GPR_CLOCK_REALTIME)
+    if deadline is not None:
+      c_deadline = deadline.c_time
+    return self._interpret_event(self._next(c_deadline))
+
+  def poll_batch(self, Timespec deadline=None):
+    """Waits for an event like poll, then also takes those already queued.
+
+    Returns:
+      A list of the events, oldest first: a single event unless the first is
+        an operation completing.
+    """
+    cdef gpr_timespec c_deadline = gpr_inf_future(GPR_CLOCK_REALTIME)
+    cdef grpc_event c_events[_POLL_BATCH_SIZE]
+    cdef grpc_event c_event
+    cdef int count = 1
+    if deadline is not None:
+      c_deadline = deadline.c_time
+    c_events[0] = self._next(c_deadline)
+    if c_events[0].type == GRPC_OP_COMPLETE:
+      with nogil:
+        while count < _POLL_BATCH_SIZE:
+          c_event = grpc_completion_queue_next(
+              self.c_completion_queue, gpr_inf_past(GPR_CLOCK_REALTIME), NULL)
+          # (a shutdown is reported again by the next poll)
+          if c_event.type != GRPC_OP_COMPLETE:
+            break
+          if c_event.tag == &_SIGNAL_KICK_TAG:
+            # the handlers run once this returns to the interpreter anyway
+            with gil:
+              self._finish_signal_kick()
+          else:
+            c_events[count] = c_event
+            count += 1
+    return [self._interpret_event(c_events[index]) for index in range(count)]
 
   def shutdown(self):
+    # Set first, so that no signal kick is added past the shutdown
+    self.is_shutting_down = True
     with nogil:
       grpc_completion_queue_shutdown(self.c_completion_queue)
-    self.is_shutting_down = True
 
   def clear(self):
     if not self.is_shutting_down:
@@ -128,6 +272,10 @@ cdef class CompletionQueue:
       while not self.is_shutdown:
         event = grpc_completion_queue_next(
             self.c_completion_queue, c_deadline, NULL)
-        self._interpret_event(event)
+        if (event.type == GRPC_OP_COMPLETE and
+            event.tag == &_SIGNAL_KICK_TAG):
+          self._finish_signal_kick()
+        else:
+          self._interpret_event(event)
       grpc_completion_queue_destroy(self.c_completion_queue)
     grpc_shutdown()
@@ -63,6 +63,8 @@ cdef extern from "grpc/grpc.h":
   gpr_slice gpr_slice_new(void *p, size_t len, void (*destroy)(void *)) nogil
   gpr_slice gpr_slice_new_with_len(
       void *p, size_t len, void (*destroy)(void *, size_t)) nogil
+  gpr_slice gpr_slice_new_with_user_data(
+      void *p, size_t len, void (*destroy)(void *), void *user_data) nogil
   gpr_slice gpr_slice_malloc(size_t length) nogil
   gpr_slice gpr_slice_from_copied_string(const char *source) nogil
   gpr_slice gpr_slice_from_copied_buffer(const char *source, size_t len) nogil
@@ -110,6 +112,10 @@ cdef extern from "grpc/grpc.h":
                                    grpc_byte_buffer *buffer) nogil
   int grpc_byte_buffer_reader_next(grpc_byte_buffer_reader *reader,
                                    gpr_slice *slice) nogil
+  gpr_slice grpc_byte_buffer_reader_readall(
+      grpc_byte_buffer_reader *reader) nogil
+  gpr_slice grpc_byte_buffer_reader_readall_shared(
+      grpc_byte_buffer_reader *reader) nogil
   void grpc_byte_buffer_reader_destroy(grpc_byte_buffer_reader *reader) nogil
 
   ctypedef enum grpc_status_code:
@@ -168,6 +174,10 @@ cdef extern from "grpc/grpc.h":
     # We don't care about the internals (and in fact don't know them)
     pass
 
+  ctypedef struct grpc_alarm:
+    # We don't care about the internals (and in fact don't know them)
+    pass
+
   ctypedef enum grpc_arg_type:
     GRPC_ARG_STRING
     GRPC_ARG_INTEGER
@@ -306,6 +316,10 @@ cdef extern from "grpc/grpc.h":
   void grpc_completion_queue_shutdown(grpc_completion_queue *cq) nogil
   void grpc_completion_queue_destroy(grpc_completion_queue *cq) nogil
 
+  grpc_alarm *grpc_alarm_create(grpc_completion_queue *cq,
+                                gpr_timespec deadline, void *tag) nogil
+  void grpc_alarm_destroy(grpc_alarm *alarm) nogil
+
   grpc_call_error grpc_call_start_batch(
       grpc_call *call, const grpc_op *ops, size_t nops, void *tag,
       void *reserved) nogil
@@ -459,6 +473,9 @@ cdef extern from "grpc/compression.h":
     GRPC_COMPRESS_NONE
     GRPC_COMPRESS_DEFLATE
     GRPC_COMPRESS_GZIP
+    GRPC_COMPRESS_STREAM_DEFLATE
+    GRPC_COMPRESS_ZSTD
+    GRPC_COMPRESS_DICT_DEFLATE
     GRPC_COMPRESS_ALGORITHMS_COUNT
 
   ctypedef enum grpc_compression_level:
@@ -70,6 +70,11 @@ cdef class Event:
   cdef readonly Operations batch_operations
 
 
+cdef class _SliceView:
+
+  cdef gpr_slice c_slice
+
+
 cdef class ByteBuffer:
 
   cdef grpc_byte_buffer *c_byte_buffer
@@ -109,6 +109,9 @@ class CompressionAlgorithm:
   none = GRPC_COMPRESS_NONE
   deflate = GRPC_COMPRESS_DEFLATE
   gzip = GRPC_COMPRESS_GZIP
+  stream_deflate = GRPC_COMPRESS_STREAM_DEFLATE
+  zstd = GRPC_COMPRESS_ZSTD
+  dict_deflate = GRPC_COMPRESS_DICT_DEFLATE
 
 
 class CompressionLevel:
@@ -233,6 +236,42 @@ cdef class Event:
     self.is_new_request = is_new_request
 
 
+# bytes objects shorter than this are copied when sent: that is cheaper than
+# keeping them alive until the core is done with them
+cdef size_t _MIN_UNCOPIED_BYTES_LENGTH = 4096
+
+
+# The core releases the slice of a sent bytes object on whichever thread drops
+# its last reference, so the object is dereferenced there, under the GIL.
+cdef void _release_bytes(void *user_data) with gil:
+  cpython.Py_DECREF(<object>user_data)
+
+
+cdef bint _read_all(
+    grpc_byte_buffer *c_byte_buffer, gpr_slice *data_slice) nogil:
+  cdef grpc_byte_buffer_reader reader
+  if not grpc_byte_buffer_reader_init(&reader, c_byte_buffer):
+    return False
+  data_slice[0] = grpc_byte_buffer_reader_readall_shared(&reader)
+  grpc_byte_buffer_reader_destroy(&reader)
+  return True
+
+
+cdef class _SliceView:
+  """Exposes the bytes of a slice, read-only, through the buffer protocol."""
+
+  def __getbuffer__(self, Py_buffer *buffer, int flags):
+    cpython.PyBuffer_FillInfo(
+        buffer, self, gpr_slice_start_ptr(self.c_slice),
+        gpr_slice_length(self.c_slice), 1, flags)
+
+  def __releasebuffer__(self, Py_buffer *buffer):
+    pass
+
+  def __dealloc__(self):
+    gpr_slice_unref(self.c_slice)
+
+
 cdef class ByteBuffer:
 
   def __cinit__(self, bytes data):
@@ -244,8 +283,15 @@ cdef class ByteBuffer:
     cdef char *c_data = data
     cdef gpr_slice data_slice
     cdef size_t data_length = len(data)
-    with nogil:
-      data_slice = gpr_slice_from_copied_buffer(c_data, data_length)
+    if data_length < _MIN_UNCOPIED_BYTES_LENGTH:
+      with nogil:
+        data_slice = gpr_slice_from_copied_buffer(c_data, data_length)
+    else:
+      # bytes are immutable: the slice can refer to them instead of a copy
+      cpython.Py_INCREF(data)
+      with nogil:
+        data_slice = gpr_slice_new_with_user_data(
+            c_data, data_length, _release_bytes, <void *>data)
     with nogil:
       self.c_byte_buffer = grpc_raw_byte_buffer_create(
           &data_slice, 1)
@@ -253,28 +299,35 @@ cdef class ByteBuffer:
       gpr_slice_unref(data_slice)
 
   def bytes(self):
-    cdef grpc_byte_buffer_reader reader
     cdef gpr_slice data_slice
-    cdef size_t data_slice_length
-    cdef void *data_slice_pointer
-    cdef bint reader_status
+    cdef bint read_status
     if self.c_byte_buffer != NULL:
       with nogil:
-        reader_status = grpc_byte_buffer_reader_init(
-            &reader, self.c_byte_buffer)
-      if not reader_status:
+        read_status = _read_all(self.c_byte_buffer, &data_slice)
+      if not read_status:
         return None
-      result = bytearray()
+      result = (<char *>gpr_slice_start_ptr(data_slice))[
+          :gpr_slice_length(data_slice)]
       with nogil:
-        while grpc_byte_buffer_reader_next(&reader, &data_slice):
-          data_slice_pointer = gpr_slice_start_ptr(data_slice)
-          data_slice_length = gpr_slice_length(data_slice)
-          with gil:
-            result += (<char *>data_slice_pointer)[:data_slice_length]
-          gpr_slice_unref(data_slice)
+        gpr_slice_unref(data_slice)
+      return result
+    else:
+      return None
+
+  def memoryview(self):
+    """Returns a read-only memoryview of the data.
+
+    Unlike bytes(), this doesn't copy data that is held in a single slice.
+    """
+    cdef _SliceView view
+    cdef bint read_status
+    if self.c_byte_buffer != NULL:
+      view = _SliceView()
       with nogil:
-        grpc_byte_buffer_reader_destroy(&reader)
-      return bytes(result)
+        read_status = _read_all(self.c_byte_buffer, &view.c_slice)
+      if not read_status:
+        return None
+      return memoryview(view)
     else:
       return None
 
@@ -641,35 +641,41 @@ def _stop_serving(state):
     return False
 
 
+def _process_event(state, event):
+  """Returns True if the server has stopped serving."""
+  if event.tag is _SHUTDOWN_TAG:
+    with state.lock:
+      state.due.remove(_SHUTDOWN_TAG)
+      return _stop_serving(state)
+  elif event.tag is _REQUEST_CALL_TAG:
+    with state.lock:
+      state.due.remove(_REQUEST_CALL_TAG)
+      rpc_state = _handle_call(
+          event, state.generic_handlers, state.thread_pool)
+      if rpc_state is not None:
+        state.rpc_states.add(rpc_state)
+      if state.stage is _ServerStage.STARTED:
+        _request_call(state)
+        return False
+      else:
+        return _stop_serving(state)
+  else:
+    rpc_state, callbacks = event.tag(event)
+    for callback in callbacks:
+      callable_util.call_logging_exceptions(
+          callback, 'Exception calling callback!')
+    if rpc_state is not None:
+      with state.lock:
+        state.rpc_states.remove(rpc_state)
+        return _stop_serving(state)
+    return False
+
+
 def _serve(state):
   while True:
-    event = state.completion_queue.poll()
-    if event.tag is _SHUTDOWN_TAG:
-      with state.lock:
-        state.due.remove(_SHUTDOWN_TAG)
-        if _stop_serving(state):
-          return
-    elif event.tag is _REQUEST_CALL_TAG:
-      with state.lock:
-        state.due.remove(_REQUEST_CALL_TAG)
-        rpc_state = _handle_call(
-            event, state.generic_handlers, state.thread_pool)
-        if rpc_state is not None:
-          state.rpc_states.add(rpc_state)
-        if state.stage is _ServerStage.STARTED:
-          _request_call(state)
-        elif _stop_serving(state):
-          return
-    else:
-      rpc_state, callbacks = event.tag(event)
-      for callback in callbacks:
-        callable_util.call_logging_exceptions(
-            callback, 'Exception calling callback!')
-      if rpc_state is not None:
-        with state.lock:
-          state.rpc_states.remove(rpc_state)
-          if _stop_serving(state):
-            return
+    for event in state.completion_queue.poll_batch():
+      if _process_event(state, event):
+        return
 
 
 def _stop(state, grace):
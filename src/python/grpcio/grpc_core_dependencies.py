@@ -35,6 +35,7 @@ CORE_SOURCE_FILES = [
   'src/core/lib/support/alloc.c',
   'src/core/lib/support/avl.c',
   'src/core/lib/support/backoff.c',
+  'src/core/lib/support/byte_class.c',
   'src/core/lib/support/cmdline.c',
   'src/core/lib/support/cpu_iphone.c',
   'src/core/lib/support/cpu_linux.c',
@@ -55,6 +56,8 @@ CORE_SOURCE_FILES = [
   'src/core/lib/support/percent_encoding.c',
   'src/core/lib/support/slice.c',
   'src/core/lib/support/slice_buffer.c',
+  'src/core/lib/support/slice_mapped_file_posix.c',
+  'src/core/lib/support/slice_mapped_file_posix_noop.c',
   'src/core/lib/support/stack_lockfree.c',
   'src/core/lib/support/string.c',
   'src/core/lib/support/string_posix.c',
@@ -87,7 +90,9 @@ CORE_SOURCE_FILES = [
   'src/core/lib/channel/handshaker.c',
   'src/core/lib/channel/http_client_filter.c',
   'src/core/lib/channel/http_server_filter.c',
+  'src/core/lib/channel/max_age_filter.c',
   'src/core/lib/channel/message_size_filter.c',
+  'src/core/lib/channel/shm_handshaker.c',
   'src/core/lib/compression/compression.c',
   'src/core/lib/compression/message_compress.c',
   'src/core/lib/debug/trace.c',
@@ -113,10 +118,13 @@ CORE_SOURCE_FILES = [
   'src/core/lib/iomgr/load_file.c',
   'src/core/lib/iomgr/network_status_tracker.c',
   'src/core/lib/iomgr/polling_entity.c',
+  'src/core/lib/iomgr/pollset_set_members.c',
   'src/core/lib/iomgr/pollset_set_windows.c',
   'src/core/lib/iomgr/pollset_windows.c',
   'src/core/lib/iomgr/resolve_address_posix.c',
   'src/core/lib/iomgr/resolve_address_windows.c',
+  'src/core/lib/iomgr/shm_endpoint_linux.c',
+  'src/core/lib/iomgr/shm_endpoint_noop.c',
   'src/core/lib/iomgr/sockaddr_utils.c',
   'src/core/lib/iomgr/socket_utils_common_posix.c',
   'src/core/lib/iomgr/socket_utils_linux.c',
@@ -586,4 +594,30 @@ CORE_SOURCE_FILES = [
   'third_party/zlib/trees.c',
   'third_party/zlib/uncompr.c',
   'third_party/zlib/zutil.c',
+  'third_party/zstd/lib/common/debug.c',
+  'third_party/zstd/lib/common/entropy_common.c',
+  'third_party/zstd/lib/common/error_private.c',
+  'third_party/zstd/lib/common/fse_decompress.c',
+  'third_party/zstd/lib/common/pool.c',
+  'third_party/zstd/lib/common/threading.c',
+  'third_party/zstd/lib/common/xxhash.c',
+  'third_party/zstd/lib/common/zstd_common.c',
+  'third_party/zstd/lib/compress/fse_compress.c',
+  'third_party/zstd/lib/compress/hist.c',
+  'third_party/zstd/lib/compress/huf_compress.c',
+  'third_party/zstd/lib/compress/zstd_compress.c',
+  'third_party/zstd/lib/compress/zstd_compress_literals.c',
+  'third_party/zstd/lib/compress/zstd_compress_sequences.c',
+  'third_party/zstd/lib/compress/zstd_compress_superblock.c',
+  'third_party/zstd/lib/compress/zstd_double_fast.c',
+  'third_party/zstd/lib/compress/zstd_fast.c',
+  'third_party/zstd/lib/compress/zstd_lazy.c',
+  'third_party/zstd/lib/compress/zstd_ldm.c',
+  'third_party/zstd/lib/compress/zstd_opt.c',
+  'third_party/zstd/lib/compress/zstd_preSplit.c',
+  'third_party/zstd/lib/compress/zstdmt_compress.c',
+  'third_party/zstd/lib/decompress/huf_decompress.c',
+  'third_party/zstd/lib/decompress/zstd_ddict.c',
+  'third_party/zstd/lib/decompress/zstd_decompress.c',
+  'third_party/zstd/lib/decompress/zstd_decompress_block.c',
 ]
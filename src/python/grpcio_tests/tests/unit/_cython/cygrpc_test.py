@@ -31,6 +31,8 @@ import time
 import threading
 import unittest
 import platform
+import signal
+import sys
 
 from grpc._cython import cygrpc
 from tests.unit._cython import test_utilities
@@ -97,10 +99,68 @@ class TypeSmokeTest(unittest.TestCase):
     timespec = cygrpc.Timespec(now)
     self.assertAlmostEqual(now, float(timespec), places=8)
 
+  def testByteBuffer(self):
+    for data in (b'', b'small', b'large' * 10000):
+      byte_buffer = cygrpc.ByteBuffer(data)
+      self.assertEqual(len(data), len(byte_buffer))
+      self.assertEqual(data, byte_buffer.bytes())
+      view = byte_buffer.memoryview()
+      self.assertTrue(view.readonly)
+      self.assertEqual(data, view.tobytes())
+
+  def testByteBufferReleasesData(self):
+    data = b'large' * 10000
+    refcount = sys.getrefcount(data)
+    byte_buffer = cygrpc.ByteBuffer(data)
+    view = byte_buffer.memoryview()
+    del byte_buffer
+    # the view holds on to the (uncopied) data
+    self.assertEqual(data, view.tobytes())
+    # and the last reference to the slice dereferences it
+    del view
+    self.assertEqual(refcount, sys.getrefcount(data))
+
   def testCompletionQueueUpDown(self):
     completion_queue = cygrpc.CompletionQueue()
     del completion_queue
 
+  def testCompletionQueuePollBatch(self):
+    completion_queue = cygrpc.CompletionQueue()
+    channel = cygrpc.Channel(b'localhost:54321', cygrpc.ChannelArgs([]))
+    for tag in range(3):
+      channel.watch_connectivity_state(
+          cygrpc.ConnectivityState.idle, cygrpc.Timespec(0), completion_queue,
+          tag)
+    tags = []
+    while len(tags) < 3:
+      tags.extend(event.tag for event in completion_queue.poll_batch())
+    self.assertEqual([0, 1, 2], tags)
+    events = completion_queue.poll_batch(cygrpc.Timespec(0))
+    self.assertEqual([cygrpc.CompletionType.queue_timeout],
+                     [event.type for event in events])
+    completion_queue.shutdown()
+    events = completion_queue.poll_batch()
+    self.assertEqual([cygrpc.CompletionType.queue_shutdown],
+                     [event.type for event in events])
+
+  def testCompletionQueuePollInterruptedBySignal(self):
+    if (threading.current_thread().name != 'MainThread' or
+        not hasattr(signal, 'setitimer')):
+      self.skipTest('signals are only handled on the main thread')
+    class Interrupted(Exception):
+      pass
+    def handler(signal_number, frame):
+      raise Interrupted()
+    completion_queue = cygrpc.CompletionQueue()
+    previous_handler = signal.signal(signal.SIGALRM, handler)
+    try:
+      signal.setitimer(signal.ITIMER_REAL, 0.01)
+      with self.assertRaises(Interrupted):
+        completion_queue.poll(cygrpc.Timespec(time.time() + 10))
+    finally:
+      signal.setitimer(signal.ITIMER_REAL, 0)
+      signal.signal(signal.SIGALRM, previous_handler)
+
   def testServerUpDown(self):
     server = cygrpc.Server(cygrpc.ChannelArgs([]))
     del server
@@ -39,6 +39,7 @@
 
 grpc_raw_byte_buffer_create_type grpc_raw_byte_buffer_create_import;
 grpc_raw_compressed_byte_buffer_create_type grpc_raw_compressed_byte_buffer_create_import;
+grpc_raw_byte_buffer_from_file_type grpc_raw_byte_buffer_from_file_import;
 grpc_byte_buffer_copy_type grpc_byte_buffer_copy_import;
 grpc_byte_buffer_length_type grpc_byte_buffer_length_import;
 grpc_byte_buffer_destroy_type grpc_byte_buffer_destroy_import;
@@ -46,6 +47,7 @@ grpc_byte_buffer_reader_init_type grpc_byte_buffer_reader_init_import;
 grpc_byte_buffer_reader_destroy_type grpc_byte_buffer_reader_destroy_import;
 grpc_byte_buffer_reader_next_type grpc_byte_buffer_reader_next_import;
 grpc_byte_buffer_reader_readall_type grpc_byte_buffer_reader_readall_import;
+grpc_byte_buffer_reader_readall_shared_type grpc_byte_buffer_reader_readall_shared_import;
 grpc_raw_byte_buffer_from_reader_type grpc_raw_byte_buffer_from_reader_import;
 census_initialize_type census_initialize_import;
 census_shutdown_type census_shutdown_import;
@@ -82,6 +84,9 @@ grpc_compression_options_init_type grpc_compression_options_init_import;
 grpc_compression_options_enable_algorithm_type grpc_compression_options_enable_algorithm_import;
 grpc_compression_options_disable_algorithm_type grpc_compression_options_disable_algorithm_import;
 grpc_compression_options_is_algorithm_enabled_type grpc_compression_options_is_algorithm_enabled_import;
+grpc_compression_dictionary_create_type grpc_compression_dictionary_create_import;
+grpc_compression_dictionary_unref_type grpc_compression_dictionary_unref_import;
+grpc_compression_dictionary_to_arg_type grpc_compression_dictionary_to_arg_import;
 grpc_metadata_array_init_type grpc_metadata_array_init_import;
 grpc_metadata_array_destroy_type grpc_metadata_array_destroy_import;
 grpc_call_details_init_type grpc_call_details_init_import;
@@ -125,6 +130,7 @@ grpc_server_register_non_listening_completion_queue_type grpc_server_register_no
 grpc_server_add_insecure_http2_port_type grpc_server_add_insecure_http2_port_import;
 grpc_server_start_type grpc_server_start_import;
 grpc_server_shutdown_and_notify_type grpc_server_shutdown_and_notify_import;
+grpc_server_drain_and_notify_type grpc_server_drain_and_notify_import;
 grpc_server_cancel_all_calls_type grpc_server_cancel_all_calls_import;
 grpc_server_destroy_type grpc_server_destroy_import;
 grpc_tracer_set_enabled_type grpc_tracer_set_enabled_import;
@@ -225,6 +231,7 @@ gpr_slice_malloc_type gpr_slice_malloc_import;
 gpr_slice_from_copied_string_type gpr_slice_from_copied_string_import;
 gpr_slice_from_copied_buffer_type gpr_slice_from_copied_buffer_import;
 gpr_slice_from_static_string_type gpr_slice_from_static_string_import;
+gpr_slice_from_mapped_file_type gpr_slice_from_mapped_file_import;
 gpr_slice_sub_type gpr_slice_sub_import;
 gpr_slice_sub_no_ref_type gpr_slice_sub_no_ref_import;
 gpr_slice_split_tail_type gpr_slice_split_tail_import;
@@ -308,6 +315,7 @@ gpr_timespec_to_micros_type gpr_timespec_to_micros_import;
 void grpc_rb_load_imports(HMODULE library) {
   grpc_raw_byte_buffer_create_import = (grpc_raw_byte_buffer_create_type) GetProcAddress(library, "grpc_raw_byte_buffer_create");
   grpc_raw_compressed_byte_buffer_create_import = (grpc_raw_compressed_byte_buffer_create_type) GetProcAddress(library, "grpc_raw_compressed_byte_buffer_create");
+  grpc_raw_byte_buffer_from_file_import = (grpc_raw_byte_buffer_from_file_type) GetProcAddress(library, "grpc_raw_byte_buffer_from_file");
   grpc_byte_buffer_copy_import = (grpc_byte_buffer_copy_type) GetProcAddress(library, "grpc_byte_buffer_copy");
   grpc_byte_buffer_length_import = (grpc_byte_buffer_length_type) GetProcAddress(library, "grpc_byte_buffer_length");
   grpc_byte_buffer_destroy_import = (grpc_byte_buffer_destroy_type) GetProcAddress(library, "grpc_byte_buffer_destroy");
@@ -315,6 +323,7 @@ void grpc_rb_load_imports(HMODULE library) {
   grpc_byte_buffer_reader_destroy_import = (grpc_byte_buffer_reader_destroy_type) GetProcAddress(library, "grpc_byte_buffer_reader_destroy");
   grpc_byte_buffer_reader_next_import = (grpc_byte_buffer_reader_next_type) GetProcAddress(library, "grpc_byte_buffer_reader_next");
   grpc_byte_buffer_reader_readall_import = (grpc_byte_buffer_reader_readall_type) GetProcAddress(library, "grpc_byte_buffer_reader_readall");
+  grpc_byte_buffer_reader_readall_shared_import = (grpc_byte_buffer_reader_readall_shared_type) GetProcAddress(library, "grpc_byte_buffer_reader_readall_shared");
   grpc_raw_byte_buffer_from_reader_import = (grpc_raw_byte_buffer_from_reader_type) GetProcAddress(library, "grpc_raw_byte_buffer_from_reader");
   census_initialize_import = (census_initialize_type) GetProcAddress(library, "census_initialize");
   census_shutdown_import = (census_shutdown_type) GetProcAddress(library, "census_shutdown");
@@ -351,6 +360,9 @@ void grpc_rb_load_imports(HMODULE library) {
   grpc_compression_options_enable_algorithm_import = (grpc_compression_options_enable_algorithm_type) GetProcAddress(library, "grpc_compression_options_enable_algorithm");
   grpc_compression_options_disable_algorithm_import = (grpc_compression_options_disable_algorithm_type) GetProcAddress(library, "grpc_compression_options_disable_algorithm");
   grpc_compression_options_is_algorithm_enabled_import = (grpc_compression_options_is_algorithm_enabled_type) GetProcAddress(library, "grpc_compression_options_is_algorithm_enabled");
+  grpc_compression_dictionary_create_import = (grpc_compression_dictionary_create_type) GetProcAddress(library, "grpc_compression_dictionary_create");
+  grpc_compression_dictionary_unref_import = (grpc_compression_dictionary_unref_type) GetProcAddress(library, "grpc_compression_dictionary_unref");
+  grpc_compression_dictionary_to_arg_import = (grpc_compression_dictionary_to_arg_type) GetProcAddress(library, "grpc_compression_dictionary_to_arg");
   grpc_metadata_array_init_import = (grpc_metadata_array_init_type) GetProcAddress(library, "grpc_metadata_array_init");
   grpc_metadata_array_destroy_import = (grpc_metadata_array_destroy_type) GetProcAddress(library, "grpc_metadata_array_destroy");
   grpc_call_details_init_import = (grpc_call_details_init_type) GetProcAddress(library, "grpc_call_details_init");
@@ -394,6 +406,7 @@ void grpc_rb_load_imports(HMODULE library) {
   grpc_server_add_insecure_http2_port_import = (grpc_server_add_insecure_http2_port_type) GetProcAddress(library, "grpc_server_add_insecure_http2_port");
   grpc_server_start_import = (grpc_server_start_type) GetProcAddress(library, "grpc_server_start");
   grpc_server_shutdown_and_notify_import = (grpc_server_shutdown_and_notify_type) GetProcAddress(library, "grpc_server_shutdown_and_notify");
+  grpc_server_drain_and_notify_import = (grpc_server_drain_and_notify_type) GetProcAddress(library, "grpc_server_drain_and_notify");
   grpc_server_cancel_all_calls_import = (grpc_server_cancel_all_calls_type) GetProcAddress(library, "grpc_server_cancel_all_calls");
   grpc_server_destroy_import = (grpc_server_destroy_type) GetProcAddress(library, "grpc_server_destroy");
   grpc_tracer_set_enabled_import = (grpc_tracer_set_enabled_type) GetProcAddress(library, "grpc_tracer_set_enabled");
@@ -494,6 +507,7 @@ void grpc_rb_load_imports(HMODULE library) {
   gpr_slice_from_copied_string_import = (gpr_slice_from_copied_string_type) GetProcAddress(library, "gpr_slice_from_copied_string");
   gpr_slice_from_copied_buffer_import = (gpr_slice_from_copied_buffer_type) GetProcAddress(library, "gpr_slice_from_copied_buffer");
   gpr_slice_from_static_string_import = (gpr_slice_from_static_string_type) GetProcAddress(library, "gpr_slice_from_static_string");
+  gpr_slice_from_mapped_file_import = (gpr_slice_from_mapped_file_type) GetProcAddress(library, "gpr_slice_from_mapped_file");
   gpr_slice_sub_import = (gpr_slice_sub_type) GetProcAddress(library, "gpr_slice_sub");
   gpr_slice_sub_no_ref_import = (gpr_slice_sub_no_ref_type) GetProcAddress(library, "gpr_slice_sub_no_ref");
   gpr_slice_split_tail_import = (gpr_slice_split_tail_type) GetProcAddress(library, "gpr_slice_split_tail");
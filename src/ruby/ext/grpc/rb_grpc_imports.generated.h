@@ -68,6 +68,9 @@ extern grpc_raw_byte_buffer_create_type grpc_raw_byte_buffer_create_import;
 typedef grpc_byte_buffer *(*grpc_raw_compressed_byte_buffer_create_type)(gpr_slice *slices, size_t nslices, grpc_compression_algorithm compression);
 extern grpc_raw_compressed_byte_buffer_create_type grpc_raw_compressed_byte_buffer_create_import;
 #define grpc_raw_compressed_byte_buffer_create grpc_raw_compressed_byte_buffer_create_import
+typedef grpc_byte_buffer *(*grpc_raw_byte_buffer_from_file_type)(int fd, int64_t offset, size_t length);
+extern grpc_raw_byte_buffer_from_file_type grpc_raw_byte_buffer_from_file_import;
+#define grpc_raw_byte_buffer_from_file grpc_raw_byte_buffer_from_file_import
 typedef grpc_byte_buffer *(*grpc_byte_buffer_copy_type)(grpc_byte_buffer *bb);
 extern grpc_byte_buffer_copy_type grpc_byte_buffer_copy_import;
 #define grpc_byte_buffer_copy grpc_byte_buffer_copy_import
@@ -89,6 +92,9 @@ extern grpc_byte_buffer_reader_next_type grpc_byte_buffer_reader_next_import;
 typedef gpr_slice(*grpc_byte_buffer_reader_readall_type)(grpc_byte_buffer_reader *reader);
 extern grpc_byte_buffer_reader_readall_type grpc_byte_buffer_reader_readall_import;
 #define grpc_byte_buffer_reader_readall grpc_byte_buffer_reader_readall_import
+typedef gpr_slice(*grpc_byte_buffer_reader_readall_shared_type)(grpc_byte_buffer_reader *reader);
+extern grpc_byte_buffer_reader_readall_shared_type grpc_byte_buffer_reader_readall_shared_import;
+#define grpc_byte_buffer_reader_readall_shared grpc_byte_buffer_reader_readall_shared_import
 typedef grpc_byte_buffer *(*grpc_raw_byte_buffer_from_reader_type)(grpc_byte_buffer_reader *reader);
 extern grpc_raw_byte_buffer_from_reader_type grpc_raw_byte_buffer_from_reader_import;
 #define grpc_raw_byte_buffer_from_reader grpc_raw_byte_buffer_from_reader_import
@@ -197,6 +203,15 @@ extern grpc_compression_options_disable_algorithm_type grpc_compression_options_
 typedef int(*grpc_compression_options_is_algorithm_enabled_type)(const grpc_compression_options *opts, grpc_compression_algorithm algorithm);
 extern grpc_compression_options_is_algorithm_enabled_type grpc_compression_options_is_algorithm_enabled_import;
 #define grpc_compression_options_is_algorithm_enabled grpc_compression_options_is_algorithm_enabled_import
+typedef grpc_compression_dictionary *(*grpc_compression_dictionary_create_type)(const void *data, size_t length);
+extern grpc_compression_dictionary_create_type grpc_compression_dictionary_create_import;
+#define grpc_compression_dictionary_create grpc_compression_dictionary_create_import
+typedef void(*grpc_compression_dictionary_unref_type)(grpc_compression_dictionary *dictionary);
+extern grpc_compression_dictionary_unref_type grpc_compression_dictionary_unref_import;
+#define grpc_compression_dictionary_unref grpc_compression_dictionary_unref_import
+typedef grpc_arg(*grpc_compression_dictionary_to_arg_type)(grpc_compression_dictionary *dictionary);
+extern grpc_compression_dictionary_to_arg_type grpc_compression_dictionary_to_arg_import;
+#define grpc_compression_dictionary_to_arg grpc_compression_dictionary_to_arg_import
 typedef void(*grpc_metadata_array_init_type)(grpc_metadata_array *array);
 extern grpc_metadata_array_init_type grpc_metadata_array_init_import;
 #define grpc_metadata_array_init grpc_metadata_array_init_import
@@ -326,6 +341,9 @@ extern grpc_server_start_type grpc_server_start_import;
 typedef void(*grpc_server_shutdown_and_notify_type)(grpc_server *server, grpc_completion_queue *cq, void *tag);
 extern grpc_server_shutdown_and_notify_type grpc_server_shutdown_and_notify_import;
 #define grpc_server_shutdown_and_notify grpc_server_shutdown_and_notify_import
+typedef void(*grpc_server_drain_and_notify_type)(grpc_server *server, gpr_timespec deadline, grpc_completion_queue *cq, void *tag);
+extern grpc_server_drain_and_notify_type grpc_server_drain_and_notify_import;
+#define grpc_server_drain_and_notify grpc_server_drain_and_notify_import
 typedef void(*grpc_server_cancel_all_calls_type)(grpc_server *server);
 extern grpc_server_cancel_all_calls_type grpc_server_cancel_all_calls_import;
 #define grpc_server_cancel_all_calls grpc_server_cancel_all_calls_import
@@ -626,6 +644,9 @@ extern gpr_slice_from_copied_buffer_type gpr_slice_from_copied_buffer_import;
 typedef gpr_slice(*gpr_slice_from_static_string_type)(const char *source);
 extern gpr_slice_from_static_string_type gpr_slice_from_static_string_import;
 #define gpr_slice_from_static_string gpr_slice_from_static_string_import
+typedef int(*gpr_slice_from_mapped_file_type)(int fd, int64_t offset, size_t length, gpr_slice_map_advice advice, gpr_slice *slice);
+extern gpr_slice_from_mapped_file_type gpr_slice_from_mapped_file_import;
+#define gpr_slice_from_mapped_file gpr_slice_from_mapped_file_import
 typedef gpr_slice(*gpr_slice_sub_type)(gpr_slice s, size_t begin, size_t end);
 extern gpr_slice_sub_type gpr_slice_sub_import;
 #define gpr_slice_sub gpr_slice_sub_import
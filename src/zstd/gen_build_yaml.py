@@ -0,0 +1,68 @@
+#!/usr/bin/env python2.7
+
+# Copyright 2016, Google Inc.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     * Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following disclaimer
+# in the documentation and/or other materials provided with the
+# distribution.
+#     * Neither the name of Google Inc. nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import glob
+import os
+import sys
+import yaml
+
+os.chdir(os.path.dirname(sys.argv[0])+'/../..')
+
+out = {}
+
+# Only the one-shot and streaming (de)compressors are built; the dictionary
+# builder, legacy format decoders and deprecated APIs are not vendored.
+ZSTD_DIRS = ['common', 'compress', 'decompress']
+
+try:
+  if not os.path.exists('third_party/zstd/lib/zstd.h'):
+    raise Exception('zstd not found')
+
+  def zpath(pattern):
+    return sorted(sum([glob.glob('third_party/zstd/lib/%s/%s' % (d, pattern))
+                       for d in ZSTD_DIRS], []))
+
+  out['libs'] = [{
+      'name': 'zstd',
+      'zstd': True,
+      'defaults': 'zstd',
+      'build': 'private',
+      'language': 'c',
+      'secure': 'no',
+      'src': zpath('*.c'),
+      'headers': sorted(['third_party/zstd/lib/zstd.h',
+                         'third_party/zstd/lib/zstd_errors.h'] +
+                        zpath('*.h')),
+  }]
+except:
+  pass
+
+print yaml.dump(out)
@@ -0,0 +1,151 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/*
+   Cost of the channel args work done for every subchannel a channel asks
+   for (building a key for the subchannel index and comparing it against the
+   keys already there). Compares plain channel args against interned ones.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/channel/channel_args.h"
+
+static double now_seconds(void) {
+  gpr_timespec t = gpr_now(GPR_CLOCK_MONOTONIC);
+  return (double)t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static grpc_arg g_args[] = {
+    {GRPC_ARG_INTEGER, GRPC_ARG_MAX_CONCURRENT_STREAMS, {.integer = 100}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH,
+     {.integer = 4194304}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_MAX_SEND_MESSAGE_LENGTH, {.integer = -1}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES,
+     {.integer = 65536}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_HTTP2_HPACK_TABLE_SIZE_DECODER,
+     {.integer = 4096}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_HTTP2_HPACK_TABLE_SIZE_ENCODER,
+     {.integer = 4096}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_HTTP2_MAX_FRAME_SIZE, {.integer = 16384}},
+    {GRPC_ARG_STRING, GRPC_ARG_DEFAULT_AUTHORITY,
+     {.string = "backend.example.com"}},
+    {GRPC_ARG_STRING, GRPC_ARG_PRIMARY_USER_AGENT_STRING,
+     {.string = "benchmark/1.0"}},
+    {GRPC_ARG_STRING, GRPC_ARG_SECONDARY_USER_AGENT_STRING,
+     {.string = "grpc-c/1.1.0"}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_MAX_RECONNECT_BACKOFF_MS, {.integer = 120000}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS,
+     {.integer = 1000}},
+    {GRPC_ARG_STRING, GRPC_SSL_TARGET_NAME_OVERRIDE_ARG,
+     {.string = "backend.example.com"}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_MAX_METADATA_SIZE, {.integer = 16384}},
+    {GRPC_ARG_STRING, GRPC_ARG_SERVICE_CONFIG, {.string = "{}"}},
+    {GRPC_ARG_INTEGER, GRPC_ARG_ENABLE_CENSUS, {.integer = 0}},
+};
+
+static grpc_channel_args g_channel_args = {GPR_ARRAY_SIZE(g_args), g_args};
+
+/* a subchannel key lookup makes about this many comparisons in the index */
+#define KEY_COMPARES 8
+
+static void plain_key(int ops) {
+  grpc_channel_args *existing = grpc_channel_args_normalize(&g_channel_args);
+  int equal = 0;
+  for (int i = 0; i < ops; i++) {
+    grpc_channel_args *key = grpc_channel_args_normalize(&g_channel_args);
+    for (int j = 0; j < KEY_COMPARES; j++) {
+      equal += grpc_channel_args_compare(key, existing) == 0;
+    }
+    grpc_channel_args_destroy(key);
+  }
+  GPR_ASSERT(equal == ops * KEY_COMPARES);
+  grpc_channel_args_destroy(existing);
+}
+
+static void interned_key(int ops) {
+  grpc_interned_channel_args *existing =
+      grpc_channel_args_intern(&g_channel_args);
+  int equal = 0;
+  for (int i = 0; i < ops; i++) {
+    grpc_interned_channel_args *key = grpc_channel_args_intern(&g_channel_args);
+    for (int j = 0; j < KEY_COMPARES; j++) {
+      equal += key == existing;
+    }
+    grpc_interned_channel_args_unref(key);
+  }
+  GPR_ASSERT(equal == ops * KEY_COMPARES);
+  grpc_interned_channel_args_unref(existing);
+}
+
+typedef struct scenario {
+  const char *name;
+  void (*run)(int ops);
+} scenario;
+
+static const scenario scenarios[] = {
+    {"plain_key", plain_key},
+    {"interned_key", interned_key},
+};
+
+int main(int argc, char **argv) {
+  int ops = 1000000;
+  size_t i;
+
+  gpr_cmdline *cmdline = gpr_cmdline_create("channel args benchmark");
+  gpr_cmdline_add_int(cmdline, "ops", "Operations per scenario", &ops);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  if (ops <= 0) {
+    fprintf(stderr, "ops must be > 0\n");
+    return 1;
+  }
+
+  grpc_init();
+  printf("%-16s %10s\n", "scenario", "ns/op");
+  for (i = 0; i < GPR_ARRAY_SIZE(scenarios); i++) {
+    double start = now_seconds();
+    scenarios[i].run(ops);
+    printf("%-16s %10.1f\n", scenarios[i].name,
+           (now_seconds() - start) * 1e9 / ops);
+  }
+  grpc_shutdown();
+
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
@@ -134,12 +134,152 @@ static void test_compression_algorithm_states(void) {
   grpc_channel_args_destroy(ch_args);
 }
 
+static grpc_arg int_arg(char *key, int value) {
+  grpc_arg arg;
+  arg.type = GRPC_ARG_INTEGER;
+  arg.key = key;
+  arg.value.integer = value;
+  return arg;
+}
+
+static grpc_arg string_arg(char *key, char *value) {
+  grpc_arg arg;
+  arg.type = GRPC_ARG_STRING;
+  arg.key = key;
+  arg.value.string = value;
+  return arg;
+}
+
+static void test_intern(void) {
+  grpc_arg a[] = {int_arg("b", 1), string_arg("a", "x"), int_arg("c", 2)};
+  grpc_arg b[] = {int_arg("c", 2), int_arg("b", 1), string_arg("a", "x")};
+  grpc_arg c[] = {int_arg("b", 1), string_arg("a", "y"), int_arg("c", 2)};
+  grpc_channel_args args_a = {GPR_ARRAY_SIZE(a), a};
+  grpc_channel_args args_b = {GPR_ARRAY_SIZE(b), b};
+  grpc_channel_args args_c = {GPR_ARRAY_SIZE(c), c};
+  grpc_channel_args no_args = {0, NULL};
+
+  grpc_interned_channel_args *ia = grpc_channel_args_intern(&args_a);
+  grpc_interned_channel_args *ib = grpc_channel_args_intern(&args_b);
+  grpc_interned_channel_args *ic = grpc_channel_args_intern(&args_c);
+  grpc_interned_channel_args *empty = grpc_channel_args_intern(NULL);
+
+  /* the same args in another order are the same object */
+  GPR_ASSERT(ia == ib);
+  GPR_ASSERT(ia != ic);
+  grpc_interned_channel_args *no_args_interned =
+      grpc_channel_args_intern(&no_args);
+  GPR_ASSERT(empty == no_args_interned);
+  GPR_ASSERT(grpc_interned_channel_args_get(empty)->num_args == 0);
+  grpc_interned_channel_args_unref(no_args_interned);
+
+  /* the args are normalized */
+  grpc_channel_args *normalized = grpc_channel_args_normalize(&args_b);
+  GPR_ASSERT(grpc_channel_args_compare(grpc_interned_channel_args_get(ia),
+                                       normalized) == 0);
+  grpc_channel_args_destroy(normalized);
+
+  grpc_interned_channel_args_unref(ia);
+  grpc_interned_channel_args_unref(ib);
+  grpc_interned_channel_args_unref(ic);
+  grpc_interned_channel_args_unref(empty);
+
+  /* once released, interning the args again makes a new object */
+  ic = grpc_channel_args_intern(&args_c);
+  GPR_ASSERT(strcmp(grpc_interned_channel_args_get(ic)->args[0].value.string,
+                    "y") == 0);
+  grpc_interned_channel_args_unref(ic);
+}
+
+static void *ptr_copy(void *p) { return p; }
+static void ptr_destroy(void *p) {}
+/* all the pointers of this type are interchangeable */
+static int ptr_cmp_equal(void *a, void *b) { return 0; }
+/* pointers of this type are ordered by the int they point to */
+static int ptr_cmp_int(void *a, void *b) {
+  return GPR_ICMP(*(int *)a, *(int *)b);
+}
+
+static const grpc_arg_pointer_vtable equal_vtable = {ptr_copy, ptr_destroy,
+                                                     ptr_cmp_equal};
+static const grpc_arg_pointer_vtable other_vtable = {ptr_copy, ptr_destroy,
+                                                     ptr_cmp_equal};
+static const grpc_arg_pointer_vtable int_vtable = {ptr_copy, ptr_destroy,
+                                                   ptr_cmp_int};
+
+static grpc_arg pointer_arg(char *key, void *p,
+                            const grpc_arg_pointer_vtable *vtable) {
+  grpc_arg arg;
+  arg.type = GRPC_ARG_POINTER;
+  arg.key = key;
+  arg.value.pointer.p = p;
+  arg.value.pointer.vtable = vtable;
+  return arg;
+}
+
+static int compare_args(grpc_arg a, grpc_arg b) {
+  grpc_channel_args args_a = {1, &a};
+  grpc_channel_args args_b = {1, &b};
+  return grpc_channel_args_compare(&args_a, &args_b);
+}
+
+static void test_compare_pointers(void) {
+  int x = 1, y = 2, z = 1;
+  /* the same pointer is equal to itself, whatever its vtable */
+  GPR_ASSERT(compare_args(pointer_arg("p", &x, &int_vtable),
+                          pointer_arg("p", &x, &other_vtable)) == 0);
+  /* distinct pointers are compared by their vtable... */
+  GPR_ASSERT(compare_args(pointer_arg("p", &x, &int_vtable),
+                          pointer_arg("p", &z, &int_vtable)) == 0);
+  GPR_ASSERT(compare_args(pointer_arg("p", &x, &int_vtable),
+                          pointer_arg("p", &y, &int_vtable)) < 0);
+  GPR_ASSERT(compare_args(pointer_arg("p", &y, &int_vtable),
+                          pointer_arg("p", &x, &int_vtable)) > 0);
+  /* ...when they share it, and are otherwise ordered by vtable */
+  GPR_ASSERT(compare_args(pointer_arg("p", &x, &equal_vtable),
+                          pointer_arg("p", &z, &other_vtable)) ==
+             GPR_ICMP(&equal_vtable, &other_vtable));
+}
+
+static void test_intern_pointers(void) {
+  int x, y;
+  grpc_arg a = pointer_arg("p", &x, &equal_vtable);
+  grpc_arg b = pointer_arg("p", &y, &equal_vtable);
+  grpc_arg c = pointer_arg("p", &x, &other_vtable);
+  grpc_arg d = pointer_arg("p", &y, &other_vtable);
+  grpc_channel_args args_a = {1, &a};
+  grpc_channel_args args_b = {1, &b};
+  grpc_channel_args args_c = {1, &c};
+  grpc_channel_args args_d = {1, &d};
+
+  grpc_interned_channel_args *ia = grpc_channel_args_intern(&args_a);
+  grpc_interned_channel_args *ib = grpc_channel_args_intern(&args_b);
+  grpc_interned_channel_args *ic = grpc_channel_args_intern(&args_c);
+  grpc_interned_channel_args *id = grpc_channel_args_intern(&args_d);
+
+  /* args that compare equal are the same interned args: distinct pointers
+     that their vtable deems equal, and the same pointer under another
+     vtable */
+  GPR_ASSERT(ia == ib);
+  GPR_ASSERT(ia == ic);
+  /* distinct pointers with distinct vtables aren't */
+  GPR_ASSERT(ia != id);
+
+  grpc_interned_channel_args_unref(ia);
+  grpc_interned_channel_args_unref(ib);
+  grpc_interned_channel_args_unref(ic);
+  grpc_interned_channel_args_unref(id);
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   grpc_init();
   test_create();
   test_set_compression_algorithm();
   test_compression_algorithm_states();
+  test_compare_pointers();
+  test_intern();
+  test_intern_pointers();
   grpc_shutdown();
   return 0;
 }
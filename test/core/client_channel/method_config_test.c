@@ -0,0 +1,138 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/ext/client_channel/method_config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/string_util.h>
+#include <grpc/support/useful.h>
+
+#include "test/core/util/test_config.h"
+
+static grpc_method_config *timeout_config(int64_t seconds) {
+  gpr_timespec timeout = gpr_time_from_seconds(seconds, GPR_TIMESPAN);
+  return grpc_method_config_create(NULL, &timeout, NULL, NULL);
+}
+
+static int64_t timeout_for(const grpc_method_config_table *table,
+                           const char *path) {
+  grpc_mdstr *path_str = grpc_mdstr_from_string(path);
+  const grpc_method_config *method_config =
+      grpc_method_config_table_get(table, path_str);
+  GRPC_MDSTR_UNREF(path_str);
+  if (method_config == NULL) return -1;
+  return grpc_method_config_get_timeout(method_config)->tv_sec;
+}
+
+static grpc_method_config_table *create_table(const char **names,
+                                              size_t num_names) {
+  grpc_method_config_table_entry *entries =
+      gpr_malloc(sizeof(*entries) * num_names);
+  for (size_t i = 0; i < num_names; i++) {
+    entries[i].method_name = grpc_mdstr_from_string(names[i]);
+    entries[i].method_config = timeout_config((int64_t)i + 1);
+  }
+  grpc_method_config_table *table =
+      grpc_method_config_table_create(num_names, entries);
+  for (size_t i = 0; i < num_names; i++) {
+    GRPC_MDSTR_UNREF(entries[i].method_name);
+    grpc_method_config_unref(entries[i].method_config);
+  }
+  gpr_free(entries);
+  return table;
+}
+
+static void test_lookup(void) {
+  const char *names[] = {"/svc.A/Get", "/svc.A/*", "/svc.B/Put", "/svc.C/*"};
+  grpc_method_config_table *table =
+      create_table(names, GPR_ARRAY_SIZE(names));
+  GPR_ASSERT(timeout_for(table, "/svc.A/Get") == 1);
+  /* methods without a config of their own fall back to their service's */
+  GPR_ASSERT(timeout_for(table, "/svc.A/List") == 2);
+  GPR_ASSERT(timeout_for(table, "/svc.B/Put") == 3);
+  GPR_ASSERT(timeout_for(table, "/svc.B/Get") == -1);
+  GPR_ASSERT(timeout_for(table, "/svc.C/Get") == 4);
+  GPR_ASSERT(timeout_for(table, "/svc.D/Get") == -1);
+  GPR_ASSERT(timeout_for(table, "/svc.A") == -1);
+  GPR_ASSERT(timeout_for(table, "svc.C") == -1);
+  grpc_method_config_table_unref(table);
+}
+
+static void test_empty(void) {
+  grpc_method_config_table *table = create_table(NULL, 0);
+  GPR_ASSERT(timeout_for(table, "/svc.A/Get") == -1);
+  grpc_method_config_table_unref(table);
+}
+
+static void test_many_entries(void) {
+  enum { NUM_SERVICES = 64, METHODS_PER_SERVICE = 4 };
+  const char *names[NUM_SERVICES * (METHODS_PER_SERVICE + 1)];
+  char buf[64];
+  size_t n = 0;
+  for (int i = 0; i < NUM_SERVICES; i++) {
+    for (int j = 0; j < METHODS_PER_SERVICE; j++) {
+      snprintf(buf, sizeof(buf), "/svc.%d/Method%d", i, j);
+      names[n++] = gpr_strdup(buf);
+    }
+    snprintf(buf, sizeof(buf), "/svc.%d/*", i);
+    names[n++] = gpr_strdup(buf);
+  }
+  grpc_method_config_table *table = create_table(names, n);
+  for (size_t i = 0; i < n; i++) {
+    GPR_ASSERT(timeout_for(table, names[i]) == (int64_t)i + 1);
+  }
+  for (int i = 0; i < NUM_SERVICES; i++) {
+    snprintf(buf, sizeof(buf), "/svc.%d/Other", i);
+    GPR_ASSERT(timeout_for(table, buf) ==
+               (i + 1) * (METHODS_PER_SERVICE + 1));
+  }
+  grpc_method_config_table_unref(table);
+  for (size_t i = 0; i < n; i++) {
+    gpr_free((void *)names[i]);
+  }
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  grpc_init();
+  test_lookup();
+  test_empty();
+  test_many_entries();
+  grpc_shutdown();
+  return 0;
+}
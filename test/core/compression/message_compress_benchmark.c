@@ -0,0 +1,238 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Compression throughput and ratio of every algorithm grpc_msg_compress
+   supports, over payloads resembling what RPCs typically carry.
+
+   For each payload, message size and algorithm, reports the compressed size
+   relative to the original and the compression and decompression speeds in
+   MB/s of uncompressed data.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/compression/message_compress.h"
+
+typedef struct payload {
+  const char *name;
+  void (*fill)(uint8_t *buf, size_t length);
+} payload;
+
+/* deterministic, so that runs on different machines are comparable */
+static uint32_t next_random(uint32_t *state) {
+  *state = *state * 1103515245 + 12345;
+  return *state >> 16;
+}
+
+/* JSON-ish records, as sent by REST-style services */
+static void fill_text(uint8_t *buf, size_t length) {
+  static const char *const words[] = {
+      "user",   "account", "status", "active", "pending", "created",
+      "region", "us-east", "eu-west", "items", "price",   "quantity"};
+  uint32_t state = 1;
+  size_t pos = 0;
+  while (pos < length) {
+    char record[128];
+    int n = snprintf(
+        record, sizeof(record), "{\"id\":%u,\"%s\":\"%s\",\"%s\":%u},",
+        (unsigned)next_random(&state), words[next_random(&state) % 12],
+        words[next_random(&state) % 12], words[next_random(&state) % 12],
+        (unsigned)(next_random(&state) % 1000));
+    size_t copy = GPR_MIN((size_t)n, length - pos);
+    memcpy(buf + pos, record, copy);
+    pos += copy;
+  }
+}
+
+/* protobuf-like: tags followed by small varints and short strings */
+static void fill_proto(uint8_t *buf, size_t length) {
+  uint32_t state = 2;
+  size_t pos = 0;
+  while (pos < length) {
+    uint32_t r = next_random(&state);
+    buf[pos++] = (uint8_t)(((r % 8) + 1) << 3 | ((r & 8) ? 2 : 0));
+    if (r & 8) {
+      size_t len = GPR_MIN(r % 16, length - pos);
+      size_t i;
+      if (pos < length) buf[pos++] = (uint8_t)len;
+      for (i = 0; i < len && pos < length; i++) {
+        buf[pos++] = (uint8_t)('a' + next_random(&state) % 26);
+      }
+    } else {
+      uint32_t v = next_random(&state) % 300;
+      while (v >= 0x80 && pos < length) {
+        buf[pos++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+      }
+      if (pos < length) buf[pos++] = (uint8_t)v;
+    }
+  }
+}
+
+/* already compressed or encrypted data */
+static void fill_random(uint8_t *buf, size_t length) {
+  uint32_t state = 3;
+  size_t i;
+  for (i = 0; i < length; i++) {
+    buf[i] = (uint8_t)next_random(&state);
+  }
+}
+
+static const payload payloads[] = {
+    {"text", fill_text}, {"proto", fill_proto}, {"random", fill_random}};
+
+static double now_seconds(void) {
+  gpr_timespec t = gpr_now(GPR_CLOCK_MONOTONIC);
+  return (double)t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static double megabytes_per_second(size_t length, int iterations,
+                                   double seconds) {
+  return (double)length * iterations / seconds / 1e6;
+}
+
+static void run_one(const payload *p, size_t length,
+                    grpc_compression_algorithm algorithm, double min_seconds) {
+  gpr_slice value = gpr_slice_malloc(length);
+  gpr_slice_buffer input;
+  gpr_slice_buffer compressed;
+  gpr_slice_buffer output;
+  char *algorithm_name;
+  int was_compressed = 0;
+  int compress_iterations = 0;
+  int decompress_iterations = 0;
+  double start;
+  double compress_seconds;
+  double decompress_seconds;
+
+  GPR_ASSERT(grpc_compression_algorithm_name(algorithm, &algorithm_name));
+  p->fill(GPR_SLICE_START_PTR(value), length);
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&compressed);
+  gpr_slice_buffer_init(&output);
+  gpr_slice_buffer_add(&input, value);
+
+  start = now_seconds();
+  do {
+    gpr_slice_buffer_reset_and_unref(&compressed);
+    was_compressed = grpc_msg_compress(algorithm, &input, &compressed);
+    compress_iterations++;
+  } while ((compress_seconds = now_seconds() - start) < min_seconds);
+
+  printf("%-8s %9" PRIuPTR " %-16s %7.3f %12.1f", p->name, length,
+         algorithm_name, (double)compressed.length / (double)length,
+         megabytes_per_second(length, compress_iterations, compress_seconds));
+
+  /* messages that don't shrink are sent as they are: nothing to decompress */
+  if (!was_compressed) {
+    printf(" %12s\n", "-");
+  } else {
+    start = now_seconds();
+    do {
+      gpr_slice_buffer_reset_and_unref(&output);
+      GPR_ASSERT(grpc_msg_decompress(algorithm, &compressed, &output));
+      decompress_iterations++;
+    } while ((decompress_seconds = now_seconds() - start) < min_seconds);
+    GPR_ASSERT(output.length == length);
+    printf(" %12.1f\n", megabytes_per_second(length, decompress_iterations,
+                                              decompress_seconds));
+  }
+
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&compressed);
+  gpr_slice_buffer_destroy(&output);
+}
+
+int main(int argc, char **argv) {
+  static const size_t default_lengths[] = {1024, 16 * 1024, 1024 * 1024};
+  int length = 0;
+  int milliseconds = 200;
+  char *algorithm_name = NULL;
+  grpc_compression_algorithm only_algorithm = GRPC_COMPRESS_ALGORITHMS_COUNT;
+  size_t i, j;
+  int k;
+
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("message compression benchmarking tool");
+  gpr_cmdline_add_int(cmdline, "msg_size",
+                      "Size of the messages (default: 1KB, 16KB and 1MB)",
+                      &length);
+  gpr_cmdline_add_int(cmdline, "milliseconds",
+                      "Minimum time spent on each measurement", &milliseconds);
+  gpr_cmdline_add_string(cmdline, "algorithm",
+                         "Only benchmark this algorithm (default: all)",
+                         &algorithm_name);
+  gpr_cmdline_parse(cmdline, argc, argv);
+
+  if (algorithm_name != NULL &&
+      !grpc_compression_algorithm_parse(algorithm_name, strlen(algorithm_name),
+                                        &only_algorithm)) {
+    fprintf(stderr, "Unknown compression algorithm %s\n", algorithm_name);
+    return 1;
+  }
+  if (length < 0 || milliseconds <= 0) {
+    fprintf(stderr, "msg_size and milliseconds must be > 0\n");
+    return 1;
+  }
+
+  grpc_init();
+  printf("%-8s %9s %-16s %7s %12s %12s\n", "payload", "size", "algorithm",
+         "ratio", "comp MB/s", "decomp MB/s");
+  for (i = 0; i < GPR_ARRAY_SIZE(payloads); i++) {
+    for (j = 0; j < GPR_ARRAY_SIZE(default_lengths); j++) {
+      if (length > 0 && j > 0) break;
+      for (k = GRPC_COMPRESS_NONE + 1; k < GRPC_COMPRESS_ALGORITHMS_COUNT;
+           k++) {
+        if (only_algorithm != GRPC_COMPRESS_ALGORITHMS_COUNT &&
+            only_algorithm != (grpc_compression_algorithm)k) {
+          continue;
+        }
+        run_one(&payloads[i], length > 0 ? (size_t)length : default_lengths[j],
+                (grpc_compression_algorithm)k, milliseconds / 1000.0);
+      }
+    }
+  }
+  grpc_shutdown();
+
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
@@ -37,7 +37,9 @@
 #include <string.h>
 
 #include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include <grpc/support/string_util.h>
 #include <grpc/support/useful.h>
 
 #include "src/core/lib/support/murmur_hash.h"
@@ -52,6 +54,30 @@ typedef enum {
   MAYBE_COMPRESSES
 } compressability;
 
+/* feeds 'input' to a grpc_msg_decompressor one slice at a time, the way the
+   call decompresses messages as they are received */
+static int decompress_incrementally(grpc_compression_algorithm algorithm,
+                                    grpc_compression_dictionary *dictionary,
+                                    gpr_slice_buffer *input,
+                                    gpr_slice_buffer *output) {
+  grpc_msg_stream_context *stream = NULL;
+  grpc_msg_decompressor *decompressor;
+  size_t i;
+  int r = 1;
+  if (algorithm == GRPC_COMPRESS_STREAM_DEFLATE) {
+    stream = grpc_msg_stream_decompressor_create();
+  }
+  decompressor = grpc_msg_decompressor_create(algorithm, stream, dictionary);
+  for (i = 0; r && i < input->count; i++) {
+    r = grpc_msg_decompressor_add(decompressor, gpr_slice_ref(input->slices[i]),
+                                  output);
+  }
+  r = r && grpc_msg_decompressor_finish(decompressor);
+  grpc_msg_decompressor_destroy(decompressor);
+  if (stream != NULL) grpc_msg_stream_context_destroy(stream);
+  return r;
+}
+
 static void assert_passthrough(gpr_slice value,
                                grpc_compression_algorithm algorithm,
                                grpc_slice_split_mode uncompressed_split_mode,
@@ -104,12 +130,20 @@ static void assert_passthrough(gpr_slice value,
 
   final = grpc_slice_merge(output.slices, output.count);
   GPR_ASSERT(0 == gpr_slice_cmp(value, final));
+  gpr_slice_unref(final);
+
+  if (was_compressed) {
+    gpr_slice_buffer_reset_and_unref(&output);
+    GPR_ASSERT(decompress_incrementally(algorithm, NULL, &compressed, &output));
+    final = grpc_slice_merge(output.slices, output.count);
+    GPR_ASSERT(0 == gpr_slice_cmp(value, final));
+    gpr_slice_unref(final);
+  }
 
   gpr_slice_buffer_destroy(&input);
   gpr_slice_buffer_destroy(&compressed);
   gpr_slice_buffer_destroy(&compressed_raw);
   gpr_slice_buffer_destroy(&output);
-  gpr_slice_unref(final);
 }
 
 static gpr_slice repeated(char c, size_t length) {
@@ -173,6 +207,7 @@ static void test_bad_decompression_data_crc(void) {
   gpr_slice_buffer corrupted;
   gpr_slice_buffer output;
   size_t idx;
+  size_t last;
   const uint32_t bad = 0xdeadbeef;
 
   gpr_slice_buffer_init(&input);
@@ -183,10 +218,10 @@ static void test_bad_decompression_data_crc(void) {
   /* compress it */
   grpc_msg_compress(GRPC_COMPRESS_GZIP, &input, &corrupted);
   /* corrupt the output by smashing the CRC */
-  GPR_ASSERT(corrupted.count > 1);
-  GPR_ASSERT(GPR_SLICE_LENGTH(corrupted.slices[1]) > 8);
-  idx = GPR_SLICE_LENGTH(corrupted.slices[1]) - 8;
-  memcpy(GPR_SLICE_START_PTR(corrupted.slices[1]) + idx, &bad, 4);
+  last = corrupted.count - 1;
+  GPR_ASSERT(GPR_SLICE_LENGTH(corrupted.slices[last]) > 8);
+  idx = GPR_SLICE_LENGTH(corrupted.slices[last]) - 8;
+  memcpy(GPR_SLICE_START_PTR(corrupted.slices[last]) + idx, &bad, 4);
 
   /* try (and fail) to decompress the corrupted compresed buffer */
   GPR_ASSERT(0 == grpc_msg_decompress(GRPC_COMPRESS_GZIP, &corrupted, &output));
@@ -230,6 +265,243 @@ static void test_bad_decompression_data_stream(void) {
   gpr_slice_buffer_destroy(&output);
 }
 
+static void test_bad_zstd_decompression_data(void) {
+  gpr_slice_buffer input;
+  gpr_slice_buffer compressed;
+  gpr_slice_buffer truncated;
+  gpr_slice_buffer output;
+  gpr_slice frame;
+
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&compressed);
+  gpr_slice_buffer_init(&truncated);
+  gpr_slice_buffer_init(&output);
+  gpr_slice_buffer_add(&input, create_test_value(ONE_KB_A));
+
+  GPR_ASSERT(grpc_msg_compress(GRPC_COMPRESS_ZSTD, &input, &compressed));
+  frame = grpc_slice_merge(compressed.slices, compressed.count);
+
+  /* a frame missing its last byte */
+  gpr_slice_buffer_add(&truncated,
+                       gpr_slice_sub(frame, 0, GPR_SLICE_LENGTH(frame) - 1));
+  GPR_ASSERT(0 == grpc_msg_decompress(GRPC_COMPRESS_ZSTD, &truncated, &output));
+  GPR_ASSERT(0 == output.length);
+
+  /* a complete frame followed by garbage */
+  gpr_slice_buffer_add(&compressed, gpr_slice_from_copied_string("garbage"));
+  GPR_ASSERT(0 ==
+             grpc_msg_decompress(GRPC_COMPRESS_ZSTD, &compressed, &output));
+  GPR_ASSERT(0 == output.length);
+
+  gpr_slice_unref(frame);
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&compressed);
+  gpr_slice_buffer_destroy(&truncated);
+  gpr_slice_buffer_destroy(&output);
+}
+
+static void test_bad_incremental_decompression_data(void) {
+  const grpc_compression_algorithm algorithms[] = {
+      GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_ZSTD};
+  size_t i;
+
+  for (i = 0; i < GPR_ARRAY_SIZE(algorithms); i++) {
+    gpr_slice_buffer input;
+    gpr_slice_buffer compressed;
+    gpr_slice_buffer truncated;
+    gpr_slice_buffer output;
+    gpr_slice whole;
+
+    gpr_slice_buffer_init(&input);
+    gpr_slice_buffer_init(&compressed);
+    gpr_slice_buffer_init(&truncated);
+    gpr_slice_buffer_init(&output);
+    gpr_slice_buffer_add(&input, create_test_value(ONE_KB_A));
+    GPR_ASSERT(grpc_msg_compress(algorithms[i], &input, &compressed));
+    whole = grpc_slice_merge(compressed.slices, compressed.count);
+
+    /* a message missing its last byte is not complete */
+    gpr_slice_buffer_add(&truncated,
+                         gpr_slice_sub(whole, 0, GPR_SLICE_LENGTH(whole) - 1));
+    GPR_ASSERT(0 == decompress_incrementally(algorithms[i], NULL, &truncated,
+                                             &output));
+
+    /* nor can anything follow the end of one */
+    gpr_slice_buffer_reset_and_unref(&output);
+    gpr_slice_buffer_add(&compressed, gpr_slice_from_copied_string("garbage"));
+    GPR_ASSERT(0 == decompress_incrementally(algorithms[i], NULL, &compressed,
+                                             &output));
+
+    gpr_slice_unref(whole);
+    gpr_slice_buffer_destroy(&input);
+    gpr_slice_buffer_destroy(&compressed);
+    gpr_slice_buffer_destroy(&truncated);
+    gpr_slice_buffer_destroy(&output);
+  }
+}
+
+static void test_compressed_output_slices(void) {
+  gpr_slice_buffer input;
+  gpr_slice_buffer output;
+
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&output);
+  gpr_slice_buffer_add(&input, create_test_value(ONE_KB_A));
+
+  /* output is sized after the input rather than cut into fixed-size blocks */
+  GPR_ASSERT(grpc_msg_compress(GRPC_COMPRESS_GZIP, &input, &output));
+  GPR_ASSERT(output.count == 1);
+
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&output);
+}
+
+static gpr_slice numbered_message(int i) {
+  char *s;
+  gpr_slice out;
+  gpr_asprintf(&s,
+               "{\"id\": %d, \"name\": \"message number %d\", \"payload\": "
+               "\"the quick brown fox jumps over the lazy dog\"}",
+               i, i);
+  out = gpr_slice_from_copied_string(s);
+  gpr_free(s);
+  return out;
+}
+
+static void test_stream_compression(void) {
+  grpc_msg_stream_context *compressor = grpc_msg_stream_compressor_create();
+  grpc_msg_stream_context *decompressor =
+      grpc_msg_stream_decompressor_create();
+  size_t first_size = 0;
+  int i;
+
+  for (i = 0; i < 10; i++) {
+    gpr_slice value = numbered_message(i);
+    gpr_slice_buffer input;
+    gpr_slice_buffer compressed_raw;
+    gpr_slice_buffer compressed;
+    gpr_slice_buffer output;
+    gpr_slice final;
+
+    gpr_slice_buffer_init(&input);
+    gpr_slice_buffer_init(&compressed_raw);
+    gpr_slice_buffer_init(&compressed);
+    gpr_slice_buffer_init(&output);
+
+    grpc_split_slices_to_buffer(GRPC_SLICE_SPLIT_ONE_BYTE, &value, 1, &input);
+    /* every message goes through, even if it doesn't shrink */
+    GPR_ASSERT(grpc_msg_stream_compress(compressor, &input, &compressed_raw));
+    if (i == 0) {
+      first_size = compressed_raw.length;
+    } else {
+      /* later messages refer back to the earlier ones */
+      GPR_ASSERT(compressed_raw.length < first_size / 2);
+    }
+    grpc_split_slice_buffer(GRPC_SLICE_SPLIT_ONE_BYTE, &compressed_raw,
+                            &compressed);
+    GPR_ASSERT(grpc_msg_stream_decompress(decompressor, &compressed, &output));
+    final = grpc_slice_merge(output.slices, output.count);
+    GPR_ASSERT(0 == gpr_slice_cmp(value, final));
+
+    gpr_slice_buffer_destroy(&input);
+    gpr_slice_buffer_destroy(&compressed_raw);
+    gpr_slice_buffer_destroy(&compressed);
+    gpr_slice_buffer_destroy(&output);
+    gpr_slice_unref(final);
+    gpr_slice_unref(value);
+  }
+
+  grpc_msg_stream_context_destroy(compressor);
+  grpc_msg_stream_context_destroy(decompressor);
+}
+
+static void test_dictionary_compression(void) {
+  gpr_slice dict_data = numbered_message(0);
+  grpc_compression_dictionary *dict = grpc_compression_dictionary_create(
+      GPR_SLICE_START_PTR(dict_data), GPR_SLICE_LENGTH(dict_data));
+  grpc_compression_dictionary *same_dict = grpc_compression_dictionary_create(
+      GPR_SLICE_START_PTR(dict_data), GPR_SLICE_LENGTH(dict_data));
+  gpr_slice other_data = numbered_message(1);
+  grpc_compression_dictionary *other_dict = grpc_compression_dictionary_create(
+      GPR_SLICE_START_PTR(other_data), GPR_SLICE_LENGTH(other_data));
+  gpr_slice value = numbered_message(42);
+  gpr_slice_buffer input;
+  gpr_slice_buffer compressed;
+  gpr_slice_buffer output;
+  gpr_slice final;
+
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&compressed);
+  gpr_slice_buffer_init(&output);
+  gpr_slice_buffer_add(&input, gpr_slice_ref(value));
+
+  /* the encoding names the dictionary by its contents */
+  GPR_ASSERT(0 == strncmp(grpc_compression_dictionary_encoding(dict),
+                          GRPC_DICT_DEFLATE_ENCODING_PREFIX,
+                          strlen(GRPC_DICT_DEFLATE_ENCODING_PREFIX)));
+  GPR_ASSERT(0 == strcmp(grpc_compression_dictionary_encoding(dict),
+                         grpc_compression_dictionary_encoding(same_dict)));
+  GPR_ASSERT(0 != strcmp(grpc_compression_dictionary_encoding(dict),
+                         grpc_compression_dictionary_encoding(other_dict)));
+
+  /* a message this small hardly compresses on its own, but is mostly made of
+     strings found in the dictionary */
+  GPR_ASSERT(grpc_msg_dict_compress(dict, &input, &compressed));
+  GPR_ASSERT(compressed.length < GPR_SLICE_LENGTH(value) / 3);
+
+  /* any dictionary with the same contents will do */
+  GPR_ASSERT(grpc_msg_dict_decompress(same_dict, &compressed, &output));
+  final = grpc_slice_merge(output.slices, output.count);
+  GPR_ASSERT(0 == gpr_slice_cmp(value, final));
+  gpr_slice_unref(final);
+
+  gpr_slice_buffer_reset_and_unref(&output);
+  GPR_ASSERT(decompress_incrementally(GRPC_COMPRESS_DICT_DEFLATE, same_dict,
+                                      &compressed, &output));
+  final = grpc_slice_merge(output.slices, output.count);
+  GPR_ASSERT(0 == gpr_slice_cmp(value, final));
+  gpr_slice_unref(final);
+
+  /* but without it, messages referring to it can't be decompressed */
+  gpr_slice_buffer_reset_and_unref(&output);
+  GPR_ASSERT(0 == grpc_msg_dict_decompress(other_dict, &compressed, &output));
+  GPR_ASSERT(0 == grpc_msg_dict_decompress(NULL, &compressed, &output));
+  GPR_ASSERT(0 == grpc_msg_decompress(GRPC_COMPRESS_DICT_DEFLATE, &compressed,
+                                      &output));
+  GPR_ASSERT(0 == decompress_incrementally(GRPC_COMPRESS_DICT_DEFLATE,
+                                           other_dict, &compressed, &output));
+  GPR_ASSERT(0 == output.length);
+
+  grpc_compression_dictionary_unref(dict);
+  grpc_compression_dictionary_unref(same_dict);
+  grpc_compression_dictionary_unref(other_dict);
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&compressed);
+  gpr_slice_buffer_destroy(&output);
+  gpr_slice_unref(value);
+  gpr_slice_unref(dict_data);
+  gpr_slice_unref(other_data);
+}
+
+static void test_bad_stream_decompression_data(void) {
+  grpc_msg_stream_context *decompressor =
+      grpc_msg_stream_decompressor_create();
+  gpr_slice_buffer input;
+  gpr_slice_buffer output;
+
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&output);
+  gpr_slice_buffer_add(&input,
+                       gpr_slice_from_copied_buffer("\x78\xda\xff\xff", 4));
+
+  GPR_ASSERT(0 == grpc_msg_stream_decompress(decompressor, &input, &output));
+  GPR_ASSERT(0 == output.length);
+
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&output);
+  grpc_msg_stream_context_destroy(decompressor);
+}
+
 static void test_bad_compression_algorithm(void) {
   gpr_slice_buffer input;
   gpr_slice_buffer output;
@@ -297,9 +569,15 @@ int main(int argc, char **argv) {
   }
 
   test_tiny_data_compress();
+  test_compressed_output_slices();
+  test_stream_compression();
+  test_bad_stream_decompression_data();
+  test_dictionary_compression();
   test_bad_decompression_data_crc();
   test_bad_decompression_data_stream();
   test_bad_decompression_data_trailing_garbage();
+  test_bad_zstd_decompression_data();
+  test_bad_incremental_decompression_data();
   test_bad_compression_algorithm();
   test_bad_decompression_algorithm();
   grpc_shutdown();
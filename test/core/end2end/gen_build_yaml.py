@@ -75,6 +75,7 @@ END2END_FIXTURES = {
     'h2_ssl_proxy': default_secure_fixture_options._replace(includes_proxy=True,
                                                             ci_mac=False),
     'h2_uds': uds_fixture_options,
+    'h2_uds+shm': uds_fixture_options._replace(platforms=['linux']),
 }
 
 TestOptions = collections.namedtuple(
@@ -113,6 +114,8 @@ END2END_TESTS = {
     'invoke_large_request': default_test_options,
     'large_metadata': default_test_options,
     'max_concurrent_streams': default_test_options._replace(proxyable=False),
+    'max_connection_age': default_test_options._replace(proxyable=False,
+                                                        cpu_cost=LOWCPU),
     'max_message_length': default_test_options,
     'negative_deadline': default_test_options,
     'network_status_change': default_test_options,
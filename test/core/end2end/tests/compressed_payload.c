@@ -266,6 +266,16 @@ static void request_for_disabled_algorithm(
   config.tear_down_data(&f);
 }
 
+/* Messages are handed over already decompressed: whether and how they were
+ * compressed on the wire is only known to the receiving call */
+static grpc_compression_algorithm received_compression(grpc_call *call) {
+  if ((grpc_call_test_only_get_message_flags(call) &
+       GRPC_WRITE_INTERNAL_COMPRESS) == 0) {
+    return GRPC_COMPRESS_NONE;
+  }
+  return grpc_call_test_only_get_compression_algorithm(call);
+}
+
 static void request_with_payload_template(
     grpc_end2end_test_config config, const char *test_name,
     uint32_t client_send_flags_bitmask,
@@ -274,7 +284,9 @@ static void request_with_payload_template(
     grpc_compression_algorithm expected_algorithm_from_client,
     grpc_compression_algorithm expected_algorithm_from_server,
     grpc_metadata *client_init_metadata, bool set_server_level,
-    grpc_compression_level server_compression_level) {
+    grpc_compression_level server_compression_level, bool offload_compression,
+    grpc_compression_dictionary *client_dictionary,
+    grpc_compression_dictionary *server_dictionary) {
   grpc_call *c;
   grpc_call *s;
   gpr_slice request_payload_slice;
@@ -314,6 +326,35 @@ static void request_with_payload_template(
       NULL, default_client_channel_compression_algorithm);
   server_args = grpc_channel_args_set_compression_algorithm(
       NULL, default_server_channel_compression_algorithm);
+  /* both ends then compress what they send, and decompress what they receive,
+     on the executor */
+  if (offload_compression) {
+    grpc_arg offload_arg;
+    grpc_channel_args *tmp;
+    offload_arg.type = GRPC_ARG_INTEGER;
+    offload_arg.key = GRPC_ARG_COMPRESSION_OFFLOAD_THRESHOLD;
+    offload_arg.value.integer = 0;
+    tmp = client_args;
+    client_args = grpc_channel_args_copy_and_add(tmp, &offload_arg, 1);
+    grpc_channel_args_destroy(tmp);
+    tmp = server_args;
+    server_args = grpc_channel_args_copy_and_add(tmp, &offload_arg, 1);
+    grpc_channel_args_destroy(tmp);
+  }
+  if (client_dictionary != NULL) {
+    grpc_arg dictionary_arg =
+        grpc_compression_dictionary_to_arg(client_dictionary);
+    grpc_channel_args *tmp = client_args;
+    client_args = grpc_channel_args_copy_and_add(tmp, &dictionary_arg, 1);
+    grpc_channel_args_destroy(tmp);
+  }
+  if (server_dictionary != NULL) {
+    grpc_arg dictionary_arg =
+        grpc_compression_dictionary_to_arg(server_dictionary);
+    grpc_channel_args *tmp = server_args;
+    server_args = grpc_channel_args_copy_and_add(tmp, &dictionary_arg, 1);
+    grpc_channel_args_destroy(tmp);
+  }
 
   f = begin_test(config, test_name, client_args, server_args);
   cqv = cq_verifier_create(f.cq);
@@ -362,8 +403,11 @@ static void request_with_payload_template(
   CQ_EXPECT_COMPLETION(cqv, tag(100), true);
   cq_verify(cqv);
 
+  /* dict/deflate is only accepted along with the server's own dictionary */
   GPR_ASSERT(GPR_BITCOUNT(grpc_call_test_only_get_encodings_accepted_by_peer(
-                 s)) == GRPC_COMPRESS_ALGORITHMS_COUNT);
+                 s)) == (client_dictionary != NULL && server_dictionary != NULL
+                             ? GRPC_COMPRESS_ALGORITHMS_COUNT
+                             : GRPC_COMPRESS_ALGORITHMS_COUNT - 1));
   GPR_ASSERT(GPR_BITGET(grpc_call_test_only_get_encodings_accepted_by_peer(s),
                         GRPC_COMPRESS_NONE) != 0);
   GPR_ASSERT(GPR_BITGET(grpc_call_test_only_get_encodings_accepted_by_peer(s),
@@ -425,7 +469,8 @@ static void request_with_payload_template(
     GPR_ASSERT(request_payload_recv->type == GRPC_BB_RAW);
     GPR_ASSERT(byte_buffer_eq_string(request_payload_recv, request_str));
     GPR_ASSERT(request_payload_recv->data.raw.compression ==
-               expected_algorithm_from_client);
+               GRPC_COMPRESS_NONE);
+    GPR_ASSERT(received_compression(s) == expected_algorithm_from_client);
 
     memset(ops, 0, sizeof(ops));
     op = ops;
@@ -442,14 +487,14 @@ static void request_with_payload_template(
 
     GPR_ASSERT(response_payload_recv->type == GRPC_BB_RAW);
     GPR_ASSERT(byte_buffer_eq_string(response_payload_recv, response_str));
+    GPR_ASSERT(response_payload_recv->data.raw.compression ==
+               GRPC_COMPRESS_NONE);
     if (server_compression_level > GRPC_COMPRESS_LEVEL_NONE) {
       const grpc_compression_algorithm algo_for_server_level =
           grpc_call_compression_for_level(s, server_compression_level);
-      GPR_ASSERT(response_payload_recv->data.raw.compression ==
-                 algo_for_server_level);
+      GPR_ASSERT(received_compression(c) == algo_for_server_level);
     } else {
-      GPR_ASSERT(response_payload_recv->data.raw.compression ==
-                 expected_algorithm_from_server);
+      GPR_ASSERT(received_compression(c) == expected_algorithm_from_server);
     }
 
     grpc_byte_buffer_destroy(request_payload);
@@ -518,7 +563,7 @@ static void test_invoke_request_with_exceptionally_uncompressed_payload(
       config, "test_invoke_request_with_exceptionally_uncompressed_payload",
       GRPC_WRITE_NO_COMPRESS, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_GZIP,
       GRPC_COMPRESS_NONE, GRPC_COMPRESS_GZIP, NULL, false,
-      /* ignored */ GRPC_COMPRESS_LEVEL_NONE);
+      /* ignored */ GRPC_COMPRESS_LEVEL_NONE, false, NULL, NULL);
 }
 
 static void test_invoke_request_with_uncompressed_payload(
@@ -526,7 +571,8 @@ static void test_invoke_request_with_uncompressed_payload(
   request_with_payload_template(
       config, "test_invoke_request_with_uncompressed_payload", 0,
       GRPC_COMPRESS_NONE, GRPC_COMPRESS_NONE, GRPC_COMPRESS_NONE,
-      GRPC_COMPRESS_NONE, NULL, false, /* ignored */ GRPC_COMPRESS_LEVEL_NONE);
+      GRPC_COMPRESS_NONE, NULL, false, /* ignored */ GRPC_COMPRESS_LEVEL_NONE,
+      false, NULL, NULL);
 }
 
 static void test_invoke_request_with_compressed_payload(
@@ -534,7 +580,76 @@ static void test_invoke_request_with_compressed_payload(
   request_with_payload_template(
       config, "test_invoke_request_with_compressed_payload", 0,
       GRPC_COMPRESS_GZIP, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_GZIP,
-      GRPC_COMPRESS_GZIP, NULL, false, /* ignored */ GRPC_COMPRESS_LEVEL_NONE);
+      GRPC_COMPRESS_GZIP, NULL, false, /* ignored */ GRPC_COMPRESS_LEVEL_NONE,
+      false, NULL, NULL);
+}
+
+static void test_invoke_request_with_zstd_compressed_payload(
+    grpc_end2end_test_config config) {
+  request_with_payload_template(
+      config, "test_invoke_request_with_zstd_compressed_payload", 0,
+      GRPC_COMPRESS_ZSTD, GRPC_COMPRESS_ZSTD, GRPC_COMPRESS_ZSTD,
+      GRPC_COMPRESS_ZSTD, NULL, false, /* ignored */ GRPC_COMPRESS_LEVEL_NONE,
+      false, NULL, NULL);
+}
+
+static void test_invoke_request_with_offloaded_compressed_payload(
+    grpc_end2end_test_config config) {
+  request_with_payload_template(
+      config, "test_invoke_request_with_offloaded_compressed_payload", 0,
+      GRPC_COMPRESS_GZIP, GRPC_COMPRESS_GZIP, GRPC_COMPRESS_GZIP,
+      GRPC_COMPRESS_GZIP, NULL, false, /* ignored */ GRPC_COMPRESS_LEVEL_NONE,
+      true, NULL, NULL);
+}
+
+static void test_invoke_request_with_offloaded_stream_compressed_payload(
+    grpc_end2end_test_config config) {
+  request_with_payload_template(
+      config, "test_invoke_request_with_offloaded_stream_compressed_payload", 0,
+      GRPC_COMPRESS_STREAM_DEFLATE, GRPC_COMPRESS_STREAM_DEFLATE,
+      GRPC_COMPRESS_STREAM_DEFLATE, GRPC_COMPRESS_STREAM_DEFLATE, NULL, false,
+      /* ignored */ GRPC_COMPRESS_LEVEL_NONE, true, NULL, NULL);
+}
+
+static void test_invoke_request_with_stream_compressed_payload(
+    grpc_end2end_test_config config) {
+  request_with_payload_template(
+      config, "test_invoke_request_with_stream_compressed_payload", 0,
+      GRPC_COMPRESS_STREAM_DEFLATE, GRPC_COMPRESS_STREAM_DEFLATE,
+      GRPC_COMPRESS_STREAM_DEFLATE, GRPC_COMPRESS_STREAM_DEFLATE, NULL, false,
+      /* ignored */ GRPC_COMPRESS_LEVEL_NONE, false, NULL, NULL);
+}
+
+static void test_invoke_request_with_dictionary_compressed_payload(
+    grpc_end2end_test_config config) {
+  grpc_compression_dictionary *dictionary =
+      grpc_compression_dictionary_create("yyyyyyyyyyyyyyyy", 16);
+  /* the client only learns that the server has the dictionary from its
+     response, so the first call's request falls back to deflate */
+  request_with_payload_template(
+      config, "test_invoke_request_with_dictionary_compressed_payload", 0,
+      GRPC_COMPRESS_DICT_DEFLATE, GRPC_COMPRESS_DICT_DEFLATE,
+      GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_DICT_DEFLATE, NULL, false,
+      /* ignored */ GRPC_COMPRESS_LEVEL_NONE, false, dictionary, dictionary);
+  grpc_compression_dictionary_unref(dictionary);
+}
+
+static void test_invoke_request_with_dictionary_unknown_to_peer(
+    grpc_end2end_test_config config) {
+  grpc_compression_dictionary *dictionary =
+      grpc_compression_dictionary_create("yyyyyyyyyyyyyyyy", 16);
+  /* neither side sends messages the other couldn't decompress */
+  request_with_payload_template(
+      config, "test_invoke_request_with_dictionary_unknown_to_client", 0,
+      GRPC_COMPRESS_DICT_DEFLATE, GRPC_COMPRESS_DICT_DEFLATE,
+      GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_DEFLATE, NULL, false,
+      /* ignored */ GRPC_COMPRESS_LEVEL_NONE, false, NULL, dictionary);
+  request_with_payload_template(
+      config, "test_invoke_request_with_dictionary_unknown_to_server", 0,
+      GRPC_COMPRESS_DICT_DEFLATE, GRPC_COMPRESS_DICT_DEFLATE,
+      GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_DEFLATE, NULL, false,
+      /* ignored */ GRPC_COMPRESS_LEVEL_NONE, false, dictionary, NULL);
+  grpc_compression_dictionary_unref(dictionary);
 }
 
 static void test_invoke_request_with_server_level(
@@ -542,7 +657,7 @@ static void test_invoke_request_with_server_level(
   request_with_payload_template(
       config, "test_invoke_request_with_server_level", 0, GRPC_COMPRESS_NONE,
       GRPC_COMPRESS_NONE, GRPC_COMPRESS_NONE, GRPC_COMPRESS_NONE /* ignored */,
-      NULL, true, GRPC_COMPRESS_LEVEL_HIGH);
+      NULL, true, GRPC_COMPRESS_LEVEL_HIGH, false, NULL, NULL);
 }
 
 static void test_invoke_request_with_compressed_payload_md_override(
@@ -569,21 +684,21 @@ static void test_invoke_request_with_compressed_payload_md_override(
       config, "test_invoke_request_with_compressed_payload_md_override_1", 0,
       GRPC_COMPRESS_NONE, GRPC_COMPRESS_NONE, GRPC_COMPRESS_GZIP,
       GRPC_COMPRESS_NONE, &gzip_compression_override, false,
-      /*ignored*/ GRPC_COMPRESS_LEVEL_NONE);
+      /*ignored*/ GRPC_COMPRESS_LEVEL_NONE, false, NULL, NULL);
 
   /* Channel default DEFLATE, call override to GZIP */
   request_with_payload_template(
       config, "test_invoke_request_with_compressed_payload_md_override_2", 0,
       GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_NONE, GRPC_COMPRESS_GZIP,
       GRPC_COMPRESS_NONE, &gzip_compression_override, false,
-      /*ignored*/ GRPC_COMPRESS_LEVEL_NONE);
+      /*ignored*/ GRPC_COMPRESS_LEVEL_NONE, false, NULL, NULL);
 
   /* Channel default DEFLATE, call override to NONE (aka IDENTITY) */
   request_with_payload_template(
       config, "test_invoke_request_with_compressed_payload_md_override_3", 0,
       GRPC_COMPRESS_DEFLATE, GRPC_COMPRESS_NONE, GRPC_COMPRESS_NONE,
       GRPC_COMPRESS_NONE, &identity_compression_override, false,
-      /*ignored*/ GRPC_COMPRESS_LEVEL_NONE);
+      /*ignored*/ GRPC_COMPRESS_LEVEL_NONE, false, NULL, NULL);
 }
 
 static void test_invoke_request_with_disabled_algorithm(
@@ -597,6 +712,12 @@ void compressed_payload(grpc_end2end_test_config config) {
   test_invoke_request_with_exceptionally_uncompressed_payload(config);
   test_invoke_request_with_uncompressed_payload(config);
   test_invoke_request_with_compressed_payload(config);
+  test_invoke_request_with_zstd_compressed_payload(config);
+  test_invoke_request_with_offloaded_compressed_payload(config);
+  test_invoke_request_with_stream_compressed_payload(config);
+  test_invoke_request_with_offloaded_stream_compressed_payload(config);
+  test_invoke_request_with_dictionary_compressed_payload(config);
+  test_invoke_request_with_dictionary_unknown_to_peer(config);
   test_invoke_request_with_server_level(config);
   test_invoke_request_with_compressed_payload_md_override(config);
   test_invoke_request_with_disabled_algorithm(config);
@@ -0,0 +1,354 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "test/core/end2end/end2end_tests.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+#include "test/core/end2end/cq_verifier.h"
+
+#define MAX_CONNECTION_AGE_MS 500
+#define MAX_CONNECTION_AGE_GRACE_MS 1000
+/* longer than cq_verify_empty waits */
+#define DRAIN_TIMEOUT_MS 3000
+
+static void *tag(intptr_t t) { return (void *)t; }
+
+static grpc_end2end_test_fixture begin_test(grpc_end2end_test_config config,
+                                            const char *test_name,
+                                            grpc_channel_args *client_args,
+                                            grpc_channel_args *server_args) {
+  grpc_end2end_test_fixture f;
+  gpr_log(GPR_INFO, "%s/%s", test_name, config.name);
+  f = config.create_fixture(client_args, server_args);
+  config.init_server(&f, server_args);
+  config.init_client(&f, client_args, NULL);
+  return f;
+}
+
+static gpr_timespec n_seconds_time(int n) {
+  return GRPC_TIMEOUT_SECONDS_TO_DEADLINE(n);
+}
+
+static gpr_timespec five_seconds_time(void) { return n_seconds_time(5); }
+
+static void drain_cq(grpc_completion_queue *cq) {
+  grpc_event ev;
+  do {
+    ev = grpc_completion_queue_next(cq, five_seconds_time(), NULL);
+  } while (ev.type != GRPC_QUEUE_SHUTDOWN);
+}
+
+static void shutdown_server(grpc_end2end_test_fixture *f) {
+  if (!f->server) return;
+  grpc_server_shutdown_and_notify(f->server, f->cq, tag(1000));
+  GPR_ASSERT(grpc_completion_queue_pluck(
+                 f->cq, tag(1000), GRPC_TIMEOUT_SECONDS_TO_DEADLINE(5), NULL)
+                 .type == GRPC_OP_COMPLETE);
+  grpc_server_destroy(f->server);
+  f->server = NULL;
+}
+
+static void shutdown_client(grpc_end2end_test_fixture *f) {
+  if (!f->client) return;
+  grpc_channel_destroy(f->client);
+  f->client = NULL;
+}
+
+static void end_test(grpc_end2end_test_fixture *f) {
+  shutdown_server(f);
+  shutdown_client(f);
+
+  grpc_completion_queue_shutdown(f->cq);
+  drain_cq(f->cq);
+  grpc_completion_queue_destroy(f->cq);
+}
+
+typedef struct {
+  grpc_call *c;
+  grpc_call *s;
+  grpc_metadata_array initial_metadata_recv;
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_metadata_array request_metadata_recv;
+  grpc_call_details call_details;
+  grpc_status_code status;
+  char *details;
+  size_t details_capacity;
+  int was_cancelled;
+} call_state;
+
+/* starts a call, completing as tag(1), and has the server accept it */
+static void start_call(grpc_end2end_test_fixture *f, cq_verifier *cqv,
+                       call_state *cs) {
+  grpc_op ops[6];
+  grpc_op *op;
+  grpc_call_error error;
+
+  memset(cs, 0, sizeof(*cs));
+  cs->was_cancelled = 2;
+  cs->c = grpc_channel_create_call(f->client, NULL, GRPC_PROPAGATE_DEFAULTS,
+                                   f->cq, "/foo", "foo.test.google.fr",
+                                   n_seconds_time(10), NULL);
+  GPR_ASSERT(cs->c);
+
+  grpc_metadata_array_init(&cs->initial_metadata_recv);
+  grpc_metadata_array_init(&cs->trailing_metadata_recv);
+  grpc_metadata_array_init(&cs->request_metadata_recv);
+  grpc_call_details_init(&cs->call_details);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op->flags = 0;
+  op->reserved = NULL;
+  op++;
+  op->op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  op->flags = 0;
+  op->reserved = NULL;
+  op++;
+  op->op = GRPC_OP_RECV_INITIAL_METADATA;
+  op->data.recv_initial_metadata = &cs->initial_metadata_recv;
+  op->flags = 0;
+  op->reserved = NULL;
+  op++;
+  op->op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  op->data.recv_status_on_client.trailing_metadata =
+      &cs->trailing_metadata_recv;
+  op->data.recv_status_on_client.status = &cs->status;
+  op->data.recv_status_on_client.status_details = &cs->details;
+  op->data.recv_status_on_client.status_details_capacity =
+      &cs->details_capacity;
+  op->flags = 0;
+  op->reserved = NULL;
+  op++;
+  error = grpc_call_start_batch(cs->c, ops, (size_t)(op - ops), tag(1), NULL);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  error = grpc_server_request_call(f->server, &cs->s, &cs->call_details,
+                                   &cs->request_metadata_recv, f->cq, f->cq,
+                                   tag(101));
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  CQ_EXPECT_COMPLETION(cqv, tag(101), 1);
+  cq_verify(cqv);
+}
+
+/* waits for the server side of the call to be closed, completing as
+   tag(102) */
+static void recv_close_on_server(call_state *cs) {
+  grpc_op ops[1];
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  ops[0].data.recv_close_on_server.cancelled = &cs->was_cancelled;
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_call_start_batch(cs->s, ops, 1, tag(102), NULL));
+}
+
+/* finishes the call from the server, completing as tag(103) */
+static void send_status_from_server(call_state *cs) {
+  grpc_op ops[2];
+  grpc_op *op;
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  op->data.send_status_from_server.trailing_metadata_count = 0;
+  op->data.send_status_from_server.status = GRPC_STATUS_UNIMPLEMENTED;
+  op->data.send_status_from_server.status_details = "xyz";
+  op++;
+  GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(cs->s, ops,
+                                                   (size_t)(op - ops),
+                                                   tag(103), NULL));
+}
+
+static void destroy_call(call_state *cs) {
+  GPR_ASSERT(0 == strcmp(cs->call_details.method, "/foo"));
+  GPR_ASSERT(0 == strcmp(cs->call_details.host, "foo.test.google.fr"));
+  gpr_free(cs->details);
+  grpc_metadata_array_destroy(&cs->initial_metadata_recv);
+  grpc_metadata_array_destroy(&cs->trailing_metadata_recv);
+  grpc_metadata_array_destroy(&cs->request_metadata_recv);
+  grpc_call_details_destroy(&cs->call_details);
+  grpc_call_destroy(cs->s);
+  grpc_call_destroy(cs->c);
+}
+
+static void test_max_age_gracefully_close(grpc_end2end_test_config config) {
+  grpc_arg server_a[] = {
+      {GRPC_ARG_INTEGER, GRPC_ARG_MAX_CONNECTION_AGE_MS,
+       {.integer = MAX_CONNECTION_AGE_MS}}};
+  grpc_channel_args server_args = {GPR_ARRAY_SIZE(server_a), server_a};
+  grpc_end2end_test_fixture f =
+      begin_test(config, "test_max_age_gracefully_close", NULL, &server_args);
+  cq_verifier *cqv = cq_verifier_create(f.cq);
+  call_state cs;
+
+  start_call(&f, cqv, &cs);
+  recv_close_on_server(&cs);
+
+  /* the connection outlives its maximum age while the call is in progress:
+     the call still completes */
+  gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(
+      MAX_CONNECTION_AGE_MS + MAX_CONNECTION_AGE_GRACE_MS));
+  cq_verify_empty(cqv);
+  send_status_from_server(&cs);
+
+  CQ_EXPECT_COMPLETION(cqv, tag(1), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(102), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(103), 1);
+  cq_verify(cqv);
+
+  GPR_ASSERT(cs.status == GRPC_STATUS_UNIMPLEMENTED);
+  GPR_ASSERT(0 == strcmp(cs.details, "xyz"));
+  GPR_ASSERT(cs.was_cancelled == 1);
+  destroy_call(&cs);
+
+  cq_verifier_destroy(cqv);
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+static void test_max_age_forcibly_close(grpc_end2end_test_config config) {
+  grpc_arg server_a[] = {
+      {GRPC_ARG_INTEGER, GRPC_ARG_MAX_CONNECTION_AGE_MS,
+       {.integer = MAX_CONNECTION_AGE_MS}},
+      {GRPC_ARG_INTEGER, GRPC_ARG_MAX_CONNECTION_AGE_GRACE_MS,
+       {.integer = MAX_CONNECTION_AGE_GRACE_MS}}};
+  grpc_channel_args server_args = {GPR_ARRAY_SIZE(server_a), server_a};
+  grpc_end2end_test_fixture f =
+      begin_test(config, "test_max_age_forcibly_close", NULL, &server_args);
+  cq_verifier *cqv = cq_verifier_create(f.cq);
+  call_state cs;
+
+  start_call(&f, cqv, &cs);
+  recv_close_on_server(&cs);
+
+  /* the call outlasts the grace period: the connection is closed under it */
+  CQ_EXPECT_COMPLETION(cqv, tag(1), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(102), 1);
+  cq_verify(cqv);
+
+  GPR_ASSERT(cs.status != GRPC_STATUS_OK);
+  GPR_ASSERT(cs.was_cancelled == 1);
+  destroy_call(&cs);
+
+  cq_verifier_destroy(cqv);
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+static void test_max_idle(grpc_end2end_test_config config) {
+  grpc_arg server_a[] = {
+      {GRPC_ARG_INTEGER, GRPC_ARG_MAX_CONNECTION_IDLE_MS,
+       {.integer = MAX_CONNECTION_AGE_MS}}};
+  grpc_channel_args server_args = {GPR_ARRAY_SIZE(server_a), server_a};
+  grpc_end2end_test_fixture f =
+      begin_test(config, "test_max_idle", NULL, &server_args);
+  cq_verifier *cqv = cq_verifier_create(f.cq);
+  call_state cs;
+
+  /* a connection with a call in progress is not idle */
+  start_call(&f, cqv, &cs);
+  recv_close_on_server(&cs);
+  gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(2 * MAX_CONNECTION_AGE_MS));
+  send_status_from_server(&cs);
+  CQ_EXPECT_COMPLETION(cqv, tag(1), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(102), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(103), 1);
+  cq_verify(cqv);
+  GPR_ASSERT(cs.status == GRPC_STATUS_UNIMPLEMENTED);
+  GPR_ASSERT(0 == strcmp(cs.details, "xyz"));
+  GPR_ASSERT(cs.was_cancelled == 1);
+  destroy_call(&cs);
+
+  /* once idle, the server sends a goaway: the client notices */
+  grpc_connectivity_state state =
+      grpc_channel_check_connectivity_state(f.client, 0);
+  while (state == GRPC_CHANNEL_READY) {
+    grpc_channel_watch_connectivity_state(f.client, state, n_seconds_time(5),
+                                          f.cq, tag(99));
+    CQ_EXPECT_COMPLETION(cqv, tag(99), 1);
+    cq_verify(cqv);
+    state = grpc_channel_check_connectivity_state(f.client, 0);
+  }
+
+  cq_verifier_destroy(cqv);
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+static void test_drain_deadline(grpc_end2end_test_config config) {
+  grpc_end2end_test_fixture f =
+      begin_test(config, "test_drain_deadline", NULL, NULL);
+  cq_verifier *cqv = cq_verifier_create(f.cq);
+  call_state cs;
+
+  start_call(&f, cqv, &cs);
+  recv_close_on_server(&cs);
+
+  /* the call is not finished by the deadline: it is cancelled */
+  grpc_server_drain_and_notify(
+      f.server, GRPC_TIMEOUT_MILLIS_TO_DEADLINE(DRAIN_TIMEOUT_MS),
+      f.cq, tag(0xdead));
+  cq_verify_empty(cqv);
+  CQ_EXPECT_COMPLETION(cqv, tag(1), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(102), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(0xdead), 1);
+  cq_verify(cqv);
+
+  GPR_ASSERT(cs.status != GRPC_STATUS_OK);
+  GPR_ASSERT(cs.was_cancelled == 1);
+  destroy_call(&cs);
+
+  grpc_server_destroy(f.server);
+  f.server = NULL;
+  cq_verifier_destroy(cqv);
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+void max_connection_age(grpc_end2end_test_config config) {
+  test_max_age_gracefully_close(config);
+  test_max_age_forcibly_close(config);
+  test_max_idle(config);
+  test_drain_deadline(config);
+}
+
+void max_connection_age_pre_init(void) {}
@@ -52,9 +52,8 @@ static void test_format_get_request(void) {
   slice = grpc_httpcli_format_get_request(&req);
 
   GPR_ASSERT(0 == gpr_slice_str_cmp(slice,
-                                    "GET /index.html HTTP/1.0\r\n"
+                                    "GET /index.html HTTP/1.1\r\n"
                                     "Host: example.com\r\n"
-                                    "Connection: close\r\n"
                                     "User-Agent: " GRPC_HTTPCLI_USER_AGENT
                                     "\r\n"
                                     "x-yz: abc\r\n"
@@ -79,9 +78,8 @@ static void test_format_post_request(void) {
   slice = grpc_httpcli_format_post_request(&req, body_bytes, body_len);
 
   GPR_ASSERT(0 == gpr_slice_str_cmp(slice,
-                                    "POST /index.html HTTP/1.0\r\n"
+                                    "POST /index.html HTTP/1.1\r\n"
                                     "Host: example.com\r\n"
-                                    "Connection: close\r\n"
                                     "User-Agent: " GRPC_HTTPCLI_USER_AGENT
                                     "\r\n"
                                     "x-yz: abc\r\n"
@@ -107,9 +105,8 @@ static void test_format_post_request_no_body(void) {
   slice = grpc_httpcli_format_post_request(&req, NULL, 0);
 
   GPR_ASSERT(0 == gpr_slice_str_cmp(slice,
-                                    "POST /index.html HTTP/1.0\r\n"
+                                    "POST /index.html HTTP/1.1\r\n"
                                     "Host: example.com\r\n"
-                                    "Connection: close\r\n"
                                     "User-Agent: " GRPC_HTTPCLI_USER_AGENT
                                     "\r\n"
                                     "x-yz: abc\r\n"
@@ -139,9 +136,8 @@ static void test_format_post_request_content_type_override(void) {
 
   GPR_ASSERT(0 == gpr_slice_str_cmp(
                       slice,
-                      "POST /index.html HTTP/1.0\r\n"
+                      "POST /index.html HTTP/1.1\r\n"
                       "Host: example.com\r\n"
-                      "Connection: close\r\n"
                       "User-Agent: " GRPC_HTTPCLI_USER_AGENT "\r\n"
                       "x-yz: abc\r\n"
                       "Content-Type: application/x-www-form-urlencoded\r\n"
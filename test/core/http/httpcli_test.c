@@ -33,6 +33,7 @@
 
 #include "src/core/lib/http/httpcli.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <grpc/grpc.h>
@@ -146,6 +147,118 @@ static void test_post(int port) {
   grpc_http_response_destroy(&response);
 }
 
+/* GETs \a path, returning the port the server saw the request come from */
+static int get_client_port(int port, const char *path) {
+  grpc_httpcli_request req;
+  char *host;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  int client_port = 0;
+
+  g_done = 0;
+  gpr_asprintf(&host, "localhost:%d", port);
+
+  memset(&req, 0, sizeof(req));
+  req.host = host;
+  req.http.path = (char *)path;
+  req.handshaker = &grpc_httpcli_plaintext;
+
+  grpc_http_response response;
+  memset(&response, 0, sizeof(response));
+  grpc_httpcli_get(&exec_ctx, &g_context, &g_pops, &req, n_seconds_time(15),
+                   grpc_closure_create(on_finish, &response), &response);
+  gpr_mu_lock(g_mu);
+  while (!g_done) {
+    grpc_pollset_worker *worker = NULL;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(&exec_ctx, grpc_polling_entity_pollset(&g_pops),
+                          &worker, gpr_now(GPR_CLOCK_MONOTONIC),
+                          n_seconds_time(20))));
+    gpr_mu_unlock(g_mu);
+    grpc_exec_ctx_finish(&exec_ctx);
+    gpr_mu_lock(g_mu);
+  }
+  gpr_mu_unlock(g_mu);
+  for (size_t i = 0; i < response.hdr_count; i++) {
+    if (0 == strcmp(response.hdrs[i].key, "X-Client-Port")) {
+      client_port = atoi(response.hdrs[i].value);
+    }
+  }
+  GPR_ASSERT(client_port != 0);
+  gpr_free(host);
+  grpc_http_response_destroy(&response);
+  return client_port;
+}
+
+static void test_connection_reuse(int port) {
+  gpr_log(GPR_INFO, "test_connection_reuse");
+  int first = get_client_port(port, "/get");
+  /* the connection of the first request is kept for the second one */
+  GPR_ASSERT(get_client_port(port, "/get") == first);
+}
+
+static void test_retry_after_server_close(int port) {
+  gpr_log(GPR_INFO, "test_retry_after_server_close");
+  /* the server closes this connection once it has responded, but the
+     response keeps it alive: the next request fails on it, and is retried
+     on a new connection */
+  int closed = get_client_port(port, "/get_and_close");
+  GPR_ASSERT(get_client_port(port, "/get") != closed);
+}
+
+static void on_post_failed(grpc_exec_ctx *exec_ctx, void *arg,
+                           grpc_error *error) {
+  GPR_ASSERT(error != GRPC_ERROR_NONE);
+  gpr_mu_lock(g_mu);
+  g_done = 1;
+  GPR_ASSERT(GRPC_LOG_IF_ERROR(
+      "pollset_kick",
+      grpc_pollset_kick(grpc_polling_entity_pollset(&g_pops), NULL)));
+  gpr_mu_unlock(g_mu);
+}
+
+static void test_post_not_retried_after_server_close(int port) {
+  grpc_httpcli_request req;
+  char *host;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  gpr_log(GPR_INFO, "test_post_not_retried_after_server_close");
+  int closed = get_client_port(port, "/get_and_close");
+
+  /* the server may have acted on a POST before the connection failed, so
+     the failure is reported rather than the POST being sent again */
+  g_done = 0;
+  gpr_asprintf(&host, "localhost:%d", port);
+  memset(&req, 0, sizeof(req));
+  req.host = host;
+  req.http.path = "/post";
+  req.handshaker = &grpc_httpcli_plaintext;
+
+  grpc_http_response response;
+  memset(&response, 0, sizeof(response));
+  grpc_httpcli_post(&exec_ctx, &g_context, &g_pops, &req, "hello", 5,
+                    n_seconds_time(15),
+                    grpc_closure_create(on_post_failed, &response), &response);
+  gpr_mu_lock(g_mu);
+  while (!g_done) {
+    grpc_pollset_worker *worker = NULL;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(&exec_ctx, grpc_polling_entity_pollset(&g_pops),
+                          &worker, gpr_now(GPR_CLOCK_MONOTONIC),
+                          n_seconds_time(20))));
+    gpr_mu_unlock(g_mu);
+    grpc_exec_ctx_finish(&exec_ctx);
+    gpr_mu_lock(g_mu);
+  }
+  gpr_mu_unlock(g_mu);
+  gpr_free(host);
+  grpc_http_response_destroy(&response);
+
+  /* the failed connection is not kept */
+  GPR_ASSERT(get_client_port(port, "/get") != closed);
+}
+
 static void destroy_pops(grpc_exec_ctx *exec_ctx, void *p, grpc_error *error) {
   grpc_pollset_destroy(grpc_polling_entity_pollset(p));
 }
@@ -200,6 +313,9 @@ int main(int argc, char **argv) {
 
   test_get(port);
   test_post(port);
+  test_connection_reuse(port);
+  test_retry_after_server_close(port);
+  test_post_not_retried_after_server_close(port);
 
   grpc_httpcli_context_destroy(&g_context);
   grpc_closure_init(&destroyed, destroy_pops, &g_pops);
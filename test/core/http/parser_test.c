@@ -156,6 +156,39 @@ static void test_succeeds(grpc_slice_split_mode split_mode, char *response_text,
   gpr_free(slices);
 }
 
+static void test_framing(grpc_slice_split_mode split_mode, char *response_text,
+                         char *expect_body, bool expect_complete,
+                         bool expect_reusable) {
+  grpc_http_parser parser;
+  gpr_slice input_slice = gpr_slice_from_copied_string(response_text);
+  size_t num_slices;
+  size_t i;
+  gpr_slice *slices;
+  grpc_http_response response;
+  memset(&response, 0, sizeof(response));
+
+  grpc_split_slices(split_mode, &input_slice, 1, &slices, &num_slices);
+  gpr_slice_unref(input_slice);
+
+  grpc_http_parser_init(&parser, GRPC_HTTP_RESPONSE, &response);
+
+  for (i = 0; i < num_slices; i++) {
+    GPR_ASSERT(grpc_http_parser_parse(&parser, slices[i], NULL) ==
+               GRPC_ERROR_NONE);
+    gpr_slice_unref(slices[i]);
+  }
+  GPR_ASSERT(grpc_http_parser_is_complete(&parser) == expect_complete);
+  GPR_ASSERT(grpc_http_parser_can_reuse_connection(&parser) ==
+             expect_reusable);
+  GPR_ASSERT(strlen(expect_body) == response.body_length);
+  GPR_ASSERT(response.body_length == 0 ||
+             0 == memcmp(expect_body, response.body, response.body_length));
+
+  grpc_http_response_destroy(&response);
+  grpc_http_parser_destroy(&parser);
+  gpr_free(slices);
+}
+
 static void test_fails(grpc_slice_split_mode split_mode, char *response_text) {
   grpc_http_parser parser;
   gpr_slice input_slice = gpr_slice_from_copied_string(response_text);
@@ -294,6 +327,90 @@ int main(int argc, char **argv) {
                "  def\r\n"
                "\r\n"
                "hello world!");
+    test_framing(split_modes[i],
+                 "HTTP/1.1 200 OK\r\n"
+                 "Content-Length: 5\r\n"
+                 "\r\n"
+                 "hello",
+                 "hello", true, true);
+    test_framing(split_modes[i],
+                 "HTTP/1.1 200 OK\r\n"
+                 "Content-Length: 5\r\n"
+                 "\r\n"
+                 "hel",
+                 "hel", false, false);
+    test_framing(split_modes[i],
+                 "HTTP/1.1 200 OK\r\n"
+                 "Transfer-Encoding: chunked\r\n"
+                 "\r\n"
+                 "5\r\n"
+                 "hello\r\n"
+                 "7;ext=1\r\n"
+                 ", world\r\n"
+                 "0\r\n"
+                 "Trailer: x\r\n"
+                 "\r\n",
+                 "hello, world", true, true);
+    test_framing(split_modes[i],
+                 "HTTP/1.1 200 OK\r\n"
+                 "Transfer-Encoding: chunked\r\n"
+                 "\r\n"
+                 "A\r\n"
+                 "0123456789\r\n",
+                 "0123456789", false, false);
+    test_framing(split_modes[i],
+                 "HTTP/1.1 200 OK\n"
+                 "transfer-encoding: gzip, Chunked\n"
+                 "\n"
+                 "3\n"
+                 "abc\n"
+                 "0\n"
+                 "\n",
+                 "abc", true, true);
+    test_framing(split_modes[i],
+                 "HTTP/1.1 200 OK\r\n"
+                 "Connection: close\r\n"
+                 "Content-Length: 0\r\n"
+                 "\r\n",
+                 "", true, false);
+    test_framing(split_modes[i],
+                 "HTTP/1.0 200 OK\r\n"
+                 "Content-Length: 2\r\n"
+                 "\r\n"
+                 "hi",
+                 "hi", true, false);
+    test_framing(split_modes[i],
+                 "HTTP/1.0 200 OK\r\n"
+                 "Connection: Keep-Alive\r\n"
+                 "Content-Length: 2\r\n"
+                 "\r\n"
+                 "hi",
+                 "hi", true, true);
+    test_framing(split_modes[i],
+                 "HTTP/1.1 200 OK\r\n"
+                 "\r\n"
+                 "abc",
+                 "abc", false, false);
+    test_fails(split_modes[i],
+               "HTTP/1.1 200 OK\r\n"
+               "Content-Length: 1x\r\n"
+               "\r\n");
+    test_fails(split_modes[i],
+               "HTTP/1.1 200 OK\r\n"
+               "Content-Length: 2\r\n"
+               "\r\n"
+               "abc");
+    test_fails(split_modes[i],
+               "HTTP/1.1 200 OK\r\n"
+               "Transfer-Encoding: chunked\r\n"
+               "\r\n"
+               "zz\r\n");
+    test_fails(split_modes[i],
+               "HTTP/1.1 200 OK\r\n"
+               "Transfer-Encoding: chunked\r\n"
+               "\r\n"
+               "3\r\n"
+               "abcd\r\n");
     test_request_fails(split_modes[i], "GET\r\n");
     test_request_fails(split_modes[i], "GET /\r\n");
     test_request_fails(split_modes[i], "GET / HTTP/0.0\r\n");
@@ -33,6 +33,7 @@
 import argparse
 import BaseHTTPServer
 import os
+import SocketServer
 import ssl
 import sys
 
@@ -49,23 +50,39 @@ args = argp.parse_args()
 print 'server running on port %d' % args.port
 
 class Handler(BaseHTTPServer.BaseHTTPRequestHandler):
+	# keeps connections open between requests, unless told otherwise
+	protocol_version = 'HTTP/1.1'
+
 	def good(self):
+		body = ('<html><head><title>Hello world!</title></head>'
+		        '<body><p>This is a test</p></body></html>')
 		self.send_response(200)
 		self.send_header('Content-Type', 'text/html')
+		self.send_header('Content-Length', str(len(body)))
+		# lets tests tell whether requests shared a connection
+		self.send_header('X-Client-Port', str(self.client_address[1]))
 		self.end_headers()
-		self.wfile.write('<html><head><title>Hello world!</title></head>')
-		self.wfile.write('<body><p>This is a test</p></body></html>')
+		self.wfile.write(body)
 
 	def do_GET(self):
 		if self.path == '/get':
 			self.good()
+		elif self.path == '/get_and_close':
+			# close the connection without announcing it, as a server timing
+			# out an idle connection would
+			self.good()
+			self.close_connection = 1
 
 	def do_POST(self):
 		content = self.rfile.read(int(self.headers.getheader('content-length')))
 		if self.path == '/post' and content == 'hello':
 			self.good()
 
-httpd = BaseHTTPServer.HTTPServer(('localhost', args.port), Handler)
+class Server(SocketServer.ThreadingMixIn, BaseHTTPServer.HTTPServer):
+	# a connection kept open would otherwise hold up every other one
+	daemon_threads = True
+
+httpd = Server(('localhost', args.port), Handler)
 if args.ssl:
 	httpd.socket = ssl.wrap_socket(httpd.socket, certfile=_PEM, keyfile=_KEY, server_side=True)
 httpd.serve_forever()
@@ -0,0 +1,185 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Closure throughput through combiners, as driven by an exec_ctx.
+
+   Each round schedules a burst of closures on the exec_ctx, standing in for
+   the read callbacks of a set of connections; each of those executes a batch
+   of closures on its connection's combiner, and each combiner closure may in
+   turn schedule a completion back on the exec_ctx. Reports the time per
+   combiner closure, and the visits and budget yields per thousand closures
+   from the combiners' statistics: a visit starts whenever a combiner is
+   picked up with work queued, so fewer visits means fewer hand-offs.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/iomgr/combiner.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/test_config.h"
+
+typedef struct connection connection;
+
+typedef struct {
+  connection *conn;
+  grpc_closure locked;
+  grpc_closure completion;
+} op;
+
+struct connection {
+  grpc_combiner *combiner;
+  grpc_closure read;
+  op *ops;
+  size_t batch;
+  bool complete;
+  size_t completions;
+};
+
+static double now_seconds(void) {
+  gpr_timespec t = gpr_now(GPR_CLOCK_MONOTONIC);
+  return (double)t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void on_completion(grpc_exec_ctx *exec_ctx, void *arg,
+                          grpc_error *error) {
+  op *o = arg;
+  o->conn->completions++;
+}
+
+static void on_locked(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
+  op *o = arg;
+  if (o->conn->complete) {
+    grpc_exec_ctx_sched(exec_ctx, &o->completion, GRPC_ERROR_NONE, NULL);
+  }
+}
+
+static void on_read(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
+  connection *c = arg;
+  size_t i;
+  for (i = 0; i < c->batch; i++) {
+    grpc_combiner_execute(exec_ctx, c->combiner, &c->ops[i].locked,
+                          GRPC_ERROR_NONE, false);
+  }
+}
+
+static void run(size_t num_connections, size_t batch, bool complete,
+                size_t total_closures) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  connection *conns = gpr_malloc(num_connections * sizeof(*conns));
+  size_t rounds = total_closures / (num_connections * batch);
+  size_t visits = 0, budget_yields = 0, closures = 0;
+  double start, elapsed;
+  size_t i, j;
+
+  for (i = 0; i < num_connections; i++) {
+    connection *c = &conns[i];
+    c->combiner = grpc_combiner_create(NULL);
+    grpc_closure_init(&c->read, on_read, c);
+    c->ops = gpr_malloc(batch * sizeof(*c->ops));
+    c->batch = batch;
+    c->complete = complete;
+    c->completions = 0;
+    for (j = 0; j < batch; j++) {
+      c->ops[j].conn = c;
+      grpc_closure_init(&c->ops[j].locked, on_locked, &c->ops[j]);
+      grpc_closure_init(&c->ops[j].completion, on_completion, &c->ops[j]);
+    }
+  }
+
+  start = now_seconds();
+  for (i = 0; i < rounds; i++) {
+    for (j = 0; j < num_connections; j++) {
+      grpc_exec_ctx_sched(&exec_ctx, &conns[j].read, GRPC_ERROR_NONE, NULL);
+    }
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  elapsed = now_seconds() - start;
+
+  for (i = 0; i < num_connections; i++) {
+    grpc_combiner_stats stats;
+    grpc_combiner_get_stats(conns[i].combiner, &stats);
+    visits += stats.visits;
+    budget_yields += stats.budget_yields;
+    closures += stats.closures_executed;
+    GPR_ASSERT(conns[i].completions == (complete ? rounds * batch : 0));
+    grpc_combiner_destroy(&exec_ctx, conns[i].combiner);
+    gpr_free(conns[i].ops);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(closures == rounds * num_connections * batch);
+
+  printf("%4d connections x %3d closures%s: %6.1f ns/closure, "
+         "%6.1f visits and %5.1f budget yields per 1000 closures\n",
+         (int)num_connections, (int)batch,
+         complete ? " with completions" : "                 ",
+         1e9 * elapsed / (double)closures,
+         1000.0 * (double)visits / (double)closures,
+         1000.0 * (double)budget_yields / (double)closures);
+  gpr_free(conns);
+}
+
+int main(int argc, char **argv) {
+  static const size_t connections[] = {1, 16, 256};
+  static const size_t batches[] = {1, 8, 128};
+  int total_closures = 4000000;
+  size_t i, j;
+  int complete;
+
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("combiner closure throughput benchmarking tool");
+  gpr_cmdline_add_int(cmdline, "closures", "Closures to run per scenario",
+                      &total_closures);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  gpr_cmdline_destroy(cmdline);
+
+  grpc_test_init(argc, argv);
+  grpc_init();
+  for (complete = 0; complete <= 1; complete++) {
+    for (i = 0; i < GPR_ARRAY_SIZE(connections); i++) {
+      for (j = 0; j < GPR_ARRAY_SIZE(batches); j++) {
+        run(connections[i], batches[j], complete, (size_t)total_closures);
+      }
+    }
+  }
+  grpc_shutdown();
+  return 0;
+}
@@ -152,12 +152,69 @@ static void test_execute_finally(void) {
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
+typedef struct {
+  grpc_combiner *busy;
+  size_t *busy_ctr;
+  size_t busy_ctr_when_run;
+} fairness_args;
+
+static void increment(grpc_exec_ctx *exec_ctx, void *ctr, grpc_error *error) {
+  ++*(size_t *)ctr;
+}
+
+static void note_busy_ctr(grpc_exec_ctx *exec_ctx, void *a,
+                          grpc_error *error) {
+  fairness_args *args = a;
+  args->busy_ctr_when_run = *args->busy_ctr;
+}
+
+static void test_budget_fairness(void) {
+  gpr_log(GPR_DEBUG, "test_budget_fairness");
+
+  grpc_combiner *busy = grpc_combiner_create(NULL);
+  grpc_combiner *other = grpc_combiner_create(NULL);
+  size_t busy_ctr = 0;
+  fairness_args args = {busy, &busy_ctr, 0};
+  grpc_closure increments[1000];
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(increments); i++) {
+    grpc_closure_init(&increments[i], increment, &busy_ctr);
+    grpc_combiner_execute(&exec_ctx, busy, &increments[i], GRPC_ERROR_NONE,
+                          false);
+  }
+  grpc_combiner_execute(&exec_ctx, other,
+                        grpc_closure_create(note_busy_ctr, &args),
+                        GRPC_ERROR_NONE, false);
+  grpc_exec_ctx_flush(&exec_ctx);
+  GPR_ASSERT(busy_ctr == GPR_ARRAY_SIZE(increments));
+  // the busy combiner must have yielded to the other before finishing
+  GPR_ASSERT(args.busy_ctr_when_run < busy_ctr);
+
+  grpc_combiner_stats stats;
+  grpc_combiner_get_stats(busy, &stats);
+  GPR_ASSERT(stats.queue_depth == 0);
+  GPR_ASSERT(stats.max_queue_depth == GPR_ARRAY_SIZE(increments));
+  GPR_ASSERT(stats.closures_executed == GPR_ARRAY_SIZE(increments));
+  GPR_ASSERT(stats.budget_yields > 0);
+  GPR_ASSERT(stats.visits == stats.budget_yields + 1);
+  GPR_ASSERT(stats.offloads == 0);
+  grpc_combiner_get_stats(other, &stats);
+  GPR_ASSERT(stats.visits == 1);
+  GPR_ASSERT(stats.closures_executed == 1);
+  GPR_ASSERT(stats.budget_yields == 0);
+
+  grpc_combiner_destroy(&exec_ctx, busy);
+  grpc_combiner_destroy(&exec_ctx, other);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   grpc_init();
   test_no_op();
   test_execute_one();
   test_execute_finally();
+  test_budget_fairness();
   test_execute_many();
   grpc_shutdown();
 
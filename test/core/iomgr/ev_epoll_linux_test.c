@@ -43,6 +43,9 @@
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
 
 #include "src/core/lib/iomgr/iomgr.h"
 #include "test/core/util/test_config.h"
@@ -222,6 +225,107 @@ static void test_add_fd_to_pollset() {
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
+#define NUM_WORKERS 4
+
+typedef struct worker_arg {
+  grpc_pollset *pollset;
+  gpr_mu *mu;
+  int timeout_ms;
+  gpr_atm *started;
+  gpr_atm *finished;
+} worker_arg;
+
+static void pollset_worker(void *arg) {
+  worker_arg *wa = arg;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_pollset_worker *worker = NULL;
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  gpr_timespec deadline = gpr_time_add(
+      now, gpr_time_from_millis(wa->timeout_ms, GPR_TIMESPAN));
+
+  gpr_mu_lock(wa->mu);
+  gpr_atm_full_fetch_add(wa->started, 1);
+  GPR_ASSERT(GRPC_LOG_IF_ERROR(
+      "pollset_work",
+      grpc_pollset_work(&exec_ctx, wa->pollset, &worker, now, deadline)));
+  gpr_mu_unlock(wa->mu);
+  grpc_exec_ctx_finish(&exec_ctx);
+  gpr_atm_full_fetch_add(wa->finished, 1);
+}
+
+static void start_workers(gpr_thd_id *thds, worker_arg *wa, int num_workers) {
+  gpr_thd_options opt = gpr_thd_options_default();
+  int i;
+  gpr_thd_options_set_joinable(&opt);
+  for (i = 0; i < num_workers; i++) {
+    GPR_ASSERT(gpr_thd_new(&thds[i], pollset_worker, wa, &opt));
+  }
+  while (gpr_atm_acq_load(wa->started) < num_workers) {
+    gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(1));
+  }
+  /* give the last worker time to get from gpr_atm_full_fetch_add() into
+     pollset_work() */
+  gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(100));
+}
+
+static void join_workers(gpr_thd_id *thds, int num_workers) {
+  int i;
+  for (i = 0; i < num_workers; i++) {
+    gpr_thd_join(thds[i]);
+  }
+}
+
+/* Only one worker of a pollset polls; the others are parked. Make sure
+   parked workers still get kicked, and still return at their deadline. */
+static void test_parked_workers() {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  test_pollset pollset;
+  gpr_thd_id thds[NUM_WORKERS];
+  gpr_atm started = 0;
+  gpr_atm finished = 0;
+  worker_arg wa;
+  int i;
+
+  test_pollset_init(&pollset, 1);
+  wa.pollset = pollset.pollset;
+  wa.mu = pollset.mu;
+  wa.started = &started;
+  wa.finished = &finished;
+
+  /* An anonymous kick gets exactly one worker out of pollset_work(), a
+     broadcast all of them */
+  wa.timeout_ms = 20000;
+  start_workers(thds, &wa, NUM_WORKERS);
+  for (i = 1; i < NUM_WORKERS; i++) {
+    gpr_mu_lock(pollset.mu);
+    GPR_ASSERT(GRPC_LOG_IF_ERROR("pollset_kick",
+                                 grpc_pollset_kick(pollset.pollset, NULL)));
+    gpr_mu_unlock(pollset.mu);
+    while (gpr_atm_acq_load(&finished) < i) {
+      gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(1));
+    }
+    gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(100));
+    GPR_ASSERT(gpr_atm_acq_load(&finished) == i);
+  }
+  gpr_mu_lock(pollset.mu);
+  GPR_ASSERT(GRPC_LOG_IF_ERROR(
+      "pollset_kick",
+      grpc_pollset_kick(pollset.pollset, GRPC_POLLSET_KICK_BROADCAST)));
+  gpr_mu_unlock(pollset.mu);
+  join_workers(thds, NUM_WORKERS);
+  GPR_ASSERT(gpr_atm_acq_load(&finished) == NUM_WORKERS);
+
+  /* Nobody kicks: every worker returns at its deadline */
+  started = finished = 0;
+  wa.timeout_ms = 200;
+  start_workers(thds, &wa, NUM_WORKERS);
+  join_workers(thds, NUM_WORKERS);
+  GPR_ASSERT(gpr_atm_acq_load(&finished) == NUM_WORKERS);
+
+  test_pollset_cleanup(&exec_ctx, &pollset, 1);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
 int main(int argc, char **argv) {
   const char *poll_strategy = NULL;
   grpc_test_init(argc, argv);
@@ -230,6 +334,7 @@ int main(int argc, char **argv) {
   poll_strategy = grpc_get_poll_strategy_name();
   if (poll_strategy != NULL && strcmp(poll_strategy, "epoll") == 0) {
     test_add_fd_to_pollset();
+    test_parked_workers();
   } else {
     gpr_log(GPR_INFO,
             "Skipping the test. The test is only relevant for 'epoll' "
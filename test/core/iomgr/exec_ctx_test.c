@@ -0,0 +1,172 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/useful.h>
+
+#include "test/core/util/test_config.h"
+
+typedef struct {
+  gpr_mu mu;
+  char order[16];
+  size_t ran;
+  size_t ran_on_caller;
+  gpr_thd_id caller;
+} run_log;
+
+typedef struct {
+  run_log *log;
+  char name;
+} owner;
+
+typedef struct {
+  grpc_closure closure;
+  owner *owner;
+} logged_closure;
+
+static void log_run(grpc_exec_ctx *exec_ctx, void *arg, grpc_error *error) {
+  owner *o = arg;
+  run_log *log = o->log;
+  gpr_mu_lock(&log->mu);
+  if (log->ran < sizeof(log->order) - 1) {
+    log->order[log->ran] = o->name;
+  }
+  log->ran++;
+  if (gpr_thd_currentid() == log->caller) {
+    log->ran_on_caller++;
+  }
+  gpr_mu_unlock(&log->mu);
+}
+
+static void run_log_init(run_log *log) {
+  memset(log, 0, sizeof(*log));
+  gpr_mu_init(&log->mu);
+  log->caller = gpr_thd_currentid();
+}
+
+static void run_log_destroy(run_log *log) {
+  gpr_mu_destroy(&log->mu);
+}
+
+static void test_runs_in_schedule_order(void) {
+  gpr_log(GPR_DEBUG, "test_runs_in_schedule_order");
+  static const char schedule[] = "abacbaddc";
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  run_log log;
+  owner owners[4];
+  logged_closure closures[GPR_ARRAY_SIZE(schedule) - 1];
+  size_t i;
+  run_log_init(&log);
+  for (i = 0; i < GPR_ARRAY_SIZE(owners); i++) {
+    owners[i].log = &log;
+    owners[i].name = (char)('a' + i);
+  }
+  for (i = 0; i < GPR_ARRAY_SIZE(closures); i++) {
+    closures[i].owner = &owners[schedule[i] - 'a'];
+    grpc_closure_init(&closures[i].closure, log_run, closures[i].owner);
+    grpc_exec_ctx_sched(&exec_ctx, &closures[i].closure, GRPC_ERROR_NONE,
+                        NULL);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(log.ran == GPR_ARRAY_SIZE(closures));
+  GPR_ASSERT(0 == strcmp(log.order, schedule));
+  run_log_destroy(&log);
+}
+
+static void schedule_more(grpc_exec_ctx *exec_ctx, void *arg,
+                          grpc_error *error) {
+  logged_closure *later = arg;
+  grpc_exec_ctx_sched(exec_ctx, &later->closure, GRPC_ERROR_NONE, NULL);
+}
+
+static void test_runs_queued_before_newly_scheduled(void) {
+  gpr_log(GPR_DEBUG, "test_runs_queued_before_newly_scheduled");
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  run_log log;
+  owner a = {&log, 'a'};
+  owner b = {&log, 'b'};
+  logged_closure later;
+  logged_closure queued;
+  grpc_closure scheduler;
+  run_log_init(&log);
+  later.owner = &a;
+  grpc_closure_init(&later.closure, log_run, &a);
+  queued.owner = &b;
+  grpc_closure_init(&queued.closure, log_run, &b);
+  grpc_closure_init(&scheduler, schedule_more, &later);
+  grpc_exec_ctx_sched(&exec_ctx, &scheduler, GRPC_ERROR_NONE, NULL);
+  grpc_exec_ctx_sched(&exec_ctx, &queued.closure, GRPC_ERROR_NONE, NULL);
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(0 == strcmp(log.order, "ba"));
+  run_log_destroy(&log);
+}
+
+#define MANY_CLOSURES 4000
+
+static void test_runs_many_on_caller(void) {
+  gpr_log(GPR_DEBUG, "test_runs_many_on_caller");
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  run_log log;
+  owner o = {&log, 'a'};
+  logged_closure *closures = gpr_malloc(MANY_CLOSURES * sizeof(*closures));
+  size_t i;
+  run_log_init(&log);
+  for (i = 0; i < MANY_CLOSURES; i++) {
+    grpc_closure_init(&closures[i].closure, log_run, &o);
+    grpc_exec_ctx_sched(&exec_ctx, &closures[i].closure, GRPC_ERROR_NONE,
+                        NULL);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(log.ran == MANY_CLOSURES);
+  GPR_ASSERT(log.ran_on_caller == MANY_CLOSURES);
+  gpr_free(closures);
+  run_log_destroy(&log);
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  grpc_init();
+  test_runs_in_schedule_order();
+  test_runs_queued_before_newly_scheduled();
+  test_runs_many_on_caller();
+  grpc_shutdown();
+  return 0;
+}
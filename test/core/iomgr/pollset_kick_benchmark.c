@@ -0,0 +1,196 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Cost of waking up a thread waiting on a pollset, as done for each
+   completion posted to a completion queue by a thread that isn't polling it.
+
+   Two pollsets each have a number of threads waiting on them. A token is
+   passed back and forth between the pollsets: a thread woken up on the pollset
+   that holds the token passes it to the other pollset and kicks that one
+   (without choosing a worker, as grpc_cq_end_op does). Reports the time per
+   hand-off.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/iomgr.h"
+#include "src/core/lib/iomgr/pollset.h"
+#include "test/core/util/test_config.h"
+
+typedef struct {
+  grpc_pollset *pollsets[2];
+  gpr_mu *mus[2];
+  /* index of the pollset that holds the token */
+  gpr_atm token;
+  gpr_atm hand_offs;
+  gpr_atm done;
+} benchmark;
+
+typedef struct {
+  benchmark *b;
+  int index;
+} waiter_arg;
+
+static void kick(benchmark *b, int index) {
+  gpr_mu_lock(b->mus[index]);
+  GRPC_LOG_IF_ERROR("kick", grpc_pollset_kick(b->pollsets[index], NULL));
+  gpr_mu_unlock(b->mus[index]);
+}
+
+static void waiter(void *arg) {
+  waiter_arg *a = arg;
+  benchmark *b = a->b;
+  int i = a->index;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+
+  gpr_mu_lock(b->mus[i]);
+  while (!gpr_atm_acq_load(&b->done)) {
+    grpc_pollset_worker *worker = NULL;
+    gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+    GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(&exec_ctx, b->pollsets[i], &worker, now,
+                          gpr_time_add(now, gpr_time_from_seconds(
+                                                1, GPR_TIMESPAN))));
+    if (gpr_atm_acq_cas(&b->token, i, 1 - i)) {
+      gpr_atm_no_barrier_fetch_add(&b->hand_offs, 1);
+      gpr_mu_unlock(b->mus[i]);
+      kick(b, 1 - i);
+      gpr_mu_lock(b->mus[i]);
+    }
+  }
+  gpr_mu_unlock(b->mus[i]);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+static void destroy_pollset(grpc_exec_ctx *exec_ctx, void *p,
+                            grpc_error *error) {
+  grpc_pollset_destroy(p);
+}
+
+static void run(int waiters_per_pollset, double seconds) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  benchmark b;
+  waiter_arg args[2];
+  gpr_thd_id *threads = gpr_malloc(2 * (size_t)waiters_per_pollset *
+                                   sizeof(*threads));
+  gpr_thd_options options = gpr_thd_options_default();
+  gpr_timespec start;
+  double elapsed;
+  grpc_closure destroyed;
+  int i, j;
+
+  for (i = 0; i < 2; i++) {
+    b.pollsets[i] = gpr_malloc(grpc_pollset_size());
+    grpc_pollset_init(b.pollsets[i], &b.mus[i]);
+    args[i].b = &b;
+    args[i].index = i;
+  }
+  gpr_atm_rel_store(&b.token, 0);
+  gpr_atm_rel_store(&b.hand_offs, 0);
+  gpr_atm_rel_store(&b.done, 0);
+
+  gpr_thd_options_set_joinable(&options);
+  for (i = 0; i < 2; i++) {
+    for (j = 0; j < waiters_per_pollset; j++) {
+      GPR_ASSERT(gpr_thd_new(&threads[i * waiters_per_pollset + j], waiter,
+                             &args[i], &options));
+    }
+  }
+
+  start = gpr_now(GPR_CLOCK_MONOTONIC);
+  kick(&b, 0);
+  gpr_sleep_until(gpr_time_add(
+      start, gpr_time_from_micros((int64_t)(1e6 * seconds), GPR_TIMESPAN)));
+  gpr_atm_rel_store(&b.done, 1);
+  elapsed = gpr_timespec_to_micros(
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start));
+  for (i = 0; i < 2; i++) {
+    gpr_mu_lock(b.mus[i]);
+    GRPC_LOG_IF_ERROR("kick", grpc_pollset_kick(b.pollsets[i],
+                                                GRPC_POLLSET_KICK_BROADCAST));
+    gpr_mu_unlock(b.mus[i]);
+  }
+  for (i = 0; i < 2 * waiters_per_pollset; i++) {
+    gpr_thd_join(threads[i]);
+  }
+
+  printf("%2d waiters per pollset: %6.2f us per hand-off\n",
+         waiters_per_pollset,
+         elapsed / (double)gpr_atm_no_barrier_load(&b.hand_offs));
+
+  for (i = 0; i < 2; i++) {
+    grpc_closure_init(&destroyed, destroy_pollset, b.pollsets[i]);
+    gpr_mu_lock(b.mus[i]);
+    grpc_pollset_shutdown(&exec_ctx, b.pollsets[i], &destroyed);
+    gpr_mu_unlock(b.mus[i]);
+    grpc_exec_ctx_flush(&exec_ctx);
+    gpr_free(b.pollsets[i]);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  gpr_free(threads);
+}
+
+int main(int argc, char **argv) {
+  static const int waiters[] = {1, 2, 4, 8};
+  int seconds = 2;
+  size_t i;
+
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("pollset wakeup latency benchmarking tool");
+  gpr_cmdline_add_int(cmdline, "seconds", "Duration of each scenario",
+                      &seconds);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  gpr_cmdline_destroy(cmdline);
+
+  grpc_test_init(argc, argv);
+  grpc_iomgr_init();
+  for (i = 0; i < GPR_ARRAY_SIZE(waiters); i++) {
+    run(waiters[i], seconds);
+  }
+  grpc_iomgr_shutdown();
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Cost of linking and unlinking the pollset_sets of many client channels.
+
+   Builds the pollset_set graph of a process with many channels to one
+   backend: every channel's pollset_set is linked under the pollset_set of
+   the subchannel they all share, and under that of a subchannel of its own
+   with its own connection fd, and a completion queue's pollset is added to
+   every channel as calls would add it. The shared subchannel reconnects every
+   RECONNECT_INTERVAL channels. Everything is then torn down in creation
+   order, with the same reconnects. Reports the time per channel of both phases for growing
+   channel counts: a time per channel that grows with the count means
+   quadratic work.
+ */
+
+#include <stdio.h>
+#include <sys/socket.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/pollset_set.h"
+#include "test/core/util/test_config.h"
+
+typedef struct {
+  grpc_pollset_set *channel;
+  grpc_pollset_set *subchannel;
+  grpc_fd *connection;
+} channel;
+
+#define RECONNECT_INTERVAL 64
+
+static gpr_mu *g_mu;
+static grpc_pollset *g_pollset;
+
+static double now_seconds(void) {
+  gpr_timespec t = gpr_now(GPR_CLOCK_MONOTONIC);
+  return (double)t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static grpc_fd *create_connection(const char *name) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(fd >= 0);
+  return grpc_fd_create(fd, name);
+}
+
+static void reconnect(grpc_exec_ctx *exec_ctx, grpc_pollset_set *shared,
+                      grpc_fd **connection) {
+  grpc_pollset_set_del_fd(exec_ctx, shared, *connection);
+  grpc_fd_orphan(exec_ctx, *connection, NULL, NULL, "shared");
+  *connection = create_connection("shared");
+  grpc_pollset_set_add_fd(exec_ctx, shared, *connection);
+}
+
+static void run(int num_channels) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  channel *channels = gpr_malloc((size_t)num_channels * sizeof(*channels));
+  grpc_pollset_set *shared = grpc_pollset_set_create();
+  grpc_fd *shared_connection = create_connection("shared");
+  double start, created, destroyed;
+  int i;
+
+  grpc_pollset_set_add_fd(&exec_ctx, shared, shared_connection);
+
+  start = now_seconds();
+  for (i = 0; i < num_channels; i++) {
+    channel *c = &channels[i];
+    c->channel = grpc_pollset_set_create();
+    c->subchannel = grpc_pollset_set_create();
+    c->connection = create_connection("channel");
+    grpc_pollset_set_add_fd(&exec_ctx, c->subchannel, c->connection);
+    grpc_pollset_set_add_pollset_set(&exec_ctx, c->subchannel, c->channel);
+    grpc_pollset_set_add_pollset_set(&exec_ctx, shared, c->channel);
+    grpc_pollset_set_add_pollset(&exec_ctx, c->channel, g_pollset);
+    if (i % RECONNECT_INTERVAL == 0) {
+      reconnect(&exec_ctx, shared, &shared_connection);
+    }
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  created = now_seconds();
+  for (i = 0; i < num_channels; i++) {
+    channel *c = &channels[i];
+    grpc_pollset_set_del_pollset(&exec_ctx, c->channel, g_pollset);
+    grpc_pollset_set_del_pollset_set(&exec_ctx, shared, c->channel);
+    grpc_pollset_set_del_pollset_set(&exec_ctx, c->subchannel, c->channel);
+    grpc_pollset_set_del_fd(&exec_ctx, c->subchannel, c->connection);
+    grpc_fd_orphan(&exec_ctx, c->connection, NULL, NULL, "channel");
+    grpc_pollset_set_destroy(c->subchannel);
+    grpc_pollset_set_destroy(c->channel);
+    if (i % RECONNECT_INTERVAL == 0) {
+      reconnect(&exec_ctx, shared, &shared_connection);
+    }
+    grpc_exec_ctx_flush(&exec_ctx);
+  }
+  destroyed = now_seconds();
+
+  printf("%6d channels: create %.2f us/channel, destroy %.2f us/channel\n",
+         num_channels, 1e6 * (created - start) / num_channels,
+         1e6 * (destroyed - created) / num_channels);
+
+  grpc_pollset_set_del_fd(&exec_ctx, shared, shared_connection);
+  grpc_fd_orphan(&exec_ctx, shared_connection, NULL, NULL, "shared");
+  grpc_pollset_set_destroy(shared);
+  grpc_exec_ctx_finish(&exec_ctx);
+  gpr_free(channels);
+}
+
+static void destroy_pollset(grpc_exec_ctx *exec_ctx, void *p,
+                            grpc_error *error) {
+  grpc_pollset_destroy(p);
+}
+
+int main(int argc, char **argv) {
+  grpc_closure destroyed;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  int max_channels = 16000;
+  int num_channels;
+
+  gpr_cmdline *cmdline = gpr_cmdline_create("pollset_set benchmarking tool");
+  gpr_cmdline_add_int(cmdline, "max_channels",
+                      "Largest number of channels to create (each takes a "
+                      "file descriptor)",
+                      &max_channels);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  gpr_cmdline_destroy(cmdline);
+
+  grpc_test_init(argc, argv);
+  grpc_init();
+  g_pollset = gpr_malloc(grpc_pollset_size());
+  grpc_pollset_init(g_pollset, &g_mu);
+
+  for (num_channels = 1000; num_channels <= max_channels; num_channels *= 2) {
+    run(num_channels);
+  }
+
+  grpc_closure_init(&destroyed, destroy_pollset, g_pollset);
+  grpc_pollset_shutdown(&exec_ctx, g_pollset, &destroyed);
+  grpc_exec_ctx_finish(&exec_ctx);
+  grpc_shutdown();
+  gpr_free(g_pollset);
+  return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/lib/iomgr/pollset_set_members.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <grpc/support/log.h>
+
+#include "test/core/util/test_config.h"
+
+/* members are addresses in this array, so that neighbouring members share
+   most of their bits as real pointers do */
+#define NUM_OBJECTS 4096
+static char g_objects[NUM_OBJECTS];
+static size_t g_counts[NUM_OBJECTS];
+
+static void check_matches_counts(grpc_pollset_set_members *m) {
+  size_t i;
+  size_t present = 0;
+  for (i = 0; i < NUM_OBJECTS; i++) {
+    if (g_counts[i] > 0) present++;
+  }
+  GPR_ASSERT(m->count == present);
+  for (i = 0; i < m->count; i++) {
+    char *member = m->members[i].member;
+    GPR_ASSERT(member >= g_objects && member < g_objects + NUM_OBJECTS);
+    GPR_ASSERT(m->members[i].count == g_counts[member - g_objects]);
+  }
+}
+
+static void test_counts(void) {
+  grpc_pollset_set_members m;
+  gpr_log(GPR_INFO, "test_counts");
+  grpc_pollset_set_members_init(&m);
+  GPR_ASSERT(!grpc_pollset_set_members_del(&m, &g_objects[0]));
+  GPR_ASSERT(grpc_pollset_set_members_add(&m, &g_objects[0]));
+  GPR_ASSERT(!grpc_pollset_set_members_add(&m, &g_objects[0]));
+  GPR_ASSERT(grpc_pollset_set_members_add(&m, &g_objects[1]));
+  GPR_ASSERT(m.count == 2);
+  GPR_ASSERT(!grpc_pollset_set_members_del(&m, &g_objects[0]));
+  GPR_ASSERT(m.count == 2);
+  GPR_ASSERT(grpc_pollset_set_members_del(&m, &g_objects[0]));
+  GPR_ASSERT(m.count == 1);
+  GPR_ASSERT(m.members[0].member == &g_objects[1]);
+  GPR_ASSERT(!grpc_pollset_set_members_del(&m, &g_objects[0]));
+  GPR_ASSERT(!grpc_pollset_set_members_add(&m, &g_objects[1]));
+  GPR_ASSERT(grpc_pollset_set_members_remove(&m, &g_objects[1]));
+  GPR_ASSERT(m.count == 0);
+  GPR_ASSERT(!grpc_pollset_set_members_remove(&m, &g_objects[1]));
+  grpc_pollset_set_members_destroy(&m);
+}
+
+/* random adds and deletes over a growing and shrinking set, checked against
+   a count per object */
+static void test_random_ops(size_t range) {
+  grpc_pollset_set_members m;
+  size_t i;
+  gpr_log(GPR_INFO, "test_random_ops: %d", (int)range);
+  grpc_pollset_set_members_init(&m);
+  memset(g_counts, 0, sizeof(g_counts));
+  for (i = 0; i < 20 * range; i++) {
+    size_t object = (size_t)rand() % range;
+    /* add more than delete for the first half, then drain */
+    bool add = rand() % 8 < (i < 10 * range ? 5 : 2);
+    if (add) {
+      GPR_ASSERT(grpc_pollset_set_members_add(&m, &g_objects[object]) ==
+                 (g_counts[object] == 0));
+      g_counts[object]++;
+    } else {
+      GPR_ASSERT(grpc_pollset_set_members_del(&m, &g_objects[object]) ==
+                 (g_counts[object] == 1));
+      if (g_counts[object] > 0) g_counts[object]--;
+    }
+    if (i % 64 == 0) check_matches_counts(&m);
+  }
+  check_matches_counts(&m);
+  grpc_pollset_set_members_destroy(&m);
+}
+
+static void test_remove_at(void) {
+  grpc_pollset_set_members m;
+  size_t i;
+  gpr_log(GPR_INFO, "test_remove_at");
+  grpc_pollset_set_members_init(&m);
+  memset(g_counts, 0, sizeof(g_counts));
+  for (i = 0; i < 1000; i++) {
+    grpc_pollset_set_members_add(&m, &g_objects[i]);
+    grpc_pollset_set_members_add(&m, &g_objects[i]);
+    g_counts[i] = 2;
+  }
+  /* take out every member at an odd object, as a pollset_set does when it
+     finds orphaned fds */
+  for (i = 0; i < m.count;) {
+    char *member = m.members[i].member;
+    if ((member - g_objects) % 2 == 1) {
+      grpc_pollset_set_members_remove_at(&m, i);
+      g_counts[member - g_objects] = 0;
+    } else {
+      i++;
+    }
+  }
+  check_matches_counts(&m);
+  for (i = 0; i < 1000; i++) {
+    GPR_ASSERT(grpc_pollset_set_members_add(&m, &g_objects[i]) == (i % 2 == 1));
+  }
+  grpc_pollset_set_members_destroy(&m);
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_counts();
+  test_random_ops(4);
+  test_random_ops(16);
+  test_random_ops(NUM_OBJECTS);
+  test_remove_at();
+  return 0;
+}
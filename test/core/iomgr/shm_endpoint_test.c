@@ -0,0 +1,239 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/lib/iomgr/shm_endpoint.h"
+
+#include <string.h>
+
+#ifdef GPR_LINUX_EVENTFD
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#endif
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/iomgr/endpoint_pair.h"
+#include "src/core/lib/iomgr/tcp_posix.h"
+#include "test/core/iomgr/endpoint_tests.h"
+#include "test/core/util/test_config.h"
+
+static gpr_mu *g_mu;
+static grpc_pollset *g_pollset;
+
+static void clean_up(void) {}
+
+static void on_bootstrap_read(grpc_exec_ctx *exec_ctx, void *arg,
+                              grpc_error *error) {
+  GPR_ASSERT(error == GRPC_ERROR_NONE);
+  *(bool *)arg = true;
+}
+
+/* reads a whole bootstrap message from the server end of a connection */
+static void read_bootstrap(grpc_exec_ctx *exec_ctx, grpc_endpoint *server,
+                           gpr_slice_buffer *bootstrap) {
+  grpc_closure bootstrap_read;
+  bool read_done = false;
+
+  grpc_closure_init(&bootstrap_read, on_bootstrap_read, &read_done);
+  grpc_endpoint_read(exec_ctx, server, bootstrap, &bootstrap_read);
+  grpc_exec_ctx_flush(exec_ctx);
+  gpr_mu_lock(g_mu);
+  while (!read_done) {
+    grpc_pollset_worker *worker = NULL;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(exec_ctx, g_pollset, &worker,
+                          gpr_now(GPR_CLOCK_MONOTONIC),
+                          GRPC_TIMEOUT_SECONDS_TO_DEADLINE(10))));
+  }
+  gpr_mu_unlock(g_mu);
+  grpc_exec_ctx_flush(exec_ctx);
+}
+
+/* connects over a unix socketpair, handing over the bootstrap message the
+   way the shm handshaker does */
+static grpc_endpoint_test_fixture create_fixture(size_t ring_size) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_endpoint_test_fixture f;
+  grpc_endpoint_pair p = grpc_iomgr_create_endpoint_pair("test", 8192);
+  gpr_slice_buffer bootstrap;
+
+  grpc_endpoint_add_to_pollset(&exec_ctx, p.server, g_pollset);
+  grpc_shm_endpoint_prepare_accept(p.server);
+  GPR_ASSERT(GRPC_ERROR_NONE == grpc_shm_endpoint_connect(&exec_ctx, p.client,
+                                                          ring_size,
+                                                          &f.client_ep));
+  gpr_slice_buffer_init(&bootstrap);
+  read_bootstrap(&exec_ctx, p.server, &bootstrap);
+  GPR_ASSERT(grpc_shm_check_bootstrap(&bootstrap) == GRPC_SHM_BOOTSTRAP_MATCH);
+  GPR_ASSERT(GRPC_ERROR_NONE == grpc_shm_endpoint_accept(&exec_ctx, p.server,
+                                                         &bootstrap,
+                                                         &f.server_ep));
+  GPR_ASSERT(bootstrap.length == 0);
+  gpr_slice_buffer_destroy(&bootstrap);
+
+  grpc_endpoint_add_to_pollset(&exec_ctx, f.client_ep, g_pollset);
+  grpc_endpoint_add_to_pollset(&exec_ctx, f.server_ep, g_pollset);
+  grpc_exec_ctx_finish(&exec_ctx);
+  return f;
+}
+
+/* the smallest rings wrap around and fill up all the time */
+static grpc_endpoint_test_fixture create_fixture_small_rings(
+    size_t slice_size) {
+  return create_fixture(GRPC_SHM_MIN_RING_SIZE);
+}
+
+static grpc_endpoint_test_fixture create_fixture_default_rings(
+    size_t slice_size) {
+  return create_fixture(GRPC_SHM_DEFAULT_RING_SIZE);
+}
+
+static grpc_endpoint_test_config configs[] = {
+    {"shm/small_rings", create_fixture_small_rings, clean_up},
+    {"shm/default_rings", create_fixture_default_rings, clean_up},
+};
+
+static void test_check_bootstrap(void) {
+  static const char preface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+  gpr_slice_buffer buffer;
+
+  gpr_log(GPR_INFO, "test_check_bootstrap");
+  gpr_slice_buffer_init(&buffer);
+  GPR_ASSERT(grpc_shm_check_bootstrap(&buffer) ==
+             GRPC_SHM_BOOTSTRAP_INCOMPLETE);
+  gpr_slice_buffer_add(&buffer, gpr_slice_from_copied_string("GRPC"));
+  GPR_ASSERT(grpc_shm_check_bootstrap(&buffer) ==
+             GRPC_SHM_BOOTSTRAP_INCOMPLETE);
+  gpr_slice_buffer_reset_and_unref(&buffer);
+  gpr_slice_buffer_add(&buffer, gpr_slice_from_copied_string(preface));
+  GPR_ASSERT(grpc_shm_check_bootstrap(&buffer) == GRPC_SHM_BOOTSTRAP_MISMATCH);
+  gpr_slice_buffer_destroy(&buffer);
+}
+
+#ifdef GPR_LINUX_EVENTFD
+/* hands the server a bootstrap message built by hand, with a memfd that is
+   sealed or not and descriptors that are eventfds or pipes, and checks that
+   it is refused */
+static void test_accept_rejects(bool sealed, bool eventfds) {
+  static const uint8_t message[] = {'G', 'R', 'P', 'C', '-', 'S', 'H', 'M',
+                                    0,   0,   0,   1,   0,   0,   0x10, 0};
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  grpc_endpoint_pair p = grpc_iomgr_create_endpoint_pair("test", 8192);
+  gpr_slice_buffer bootstrap;
+  grpc_endpoint *ep = NULL;
+  grpc_error *error;
+  int fds[5];
+  size_t i;
+
+  gpr_log(GPR_INFO, "test_accept_rejects: sealed=%d eventfds=%d", sealed,
+          eventfds);
+  fds[0] = (int)syscall(__NR_memfd_create, "test",
+                        sealed ? MFD_ALLOW_SEALING : 0);
+  GPR_ASSERT(fds[0] >= 0);
+  GPR_ASSERT(ftruncate(fds[0], 1024 * 1024) == 0);
+  if (sealed) {
+    GPR_ASSERT(fcntl(fds[0], F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) == 0);
+  }
+  for (i = 1; i < GPR_ARRAY_SIZE(fds); i += 2) {
+    if (eventfds) {
+      fds[i] = eventfd(0, EFD_NONBLOCK);
+      fds[i + 1] = eventfd(0, EFD_NONBLOCK);
+    } else {
+      GPR_ASSERT(pipe(fds + i) == 0);
+    }
+  }
+
+  grpc_endpoint_add_to_pollset(&exec_ctx, p.server, g_pollset);
+  grpc_shm_endpoint_prepare_accept(p.server);
+  GPR_ASSERT(GRPC_ERROR_NONE == grpc_tcp_send_fds(p.client, message,
+                                                  sizeof(message), fds,
+                                                  GPR_ARRAY_SIZE(fds)));
+  for (i = 0; i < GPR_ARRAY_SIZE(fds); i++) {
+    close(fds[i]);
+  }
+  gpr_slice_buffer_init(&bootstrap);
+  read_bootstrap(&exec_ctx, p.server, &bootstrap);
+  GPR_ASSERT(grpc_shm_check_bootstrap(&bootstrap) == GRPC_SHM_BOOTSTRAP_MATCH);
+  error = grpc_shm_endpoint_accept(&exec_ctx, p.server, &bootstrap, &ep);
+  GPR_ASSERT(error != GRPC_ERROR_NONE);
+  GPR_ASSERT(ep == NULL);
+  GRPC_ERROR_UNREF(error);
+  gpr_slice_buffer_destroy(&bootstrap);
+  grpc_endpoint_destroy(&exec_ctx, p.client);
+  grpc_endpoint_destroy(&exec_ctx, p.server);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+#endif
+
+static void destroy_pollset(grpc_exec_ctx *exec_ctx, void *p,
+                            grpc_error *error) {
+  grpc_pollset_destroy(p);
+}
+
+int main(int argc, char **argv) {
+  grpc_closure destroyed;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  size_t i;
+  grpc_test_init(argc, argv);
+  grpc_init();
+  if (grpc_shm_endpoint_supported()) {
+    g_pollset = gpr_malloc(grpc_pollset_size());
+    grpc_pollset_init(g_pollset, &g_mu);
+    test_check_bootstrap();
+#ifdef GPR_LINUX_EVENTFD
+    test_accept_rejects(false, true);
+    test_accept_rejects(true, false);
+#endif
+    for (i = 0; i < GPR_ARRAY_SIZE(configs); i++) {
+      grpc_endpoint_tests(configs[i], g_pollset, g_mu);
+    }
+    grpc_closure_init(&destroyed, destroy_pollset, g_pollset);
+    grpc_pollset_shutdown(&exec_ctx, g_pollset, &destroyed);
+    grpc_exec_ctx_finish(&exec_ctx);
+    gpr_free(g_pollset);
+  }
+  grpc_shutdown();
+
+  return 0;
+}
@@ -45,6 +45,7 @@
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
 #include <grpc/support/useful.h>
+#include "src/core/lib/support/tmpfile.h"
 #include "test/core/iomgr/endpoint_tests.h"
 #include "test/core/util/test_config.h"
 
@@ -285,6 +286,43 @@ static gpr_slice *allocate_blocks(size_t num_bytes, size_t slice_size,
   return slices;
 }
 
+/* Like allocate_blocks(), but every other block is a mapped file slice, so
+   that the data is partly sent with sendfile() */
+static gpr_slice *allocate_file_blocks(size_t num_bytes, size_t slice_size,
+                                       size_t *num_blocks) {
+  size_t nslices = num_bytes / slice_size + (num_bytes % slice_size ? 1u : 0u);
+  gpr_slice *slices = gpr_malloc(sizeof(gpr_slice) * nslices);
+  uint8_t *data = gpr_malloc(num_bytes);
+  FILE *file = gpr_tmpfile("tcp_posix_test", NULL);
+  size_t offset = 0;
+  size_t i, length;
+  *num_blocks = nslices;
+
+  GPR_ASSERT(file != NULL);
+  for (i = 0; i < num_bytes; i++) {
+    data[i] = (uint8_t)i;
+  }
+  GPR_ASSERT(fwrite(data, 1, num_bytes, file) == num_bytes);
+  GPR_ASSERT(fflush(file) == 0);
+
+  for (i = 0; i < nslices; i++) {
+    length = GPR_MIN(slice_size, num_bytes - offset);
+    if (i % 2 == 0) {
+      GPR_ASSERT(gpr_slice_from_mapped_file(fileno(file), (int64_t)offset,
+                                            length, GPR_SLICE_MAP_ADVICE_NORMAL,
+                                            &slices[i]));
+    } else {
+      slices[i] = gpr_slice_from_copied_buffer((char *)data + offset, length);
+    }
+    offset += length;
+  }
+  GPR_ASSERT(offset == num_bytes);
+  /* the slices hold on to the file */
+  fclose(file);
+  gpr_free(data);
+  return slices;
+}
+
 static void write_done(grpc_exec_ctx *exec_ctx,
                        void *user_data /* write_socket_state */,
                        grpc_error *error) {
@@ -341,7 +379,7 @@ void drain_socket_blocking(int fd, size_t num_bytes, size_t read_size) {
 /* Write to a socket using the grpc_tcp API, then drain it directly.
    Note that if the write does not complete immediately we need to drain the
    socket in parallel with the read. */
-static void write_test(size_t num_bytes, size_t slice_size) {
+static void write_test(size_t num_bytes, size_t slice_size, bool from_file) {
   int sv[2];
   grpc_endpoint *ep;
   struct write_socket_state state;
@@ -354,8 +392,9 @@ static void write_test(size_t num_bytes, size_t slice_size) {
   grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
 
   gpr_log(GPR_INFO,
-          "Start write test with %" PRIuPTR " bytes, slice size %" PRIuPTR,
-          num_bytes, slice_size);
+          "Start write test with %" PRIuPTR " bytes, slice size %" PRIuPTR
+          "%s",
+          num_bytes, slice_size, from_file ? ", from a file" : "");
 
   create_sockets(sv);
 
@@ -366,7 +405,10 @@ static void write_test(size_t num_bytes, size_t slice_size) {
   state.ep = ep;
   state.write_done = 0;
 
-  slices = allocate_blocks(num_bytes, slice_size, &num_blocks, &current_data);
+  slices = from_file
+               ? allocate_file_blocks(num_bytes, slice_size, &num_blocks)
+               : allocate_blocks(num_bytes, slice_size, &num_blocks,
+                                 &current_data);
 
   gpr_slice_buffer_init(&outgoing);
   gpr_slice_buffer_addn(&outgoing, slices, num_blocks);
@@ -484,16 +526,20 @@ void run_tests(void) {
   large_read_test(8192);
   large_read_test(1);
 
-  write_test(100, 8192);
-  write_test(100, 1);
-  write_test(100000, 8192);
-  write_test(100000, 1);
-  write_test(100000, 137);
+  write_test(100, 8192, false);
+  write_test(100, 1, false);
+  write_test(100000, 8192, false);
+  write_test(100000, 1, false);
+  write_test(100000, 137, false);
 
   for (i = 1; i < 1000; i = GPR_MAX(i + 1, i * 5 / 4)) {
-    write_test(40320, i);
+    write_test(40320, i, false);
   }
 
+  write_test(100, 8192, true);
+  write_test(100000, 137, true);
+  write_test(10000000, 1000000, true);
+
   release_fd_test(100, 8192);
 }
 
@@ -150,9 +150,84 @@ void destruction_test(void) {
   GPR_ASSERT(1 == cb_called[2][0]);
 }
 
+static gpr_timespec tfm_plus_nanos(int m, int n) {
+  return gpr_time_add(tfm(m), gpr_time_from_nanos(n, GPR_TIMESPAN));
+}
+
+/* Coalesced timers: deadlines are rounded up to the millisecond, and timers
+   with the same deadline share a queue entry. */
+void coalesced_test(void) {
+  grpc_timer timers[20];
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  int i;
+
+  grpc_timer_list_init(gpr_time_0(GPR_CLOCK_REALTIME));
+  memset(cb_called, 0, sizeof(cb_called));
+
+  /* 10 timers sharing the 11ms deadline, 5 sharing 1010ms */
+  for (i = 0; i < 10; i++) {
+    grpc_timer_init_coalesced(&exec_ctx, &timers[i],
+                              tfm_plus_nanos(10, 100000 * i + 1), cb,
+                              (void *)(intptr_t)i,
+                              gpr_time_0(GPR_CLOCK_REALTIME));
+    GPR_ASSERT(0 == gpr_time_cmp(timers[i].deadline, tfm(11)));
+  }
+  for (i = 10; i < 15; i++) {
+    grpc_timer_init_coalesced(&exec_ctx, &timers[i], tfm(1010), cb,
+                              (void *)(intptr_t)i,
+                              gpr_time_0(GPR_CLOCK_REALTIME));
+  }
+  /* and a regular timer in between */
+  grpc_timer_init(&exec_ctx, &timers[15], tfm_plus_nanos(10, 500000), cb,
+                  (void *)(intptr_t)15, gpr_time_0(GPR_CLOCK_REALTIME));
+
+  /* cancelling a timer leaves the others of its bucket alone */
+  grpc_timer_cancel(&exec_ctx, &timers[3]);
+  grpc_timer_cancel(&exec_ctx, &timers[12]);
+  grpc_exec_ctx_finish(&exec_ctx);
+  for (i = 0; i < 16; i++) {
+    GPR_ASSERT(cb_called[i][0] == (i == 3 || i == 12));
+    GPR_ASSERT(cb_called[i][1] == 0);
+  }
+
+  /* never early */
+  GPR_ASSERT(grpc_timer_check(&exec_ctx, tfm_plus_nanos(10, 900000), NULL));
+  grpc_exec_ctx_finish(&exec_ctx);
+  for (i = 0; i < 16; i++) {
+    GPR_ASSERT(cb_called[i][1] == (i == 15));
+  }
+  GPR_ASSERT(grpc_timer_check(&exec_ctx, tfm_plus_nanos(11, 1), NULL));
+  grpc_exec_ctx_finish(&exec_ctx);
+  for (i = 0; i < 16; i++) {
+    GPR_ASSERT(cb_called[i][1] == ((i < 10 && i != 3) || i == 15));
+  }
+
+  /* cancelling the last timer of a bucket removes the bucket */
+  for (i = 10; i < 15; i++) {
+    grpc_timer_cancel(&exec_ctx, &timers[i]);
+  }
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(!grpc_timer_check(&exec_ctx, tfm(1500), NULL));
+  for (i = 0; i < 16; i++) {
+    GPR_ASSERT(cb_called[i][0] == (i == 3 || (i >= 10 && i < 15)));
+  }
+
+  /* pending coalesced timers get cancelled at shutdown */
+  for (i = 16; i < 20; i++) {
+    grpc_timer_init_coalesced(&exec_ctx, &timers[i], tfm(2000), cb,
+                              (void *)(intptr_t)i, tfm(1500));
+  }
+  grpc_timer_list_shutdown(&exec_ctx);
+  grpc_exec_ctx_finish(&exec_ctx);
+  for (i = 16; i < 20; i++) {
+    GPR_ASSERT(cb_called[i][0] == 1);
+  }
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   add_test();
   destruction_test();
+  coalesced_test();
   return 0;
 }
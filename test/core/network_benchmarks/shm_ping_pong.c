@@ -0,0 +1,400 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Shared memory endpoint benchmarks.
+
+   Compares shm endpoints with tcp endpoints over a unix socket, the
+   connections they replace, for request-response latency and for one way
+   throughput. Both ends run in this process on one pollset, so the numbers
+   are for the endpoints themselves rather than for any thread hand-offs.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/histogram.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/iomgr/endpoint_pair.h"
+#include "src/core/lib/iomgr/shm_endpoint.h"
+#include "test/core/util/test_config.h"
+
+static gpr_mu *g_mu;
+static grpc_pollset *g_pollset;
+
+static void set_done(bool *done) {
+  gpr_mu_lock(g_mu);
+  *done = true;
+  GPR_ASSERT(
+      GRPC_LOG_IF_ERROR("pollset_kick", grpc_pollset_kick(g_pollset, NULL)));
+  gpr_mu_unlock(g_mu);
+}
+
+static void poll_until_done(grpc_exec_ctx *exec_ctx, bool *done) {
+  grpc_exec_ctx_flush(exec_ctx);
+  gpr_mu_lock(g_mu);
+  while (!*done) {
+    grpc_pollset_worker *worker = NULL;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(exec_ctx, g_pollset, &worker,
+                          gpr_now(GPR_CLOCK_MONOTONIC),
+                          GRPC_TIMEOUT_SECONDS_TO_DEADLINE(1))));
+    gpr_mu_unlock(g_mu);
+    grpc_exec_ctx_flush(exec_ctx);
+    gpr_mu_lock(g_mu);
+  }
+  gpr_mu_unlock(g_mu);
+}
+
+static void on_bootstrap_read(grpc_exec_ctx *exec_ctx, void *arg,
+                              grpc_error *error) {
+  GPR_ASSERT(error == GRPC_ERROR_NONE);
+  set_done(arg);
+}
+
+static grpc_endpoint_pair create_pair(grpc_exec_ctx *exec_ctx, bool shm,
+                                      size_t ring_size) {
+  grpc_endpoint_pair p = grpc_iomgr_create_endpoint_pair("bench", 65536);
+  grpc_endpoint_add_to_pollset(exec_ctx, p.server, g_pollset);
+  if (shm) {
+    grpc_endpoint_pair control = p;
+    gpr_slice_buffer bootstrap;
+    grpc_closure bootstrap_read;
+    bool read_done = false;
+    grpc_shm_endpoint_prepare_accept(control.server);
+    GPR_ASSERT(GRPC_ERROR_NONE == grpc_shm_endpoint_connect(exec_ctx,
+                                                            control.client,
+                                                            ring_size,
+                                                            &p.client));
+    gpr_slice_buffer_init(&bootstrap);
+    grpc_closure_init(&bootstrap_read, on_bootstrap_read, &read_done);
+    grpc_endpoint_read(exec_ctx, control.server, &bootstrap, &bootstrap_read);
+    poll_until_done(exec_ctx, &read_done);
+    GPR_ASSERT(GRPC_ERROR_NONE == grpc_shm_endpoint_accept(exec_ctx,
+                                                           control.server,
+                                                           &bootstrap,
+                                                           &p.server));
+    gpr_slice_buffer_destroy(&bootstrap);
+    grpc_endpoint_add_to_pollset(exec_ctx, p.server, g_pollset);
+  }
+  grpc_endpoint_add_to_pollset(exec_ctx, p.client, g_pollset);
+  return p;
+}
+
+static void destroy_pair(grpc_exec_ctx *exec_ctx, grpc_endpoint_pair *p) {
+  grpc_endpoint_shutdown(exec_ctx, p->client);
+  grpc_endpoint_shutdown(exec_ctx, p->server);
+  grpc_endpoint_destroy(exec_ctx, p->client);
+  grpc_endpoint_destroy(exec_ctx, p->server);
+  grpc_exec_ctx_flush(exec_ctx);
+}
+
+static void fill_message(gpr_slice_buffer *buffer, size_t size) {
+  gpr_slice slice = gpr_slice_malloc(size);
+  memset(GPR_SLICE_START_PTR(slice), 'a', size);
+  gpr_slice_buffer_reset_and_unref(buffer);
+  gpr_slice_buffer_add(buffer, slice);
+}
+
+/* Ping-pong: the client sends a message, the server echoes it once it has
+   all of it, and the client starts the next round once it has the echo.
+   A side only reuses its write closure once the previous write is done. */
+typedef struct {
+  grpc_endpoint_pair p;
+  size_t msg_size;
+  int rounds_left;
+  gpr_timespec round_start;
+  gpr_histogram *latency;
+  gpr_slice_buffer client_in;
+  gpr_slice_buffer client_out;
+  gpr_slice_buffer server_in;
+  gpr_slice_buffer server_out;
+  size_t client_received;
+  size_t server_received;
+  bool client_writing;
+  bool server_writing;
+  bool echo_received;
+  bool echo_owed;
+  grpc_closure client_read;
+  grpc_closure server_read;
+  grpc_closure client_write;
+  grpc_closure server_write;
+  bool done;
+} ping_pong;
+
+static void start_round(grpc_exec_ctx *exec_ctx, ping_pong *pp) {
+  pp->round_start = gpr_now(GPR_CLOCK_MONOTONIC);
+  pp->echo_received = false;
+  pp->client_writing = true;
+  fill_message(&pp->client_out, pp->msg_size);
+  grpc_endpoint_write(exec_ctx, pp->p.client, &pp->client_out,
+                      &pp->client_write);
+}
+
+static void send_echo(grpc_exec_ctx *exec_ctx, ping_pong *pp) {
+  pp->echo_owed = false;
+  pp->server_writing = true;
+  fill_message(&pp->server_out, pp->msg_size);
+  grpc_endpoint_write(exec_ctx, pp->p.server, &pp->server_out,
+                      &pp->server_write);
+}
+
+static void maybe_finish_round(grpc_exec_ctx *exec_ctx, ping_pong *pp) {
+  if (pp->client_writing || !pp->echo_received) return;
+  gpr_timespec elapsed =
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), pp->round_start);
+  gpr_histogram_add(pp->latency, gpr_timespec_to_micros(elapsed));
+  if (--pp->rounds_left == 0) {
+    set_done(&pp->done);
+  } else {
+    start_round(exec_ctx, pp);
+  }
+}
+
+static void on_client_write_done(grpc_exec_ctx *exec_ctx, void *arg,
+                                 grpc_error *error) {
+  ping_pong *pp = arg;
+  if (error != GRPC_ERROR_NONE) return;
+  pp->client_writing = false;
+  maybe_finish_round(exec_ctx, pp);
+}
+
+static void on_server_write_done(grpc_exec_ctx *exec_ctx, void *arg,
+                                 grpc_error *error) {
+  ping_pong *pp = arg;
+  if (error != GRPC_ERROR_NONE) return;
+  pp->server_writing = false;
+  if (pp->echo_owed) send_echo(exec_ctx, pp);
+}
+
+static void on_server_read(grpc_exec_ctx *exec_ctx, void *arg,
+                           grpc_error *error) {
+  ping_pong *pp = arg;
+  if (error != GRPC_ERROR_NONE) return;
+  pp->server_received += pp->server_in.length;
+  if (pp->server_received == pp->msg_size) {
+    pp->server_received = 0;
+    pp->echo_owed = true;
+    if (!pp->server_writing) send_echo(exec_ctx, pp);
+  }
+  grpc_endpoint_read(exec_ctx, pp->p.server, &pp->server_in,
+                     &pp->server_read);
+}
+
+static void on_client_read(grpc_exec_ctx *exec_ctx, void *arg,
+                           grpc_error *error) {
+  ping_pong *pp = arg;
+  if (error != GRPC_ERROR_NONE) return;
+  pp->client_received += pp->client_in.length;
+  if (pp->client_received == pp->msg_size) {
+    pp->client_received = 0;
+    pp->echo_received = true;
+    maybe_finish_round(exec_ctx, pp);
+    if (pp->done) return;
+  }
+  grpc_endpoint_read(exec_ctx, pp->p.client, &pp->client_in,
+                     &pp->client_read);
+}
+
+static void run_ping_pong(bool shm, size_t ring_size, size_t msg_size,
+                          int rounds) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  ping_pong pp;
+  memset(&pp, 0, sizeof(pp));
+  pp.p = create_pair(&exec_ctx, shm, ring_size);
+  pp.msg_size = msg_size;
+  pp.rounds_left = rounds;
+  pp.latency = gpr_histogram_create(0.01, 60e6);
+  gpr_slice_buffer_init(&pp.client_in);
+  gpr_slice_buffer_init(&pp.client_out);
+  gpr_slice_buffer_init(&pp.server_in);
+  gpr_slice_buffer_init(&pp.server_out);
+  grpc_closure_init(&pp.client_read, on_client_read, &pp);
+  grpc_closure_init(&pp.server_read, on_server_read, &pp);
+  grpc_closure_init(&pp.client_write, on_client_write_done, &pp);
+  grpc_closure_init(&pp.server_write, on_server_write_done, &pp);
+
+  grpc_endpoint_read(&exec_ctx, pp.p.server, &pp.server_in, &pp.server_read);
+  grpc_endpoint_read(&exec_ctx, pp.p.client, &pp.client_in, &pp.client_read);
+  start_round(&exec_ctx, &pp);
+  poll_until_done(&exec_ctx, &pp.done);
+
+  printf("%-4s ping-pong %8zu bytes: latency us (50/95/99/99.9) "
+         "%.1f/%.1f/%.1f/%.1f\n",
+         shm ? "shm" : "uds", msg_size,
+         gpr_histogram_percentile(pp.latency, 50),
+         gpr_histogram_percentile(pp.latency, 95),
+         gpr_histogram_percentile(pp.latency, 99),
+         gpr_histogram_percentile(pp.latency, 99.9));
+
+  destroy_pair(&exec_ctx, &pp.p);
+  grpc_exec_ctx_finish(&exec_ctx);
+  gpr_slice_buffer_destroy(&pp.client_in);
+  gpr_slice_buffer_destroy(&pp.client_out);
+  gpr_slice_buffer_destroy(&pp.server_in);
+  gpr_slice_buffer_destroy(&pp.server_out);
+  gpr_histogram_destroy(pp.latency);
+}
+
+/* Streaming: the client writes chunk after chunk until the server has read
+   total_size bytes. */
+typedef struct {
+  grpc_endpoint_pair p;
+  size_t chunk_size;
+  size_t total_size;
+  size_t sent;
+  size_t received;
+  gpr_slice_buffer out;
+  gpr_slice_buffer in;
+  grpc_closure write_done;
+  grpc_closure read_done;
+  bool done;
+} stream;
+
+static void on_stream_write_done(grpc_exec_ctx *exec_ctx, void *arg,
+                                 grpc_error *error) {
+  stream *s = arg;
+  if (error != GRPC_ERROR_NONE || s->sent == s->total_size) return;
+  size_t n = GPR_MIN(s->chunk_size, s->total_size - s->sent);
+  fill_message(&s->out, n);
+  s->sent += n;
+  grpc_endpoint_write(exec_ctx, s->p.client, &s->out, &s->write_done);
+}
+
+static void on_stream_read_done(grpc_exec_ctx *exec_ctx, void *arg,
+                                grpc_error *error) {
+  stream *s = arg;
+  if (error != GRPC_ERROR_NONE) return;
+  s->received += s->in.length;
+  if (s->received == s->total_size) {
+    set_done(&s->done);
+    return;
+  }
+  grpc_endpoint_read(exec_ctx, s->p.server, &s->in, &s->read_done);
+}
+
+static void run_stream(bool shm, size_t ring_size, size_t chunk_size,
+                       size_t total_size) {
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  stream s;
+  memset(&s, 0, sizeof(s));
+  s.p = create_pair(&exec_ctx, shm, ring_size);
+  s.chunk_size = chunk_size;
+  s.total_size = total_size;
+  gpr_slice_buffer_init(&s.out);
+  gpr_slice_buffer_init(&s.in);
+  grpc_closure_init(&s.write_done, on_stream_write_done, &s);
+  grpc_closure_init(&s.read_done, on_stream_read_done, &s);
+
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  grpc_endpoint_read(&exec_ctx, s.p.server, &s.in, &s.read_done);
+  on_stream_write_done(&exec_ctx, &s, GRPC_ERROR_NONE);
+  poll_until_done(&exec_ctx, &s.done);
+  double seconds = gpr_timespec_to_micros(
+                       gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start)) /
+                   1e6;
+
+  printf("%-4s stream    %8zu byte writes: %.1f MB/s\n", shm ? "shm" : "uds",
+         chunk_size, (double)total_size / seconds / 1e6);
+
+  destroy_pair(&exec_ctx, &s.p);
+  grpc_exec_ctx_finish(&exec_ctx);
+  gpr_slice_buffer_destroy(&s.out);
+  gpr_slice_buffer_destroy(&s.in);
+}
+
+static void destroy_pollset(grpc_exec_ctx *exec_ctx, void *p,
+                            grpc_error *error) {
+  grpc_pollset_destroy(p);
+}
+
+int main(int argc, char **argv) {
+  static const size_t msg_sizes[] = {1, 64, 1024, 16384, 65536, 1048576};
+  static const size_t write_sizes[] = {1024, 16384, 65536, 1048576};
+  grpc_closure destroyed;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  int rounds = 10000;
+  int total_mb = 256;
+  int ring_size = GRPC_SHM_DEFAULT_RING_SIZE;
+  size_t i;
+  int shm;
+
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("shared memory endpoint benchmarking tool");
+  gpr_cmdline_add_int(cmdline, "rounds", "Ping-pong rounds per message size",
+                      &rounds);
+  gpr_cmdline_add_int(cmdline, "total_mb",
+                      "Megabytes streamed per write size", &total_mb);
+  gpr_cmdline_add_int(cmdline, "ring_size", "Shared memory ring size",
+                      &ring_size);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  gpr_cmdline_destroy(cmdline);
+
+  grpc_test_init(argc, argv);
+  grpc_init();
+  if (!grpc_shm_endpoint_supported()) {
+    fprintf(stderr, "Shared memory endpoints are not supported here\n");
+    grpc_shutdown();
+    return 1;
+  }
+  g_pollset = gpr_malloc(grpc_pollset_size());
+  grpc_pollset_init(g_pollset, &g_mu);
+
+  for (i = 0; i < GPR_ARRAY_SIZE(msg_sizes); i++) {
+    /* fewer rounds for the big messages, which take longer */
+    int size_rounds = GPR_MAX(10, rounds / (1 + (int)(msg_sizes[i] / 16384)));
+    for (shm = 0; shm <= 1; shm++) {
+      run_ping_pong(shm, (size_t)ring_size, msg_sizes[i], size_rounds);
+    }
+  }
+  for (i = 0; i < GPR_ARRAY_SIZE(write_sizes); i++) {
+    for (shm = 0; shm <= 1; shm++) {
+      run_stream(shm, (size_t)ring_size, write_sizes[i],
+                 (size_t)total_mb * 1024 * 1024);
+    }
+  }
+
+  grpc_closure_init(&destroyed, destroy_pollset, g_pollset);
+  grpc_pollset_shutdown(&exec_ctx, g_pollset, &destroyed);
+  grpc_exec_ctx_finish(&exec_ctx);
+  grpc_shutdown();
+  gpr_free(g_pollset);
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Speed of the checks and conversions applied to every custom metadata
+   element and status message: header key and value validation, and the
+   percent encoding and decoding of grpc-message.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/lib/support/percent_encoding.h"
+
+typedef struct value {
+  const char *name;
+  const char *text;
+} value;
+
+static const value values[] = {
+    {"key", "x-request-trace-context"},
+    {"short", "gzip, deflate"},
+    {"agent", "grpc-c/1.1.0-dev (linux; chttp2; good)"},
+    {"status", "Deadline exceeded while waiting for the backend to respond to "
+               "the request; retry after 250ms"},
+    {"escaped", "Failed to parse \"config\": unexpected token '%' at line 3"},
+    {"token",
+     "Bearer eyJhbGciOiJSUzI1NiIsImtpZCI6IjFlOWdkazcifQ.ewogImlzcyI6ICJodHRw"
+     "Oi8vc2VydmVyLmV4YW1wbGUuY29tIiwKICJzdWIiOiAiMjQ4Mjg5NzYxMDAxIiwKICJhdWQi"
+     "OiAiczZCaGRSa3F0MyIsCiAibm9uY2UiOiAibi0wUzZfV3pBMk1qIiwKICJleHAiOiAxMzEx"
+     "MjgxOTcwLAogImlhdCI6IDEzMTEyODA5NzAKfQ.ggW8hZ1EuVLuxNuuIJKX_V8a_OMXzR0E"},
+};
+
+static double now_seconds(void) {
+  gpr_timespec t = gpr_now(GPR_CLOCK_MONOTONIC);
+  return (double)t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+/* runs 'op' on 'v' for at least min_seconds, returning MB/s of input */
+static double measure(int (*op)(gpr_slice v), gpr_slice v,
+                      double min_seconds) {
+  int iterations = 0;
+  int sink = 0;
+  double start = now_seconds();
+  double seconds;
+  do {
+    sink += op(v);
+    iterations++;
+  } while ((seconds = now_seconds() - start) < min_seconds);
+  GPR_ASSERT(sink >= 0);
+  return (double)GPR_SLICE_LENGTH(v) * iterations / seconds / 1e6;
+}
+
+static int validate_key(gpr_slice v) {
+  return grpc_header_key_is_legal((const char *)GPR_SLICE_START_PTR(v),
+                                  GPR_SLICE_LENGTH(v));
+}
+
+static int validate_value(gpr_slice v) {
+  return grpc_header_nonbin_value_is_legal(
+      (const char *)GPR_SLICE_START_PTR(v), GPR_SLICE_LENGTH(v));
+}
+
+static int encode(gpr_slice v) {
+  gpr_slice out = gpr_percent_encode_slice(
+      v, gpr_compatible_percent_encoding_unreserved_bytes);
+  int length = (int)GPR_SLICE_LENGTH(out);
+  gpr_slice_unref(out);
+  return length;
+}
+
+static int decode(gpr_slice v) {
+  gpr_slice out;
+  int length;
+  if (!gpr_strict_percent_decode_slice(
+          v, gpr_compatible_percent_encoding_unreserved_bytes, &out)) {
+    return 0;
+  }
+  length = (int)GPR_SLICE_LENGTH(out);
+  gpr_slice_unref(out);
+  return length;
+}
+
+int main(int argc, char **argv) {
+  int milliseconds = 200;
+  size_t i;
+
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("metadata validation and encoding benchmark");
+  gpr_cmdline_add_int(cmdline, "milliseconds",
+                      "Minimum time spent on each measurement", &milliseconds);
+  gpr_cmdline_parse(cmdline, argc, argv);
+
+  if (milliseconds <= 0) {
+    fprintf(stderr, "milliseconds must be > 0\n");
+    return 1;
+  }
+
+  grpc_init();
+  printf("%-8s %5s %12s %12s %12s %12s\n", "value", "size", "key MB/s",
+         "value MB/s", "encode MB/s", "decode MB/s");
+  for (i = 0; i < GPR_ARRAY_SIZE(values); i++) {
+    double min_seconds = milliseconds / 1000.0;
+    gpr_slice v = gpr_slice_from_copied_string(values[i].text);
+    gpr_slice encoded = gpr_percent_encode_slice(
+        v, gpr_compatible_percent_encoding_unreserved_bytes);
+    printf("%-8s %5d %12.1f %12.1f %12.1f %12.1f\n", values[i].name,
+           (int)GPR_SLICE_LENGTH(v), measure(validate_key, v, min_seconds),
+           measure(validate_value, v, min_seconds),
+           measure(encode, v, min_seconds),
+           measure(decode, encoded, min_seconds));
+    gpr_slice_unref(encoded);
+    gpr_slice_unref(v);
+  }
+  grpc_shutdown();
+
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
@@ -33,6 +33,8 @@
 
 #include "src/core/lib/support/percent_encoding.h"
 
+#include <string.h>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
@@ -130,6 +132,49 @@ static void test_nonconformant_vector(const char *encoded,
   gpr_slice_unref(encoded_slice);
 }
 
+/* Strings long enough for the vectorized scan, with one byte of every value
+   at every position, must encode and decode the same way as with a copy of
+   the table, which goes through the byte at a time code. */
+static void test_long_strings(const uint8_t *dict) {
+  uint8_t dict_copy[256 / 8];
+  char raw[40];
+  size_t length;
+  size_t pos;
+  int c;
+  memcpy(dict_copy, dict, sizeof(dict_copy));
+  memset(raw, 'a', sizeof(raw));
+  for (length = 0; length <= sizeof(raw); length += 13) {
+    for (pos = 0; pos < length; pos++) {
+      for (c = 0; c < 256; c++) {
+        raw[pos] = (char)c;
+        gpr_slice raw_slice = gpr_slice_from_copied_buffer(raw, length);
+        gpr_slice encoded = gpr_percent_encode_slice(raw_slice, dict);
+        gpr_slice expected = gpr_percent_encode_slice(raw_slice, dict_copy);
+        gpr_slice decoded;
+        gpr_slice expected_decoded;
+        GPR_ASSERT(0 == gpr_slice_cmp(encoded, expected));
+        GPR_ASSERT(gpr_strict_percent_decode_slice(encoded, dict, &decoded));
+        GPR_ASSERT(0 == gpr_slice_cmp(raw_slice, decoded));
+        gpr_slice_unref(decoded);
+        /* the raw string is itself valid only if it needs no encoding, or
+           happens to hold a percent encoded byte */
+        bool valid = gpr_strict_percent_decode_slice(raw_slice, dict, &decoded);
+        GPR_ASSERT(valid == gpr_strict_percent_decode_slice(
+                                raw_slice, dict_copy, &expected_decoded));
+        if (valid) {
+          GPR_ASSERT(0 == gpr_slice_cmp(decoded, expected_decoded));
+          gpr_slice_unref(decoded);
+          gpr_slice_unref(expected_decoded);
+        }
+        gpr_slice_unref(raw_slice);
+        gpr_slice_unref(encoded);
+        gpr_slice_unref(expected);
+      }
+      raw[pos] = 'a';
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   TEST_VECTOR(
@@ -153,5 +198,7 @@ int main(int argc, char **argv) {
                             gpr_url_percent_encoding_unreserved_bytes);
   TEST_NONCONFORMANT_VECTOR("\0", "\0",
                             gpr_url_percent_encoding_unreserved_bytes);
+  test_long_strings(gpr_url_percent_encoding_unreserved_bytes);
+  test_long_strings(gpr_compatible_percent_encoding_unreserved_bytes);
   return 0;
 }
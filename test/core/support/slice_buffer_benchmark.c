@@ -0,0 +1,176 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Cost of the slice buffer operations framing code is built on: moving a
+   frame's worth of bytes off the front of a buffer that keeps being refilled,
+   and using a buffer as a queue of slices. Reports the time per operation and
+   how many times the slice arrays had to be allocated or reallocated.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/slice_buffer.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+static gpr_allocation_functions g_default_allocation_functions;
+static int g_allocations;
+
+static void *counting_malloc(size_t size) {
+  g_allocations++;
+  return g_default_allocation_functions.malloc_fn(size);
+}
+
+static void *counting_realloc(void *ptr, size_t size) {
+  g_allocations++;
+  return g_default_allocation_functions.realloc_fn(ptr, size);
+}
+
+static double now_seconds(void) {
+  gpr_timespec t = gpr_now(GPR_CLOCK_MONOTONIC);
+  return (double)t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+/* static slices: neither refcounting nor splitting them allocates, so only
+   the slice buffers' own allocations are counted */
+static char g_data[8193];
+static gpr_slice g_data_slice;
+
+static gpr_slice read_slice(size_t length) {
+  return gpr_slice_sub_no_ref(g_data_slice, 0, length);
+}
+
+/* like a transport parsing frames off the bytes read from the network:
+   batches of 'batch' reads of 'read_size' bytes arrive in src, and whole
+   frames are moved out to dst */
+static void move_first(int ops, int batch, size_t read_size,
+                       size_t frame_size) {
+  gpr_slice_buffer src;
+  gpr_slice_buffer dst;
+  int i;
+  int j;
+  gpr_slice_buffer_init(&src);
+  gpr_slice_buffer_init(&dst);
+  for (i = 0; i < ops; i++) {
+    while (src.length <= frame_size) {
+      for (j = 0; j < batch; j++) {
+        gpr_slice_buffer_add_indexed(&src, read_slice(read_size));
+      }
+    }
+    gpr_slice_buffer_move_first(&src, frame_size, &dst);
+    gpr_slice_buffer_reset_and_unref(&dst);
+  }
+  gpr_slice_buffer_destroy(&src);
+  gpr_slice_buffer_destroy(&dst);
+}
+
+static void move_first_small_reads(int ops) { move_first(ops, 1, 100, 4096); }
+
+static void move_first_large_reads(int ops) { move_first(ops, 1, 8192, 300); }
+
+static void move_first_read_batches(int ops) {
+  move_first(ops, 64, 8192, 1000);
+}
+
+/* a queue of pending writes 'depth' deep */
+static void take_first(int ops, int depth) {
+  gpr_slice_buffer queue;
+  int i;
+  gpr_slice_buffer_init(&queue);
+  for (i = 0; i < depth; i++) {
+    gpr_slice_buffer_add_indexed(&queue, read_slice(100));
+  }
+  for (i = 0; i < ops; i++) {
+    gpr_slice_buffer_add_indexed(&queue, read_slice(100));
+    gpr_slice_unref(gpr_slice_buffer_take_first(&queue));
+  }
+  gpr_slice_buffer_destroy(&queue);
+}
+
+static void take_first_shallow(int ops) { take_first(ops, 4); }
+
+static void take_first_deep(int ops) { take_first(ops, 64); }
+
+typedef struct scenario {
+  const char *name;
+  void (*run)(int ops);
+} scenario;
+
+static const scenario scenarios[] = {
+    {"move_first_small_reads", move_first_small_reads},
+    {"move_first_large_reads", move_first_large_reads},
+    {"move_first_read_batches", move_first_read_batches},
+    {"take_first_shallow", take_first_shallow},
+    {"take_first_deep", take_first_deep},
+};
+
+int main(int argc, char **argv) {
+  int ops = 1000000;
+  gpr_allocation_functions counting;
+  size_t i;
+
+  gpr_cmdline *cmdline = gpr_cmdline_create("slice buffer benchmark");
+  gpr_cmdline_add_int(cmdline, "ops", "Operations per scenario", &ops);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  if (ops <= 0) {
+    fprintf(stderr, "ops must be > 0\n");
+    return 1;
+  }
+
+  memset(g_data, 'x', sizeof(g_data) - 1);
+  g_data_slice = gpr_slice_from_static_string(g_data);
+
+  g_default_allocation_functions = gpr_get_allocation_functions();
+  counting = g_default_allocation_functions;
+  counting.malloc_fn = counting_malloc;
+  counting.realloc_fn = counting_realloc;
+  gpr_set_allocation_functions(counting);
+
+  printf("%-24s %10s %16s\n", "scenario", "ns/op", "allocs/1000 ops");
+  for (i = 0; i < GPR_ARRAY_SIZE(scenarios); i++) {
+    double start = now_seconds();
+    g_allocations = 0;
+    scenarios[i].run(ops);
+    printf("%-24s %10.1f %16.3f\n", scenarios[i].name,
+           (now_seconds() - start) * 1e9 / ops, g_allocations * 1000.0 / ops);
+  }
+
+  gpr_set_allocation_functions(g_default_allocation_functions);
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
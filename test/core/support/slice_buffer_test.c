@@ -31,8 +31,11 @@
  *
  */
 
+#include <stdio.h>
+
 #include <grpc/support/log.h>
 #include <grpc/support/slice_buffer.h>
+#include <grpc/support/useful.h>
 #include "test/core/util/test_config.h"
 
 void test_slice_buffer_add() {
@@ -119,11 +122,94 @@ void test_slice_buffer_move_first() {
   GPR_ASSERT(dst.length == dst.length);
 }
 
+static gpr_slice numbered_slice(int n) {
+  char buf[16];
+  sprintf(buf, "slice %d", n);
+  return gpr_slice_from_copied_string(buf);
+}
+
+static void expect_numbered_slice(gpr_slice slice, int n) {
+  gpr_slice expected = numbered_slice(n);
+  GPR_ASSERT(0 == gpr_slice_cmp(slice, expected));
+  gpr_slice_unref(expected);
+  gpr_slice_unref(slice);
+}
+
+/* slices taken off the front while others are added at the back must come
+   out in order, whether the room they leave is reused or the buffer grows */
+void test_slice_buffer_take_first() {
+  gpr_slice_buffer buf;
+  int added = 0;
+  int taken = 0;
+  int round;
+  int i;
+
+  gpr_slice_buffer_init(&buf);
+  for (round = 1; round <= 40; round++) {
+    for (i = 0; i < round % 7 + 1; i++) {
+      gpr_slice_buffer_add_indexed(&buf, numbered_slice(added++));
+    }
+    for (i = 0; i < round % 5 && taken < added; i++) {
+      expect_numbered_slice(gpr_slice_buffer_take_first(&buf), taken++);
+    }
+    GPR_ASSERT(buf.count == (size_t)(added - taken));
+  }
+  while (taken < added) {
+    expect_numbered_slice(gpr_slice_buffer_take_first(&buf), taken++);
+  }
+  GPR_ASSERT(buf.count == 0);
+  GPR_ASSERT(buf.length == 0);
+  gpr_slice_buffer_destroy(&buf);
+}
+
+/* swapping must carry over slices that no longer start at the beginning of
+   their storage, inlined or not */
+void test_slice_buffer_swap() {
+  size_t counts[] = {3, 20};
+  size_t a;
+  size_t b;
+  int i;
+
+  for (a = 0; a < GPR_ARRAY_SIZE(counts); a++) {
+    for (b = 0; b < GPR_ARRAY_SIZE(counts); b++) {
+      gpr_slice_buffer x;
+      gpr_slice_buffer y;
+      gpr_slice_buffer_init(&x);
+      gpr_slice_buffer_init(&y);
+      for (i = 0; i < (int)counts[a]; i++) {
+        gpr_slice_buffer_add_indexed(&x, numbered_slice(i));
+      }
+      for (i = 0; i < (int)counts[b]; i++) {
+        gpr_slice_buffer_add_indexed(&y, numbered_slice(100 + i));
+      }
+      gpr_slice_unref(gpr_slice_buffer_take_first(&x));
+      gpr_slice_unref(gpr_slice_buffer_take_first(&y));
+      gpr_slice_unref(gpr_slice_buffer_take_first(&y));
+      gpr_slice_buffer_swap(&x, &y);
+      GPR_ASSERT(x.count == counts[b] - 2);
+      GPR_ASSERT(y.count == counts[a] - 1);
+      for (i = 2; i < (int)counts[b]; i++) {
+        expect_numbered_slice(gpr_slice_buffer_take_first(&x), 100 + i);
+      }
+      for (i = 1; i < (int)counts[a]; i++) {
+        expect_numbered_slice(gpr_slice_buffer_take_first(&y), i);
+      }
+      /* and both remain usable */
+      gpr_slice_buffer_add(&x, numbered_slice(0));
+      gpr_slice_buffer_add(&y, numbered_slice(0));
+      gpr_slice_buffer_destroy(&x);
+      gpr_slice_buffer_destroy(&y);
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
 
   test_slice_buffer_add();
   test_slice_buffer_move_first();
+  test_slice_buffer_take_first();
+  test_slice_buffer_swap();
 
   return 0;
 }
@@ -33,10 +33,14 @@
 
 #include <grpc/support/slice.h>
 
+#include <errno.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include "src/core/lib/support/slice_mapped_file.h"
+#include "src/core/lib/support/tmpfile.h"
 #include "test/core/util/test_config.h"
 
 #define LOG_TEST_NAME(x) gpr_log(GPR_INFO, "%s", x);
@@ -248,6 +252,74 @@ static void test_slice_from_copied_string_works(void) {
   gpr_slice_unref(slice);
 }
 
+static void test_slice_from_mapped_file(void) {
+#ifdef GPR_POSIX_FILE
+  /* spans a few pages, and starts and ends away from page boundaries */
+  const size_t file_length = 20000;
+  const int64_t offset = 4100;
+  const size_t length = 9000;
+  FILE *file;
+  uint8_t *data;
+  gpr_slice slice;
+  gpr_slice sub;
+  gpr_slice heap;
+  int fd;
+  int64_t range_offset;
+  size_t i;
+
+  LOG_TEST_NAME("test_slice_from_mapped_file");
+
+  data = gpr_malloc(file_length);
+  for (i = 0; i < file_length; i++) {
+    data[i] = (uint8_t)(i * 7);
+  }
+  file = gpr_tmpfile("slice_test", NULL);
+  GPR_ASSERT(file != NULL);
+  GPR_ASSERT(fwrite(data, 1, file_length, file) == file_length);
+  GPR_ASSERT(fflush(file) == 0);
+
+  GPR_ASSERT(gpr_slice_from_mapped_file(fileno(file), offset, length,
+                                        GPR_SLICE_MAP_ADVICE_SEQUENTIAL,
+                                        &slice));
+  /* the slice holds on to the file */
+  GPR_ASSERT(fclose(file) == 0);
+  GPR_ASSERT(GPR_SLICE_LENGTH(slice) == length);
+  GPR_ASSERT(0 == memcmp(data + offset, GPR_SLICE_START_PTR(slice), length));
+
+  /* derived slices share the mapping and know where they are in the file */
+  sub = gpr_slice_sub(slice, 1000, 2000);
+  gpr_slice_unref(slice);
+  GPR_ASSERT(gpr_slice_get_mapped_file_range(sub, &fd, &range_offset));
+  GPR_ASSERT(range_offset == offset + 1000);
+  GPR_ASSERT(0 == memcmp(data + offset + 1000, GPR_SLICE_START_PTR(sub), 1000));
+  gpr_slice_unref(sub);
+
+  heap = gpr_slice_from_copied_buffer((const char *)data, 10);
+  GPR_ASSERT(!gpr_slice_get_mapped_file_range(heap, &fd, &range_offset));
+  gpr_slice_unref(heap);
+
+  file = gpr_tmpfile("slice_test", NULL);
+  GPR_ASSERT(file != NULL);
+  GPR_ASSERT(fwrite(data, 1, file_length, file) == file_length);
+  GPR_ASSERT(fflush(file) == 0);
+  GPR_ASSERT(gpr_slice_from_mapped_file(fileno(file), 10, 0,
+                                        GPR_SLICE_MAP_ADVICE_NORMAL, &slice));
+  GPR_ASSERT(GPR_SLICE_LENGTH(slice) == 0);
+  gpr_slice_unref(slice);
+  /* ranges past the end of the file are refused */
+  GPR_ASSERT(!gpr_slice_from_mapped_file(fileno(file), 10, file_length,
+                                         GPR_SLICE_MAP_ADVICE_NORMAL, &slice));
+  GPR_ASSERT(errno == EINVAL);
+  GPR_ASSERT(!gpr_slice_from_mapped_file(fileno(file), -1, 10,
+                                         GPR_SLICE_MAP_ADVICE_NORMAL, &slice));
+  GPR_ASSERT(fclose(file) == 0);
+  GPR_ASSERT(!gpr_slice_from_mapped_file(-1, 0, 10,
+                                         GPR_SLICE_MAP_ADVICE_NORMAL, &slice));
+
+  gpr_free(data);
+#endif
+}
+
 int main(int argc, char **argv) {
   unsigned length;
   grpc_test_init(argc, argv);
@@ -261,5 +333,6 @@ int main(int argc, char **argv) {
     test_slice_split_tail_works(length);
   }
   test_slice_from_copied_string_works();
+  test_slice_from_mapped_file();
   return 0;
 }
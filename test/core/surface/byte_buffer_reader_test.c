@@ -43,6 +43,7 @@
 #include "test/core/util/test_config.h"
 
 #include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/support/tmpfile.h"
 
 #include <string.h>
 
@@ -237,6 +238,40 @@ static void test_readall(void) {
   grpc_byte_buffer_destroy(buffer);
 }
 
+static void test_readall_one_slice(void) {
+  char lotsa_as[512];
+  gpr_slice slice;
+  grpc_byte_buffer *buffer;
+  grpc_byte_buffer_reader reader;
+  gpr_slice slice_out;
+
+  LOG_TEST("test_readall_one_slice");
+
+  memset(lotsa_as, 'a', 512);
+  slice = gpr_slice_from_copied_buffer(lotsa_as, 512);
+  buffer = grpc_raw_byte_buffer_create(&slice, 1);
+
+  /* readall always hands out a copy the caller can modify */
+  GPR_ASSERT(grpc_byte_buffer_reader_init(&reader, buffer) &&
+             "Couldn't init byte buffer reader");
+  slice_out = grpc_byte_buffer_reader_readall(&reader);
+  GPR_ASSERT(GPR_SLICE_START_PTR(slice_out) != GPR_SLICE_START_PTR(slice));
+  GPR_ASSERT(0 == gpr_slice_cmp(slice_out, slice));
+  gpr_slice_unref(slice_out);
+  grpc_byte_buffer_reader_destroy(&reader);
+
+  /* readall_shared shares it */
+  GPR_ASSERT(grpc_byte_buffer_reader_init(&reader, buffer) &&
+             "Couldn't init byte buffer reader");
+  slice_out = grpc_byte_buffer_reader_readall_shared(&reader);
+  GPR_ASSERT(GPR_SLICE_START_PTR(slice_out) == GPR_SLICE_START_PTR(slice));
+  GPR_ASSERT(GPR_SLICE_LENGTH(slice_out) == 512);
+  gpr_slice_unref(slice_out);
+  gpr_slice_unref(slice);
+  grpc_byte_buffer_reader_destroy(&reader);
+  grpc_byte_buffer_destroy(buffer);
+}
+
 static void test_byte_buffer_copy(void) {
   char *lotsa_as[512];
   char *lotsa_bs[1024];
@@ -274,6 +309,38 @@ static void test_byte_buffer_copy(void) {
   grpc_byte_buffer_destroy(copied_buffer);
 }
 
+static void test_byte_buffer_from_file(void) {
+#ifdef GPR_POSIX_FILE
+  static const char content[] = "the file contents";
+  FILE *file;
+  grpc_byte_buffer *buffer;
+  grpc_byte_buffer_reader reader;
+  gpr_slice slice_out;
+
+  LOG_TEST("test_byte_buffer_from_file");
+
+  file = gpr_tmpfile("byte_buffer_reader_test", NULL);
+  GPR_ASSERT(file != NULL);
+  GPR_ASSERT(fwrite(content, 1, strlen(content), file) == strlen(content));
+  GPR_ASSERT(fflush(file) == 0);
+
+  buffer = grpc_raw_byte_buffer_from_file(fileno(file), 4, 4);
+  /* the buffer holds on to the file */
+  fclose(file);
+  GPR_ASSERT(buffer != NULL);
+  GPR_ASSERT(grpc_byte_buffer_length(buffer) == 4);
+  GPR_ASSERT(grpc_byte_buffer_reader_init(&reader, buffer) &&
+             "Couldn't init byte buffer reader");
+  slice_out = grpc_byte_buffer_reader_readall(&reader);
+  GPR_ASSERT(gpr_slice_str_cmp(slice_out, "file") == 0);
+  gpr_slice_unref(slice_out);
+  grpc_byte_buffer_reader_destroy(&reader);
+  grpc_byte_buffer_destroy(buffer);
+
+  GPR_ASSERT(grpc_raw_byte_buffer_from_file(-1, 0, 4) == NULL);
+#endif
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   test_read_one_slice();
@@ -285,5 +352,7 @@ int main(int argc, char **argv) {
   test_byte_buffer_from_reader();
   test_byte_buffer_copy();
   test_readall();
+  test_readall_one_slice();
+  test_byte_buffer_from_file();
   return 0;
 }
@@ -252,6 +252,114 @@ static void test_too_many_plucks(void) {
   grpc_exec_ctx_finish(&exec_ctx);
 }
 
+static void test_sharded_shards(void) {
+  grpc_completion_queue *cc;
+  grpc_completion_queue *home;
+  size_t i;
+  int found = 0;
+
+  LOG_TEST("test_sharded_shards");
+
+  cc = grpc_completion_queue_create(NULL);
+  GPR_ASSERT(grpc_cq_num_shards(cc) == 1);
+  GPR_ASSERT(grpc_cq_shard(cc, 0) == cc);
+  GPR_ASSERT(grpc_cq_shard_for_current_thread(cc) == cc);
+  shutdown_and_destroy(cc);
+
+  cc = grpc_completion_queue_create_sharded(4);
+  GPR_ASSERT(grpc_cq_num_shards(cc) == 4);
+  GPR_ASSERT(grpc_cq_shard(cc, 0) == cc);
+  home = grpc_cq_shard_for_current_thread(cc);
+  for (i = 0; i < 4; i++) {
+    if (grpc_cq_shard(cc, i) == home) found = 1;
+  }
+  GPR_ASSERT(found);
+  GPR_ASSERT(grpc_cq_shard_for_current_thread(cc) == home);
+  shutdown_and_destroy(cc);
+}
+
+static void test_sharded_next_takes_from_all_shards(void) {
+  grpc_event ev;
+  grpc_completion_queue *cc;
+  grpc_cq_completion completions[4];
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  void *tags[4];
+  int seen[4] = {0, 0, 0, 0};
+  size_t i, j;
+
+  LOG_TEST("test_sharded_next_takes_from_all_shards");
+
+  cc = grpc_completion_queue_create_sharded(4);
+  for (i = 0; i < 4; i++) {
+    tags[i] = create_test_tag();
+    grpc_cq_begin_op(grpc_cq_shard(cc, i), tags[i]);
+    grpc_cq_end_op(&exec_ctx, grpc_cq_shard(cc, i), tags[i], GRPC_ERROR_NONE,
+                   do_nothing_end_completion, NULL, &completions[i]);
+  }
+  for (i = 0; i < 4; i++) {
+    ev = grpc_completion_queue_next(cc, gpr_inf_past(GPR_CLOCK_REALTIME), NULL);
+    GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+    for (j = 0; j < 4; j++) {
+      if (ev.tag == tags[j]) seen[j]++;
+    }
+  }
+  for (i = 0; i < 4; i++) {
+    GPR_ASSERT(seen[i] == 1);
+  }
+  ev = grpc_completion_queue_next(cc, gpr_inf_past(GPR_CLOCK_REALTIME), NULL);
+  GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+
+  shutdown_and_destroy(cc);
+  grpc_exec_ctx_finish(&exec_ctx);
+}
+
+typedef struct {
+  grpc_completion_queue *cc;
+  gpr_event home;
+  gpr_event done;
+} sharded_waiter;
+
+static void sharded_wait_one(void *arg) {
+  sharded_waiter *w = arg;
+  grpc_event ev;
+  gpr_event_set(&w->home, grpc_cq_shard_for_current_thread(w->cc));
+  ev = grpc_completion_queue_next(w->cc, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(10),
+                                  NULL);
+  GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+  gpr_event_set(&w->done, (void *)(intptr_t)1);
+}
+
+/* an event queued on a shard nobody waits on wakes up a waiter elsewhere */
+static void test_sharded_wakeup(void) {
+  sharded_waiter w;
+  grpc_completion_queue *home;
+  grpc_completion_queue *other;
+  grpc_cq_completion completion;
+  grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
+  gpr_thd_id id;
+  void *tag = create_test_tag();
+
+  LOG_TEST("test_sharded_wakeup");
+
+  w.cc = grpc_completion_queue_create_sharded(2);
+  gpr_event_init(&w.home);
+  gpr_event_init(&w.done);
+  GPR_ASSERT(gpr_thd_new(&id, sharded_wait_one, &w, NULL));
+  home = gpr_event_wait(&w.home, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(10));
+  GPR_ASSERT(home != NULL);
+  other = grpc_cq_shard(w.cc, 0) == home ? grpc_cq_shard(w.cc, 1)
+                                         : grpc_cq_shard(w.cc, 0);
+  /* give the waiter time to block */
+  gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(100));
+  grpc_cq_begin_op(other, tag);
+  grpc_cq_end_op(&exec_ctx, other, tag, GRPC_ERROR_NONE,
+                 do_nothing_end_completion, NULL, &completion);
+  grpc_exec_ctx_finish(&exec_ctx);
+  GPR_ASSERT(gpr_event_wait(&w.done, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(5)));
+
+  shutdown_and_destroy(w.cc);
+}
+
 #define TEST_THREAD_EVENTS 10000
 
 typedef struct test_thread_options {
@@ -276,6 +384,8 @@ static void free_completion(grpc_exec_ctx *exec_ctx, void *arg,
 
 static void producer_thread(void *arg) {
   test_thread_options *opt = arg;
+  /* spread the events over the shards of a sharded queue */
+  grpc_completion_queue *cc = grpc_cq_shard_for_current_thread(opt->cc);
   int i;
   grpc_exec_ctx exec_ctx = GRPC_EXEC_CTX_INIT;
 
@@ -285,7 +395,7 @@ static void producer_thread(void *arg) {
 
   gpr_log(GPR_INFO, "producer %d phase 1", opt->id);
   for (i = 0; i < TEST_THREAD_EVENTS; i++) {
-    grpc_cq_begin_op(opt->cc, (void *)(intptr_t)1);
+    grpc_cq_begin_op(cc, (void *)(intptr_t)1);
   }
 
   gpr_log(GPR_INFO, "producer %d phase 1 done", opt->id);
@@ -294,7 +404,7 @@ static void producer_thread(void *arg) {
 
   gpr_log(GPR_INFO, "producer %d phase 2", opt->id);
   for (i = 0; i < TEST_THREAD_EVENTS; i++) {
-    grpc_cq_end_op(&exec_ctx, opt->cc, (void *)(intptr_t)1, GRPC_ERROR_NONE,
+    grpc_cq_end_op(&exec_ctx, cc, (void *)(intptr_t)1, GRPC_ERROR_NONE,
                    free_completion, NULL,
                    gpr_malloc(sizeof(grpc_cq_completion)));
     opt->events_triggered++;
@@ -339,18 +449,23 @@ static void consumer_thread(void *arg) {
   }
 }
 
-static void test_threading(size_t producers, size_t consumers) {
+/* num_shards is 0 for a queue that isn't sharded */
+static void test_threading(size_t producers, size_t consumers,
+                           size_t num_shards) {
   test_thread_options *options =
       gpr_malloc((producers + consumers) * sizeof(test_thread_options));
   gpr_event phase1 = GPR_EVENT_INIT;
   gpr_event phase2 = GPR_EVENT_INIT;
-  grpc_completion_queue *cc = grpc_completion_queue_create(NULL);
+  grpc_completion_queue *cc =
+      num_shards == 0 ? grpc_completion_queue_create(NULL)
+                      : grpc_completion_queue_create_sharded(num_shards);
   size_t i;
   size_t total_consumed = 0;
   static int optid = 101;
 
-  gpr_log(GPR_INFO, "%s: %" PRIuPTR " producers, %" PRIuPTR " consumers",
-          "test_threading", producers, consumers);
+  gpr_log(GPR_INFO, "%s: %" PRIuPTR " producers, %" PRIuPTR
+                    " consumers, %" PRIuPTR " shards",
+          "test_threading", producers, consumers, num_shards);
 
   /* start all threads: they will wait for phase1 */
   for (i = 0; i < producers + consumers; i++) {
@@ -423,10 +538,16 @@ int main(int argc, char **argv) {
   test_pluck();
   test_pluck_after_shutdown();
   test_too_many_plucks();
-  test_threading(1, 1);
-  test_threading(1, 10);
-  test_threading(10, 1);
-  test_threading(10, 10);
+  test_threading(1, 1, 0);
+  test_threading(1, 10, 0);
+  test_threading(10, 1, 0);
+  test_threading(10, 10, 0);
+  test_sharded_shards();
+  test_sharded_next_takes_from_all_shards();
+  test_sharded_wakeup();
+  test_threading(1, 1, 4);
+  test_threading(10, 1, 4);
+  test_threading(10, 10, 4);
   grpc_shutdown();
   return 0;
 }
@@ -88,6 +88,46 @@ static gpr_slice base64_decode_with_length(const char *s,
   EXPECT_SLICE_EQ(           \
       s, grpc_chttp2_base64_decode_with_length(base64_encode(s), strlen(s)));
 
+/* inputs long enough to go through the vectorized code, round tripped
+   through the encoder, and with an invalid character at each position */
+static void test_long_inputs(void) {
+  char data[200];
+  size_t length;
+  size_t i;
+  for (length = 0; length <= sizeof(data); length++) {
+    gpr_slice input;
+    gpr_slice encoded;
+    gpr_slice decoded;
+    for (i = 0; i < length; i++) {
+      data[i] = (char)(i * 167 + length);
+    }
+    input = gpr_slice_from_copied_buffer(data, length);
+    encoded = grpc_chttp2_base64_encode(input);
+    decoded = grpc_chttp2_base64_decode_with_length(encoded, length);
+    if (0 != gpr_slice_cmp(input, decoded)) {
+      gpr_log(GPR_ERROR, "FAILED: round trip of %d bytes", (int)length);
+      all_ok = 0;
+    }
+    gpr_slice_unref(decoded);
+    for (i = 0; i < GPR_SLICE_LENGTH(encoded); i += 7) {
+      gpr_slice corrupt = gpr_slice_malloc(GPR_SLICE_LENGTH(encoded));
+      memcpy(GPR_SLICE_START_PTR(corrupt), GPR_SLICE_START_PTR(encoded),
+             GPR_SLICE_LENGTH(encoded));
+      GPR_SLICE_START_PTR(corrupt)[i] = (uint8_t)(i % 2 ? ':' : 0xc1);
+      decoded = grpc_chttp2_base64_decode_with_length(corrupt, length);
+      if (GPR_SLICE_LENGTH(decoded) != 0) {
+        gpr_log(GPR_ERROR, "FAILED: accepted invalid character at %d of %d",
+                (int)i, (int)GPR_SLICE_LENGTH(encoded));
+        all_ok = 0;
+      }
+      gpr_slice_unref(decoded);
+      gpr_slice_unref(corrupt);
+    }
+    gpr_slice_unref(encoded);
+    gpr_slice_unref(input);
+  }
+}
+
 int main(int argc, char **argv) {
   /* ENCODE_AND_DECODE tests grpc_chttp2_base64_decode_with_length(), which
      takes encoded base64 strings without pad chars, but output length is
@@ -140,5 +180,7 @@ int main(int argc, char **argv) {
   EXPECT_SLICE_EQ("", base64_decode_with_length("Zm:v", 3));
   EXPECT_SLICE_EQ("", base64_decode_with_length("Zm=v", 3));
 
+  test_long_inputs();
+
   return all_ok ? 0 : 1;
 }
@@ -0,0 +1,141 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Throughput of the base64 and base64+huffman encoders used for binary
+   metadata values, and of the base64 decoder, in MB/s of binary data.
+ */
+
+#include <stdio.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+#include "src/core/ext/transport/chttp2/transport/bin_decoder.h"
+#include "src/core/ext/transport/chttp2/transport/bin_encoder.h"
+
+static double now_seconds(void) {
+  gpr_timespec t = gpr_now(GPR_CLOCK_MONOTONIC);
+  return (double)t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void run_one(size_t length, double min_seconds) {
+  gpr_slice value = gpr_slice_malloc(length);
+  gpr_slice base64 = gpr_empty_slice();
+  gpr_slice out;
+  double encode_mbps;
+  double huffman_mbps;
+  double decode_mbps;
+  double start;
+  double seconds;
+  int iterations;
+  uint32_t state = 1;
+  size_t i;
+
+  /* trace contexts and auth tokens are effectively random bytes */
+  for (i = 0; i < length; i++) {
+    state = state * 1103515245 + 12345;
+    GPR_SLICE_START_PTR(value)[i] = (uint8_t)(state >> 16);
+  }
+
+  iterations = 0;
+  start = now_seconds();
+  do {
+    gpr_slice_unref(base64);
+    base64 = grpc_chttp2_base64_encode(value);
+    iterations++;
+  } while ((seconds = now_seconds() - start) < min_seconds);
+  encode_mbps = (double)length * iterations / seconds / 1e6;
+
+  iterations = 0;
+  start = now_seconds();
+  do {
+    out = grpc_chttp2_base64_encode_and_huffman_compress_impl(value);
+    gpr_slice_unref(out);
+    iterations++;
+  } while ((seconds = now_seconds() - start) < min_seconds);
+  huffman_mbps = (double)length * iterations / seconds / 1e6;
+
+  iterations = 0;
+  start = now_seconds();
+  do {
+    out = grpc_chttp2_base64_decode_with_length(base64, length);
+    GPR_ASSERT(GPR_SLICE_LENGTH(out) == length);
+    gpr_slice_unref(out);
+    iterations++;
+  } while ((seconds = now_seconds() - start) < min_seconds);
+  decode_mbps = (double)length * iterations / seconds / 1e6;
+
+  printf("%9" PRIuPTR " %12.1f %12.1f %12.1f\n", length, encode_mbps,
+         huffman_mbps, decode_mbps);
+
+  gpr_slice_unref(base64);
+  gpr_slice_unref(value);
+}
+
+int main(int argc, char **argv) {
+  static const size_t default_lengths[] = {16, 64, 256, 1024, 4096, 65536};
+  int length = 0;
+  int milliseconds = 200;
+  size_t i;
+
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("binary metadata encoding benchmark");
+  gpr_cmdline_add_int(cmdline, "value_size",
+                      "Size of the binary values (default: 16B to 64KB)",
+                      &length);
+  gpr_cmdline_add_int(cmdline, "milliseconds",
+                      "Minimum time spent on each measurement", &milliseconds);
+  gpr_cmdline_parse(cmdline, argc, argv);
+
+  if (length < 0 || milliseconds <= 0) {
+    fprintf(stderr, "value_size and milliseconds must be > 0\n");
+    return 1;
+  }
+
+  grpc_init();
+  printf("%9s %12s %12s %12s\n", "size", "base64 MB/s", "+huff MB/s",
+         "decode MB/s");
+  for (i = 0; i < GPR_ARRAY_SIZE(default_lengths); i++) {
+    if (length > 0 && i > 0) break;
+    run_one(length > 0 ? (size_t)length : default_lengths[i],
+            milliseconds / 1000.0);
+  }
+  grpc_shutdown();
+
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
@@ -104,6 +104,47 @@ static void expect_combined_equiv(const char *s, size_t len, int line) {
 #define EXPECT_COMBINED_EQUIV(x) \
   expect_combined_equiv(x, sizeof(x) - 1, __LINE__)
 
+/* straightforward encoder to check the optimized one against */
+static gpr_slice reference_base64(const uint8_t *in, size_t length) {
+  static const char alphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  gpr_slice out = gpr_slice_malloc((length * 8 + 5) / 6);
+  uint8_t *p = GPR_SLICE_START_PTR(out);
+  uint32_t bits = 0;
+  size_t nbits = 0;
+  size_t i;
+  for (i = 0; i < length; i++) {
+    bits = (bits << 8) | in[i];
+    nbits += 8;
+    while (nbits >= 6) {
+      nbits -= 6;
+      *p++ = (uint8_t)alphabet[(bits >> nbits) & 0x3f];
+    }
+  }
+  if (nbits > 0) *p++ = (uint8_t)alphabet[(bits << (6 - nbits)) & 0x3f];
+  GPR_ASSERT(p == GPR_SLICE_END_PTR(out));
+  return out;
+}
+
+/* inputs long enough to go through the vectorized code, with every possible
+   tail after the whole blocks */
+static void test_long_inputs(void) {
+  uint8_t data[256];
+  size_t length;
+  size_t i;
+  for (length = 0; length <= sizeof(data); length++) {
+    gpr_slice input;
+    for (i = 0; i < length; i++) {
+      data[i] = (uint8_t)(i * 167 + length);
+    }
+    input = gpr_slice_from_copied_buffer((const char *)data, length);
+    expect_slice_eq(reference_base64(data, length),
+                    grpc_chttp2_base64_encode(input), "long base64", __LINE__);
+    gpr_slice_unref(input);
+    expect_combined_equiv((const char *)data, length, __LINE__);
+  }
+}
+
 static void expect_binary_header(const char *hdr, int binary) {
   if (grpc_is_binary_header(hdr, strlen(hdr)) != binary) {
     gpr_log(GPR_ERROR, "FAILED: expected header '%s' to be %s", hdr,
@@ -179,6 +220,8 @@ int main(int argc, char **argv) {
       "\xe0\xe1\xe2\xe3\xe4\xe5\xe6\xe7\xe8\xe9\xea\xeb\xec\xed\xee\xef"
       "\xf0\xf1\xf2\xf3\xf4\xf5\xf6\xf7\xf8\xf9\xfa\xfb\xfc\xfd\xfe\xff");
 
+  test_long_inputs();
+
   expect_binary_header("foo-bin", 1);
   expect_binary_header("foo-bar", 0);
   expect_binary_header("-bin", 0);
@@ -0,0 +1,247 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <grpc++/channel.h>
+#include <grpc++/client_context.h>
+#include <grpc++/create_channel.h>
+#include <grpc++/security/credentials.h>
+#include <grpc++/security/server_credentials.h>
+#include <grpc++/server.h>
+#include <grpc++/server_builder.h>
+#include <grpc++/server_context.h>
+#include <grpc++/sharded_completion_queue.h>
+#include <grpc/grpc.h>
+#include <grpc/support/time.h>
+#include <gtest/gtest.h>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+using grpc::testing::EchoRequest;
+using grpc::testing::EchoResponse;
+
+namespace grpc {
+namespace testing {
+
+namespace {
+
+// Serves one Echo call, then requests the next one.
+class CallData {
+ public:
+  CallData(EchoTestService::AsyncService* service, ServerCompletionQueue* cq,
+           std::atomic<int>* live, std::atomic<int>* served)
+      : service_(service),
+        cq_(cq),
+        live_(live),
+        served_(served),
+        responder_(&ctx_),
+        finishing_(false) {
+    live_->fetch_add(1);
+    service_->RequestEcho(&ctx_, &request_, &responder_, cq_, cq_, this);
+  }
+
+  ~CallData() { live_->fetch_sub(1); }
+
+  void Proceed(bool ok) {
+    if (!ok || finishing_) {
+      delete this;
+      return;
+    }
+    new CallData(service_, cq_, live_, served_);
+    served_->fetch_add(1);
+    response_.set_message(request_.message());
+    finishing_ = true;
+    responder_.Finish(response_, Status::OK, this);
+  }
+
+ private:
+  EchoTestService::AsyncService* service_;
+  ServerCompletionQueue* cq_;
+  std::atomic<int>* live_;
+  std::atomic<int>* served_;
+  ServerContext ctx_;
+  EchoRequest request_;
+  EchoResponse response_;
+  ServerAsyncResponseWriter<EchoResponse> responder_;
+  bool finishing_;
+};
+
+class ShardedCqEnd2endTest : public ::testing::Test {
+ protected:
+  ShardedCqEnd2endTest() : live_calls_(0), served_calls_(0) {}
+
+  void StartServer(size_t num_shards) {
+    port_ = grpc_pick_unused_port_or_die();
+    std::ostringstream server_address;
+    server_address << "localhost:" << port_;
+    ServerBuilder builder;
+    builder.AddListeningPort(server_address.str(),
+                             InsecureServerCredentials());
+    builder.RegisterService(&service_);
+    cq_ = builder.AddShardedCompletionQueue(num_shards);
+    ASSERT_TRUE(cq_ != nullptr);
+    EXPECT_EQ(num_shards, cq_->NumShards());
+    server_ = builder.BuildAndStart();
+    stub_ = EchoTestService::NewStub(
+        CreateChannel(server_address.str(), InsecureChannelCredentials()));
+  }
+
+  void RequestCall() {
+    new CallData(&service_, cq_.get(), &live_calls_, &served_calls_);
+  }
+
+  void Poll() {
+    void* tag;
+    bool ok;
+    while (cq_->Next(&tag, &ok)) {
+      static_cast<CallData*>(tag)->Proceed(ok);
+    }
+  }
+
+  // Each thread requests a call, which lands on its own shard, unless
+  // \a request_calls is false.
+  void StartPollers(int num_threads, bool request_calls) {
+    for (int i = 0; i < num_threads; i++) {
+      pollers_.emplace_back([this, request_calls]() {
+        if (request_calls) RequestCall();
+        Poll();
+      });
+    }
+  }
+
+  void TearDown() GRPC_OVERRIDE {
+    server_->Shutdown();
+    cq_->Shutdown();
+    if (pollers_.empty()) Poll();
+    for (auto it = pollers_.begin(); it != pollers_.end(); ++it) {
+      it->join();
+    }
+    EXPECT_EQ(0, live_calls_.load());
+    grpc_recycle_unused_port(port_);
+  }
+
+  void SendRpcs(int num_clients, int num_rpcs) {
+    std::vector<std::thread> clients;
+    for (int i = 0; i < num_clients; i++) {
+      clients.emplace_back([this, num_rpcs]() {
+        for (int j = 0; j < num_rpcs; j++) {
+          EchoRequest request;
+          EchoResponse response;
+          ClientContext context;
+          request.set_message("hello");
+          Status s = stub_->Echo(&context, request, &response);
+          EXPECT_TRUE(s.ok());
+          EXPECT_EQ(request.message(), response.message());
+        }
+      });
+    }
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+      it->join();
+    }
+  }
+
+  int port_;
+  EchoTestService::AsyncService service_;
+  std::unique_ptr<ShardedServerCompletionQueue> cq_;
+  std::unique_ptr<Server> server_;
+  std::unique_ptr<EchoTestService::Stub> stub_;
+  std::vector<std::thread> pollers_;
+  std::atomic<int> live_calls_;
+  std::atomic<int> served_calls_;
+};
+
+TEST(ShardedCqTest, ZeroShardsIsRejected) {
+  ServerBuilder builder;
+  EXPECT_TRUE(builder.AddShardedCompletionQueue(0) == nullptr);
+}
+
+TEST_F(ShardedCqEnd2endTest, AsyncNextTimesOut) {
+  StartServer(4);
+  void* tag;
+  bool ok;
+  EXPECT_EQ(CompletionQueue::TIMEOUT,
+            cq_->AsyncNext(&tag, &ok, gpr_time_0(GPR_CLOCK_REALTIME)));
+  EXPECT_EQ(CompletionQueue::TIMEOUT,
+            cq_->AsyncNext(&tag, &ok, gpr_time_add(
+                                          gpr_now(GPR_CLOCK_REALTIME),
+                                          gpr_time_from_millis(
+                                              20, GPR_TIMESPAN))));
+}
+
+// the first calls are requested here, on this thread's shard: the poller,
+// whose own shard has nothing, must be woken up to take them
+TEST_F(ShardedCqEnd2endTest, OnePollerTakesEventsOfOtherShards) {
+  StartServer(4);
+  for (int i = 0; i < 4; i++) RequestCall();
+  StartPollers(1, false);
+  SendRpcs(4, 50);
+  EXPECT_EQ(200, served_calls_.load());
+}
+
+TEST_F(ShardedCqEnd2endTest, ManyThreads) {
+  StartServer(4);
+  StartPollers(8, true);
+  SendRpcs(8, 50);
+  EXPECT_EQ(400, served_calls_.load());
+}
+
+TEST_F(ShardedCqEnd2endTest, FewerThreadsThanShards) {
+  StartServer(8);
+  StartPollers(2, true);
+  SendRpcs(4, 50);
+  EXPECT_EQ(200, served_calls_.load());
+}
+
+TEST_F(ShardedCqEnd2endTest, SingleShard) {
+  StartServer(1);
+  StartPollers(2, true);
+  SendRpcs(2, 50);
+  EXPECT_EQ(100, served_calls_.load());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc_test_init(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
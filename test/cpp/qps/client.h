@@ -51,6 +51,7 @@
 #include "test/cpp/qps/histogram.h"
 #include "test/cpp/qps/interarrival.h"
 #include "test/cpp/qps/limit_cores.h"
+#include "test/cpp/qps/payload_size.h"
 #include "test/cpp/qps/usage_timer.h"
 #include "test/cpp/util/create_test_channel.h"
 
@@ -112,19 +113,31 @@ class ClientRequestCreator<ByteBuffer> {
   }
 };
 
+// Payload bytes carried by a request, used for per-byte stats
+inline size_t RequestPayloadBytes(const SimpleRequest& req) {
+  return req.payload().body().size();
+}
+
+inline size_t RequestPayloadBytes(const ByteBuffer& req) {
+  return req.Length();
+}
+
 class HistogramEntry GRPC_FINAL {
  public:
-  HistogramEntry() : used_(false) {}
+  HistogramEntry() : used_(false), payload_bytes_(0) {}
   bool used() const { return used_; }
   double value() const { return value_; }
   void set_value(double v) {
     used_ = true;
     value_ = v;
   }
+  size_t payload_bytes() const { return payload_bytes_; }
+  void set_payload_bytes(size_t n) { payload_bytes_ = n; }
 
  private:
   bool used_;
   double value_;
+  size_t payload_bytes_;
 };
 
 class Client {
@@ -139,6 +152,7 @@ class Client {
 
   ClientStats Mark(bool reset) {
     Histogram latencies;
+    double payload_bytes = 0;
     UsageTimer::Result timer_result;
 
     MaybeStartRequests();
@@ -147,7 +161,9 @@ class Client {
     if (reset) {
       Histogram* to_merge = new Histogram[threads_.size()];
       for (size_t i = 0; i < threads_.size(); i++) {
-        threads_[i]->BeginSwap(&to_merge[i]);
+        double thread_payload_bytes;
+        threads_[i]->BeginSwap(&to_merge[i], &thread_payload_bytes);
+        payload_bytes += thread_payload_bytes;
       }
       std::unique_ptr<UsageTimer> timer(new UsageTimer);
       timer_.swap(timer);
@@ -160,7 +176,7 @@ class Client {
     } else {
       // merge snapshots of each thread histogram
       for (size_t i = 0; i < threads_.size(); i++) {
-        threads_[i]->MergeStatsInto(&latencies);
+        threads_[i]->MergeStatsInto(&latencies, &payload_bytes);
       }
       timer_result = timer_->Mark();
     }
@@ -170,6 +186,9 @@ class Client {
     stats.set_time_elapsed(timer_result.wall);
     stats.set_time_system(timer_result.system);
     stats.set_time_user(timer_result.user);
+    stats.set_payload_bytes(payload_bytes);
+    stats.set_allocs(timer_result.allocs);
+    stats.set_alloc_bytes(timer_result.alloc_bytes);
     return stats;
   }
 
@@ -254,20 +273,26 @@ class Client {
   class Thread {
    public:
     Thread(Client* client, size_t idx)
-        : client_(client), idx_(idx), impl_(&Thread::ThreadFunc, this) {}
+        : payload_bytes_(0),
+          client_(client),
+          idx_(idx),
+          impl_(&Thread::ThreadFunc, this) {}
 
     ~Thread() { impl_.join(); }
 
-    void BeginSwap(Histogram* n) {
+    void BeginSwap(Histogram* n, double* payload_bytes) {
       std::lock_guard<std::mutex> g(mu_);
       n->Swap(&histogram_);
+      *payload_bytes = payload_bytes_;
+      payload_bytes_ = 0;
     }
 
     void EndSwap() {}
 
-    void MergeStatsInto(Histogram* hist) {
+    void MergeStatsInto(Histogram* hist, double* payload_bytes) {
       std::unique_lock<std::mutex> g(mu_);
       hist->Merge(histogram_);
+      *payload_bytes += payload_bytes_;
     }
 
    private:
@@ -290,6 +315,7 @@ class Client {
         std::lock_guard<std::mutex> g(mu_);
         if (entry.used()) {
           histogram_.Add(entry.value());
+          payload_bytes_ += entry.payload_bytes();
         }
         if (!thread_still_ok) {
           gpr_log(GPR_ERROR, "Finishing client thread due to RPC error");
@@ -304,6 +330,7 @@ class Client {
 
     std::mutex mu_;
     Histogram histogram_;
+    double payload_bytes_;
     Client* client_;
     const size_t idx_;
     std::thread impl_;
@@ -358,9 +385,59 @@ class ClientImpl : public Client {
   virtual ~ClientImpl() {}
 
  protected:
+  // Number of requests pre-built when a request size distribution is
+  // configured. Sizes are drawn at stratified quantiles, so this is enough
+  // to cover the tail without holding too many large requests in memory.
+  static const int kRequestPoolSize = 256;
+
   const int cores_;
   RequestType request_;
 
+  // Must be called before NextRequest when request sizes are randomized;
+  // num_threads is the number of threads that will call NextRequest
+  void SetupRequestPool(const ClientConfig& config, size_t num_threads) {
+    const auto& size_params = config.request_size_params();
+    if (size_params.size_case() == PayloadSizeParams::SIZE_NOT_SET ||
+        size_params.has_fixed()) {
+      return;  // request_ already has the configured fixed size
+    }
+    const auto& payload_config = config.payload_config();
+    std::unique_ptr<PayloadSizeDistInterface> dist;
+    if (payload_config.has_bytebuf_params()) {
+      dist = CreatePayloadSizeDist(size_params,
+                                   payload_config.bytebuf_params().req_size());
+    } else if (payload_config.has_simple_params()) {
+      dist = CreatePayloadSizeDist(size_params,
+                                   payload_config.simple_params().req_size());
+    } else {
+      GPR_ASSERT(false);  // only sized payloads can follow a distribution
+    }
+    request_sizes_.init(*dist, num_threads, kRequestPoolSize);
+    request_pool_.resize(request_sizes_.size());
+    for (size_t i = 0; i < request_pool_.size(); i++) {
+      PayloadConfig sized_config(payload_config);
+      if (sized_config.has_bytebuf_params()) {
+        sized_config.mutable_bytebuf_params()->set_req_size(request_sizes_[i]);
+      } else {
+        sized_config.mutable_simple_params()->set_req_size(request_sizes_[i]);
+      }
+      ClientRequestCreator<RequestType> create_req(&request_pool_[i],
+                                                   sized_config);
+    }
+  }
+
+  // The request to send next from thread_idx: request_ itself, or the next
+  // pooled request if request sizes follow a distribution
+  const RequestType& NextRequest(size_t thread_idx) {
+    if (request_pool_.empty()) {
+      return request_;
+    }
+    return request_pool_[request_sizes_.next(thread_idx)];
+  }
+  std::function<const RequestType&()> NextRequester(size_t thread_idx) {
+    return std::bind(&ClientImpl::NextRequest, this, thread_idx);
+  }
+
   class ClientChannelInfo {
    public:
     ClientChannelInfo() {}
@@ -399,6 +476,10 @@ class ClientImpl : public Client {
   std::vector<ClientChannelInfo> channels_;
   std::function<std::unique_ptr<StubType>(const std::shared_ptr<Channel>&)>
       create_stub_;
+
+ private:
+  PayloadSizeTable request_sizes_;
+  std::vector<RequestType> request_pool_;
 };
 
 std::unique_ptr<Client> CreateSynchronousUnaryClient(const ClientConfig& args);
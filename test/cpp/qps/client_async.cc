@@ -76,7 +76,8 @@ template <class RequestType, class ResponseType>
 class ClientRpcContextUnaryImpl : public ClientRpcContext {
  public:
   ClientRpcContextUnaryImpl(
-      BenchmarkService::Stub* stub, const RequestType& req,
+      BenchmarkService::Stub* stub,
+      std::function<const RequestType&()> next_req,
       std::function<gpr_timespec()> next_issue,
       std::function<
           std::unique_ptr<grpc::ClientAsyncResponseReader<ResponseType>>(
@@ -87,7 +88,8 @@ class ClientRpcContextUnaryImpl : public ClientRpcContext {
       : context_(),
         stub_(stub),
         cq_(nullptr),
-        req_(req),
+        next_req_(next_req),
+        req_(nullptr),
         response_(),
         next_state_(State::READY),
         callback_(on_done),
@@ -106,13 +108,15 @@ class ClientRpcContextUnaryImpl : public ClientRpcContext {
     switch (next_state_) {
       case State::READY:
         start_ = UsageTimer::Now();
-        response_reader_ = start_req_(stub_, &context_, req_, cq_);
+        req_ = &next_req_();
+        response_reader_ = start_req_(stub_, &context_, *req_, cq_);
         response_reader_->Finish(&response_, &status_,
                                  ClientRpcContext::tag(this));
         next_state_ = State::RESP_DONE;
         return true;
       case State::RESP_DONE:
         entry->set_value((UsageTimer::Now() - start_) * 1e9);
+        entry->set_payload_bytes(RequestPayloadBytes(*req_));
         callback_(status_, &response_);
         next_state_ = State::INVALID;
         return false;
@@ -122,8 +126,8 @@ class ClientRpcContextUnaryImpl : public ClientRpcContext {
     }
   }
   ClientRpcContext* StartNewClone() GRPC_OVERRIDE {
-    return new ClientRpcContextUnaryImpl(stub_, req_, next_issue_, start_req_,
-                                         callback_);
+    return new ClientRpcContextUnaryImpl(stub_, next_req_, next_issue_,
+                                         start_req_, callback_);
   }
 
  private:
@@ -131,7 +135,8 @@ class ClientRpcContextUnaryImpl : public ClientRpcContext {
   BenchmarkService::Stub* stub_;
   CompletionQueue* cq_;
   std::unique_ptr<Alarm> alarm_;
-  RequestType req_;
+  std::function<const RequestType&()> next_req_;
+  const RequestType* req_;
   ResponseType response_;
   enum State { INVALID, READY, RESP_DONE };
   State next_state_;
@@ -159,17 +164,19 @@ class AsyncClient : public ClientImpl<StubType, RequestType> {
   using Client::NextIssuer;
   using ClientImpl<StubType, RequestType>::cores_;
   using ClientImpl<StubType, RequestType>::channels_;
-  using ClientImpl<StubType, RequestType>::request_;
+  using ClientImpl<StubType, RequestType>::SetupRequestPool;
+  using ClientImpl<StubType, RequestType>::NextRequester;
   AsyncClient(const ClientConfig& config,
               std::function<ClientRpcContext*(
-                  StubType*, std::function<gpr_timespec()> next_issue,
-                  const RequestType&)>
+                  StubType*, std::function<const RequestType&()> next_req,
+                  std::function<gpr_timespec()> next_issue)>
                   setup_ctx,
               std::function<std::unique_ptr<StubType>(std::shared_ptr<Channel>)>
                   create_stub)
       : ClientImpl<StubType, RequestType>(config, create_stub),
         num_async_threads_(NumThreads(config)) {
     SetupLoadTest(config, num_async_threads_);
+    SetupRequestPool(config, num_async_threads_);
 
     for (int i = 0; i < num_async_threads_; i++) {
       cli_cqs_.emplace_back(new CompletionQueue);
@@ -182,8 +189,8 @@ class AsyncClient : public ClientImpl<StubType, RequestType> {
     for (int ch = 0; ch < config.client_channels(); ch++) {
       for (int i = 0; i < config.outstanding_rpcs_per_channel(); i++) {
         auto* cq = cli_cqs_[t].get();
-        auto ctx =
-            setup_ctx(channels_[ch].get_stub(), next_issuers_[t], request_);
+        auto ctx = setup_ctx(channels_[ch].get_stub(), NextRequester(t),
+                             next_issuers_[t]);
         ctx->Start(cq);
       }
       t = (t + 1) % cli_cqs_.size();
@@ -296,11 +303,12 @@ class AsyncUnaryClient GRPC_FINAL
            const SimpleRequest& request, CompletionQueue* cq) {
     return stub->AsyncUnaryCall(ctx, request, cq);
   };
-  static ClientRpcContext* SetupCtx(BenchmarkService::Stub* stub,
-                                    std::function<gpr_timespec()> next_issue,
-                                    const SimpleRequest& req) {
+  static ClientRpcContext* SetupCtx(
+      BenchmarkService::Stub* stub,
+      std::function<const SimpleRequest&()> next_req,
+      std::function<gpr_timespec()> next_issue) {
     return new ClientRpcContextUnaryImpl<SimpleRequest, SimpleResponse>(
-        stub, req, next_issue, AsyncUnaryClient::StartReq,
+        stub, next_req, next_issue, AsyncUnaryClient::StartReq,
         AsyncUnaryClient::CheckDone);
   }
 };
@@ -309,7 +317,8 @@ template <class RequestType, class ResponseType>
 class ClientRpcContextStreamingImpl : public ClientRpcContext {
  public:
   ClientRpcContextStreamingImpl(
-      BenchmarkService::Stub* stub, const RequestType& req,
+      BenchmarkService::Stub* stub,
+      std::function<const RequestType&()> next_req,
       std::function<gpr_timespec()> next_issue,
       std::function<std::unique_ptr<
           grpc::ClientAsyncReaderWriter<RequestType, ResponseType>>(
@@ -320,7 +329,8 @@ class ClientRpcContextStreamingImpl : public ClientRpcContext {
       : context_(),
         stub_(stub),
         cq_(nullptr),
-        req_(req),
+        next_req_(next_req),
+        req_(nullptr),
         response_(),
         next_state_(State::INVALID),
         callback_(on_done),
@@ -353,7 +363,8 @@ class ClientRpcContextStreamingImpl : public ClientRpcContext {
           }
           start_ = UsageTimer::Now();
           next_state_ = State::WRITE_DONE;
-          stream_->Write(req_, ClientRpcContext::tag(this));
+          req_ = &next_req_();
+          stream_->Write(*req_, ClientRpcContext::tag(this));
           return true;
         case State::WRITE_DONE:
           if (!ok) {
@@ -365,6 +376,7 @@ class ClientRpcContextStreamingImpl : public ClientRpcContext {
           break;
         case State::READ_DONE:
           entry->set_value((UsageTimer::Now() - start_) * 1e9);
+          entry->set_payload_bytes(RequestPayloadBytes(*req_));
           callback_(status_, &response_);
           next_state_ = State::STREAM_IDLE;
           break;  // loop around
@@ -375,7 +387,7 @@ class ClientRpcContextStreamingImpl : public ClientRpcContext {
     }
   }
   ClientRpcContext* StartNewClone() GRPC_OVERRIDE {
-    return new ClientRpcContextStreamingImpl(stub_, req_, next_issue_,
+    return new ClientRpcContextStreamingImpl(stub_, next_req_, next_issue_,
                                              start_req_, callback_);
   }
 
@@ -384,7 +396,8 @@ class ClientRpcContextStreamingImpl : public ClientRpcContext {
   BenchmarkService::Stub* stub_;
   CompletionQueue* cq_;
   std::unique_ptr<Alarm> alarm_;
-  RequestType req_;
+  std::function<const RequestType&()> next_req_;
+  const RequestType* req_;
   ResponseType response_;
   enum State {
     INVALID,
@@ -427,11 +440,12 @@ class AsyncStreamingClient GRPC_FINAL
     auto stream = stub->AsyncStreamingCall(ctx, cq, tag);
     return stream;
   };
-  static ClientRpcContext* SetupCtx(BenchmarkService::Stub* stub,
-                                    std::function<gpr_timespec()> next_issue,
-                                    const SimpleRequest& req) {
+  static ClientRpcContext* SetupCtx(
+      BenchmarkService::Stub* stub,
+      std::function<const SimpleRequest&()> next_req,
+      std::function<gpr_timespec()> next_issue) {
     return new ClientRpcContextStreamingImpl<SimpleRequest, SimpleResponse>(
-        stub, req, next_issue, AsyncStreamingClient::StartReq,
+        stub, next_req, next_issue, AsyncStreamingClient::StartReq,
         AsyncStreamingClient::CheckDone);
   }
 };
@@ -439,7 +453,7 @@ class AsyncStreamingClient GRPC_FINAL
 class ClientRpcContextGenericStreamingImpl : public ClientRpcContext {
  public:
   ClientRpcContextGenericStreamingImpl(
-      grpc::GenericStub* stub, const ByteBuffer& req,
+      grpc::GenericStub* stub, std::function<const ByteBuffer&()> next_req,
       std::function<gpr_timespec()> next_issue,
       std::function<std::unique_ptr<grpc::GenericClientAsyncReaderWriter>(
           grpc::GenericStub*, grpc::ClientContext*,
@@ -449,7 +463,8 @@ class ClientRpcContextGenericStreamingImpl : public ClientRpcContext {
       : context_(),
         stub_(stub),
         cq_(nullptr),
-        req_(req),
+        next_req_(next_req),
+        req_(nullptr),
         response_(),
         next_state_(State::INVALID),
         callback_(on_done),
@@ -485,7 +500,8 @@ class ClientRpcContextGenericStreamingImpl : public ClientRpcContext {
           }
           start_ = UsageTimer::Now();
           next_state_ = State::WRITE_DONE;
-          stream_->Write(req_, ClientRpcContext::tag(this));
+          req_ = &next_req_();
+          stream_->Write(*req_, ClientRpcContext::tag(this));
           return true;
         case State::WRITE_DONE:
           if (!ok) {
@@ -497,6 +513,7 @@ class ClientRpcContextGenericStreamingImpl : public ClientRpcContext {
           break;
         case State::READ_DONE:
           entry->set_value((UsageTimer::Now() - start_) * 1e9);
+          entry->set_payload_bytes(RequestPayloadBytes(*req_));
           callback_(status_, &response_);
           next_state_ = State::STREAM_IDLE;
           break;  // loop around
@@ -507,7 +524,8 @@ class ClientRpcContextGenericStreamingImpl : public ClientRpcContext {
     }
   }
   ClientRpcContext* StartNewClone() GRPC_OVERRIDE {
-    return new ClientRpcContextGenericStreamingImpl(stub_, req_, next_issue_,
+    return new ClientRpcContextGenericStreamingImpl(stub_, next_req_,
+                                                    next_issue_,
                                                     start_req_, callback_);
   }
 
@@ -516,7 +534,8 @@ class ClientRpcContextGenericStreamingImpl : public ClientRpcContext {
   grpc::GenericStub* stub_;
   CompletionQueue* cq_;
   std::unique_ptr<Alarm> alarm_;
-  ByteBuffer req_;
+  std::function<const ByteBuffer&()> next_req_;
+  const ByteBuffer* req_;
   ByteBuffer response_;
   enum State {
     INVALID,
@@ -563,10 +582,10 @@ class GenericAsyncStreamingClient GRPC_FINAL
     return stream;
   };
   static ClientRpcContext* SetupCtx(grpc::GenericStub* stub,
-                                    std::function<gpr_timespec()> next_issue,
-                                    const ByteBuffer& req) {
+                                    std::function<const ByteBuffer&()> next_req,
+                                    std::function<gpr_timespec()> next_issue) {
     return new ClientRpcContextGenericStreamingImpl(
-        stub, req, next_issue, GenericAsyncStreamingClient::StartReq,
+        stub, next_req, next_issue, GenericAsyncStreamingClient::StartReq,
         GenericAsyncStreamingClient::CheckDone);
   }
 };
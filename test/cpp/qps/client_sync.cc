@@ -74,6 +74,7 @@ class SynchronousClient
         config.outstanding_rpcs_per_channel() * config.client_channels();
     responses_.resize(num_threads_);
     SetupLoadTest(config, num_threads_);
+    SetupRequestPool(config, num_threads_);
   }
 
   virtual ~SynchronousClient(){};
@@ -127,9 +128,11 @@ class SynchronousUnaryClient GRPC_FINAL : public SynchronousClient {
     double start = UsageTimer::Now();
     GPR_TIMER_SCOPE("SynchronousUnaryClient::ThreadFunc", 0);
     grpc::ClientContext context;
+    const SimpleRequest& request = NextRequest(thread_idx);
     grpc::Status s =
-        stub->UnaryCall(&context, request_, &responses_[thread_idx]);
+        stub->UnaryCall(&context, request, &responses_[thread_idx]);
     entry->set_value((UsageTimer::Now() - start) * 1e9);
+    entry->set_payload_bytes(RequestPayloadBytes(request));
     if (!s.ok()) {
       gpr_log(GPR_ERROR, "RPC error: %d: %s", s.error_code(),
               s.error_message().c_str());
@@ -174,9 +177,11 @@ class SynchronousStreamingClient GRPC_FINAL : public SynchronousClient {
     }
     GPR_TIMER_SCOPE("SynchronousStreamingClient::ThreadFunc", 0);
     double start = UsageTimer::Now();
-    if (stream_[thread_idx]->Write(request_) &&
+    const SimpleRequest& request = NextRequest(thread_idx);
+    if (stream_[thread_idx]->Write(request) &&
         stream_[thread_idx]->Read(&responses_[thread_idx])) {
       entry->set_value((UsageTimer::Now() - start) * 1e9);
+      entry->set_payload_bytes(RequestPayloadBytes(request));
       return true;
     }
     return false;
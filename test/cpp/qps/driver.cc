@@ -125,6 +125,11 @@ static double UserTime(ClientStats s) { return s.time_user(); }
 static double ServerWallTime(ServerStats s) { return s.time_elapsed(); }
 static double ServerSystemTime(ServerStats s) { return s.time_system(); }
 static double ServerUserTime(ServerStats s) { return s.time_user(); }
+static double PayloadBytes(ClientStats s) { return s.payload_bytes(); }
+static double Allocs(ClientStats s) { return s.allocs(); }
+static double AllocBytes(ClientStats s) { return s.alloc_bytes(); }
+static double ServerAllocs(ServerStats s) { return s.allocs(); }
+static double ServerAllocBytes(ServerStats s) { return s.alloc_bytes(); }
 static int Cores(int n) { return n; }
 
 // Postprocess ScenarioResult and populate result summary.
@@ -157,6 +162,24 @@ static void postprocess_scenario_result(ScenarioResult* result) {
   result->mutable_summary()->set_server_user_time(server_user_time);
   result->mutable_summary()->set_client_system_time(client_system_time);
   result->mutable_summary()->set_client_user_time(client_user_time);
+
+  // Allocation counters are only nonzero if workers track allocations
+  auto messages = histogram.Count();
+  auto payload_bytes = sum(result->client_stats(), PayloadBytes);
+  if (messages > 0 && payload_bytes > 0) {
+    auto client_allocs = sum(result->client_stats(), Allocs);
+    auto client_alloc_bytes = sum(result->client_stats(), AllocBytes);
+    auto server_allocs = sum(result->server_stats(), ServerAllocs);
+    auto server_alloc_bytes = sum(result->server_stats(), ServerAllocBytes);
+    result->mutable_summary()->set_client_allocs_per_message(client_allocs /
+                                                             messages);
+    result->mutable_summary()->set_client_alloc_bytes_per_payload_byte(
+        client_alloc_bytes / payload_bytes);
+    result->mutable_summary()->set_server_allocs_per_message(server_allocs /
+                                                             messages);
+    result->mutable_summary()->set_server_alloc_bytes_per_payload_byte(
+        server_alloc_bytes / payload_bytes);
+  }
 }
 
 // Namespace for classes and functions used only in RunScenario
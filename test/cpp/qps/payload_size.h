@@ -0,0 +1,229 @@
+/*
+ *
+ * Copyright 2016, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef TEST_QPS_PAYLOAD_SIZE_H
+#define TEST_QPS_PAYLOAD_SIZE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <grpc++/support/config.h>
+#include <grpc/support/log.h>
+
+#include "src/proto/grpc/testing/control.grpc.pb.h"
+
+namespace grpc {
+namespace testing {
+
+// Distributions of request payload sizes. As with the interarrival
+// distributions, these avoid std::random so that other language stacks can
+// follow the same code: each one maps a uniform double in [0,1) to a size.
+
+class PayloadSizeDistInterface {
+ public:
+  PayloadSizeDistInterface() {}
+  virtual ~PayloadSizeDistInterface() = 0;
+  // Argument to transform is a uniform double in the range [0,1)
+  virtual int transform(double uni) const = 0;
+};
+
+inline PayloadSizeDistInterface::~PayloadSizeDistInterface() {}
+
+class FixedSizeDist GRPC_FINAL : public PayloadSizeDistInterface {
+ public:
+  explicit FixedSizeDist(int size) : size_(size) {}
+  ~FixedSizeDist() GRPC_OVERRIDE {}
+  int transform(double uni) const GRPC_OVERRIDE { return size_; }
+
+ private:
+  int size_;
+};
+
+class UniformSizeDist GRPC_FINAL : public PayloadSizeDistInterface {
+ public:
+  UniformSizeDist(int min_size, int max_size)
+      : min_size_(min_size), range_(max_size - min_size + 1) {
+    GPR_ASSERT(min_size >= 0 && max_size >= min_size);
+  }
+  ~UniformSizeDist() GRPC_OVERRIDE {}
+  int transform(double uni) const GRPC_OVERRIDE {
+    return min_size_ + static_cast<int>(uni * range_);
+  }
+
+ private:
+  int min_size_;
+  double range_;
+};
+
+// LogNormalSizeDist draws exp(N(mu, sigma^2)), clamped to the configured
+// bounds. See http://en.wikipedia.org/wiki/Log-normal_distribution
+class LogNormalSizeDist GRPC_FINAL : public PayloadSizeDistInterface {
+ public:
+  LogNormalSizeDist(double mu, double sigma, int min_size, int max_size)
+      : mu_(mu), sigma_(sigma), min_size_(min_size), max_size_(max_size) {
+    GPR_ASSERT(sigma >= 0 && min_size >= 0);
+    GPR_ASSERT(max_size == 0 || max_size >= min_size);
+  }
+  ~LogNormalSizeDist() GRPC_OVERRIDE {}
+  int transform(double uni) const GRPC_OVERRIDE {
+    double size = exp(mu_ + sigma_ * InverseNormalCdf(uni));
+    if (max_size_ != 0 && size > max_size_) return max_size_;
+    if (size < min_size_) return min_size_;
+    return static_cast<int>(size);
+  }
+
+ private:
+  // Bisection on the standard normal CDF: only called while building request
+  // pools, so simplicity wins over speed here.
+  static double InverseNormalCdf(double p) {
+    double lo = -40.0;
+    double hi = 40.0;
+    for (int i = 0; i < 64; i++) {
+      const double mid = (lo + hi) / 2;
+      if (0.5 * erfc(-mid / sqrt(2.0)) < p) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    return (lo + hi) / 2;
+  }
+
+  double mu_;
+  double sigma_;
+  int min_size_;
+  int max_size_;
+};
+
+// HistogramSizeDist replays a recorded histogram of sizes, picking each
+// bucket with probability proportional to its weight.
+class HistogramSizeDist GRPC_FINAL : public PayloadSizeDistInterface {
+ public:
+  explicit HistogramSizeDist(const HistogramSizeParams& params) {
+    GPR_ASSERT(params.sizes_size() > 0);
+    GPR_ASSERT(params.sizes_size() == params.weights_size());
+    double total = 0;
+    for (int i = 0; i < params.sizes_size(); i++) {
+      GPR_ASSERT(params.sizes(i) >= 0 && params.weights(i) >= 0);
+      total += params.weights(i);
+      sizes_.push_back(params.sizes(i));
+      cumulative_.push_back(total);
+    }
+    GPR_ASSERT(total > 0);
+  }
+  ~HistogramSizeDist() GRPC_OVERRIDE {}
+  int transform(double uni) const GRPC_OVERRIDE {
+    const double target = uni * cumulative_.back();
+    size_t i = static_cast<size_t>(
+        std::upper_bound(cumulative_.begin(), cumulative_.end(), target) -
+        cumulative_.begin());
+    return sizes_[std::min(i, sizes_.size() - 1)];
+  }
+
+ private:
+  std::vector<int> sizes_;
+  std::vector<double> cumulative_;
+};
+
+inline std::unique_ptr<PayloadSizeDistInterface> CreatePayloadSizeDist(
+    const PayloadSizeParams& params, int fixed_size) {
+  std::unique_ptr<PayloadSizeDistInterface> dist;
+  switch (params.size_case()) {
+    case PayloadSizeParams::SIZE_NOT_SET:
+    case PayloadSizeParams::kFixed:
+      dist.reset(new FixedSizeDist(fixed_size));
+      break;
+    case PayloadSizeParams::kUniform:
+      dist.reset(new UniformSizeDist(params.uniform().min_size(),
+                                     params.uniform().max_size()));
+      break;
+    case PayloadSizeParams::kLogNormal:
+      dist.reset(new LogNormalSizeDist(
+          params.log_normal().mu(), params.log_normal().sigma(),
+          params.log_normal().min_size(), params.log_normal().max_size()));
+      break;
+    case PayloadSizeParams::kHistogram:
+      dist.reset(new HistogramSizeDist(params.histogram()));
+      break;
+  }
+  GPR_ASSERT(dist);
+  return dist;
+}
+
+// Draws a fixed number of sizes from a distribution at stratified quantiles,
+// so that even a small table represents the tail faithfully, then shuffles
+// them. The table is built at construction time; each thread walks it from
+// its own starting point, so calls must include the thread id of the invoker.
+
+class PayloadSizeTable {
+ public:
+  PayloadSizeTable() {}
+  void init(const PayloadSizeDistInterface& d, int threads, int entries) {
+    for (int i = 0; i < entries; i++) {
+      sizes_.push_back(d.transform((i + 0.5) / entries));
+    }
+    // rand is the only choice that is portable across POSIX and Windows
+    // and that supports new and old compilers
+    for (int i = entries - 1; i > 0; i--) {
+      std::swap(sizes_[i], sizes_[rand() % (i + 1)]);
+    }
+    for (int i = 0; i < threads; i++) {
+      thread_posns_.push_back((entries * i) / threads);
+    }
+  }
+
+  size_t size() const { return sizes_.size(); }
+  int operator[](size_t i) const { return sizes_[i]; }
+
+  // Index of the next entry to use from thread_num
+  size_t next(int thread_num) {
+    size_t ret = thread_posns_[thread_num]++;
+    if (thread_posns_[thread_num] == sizes_.size()) {
+      thread_posns_[thread_num] = 0;
+    }
+    return ret;
+  }
+
+ private:
+  std::vector<int> sizes_;
+  std::vector<size_t> thread_posns_;
+};
+
+}  // namespace testing
+}  // namespace grpc
+
+#endif  // TEST_QPS_PAYLOAD_SIZE_H
@@ -71,6 +71,12 @@ void CompositeReporter::ReportTimes(const ScenarioResult& result) {
   }
 }
 
+void CompositeReporter::ReportAllocations(const ScenarioResult& result) {
+  for (size_t i = 0; i < reporters_.size(); ++i) {
+    reporters_[i]->ReportAllocations(result);
+  }
+}
+
 void GprLogReporter::ReportQPS(const ScenarioResult& result) {
   gpr_log(GPR_INFO, "QPS: %.1f", result.summary().qps());
 }
@@ -101,6 +107,19 @@ void GprLogReporter::ReportTimes(const ScenarioResult& result) {
           result.summary().client_user_time());
 }
 
+void GprLogReporter::ReportAllocations(const ScenarioResult& result) {
+  if (result.summary().client_allocs_per_message() == 0 &&
+      result.summary().server_allocs_per_message() == 0) {
+    return;  // workers didn't track allocations
+  }
+  gpr_log(GPR_INFO, "Client allocs/message: %.2f (%.3f bytes/payload byte)",
+          result.summary().client_allocs_per_message(),
+          result.summary().client_alloc_bytes_per_payload_byte());
+  gpr_log(GPR_INFO, "Server allocs/message: %.2f (%.3f bytes/payload byte)",
+          result.summary().server_allocs_per_message(),
+          result.summary().server_alloc_bytes_per_payload_byte());
+}
+
 void JsonReporter::ReportQPS(const ScenarioResult& result) {
   grpc::string json_string =
       SerializeJson(result, "type.googleapis.com/grpc.testing.ScenarioResult");
@@ -121,5 +140,9 @@ void JsonReporter::ReportTimes(const ScenarioResult& result) {
   // NOP - all reporting is handled by ReportQPS.
 }
 
+void JsonReporter::ReportAllocations(const ScenarioResult& result) {
+  // NOP - all reporting is handled by ReportQPS.
+}
+
 }  // namespace testing
 }  // namespace grpc
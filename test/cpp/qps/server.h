@@ -75,6 +75,8 @@ class Server {
     stats.set_time_elapsed(timer_result.wall);
     stats.set_time_system(timer_result.system);
     stats.set_time_user(timer_result.user);
+    stats.set_allocs(timer_result.allocs);
+    stats.set_alloc_bytes(timer_result.alloc_bytes);
     return stats;
   }
 
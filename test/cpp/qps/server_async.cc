@@ -31,6 +31,7 @@
  *
  */
 
+#include <climits>
 #include <forward_list>
 #include <functional>
 #include <memory>
@@ -82,6 +83,9 @@ class AsyncQpsServerTest GRPC_FINAL : public grpc::testing::Server {
     builder.AddListeningPort(server_address,
                              Server::CreateServerCredentials(config));
     gpr_free(server_address);
+    // Request sizes are set by the client config and may exceed the default
+    // receive limit in large-message scenarios
+    builder.SetMaxReceiveMessageSize(INT_MAX);
 
     register_service(&builder, &async_service_);
 
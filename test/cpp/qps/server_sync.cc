@@ -31,6 +31,8 @@
  *
  */
 
+#include <climits>
+
 #include <grpc++/security/server_credentials.h>
 #include <grpc++/server.h>
 #include <grpc++/server_builder.h>
@@ -90,6 +92,9 @@ class SynchronousServer GRPC_FINAL : public grpc::testing::Server {
     builder.AddListeningPort(server_address,
                              Server::CreateServerCredentials(config));
     gpr_free(server_address);
+    // Request sizes are set by the client config and may exceed the default
+    // receive limit in large-message scenarios
+    builder.SetMaxReceiveMessageSize(INT_MAX);
 
     builder.RegisterService(&service_);
 
@@ -37,6 +37,12 @@
 #include <sys/resource.h>
 #include <sys/time.h>
 
+extern "C" {
+#include "test/core/util/memory_counters.h"
+}
+
+static bool g_allocation_counters_enabled = false;
+
 UsageTimer::UsageTimer() : start_(Sample()) {}
 
 double UsageTimer::Now() {
@@ -58,6 +64,14 @@ UsageTimer::Result UsageTimer::Sample() {
   r.wall = time_double(&tv);
   r.user = time_double(&usage.ru_utime);
   r.system = time_double(&usage.ru_stime);
+  if (g_allocation_counters_enabled) {
+    struct grpc_memory_counters counters = grpc_memory_counters_snapshot();
+    r.allocs = counters.total_allocs_absolute;
+    r.alloc_bytes = counters.total_size_absolute;
+  } else {
+    r.allocs = 0;
+    r.alloc_bytes = 0;
+  }
   return r;
 }
 
@@ -67,5 +81,14 @@ UsageTimer::Result UsageTimer::Mark() const {
   r.wall = s.wall - start_.wall;
   r.user = s.user - start_.user;
   r.system = s.system - start_.system;
+  r.allocs = s.allocs - start_.allocs;
+  r.alloc_bytes = s.alloc_bytes - start_.alloc_bytes;
   return r;
 }
+
+void UsageTimer::EnableAllocationCounters() {
+  if (!g_allocation_counters_enabled) {
+    grpc_memory_counters_init();
+    g_allocation_counters_enabled = true;
+  }
+}
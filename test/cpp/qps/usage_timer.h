@@ -42,12 +42,23 @@ class UsageTimer {
     double wall;
     double user;
     double system;
+    double allocs;
+    double alloc_bytes;
   };
 
   Result Mark() const;
 
   static double Now();
 
+  // Start counting gpr allocations, reported in Result. Must be called before
+  // anything is allocated with gpr_malloc (so before grpc_init() or creating
+  // any gRPC object): a block allocated earlier would later be freed through
+  // the counting allocator, which expects its own header in front of it.
+  // Parsing flags first is fine, as that does not go through gpr_malloc.
+  // Adds a global lock to every allocation, so it should only be enabled when
+  // allocations are of interest.
+  static void EnableAllocationCounters();
+
  private:
   static Result Sample();
 
@@ -41,10 +41,14 @@
 #include <grpc/support/time.h>
 
 #include "test/cpp/qps/qps_worker.h"
+#include "test/cpp/qps/usage_timer.h"
 #include "test/cpp/util/test_config.h"
 
 DEFINE_int32(driver_port, 0, "Port for communication with driver");
 DEFINE_int32(server_port, 0, "Port for operation as a server");
+DEFINE_bool(track_allocations, false,
+            "Count gpr allocations and report them in client and server stats "
+            "(slows down every allocation)");
 
 static bool got_sigint = false;
 
@@ -68,6 +72,12 @@ static void RunServer() {
 int main(int argc, char** argv) {
   grpc::testing::InitTest(&argc, &argv, true);
 
+  // InitTest only parses flags, so nothing has been allocated with gpr_malloc
+  // yet: the counters see every allocation the worker makes.
+  if (FLAGS_track_allocations) {
+    UsageTimer::EnableAllocationCounters();
+  }
+
   signal(SIGINT, sigint_handler);
 
   grpc::testing::RunServer();
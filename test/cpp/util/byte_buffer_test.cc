@@ -40,6 +40,8 @@
 #include <grpc/support/slice.h>
 #include <gtest/gtest.h>
 
+#include "src/core/lib/support/tmpfile.h"
+
 namespace grpc {
 namespace {
 
@@ -123,6 +125,26 @@ TEST_F(ByteBufferTest, SerializationMakesCopy) {
   grpc_byte_buffer_destroy(send_buffer);
 }
 
+#ifdef GPR_POSIX_FILE
+TEST_F(ByteBufferTest, SetFromFile) {
+  FILE* file = gpr_tmpfile("byte_buffer_test", nullptr);
+  ASSERT_TRUE(file != nullptr);
+  EXPECT_EQ(strlen(kContent1), fwrite(kContent1, 1, strlen(kContent1), file));
+  EXPECT_EQ(0, fflush(file));
+
+  ByteBuffer buffer;
+  EXPECT_TRUE(buffer.SetFromFile(fileno(file), 6, 3).ok());
+  fclose(file);
+  EXPECT_EQ(3u, buffer.Length());
+  std::vector<Slice> slices;
+  EXPECT_TRUE(buffer.Dump(&slices).ok());
+  ASSERT_EQ(1u, slices.size());
+  EXPECT_EQ(0, memcmp(slices[0].begin(), "xxx", 3));
+
+  EXPECT_FALSE(buffer.SetFromFile(-1, 0, 3).ok());
+}
+#endif
+
 }  // namespace
 }  // namespace grpc
 
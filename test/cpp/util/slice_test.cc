@@ -33,9 +33,14 @@
 
 #include <grpc++/support/slice.h>
 
+#include <stdio.h>
+#include <string.h>
+
 #include <grpc/support/slice.h>
 #include <gtest/gtest.h>
 
+#include "src/core/lib/support/tmpfile.h"
+
 namespace grpc {
 namespace {
 
@@ -78,6 +83,24 @@ TEST_F(SliceTest, Cslice) {
   gpr_slice_unref(c_slice);
 }
 
+#ifdef GPR_POSIX_FILE
+TEST_F(SliceTest, MappedFile) {
+  FILE* file = gpr_tmpfile("slice_test", nullptr);
+  ASSERT_TRUE(file != nullptr);
+  EXPECT_EQ(strlen(kContent), fwrite(kContent, 1, strlen(kContent), file));
+  EXPECT_EQ(0, fflush(file));
+
+  Slice spp(fileno(file), 6, 20, Slice::MAP_ADVICE_WILLNEED);
+  fclose(file);
+  CheckSlice(spp, "xxxxxxxxxxxxxxxxxxxx");
+  Slice copy(spp);
+  CheckSlice(copy, "xxxxxxxxxxxxxxxxxxxx");
+
+  Slice bad(-1, 0, 20, Slice::MAP_ADVICE_NORMAL);
+  CheckSlice(bad, "");
+}
+#endif
+
 }  // namespace
 }  // namespace grpc
 
@@ -32,6 +32,7 @@ gen_build_yaml_dirs="  \
   src/boringssl        \
   src/proto            \
   src/zlib             \
+  src/zstd             \
   test/core/bad_client \
   test/core/bad_ssl    \
   test/core/end2end    \
@@ -51,11 +51,17 @@ static void legal(int x) {
 
 static void dump(void) {
   int i;
+  int c;
 
-  printf("static const uint8_t legal_header_bits[256/8] = ");
-  for (i = 0; i < 256 / 8; i++)
-    printf("%c 0x%02x", i ? ',' : '{', legal_bits[i]);
-  printf(" };\n");
+  printf("static const gpr_byte_class legal_header_class = {");
+  for (i = 0; i < 16; i++) {
+    unsigned row = 0;
+    for (c = i; c < 128; c += 16) {
+      if (legal_bits[c / 8] & (1 << (c % 8))) row |= 1u << (c / 16);
+    }
+    printf("%c 0x%02x", i ? ',' : '{', row);
+  }
+  printf(" }};\n");
 }
 
 static void clear(void) { memset(legal_bits, 0, sizeof(legal_bits)); }
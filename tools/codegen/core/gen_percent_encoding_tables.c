@@ -58,6 +58,21 @@ static void dump(const char *name) {
   printf(" };\n");
 }
 
+static void dump_class(const char *name) {
+  int i;
+  int c;
+
+  printf("const gpr_byte_class %s = {", name);
+  for (i = 0; i < 16; i++) {
+    unsigned row = 0;
+    for (c = i; c < 128; c += 16) {
+      if (legal_bits[c / 8] & (1 << (c % 8))) row |= 1u << (c / 16);
+    }
+    printf("%c 0x%02x", i ? ',' : '{', row);
+  }
+  printf(" }};\n");
+}
+
 static void clear(void) { memset(legal_bits, 0, sizeof(legal_bits)); }
 
 int main(void) {
@@ -72,6 +87,7 @@ int main(void) {
   legal('.');
   legal('~');
   dump("gpr_url_percent_encoding_unreserved_bytes");
+  dump_class("gpr_url_percent_encoding_unreserved_class");
 
   clear();
   for (i = 32; i <= 126; i++) {
@@ -79,6 +95,7 @@ int main(void) {
     legal(i);
   }
   dump("gpr_compatible_percent_encoding_unreserved_bytes");
+  dump_class("gpr_compatible_percent_encoding_unreserved_class");
 
   return 0;
 }
@@ -53,6 +53,9 @@ CONFIG = [
     'grpc-status',
     'grpc-tracing-bin',
     'grpc-stats-bin',
+    # the name of GRPC_COMPRESS_DICT_DEFLATE: its grpc-encoding values also
+    # carry a dictionary ID, and so can't be static
+    'dict/deflate',
     '',
     ('grpc-status', '0'),
     ('grpc-status', '1'),
@@ -60,6 +63,8 @@ CONFIG = [
     ('grpc-encoding', 'identity'),
     ('grpc-encoding', 'gzip'),
     ('grpc-encoding', 'deflate'),
+    ('grpc-encoding', 'stream/deflate'),
+    ('grpc-encoding', 'zstd'),
     ('te', 'trailers'),
     ('content-type', 'application/grpc'),
     (':method', 'POST'),
@@ -134,6 +139,9 @@ COMPRESSION_ALGORITHMS = [
     'identity',
     'deflate',
     'gzip',
+    'stream/deflate',
+    'zstd',
+    # dict/deflate is advertised with its dictionary ID, outside of this table
 ]
 
 # utility: mangle the name of a config
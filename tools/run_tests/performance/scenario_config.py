@@ -67,6 +67,16 @@ BIG_GENERIC_PAYLOAD = {
   }
 }
 
+# heavy-tailed request sizes: median ~1KB, bounded to [100B, 32MB]
+LOG_NORMAL_REQUEST_SIZES = {
+  'log_normal': {
+    'mu': 7.0,
+    'sigma': 2.0,
+    'min_size': 100,
+    'max_size': 32 * 1024 * 1024,
+  }
+}
+
 # target number of RPCs outstanding on across all client channels in
 # non-ping-pong tests (since we can only specify per-channel numbers, the
 # actual target will be slightly higher)
@@ -114,7 +124,8 @@ def _ping_pong_scenario(name, rpc_type,
                         warmup_seconds=WARMUP_SECONDS,
                         categories=DEFAULT_CATEGORIES,
                         channels=None,
-                        outstanding=None):
+                        outstanding=None,
+                        request_size_params=None):
   """Creates a basic ping pong scenario."""
   scenario = {
     'name': name,
@@ -150,6 +161,9 @@ def _ping_pong_scenario(name, rpc_type,
     # For proto payload, only the client should get the config.
     scenario['client_config']['payload_config'] = EMPTY_PROTO_PAYLOAD
 
+  if request_size_params:
+    scenario['client_config']['request_size_params'] = request_size_params
+
   if unconstrained_client:
     outstanding_calls = outstanding if outstanding is not None else OUTSTANDING_REQUESTS[unconstrained_client]
     wide = channels if channels is not None else WIDE
@@ -229,6 +243,16 @@ class CXXLanguage:
           secure=secure,
           categories=smoketest_categories + [SCALABLE])
 
+      yield _ping_pong_scenario(
+          'cpp_protobuf_async_unary_qps_unconstrained_mixed_sizes_%s' % secstr,
+          rpc_type='UNARY',
+          client_type='ASYNC_CLIENT',
+          server_type='ASYNC_SERVER',
+          unconstrained_client='async',
+          request_size_params=LOG_NORMAL_REQUEST_SIZES,
+          secure=secure,
+          categories=smoketest_categories + [SCALABLE])
+
       for rpc_type in ['unary', 'streaming']:
         for synchronicity in ['sync', 'async']:
           yield _ping_pong_scenario(
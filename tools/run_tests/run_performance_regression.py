@@ -0,0 +1,381 @@
+#!/usr/bin/env python2.7
+# Copyright 2016, Google Inc.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     * Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following disclaimer
+# in the documentation and/or other materials provided with the
+# distribution.
+#     * Neither the name of Google Inc. nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Track C++ benchmark results over time and detect regressions.
+
+'run' executes a matrix of qps scenarios (and optionally netperf) N times
+against localhost workers and stores every per-run summary in a JSON file
+labelled with the revision under test. 'compare' takes two such files and
+uses Welch's t-test to report the change of each metric with a confidence
+interval, flagging statistically significant regressions.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import math
+import os
+import performance.scenario_config as scenario_config
+import re
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+
+_ROOT = os.path.abspath(os.path.join(os.path.dirname(sys.argv[0]), '../..'))
+os.chdir(_ROOT)
+
+
+_NETPERF_SCENARIO = 'netperf_tcp_rr'
+
+# Metrics compared by default and whether a larger value is an improvement.
+# Names follow the JSON encoding of ScenarioResultSummary.
+_METRICS = [
+  ('qps', True),
+  ('qpsPerServerCore', True),
+  ('latency50', False),
+  ('latency90', False),
+  ('latency99', False),
+]
+
+_ROW_FORMAT = '%-60s %-16s %14.1f %14.1f %+7.1f%% [%+7.1f%%, %+7.1f%%] %8.4f %s'
+
+
+def _git_revision():
+  try:
+    return subprocess.check_output(
+        ['git', 'rev-parse', 'HEAD']).decode('utf-8').strip()
+  except (OSError, subprocess.CalledProcessError):
+    return 'unknown'
+
+
+def _select_scenarios(regex, category, benchmark_seconds, warmup_seconds):
+  """Returns the proto-compatible scenarios to benchmark, keyed by name."""
+  scenarios = {}
+  for scenario_json in scenario_config.CXXLanguage().scenarios():
+    if not re.search(regex, scenario_json['name']):
+      continue
+    categories = scenario_json.get('CATEGORIES', ['scalable', 'smoketest'])
+    if category not in categories and category != 'all':
+      continue
+    scenario_json = scenario_config.remove_nonproto_fields(scenario_json)
+    if benchmark_seconds is not None:
+      scenario_json['benchmark_seconds'] = benchmark_seconds
+    if warmup_seconds is not None:
+      scenario_json['warmup_seconds'] = warmup_seconds
+    scenarios[scenario_json['name']] = scenario_json
+  return scenarios
+
+
+def _run_qps_scenario(bins, scenario_json):
+  """Runs one scenario on two localhost workers, returns its summary."""
+  fd, result_file = tempfile.mkstemp(suffix='.json')
+  os.close(fd)
+  try:
+    subprocess.check_call(
+        [os.path.join(bins, 'json_run_localhost'),
+         '--scenarios_json=%s' % json.dumps({'scenarios': [scenario_json]}),
+         '--scenario_result_file=%s' % result_file])
+    with open(result_file) as f:
+      return json.load(f)['summary']
+  finally:
+    os.remove(result_file)
+
+
+def _run_netperf(port):
+  """Runs a netperf TCP_RR test against the local netserver."""
+  output = subprocess.check_output(
+      ['netperf', '-P', '0', '-t', 'TCP_RR', '-H', 'localhost',
+       '-p', str(port), '--', '-r', '1,1',
+       '-o', 'P50_LATENCY,P90_LATENCY,P99_LATENCY']).decode('utf-8')
+  # netperf reports microseconds, ScenarioResultSummary uses nanoseconds
+  latencies = [float(col.strip()) * 1000 for col in output.split(',')]
+  return dict(zip(['latency50', 'latency90', 'latency99'], latencies))
+
+
+def _pick_unused_port():
+  s = socket.socket()
+  s.bind(('localhost', 0))
+  port = s.getsockname()[1]
+  s.close()
+  return port
+
+
+def run_benchmarks(args):
+  scenarios = _select_scenarios(args.regex, args.category,
+                                args.benchmark_seconds, args.warmup_seconds)
+  if not scenarios and not args.netperf:
+    print('No scenarios matched.')
+    sys.exit(1)
+
+  netserver = None
+  if args.netperf:
+    netserver_port = _pick_unused_port()
+    netserver = subprocess.Popen(['netserver', '-D', '-p', str(netserver_port)])
+    time.sleep(1)
+
+  results = dict((name, []) for name in scenarios)
+  if netserver:
+    results[_NETPERF_SCENARIO] = []
+  try:
+    # Interleave the scenarios rather than running each N times in a row so
+    # that slow drift of the machine state affects all of them alike.
+    for i in range(args.runs):
+      for name in sorted(scenarios):
+        print('[%d/%d] %s' % (i + 1, args.runs, name))
+        results[name].append(_run_qps_scenario(args.bins, scenarios[name]))
+      if netserver:
+        print('[%d/%d] %s' % (i + 1, args.runs, _NETPERF_SCENARIO))
+        results[_NETPERF_SCENARIO].append(_run_netperf(netserver_port))
+  finally:
+    if netserver:
+      netserver.terminate()
+      netserver.wait()
+
+  report = {
+    'label': args.label or _git_revision(),
+    'hostname': socket.gethostname(),
+    'timestamp': time.strftime('%Y-%m-%dT%H:%M:%S'),
+    'runs': args.runs,
+    'results': results,
+  }
+  with open(args.output, 'w') as f:
+    json.dump(report, f, indent=2, sort_keys=True)
+  print('Wrote %d scenario(s) x %d run(s) to %s' %
+        (len(results), args.runs, args.output))
+
+
+def _betacf(a, b, x):
+  """Continued fraction for the incomplete beta function (Lentz's method)."""
+  tiny = 1e-300
+  qab = a + b
+  qap = a + 1.0
+  qam = a - 1.0
+  c = 1.0
+  d = 1.0 - qab * x / qap
+  if abs(d) < tiny:
+    d = tiny
+  d = 1.0 / d
+  h = d
+  for m in range(1, 300):
+    m2 = 2 * m
+    aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+    d = 1.0 + aa * d
+    if abs(d) < tiny:
+      d = tiny
+    c = 1.0 + aa / c
+    if abs(c) < tiny:
+      c = tiny
+    d = 1.0 / d
+    h *= d * c
+    aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+    d = 1.0 + aa * d
+    if abs(d) < tiny:
+      d = tiny
+    c = 1.0 + aa / c
+    if abs(c) < tiny:
+      c = tiny
+    d = 1.0 / d
+    delta = d * c
+    h *= delta
+    if abs(delta - 1.0) < 1e-12:
+      break
+  return h
+
+
+def _betai(a, b, x):
+  """Regularized incomplete beta function I_x(a, b)."""
+  if x <= 0.0:
+    return 0.0
+  if x >= 1.0:
+    return 1.0
+  bt = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) +
+                a * math.log(x) + b * math.log(1.0 - x))
+  if x < (a + 1.0) / (a + b + 2.0):
+    return bt * _betacf(a, b, x) / a
+  return 1.0 - bt * _betacf(b, a, 1.0 - x) / b
+
+
+def _t_two_sided_p(t, df):
+  """P(|T| >= |t|) for Student's t distribution with df degrees of freedom."""
+  return _betai(df / 2.0, 0.5, df / (df + t * t))
+
+
+def _t_critical(confidence, df):
+  """Value t such that P(|T| <= t) == confidence."""
+  lo, hi = 0.0, 1.0
+  while _t_two_sided_p(hi, df) > 1.0 - confidence:
+    hi *= 2.0
+  for _ in range(100):
+    mid = (lo + hi) / 2.0
+    if _t_two_sided_p(mid, df) > 1.0 - confidence:
+      lo = mid
+    else:
+      hi = mid
+  return hi
+
+
+def _mean_and_variance(samples):
+  n = len(samples)
+  mean = float(sum(samples)) / n
+  var = sum((x - mean) ** 2 for x in samples) / (n - 1)
+  return mean, var
+
+
+def welch_compare(base, new, confidence):
+  """Compares two samples with Welch's t-test.
+
+  Returns (base_mean, new_mean, diff, ci_low, ci_high, p_value) where diff
+  and the confidence interval bounds refer to new_mean - base_mean.
+  """
+  mean_a, var_a = _mean_and_variance(base)
+  mean_b, var_b = _mean_and_variance(new)
+  diff = mean_b - mean_a
+  se2_a = var_a / len(base)
+  se2_b = var_b / len(new)
+  se = math.sqrt(se2_a + se2_b)
+  if se == 0:
+    return mean_a, mean_b, diff, diff, diff, 1.0 if diff == 0 else 0.0
+  df = (se2_a + se2_b) ** 2 / (se2_a ** 2 / (len(base) - 1) +
+                               se2_b ** 2 / (len(new) - 1))
+  t_crit = _t_critical(confidence, df)
+  p_value = _t_two_sided_p(diff / se, df)
+  return mean_a, mean_b, diff, diff - t_crit * se, diff + t_crit * se, p_value
+
+
+def compare_results(args):
+  with open(args.base) as f:
+    base = json.load(f)
+  with open(args.new) as f:
+    new = json.load(f)
+  metrics = [m for m in _METRICS if not args.metrics or m[0] in args.metrics]
+
+  print('Comparing %s (base) against %s (new) at %.0f%% confidence' %
+        (base['label'], new['label'], args.confidence * 100))
+  if base.get('hostname') != new.get('hostname'):
+    print('WARNING: results were collected on different hosts (%s, %s)' %
+          (base.get('hostname'), new.get('hostname')))
+  print()
+  print('%-60s %-16s %14s %14s %8s %20s %8s' %
+        ('scenario', 'metric', 'base', 'new', 'change', 'confidence interval',
+         'p'))
+
+  regressions = []
+  for name in sorted(set(base['results']) & set(new['results'])):
+    for metric, higher_is_better in metrics:
+      base_samples = [r[metric] for r in base['results'][name] if metric in r]
+      new_samples = [r[metric] for r in new['results'][name] if metric in r]
+      if len(base_samples) < 2 or len(new_samples) < 2:
+        continue
+      mean_a, mean_b, diff, ci_low, ci_high, p_value = welch_compare(
+          base_samples, new_samples, args.confidence)
+      if mean_a == 0:
+        continue
+      change = 100.0 * diff / mean_a
+      significant = ci_low > 0 or ci_high < 0
+      worse = (change < 0) == higher_is_better
+      verdict = ''
+      if significant and abs(change) >= args.threshold:
+        verdict = 'REGRESSION' if worse else 'improvement'
+        if worse:
+          regressions.append((name, metric))
+      line = (_ROW_FORMAT %
+              (name, metric, mean_a, mean_b, change, 100.0 * ci_low / mean_a,
+               100.0 * ci_high / mean_a, p_value, verdict))
+      print(line.rstrip())
+
+  only_one = set(base['results']) ^ set(new['results'])
+  for name in sorted(only_one):
+    print('%s: only present in one of the result files, skipped' % name)
+
+  print()
+  if regressions:
+    print('%d significant regression(s):' % len(regressions))
+    for name, metric in regressions:
+      print('  %s: %s' % (name, metric))
+    sys.exit(1)
+  print('No significant regressions.')
+
+
+argp = argparse.ArgumentParser(
+    description='Run C++ benchmarks repeatedly and compare revisions.')
+subparsers = argp.add_subparsers(dest='command')
+
+run_argp = subparsers.add_parser(
+    'run', help='Run the benchmark matrix and store the results.')
+run_argp.add_argument('--bins', default='bins/opt', type=str,
+                      help='Directory containing json_run_localhost, '
+                      'qps_json_driver and qps_worker.')
+run_argp.add_argument('-r', '--regex', default='.*', type=str,
+                      help='Regex to select scenarios to run.')
+run_argp.add_argument('--category',
+                      choices=['smoketest', 'scalable', 'all'],
+                      default='scalable',
+                      help='Select a category of scenarios to run.')
+run_argp.add_argument('-n', '--runs', default=5, type=int,
+                      help='Number of times to run each scenario.')
+run_argp.add_argument('--benchmark_seconds', default=None, type=int,
+                      help='Override the benchmark duration of scenarios.')
+run_argp.add_argument('--warmup_seconds', default=None, type=int,
+                      help='Override the warmup duration of scenarios.')
+run_argp.add_argument('--netperf', default=False, action='store_const',
+                      const=True,
+                      help='Also run netperf TCP_RR against a local netserver.')
+run_argp.add_argument('--label', default=None, type=str,
+                      help='Label stored with the results. Defaults to the '
+                      'git revision of the working tree.')
+run_argp.add_argument('-o', '--output', default='perf_results.json', type=str,
+                      help='File to write the results to.')
+
+compare_argp = subparsers.add_parser(
+    'compare', help='Compare two result files produced by "run".')
+compare_argp.add_argument('base', type=str, help='Results of the baseline.')
+compare_argp.add_argument('new', type=str, help='Results to check.')
+compare_argp.add_argument('--confidence', default=0.95, type=float,
+                          help='Confidence level of the reported intervals.')
+compare_argp.add_argument('--threshold', default=2.0, type=float,
+                          help='Minimum change in percent for a significant '
+                          'difference to be reported.')
+compare_argp.add_argument('--metrics', default=None, nargs='+',
+                          choices=[m[0] for m in _METRICS],
+                          help='Metrics to compare (default: all).')
+
+args = argp.parse_args()
+
+if args.command == 'run':
+  if args.runs < 2:
+    print('At least 2 runs are needed to compute confidence intervals.')
+    sys.exit(1)
+  run_benchmarks(args)
+else:
+  compare_results(args)